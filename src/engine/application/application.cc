@@ -132,6 +132,7 @@ namespace sulphur
 
       foundation::Job renderer_startframe_job = make_job("renderer_startframe", "render",
         renderer_startframe, bind_write(renderer_));
+      renderer_startframe_job.set_blocker("transformsystem_propagate");
       job_graph.Add(std::move(renderer_startframe_job));
 
       foundation::Job renderer_endframe_job = make_job("renderer_endframe", "render",
@@ -312,6 +313,12 @@ namespace sulphur
       return *(platform_);
     }
 
+    //------------------------------------------------------------------------------------------------------
+    foundation::WorkerGroup& Application::workers()
+    {
+      return workers_;
+    }
+
     //------------------------------------------------------------------------------------------------------
     const foundation::Path& Application::project_directory() const
     {
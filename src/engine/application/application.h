@@ -4,6 +4,7 @@
 #include "engine/systems/service_system.h"
 
 #include <foundation/job/resource.h>
+#include <foundation/job/worker_group.h>
 #include <foundation/io/filesystem.h>
 
 namespace sulphur
@@ -108,6 +109,14 @@ namespace sulphur
       */
       const Platform& platform() const;
 
+      /**
+      * @brief Get the worker threads that every system shares for data-parallel work
+      * @return (sulphur::foundation::WorkerGroup&) The worker group, dispatched from the thread that runs the frame
+      * @remarks Work that is still running when another system dispatches is finished first, so systems never
+      *          add threads on top of each other.
+      */
+      foundation::WorkerGroup& workers();
+
       /**
       * @returns (const sulphur::foundation::String&) Returns the directory (path) where the project's assets are located.
       */
@@ -174,6 +183,11 @@ namespace sulphur
       * @brief Class used to execute editor specific logic in the application.
       */
       IEditorHook* editor_hook_;
+
+      /**
+      * @brief Worker threads shared by all systems
+      */
+      foundation::WorkerGroup workers_;
     };
   }
 }
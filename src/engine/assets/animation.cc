@@ -38,6 +38,16 @@ namespace sulphur
         AnimationChannel& new_channel = animation_channels_[i];
         new_channel.bone_name = loaded_channel.bone_name;
 
+        if (loaded_channel.compressed == true)
+        {
+          // Compressed tracks are sampled directly, no need to expand them
+          new_channel.compressed = true;
+          new_channel.position_track = loaded_channel.position_track;
+          new_channel.rotation_track = loaded_channel.rotation_track;
+          new_channel.scale_track = loaded_channel.scale_track;
+          continue;
+        }
+
         new_channel.position_keys.resize(loaded_channel.position_keys.size());
         for (int j = 0; j < loaded_channel.position_keys.size(); ++j)
         {
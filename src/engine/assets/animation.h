@@ -40,6 +40,11 @@ namespace sulphur
       foundation::Vector<Vector3Keyframe> position_keys;        //!< The various keyframes that relate to the position of the bone.
       foundation::Vector<QuaternionKeyframe> rotation_keys;     //!< The various keyframes that relate to the rotation of the bone.
       foundation::Vector<Vector3Keyframe> scale_keys;           //!< The various keyframes that relate to the scaling of the bone.
+
+      bool compressed = false;                                  //!< Whether the tracks are sampled instead of the keyframes.
+      foundation::AnimationVectorTrack position_track;          //!< The compressed position keys of the bone.
+      foundation::AnimationRotationTrack rotation_track;        //!< The compressed rotation keys of the bone.
+      foundation::AnimationVectorTrack scale_track;             //!< The compressed scale keys of the bone.
     };
 
     /**
@@ -16,9 +16,13 @@ namespace sulphur
         application_->project_directory() + asset_file);
       if (reader.is_ok())
       {
-        Animation* asset_animation = foundation::Memory::Construct<Animation>(
-          reader.Read<foundation::AnimationData>()
-        );
+        const foundation::AnimationData animation_data = reader.Read<foundation::AnimationData>();
+        if (animation_data.channels.empty() == true)
+        {
+          return nullptr;
+        }
+
+        Animation* asset_animation = foundation::Memory::Construct<Animation>(animation_data);
 
         return asset_animation;
       }
@@ -11,6 +11,97 @@ namespace sulphur
 {
   namespace engine
   {
+    namespace
+    {
+      /**
+      * @struct sulphur::engine::<anonymous>::MeshStreams
+      * @brief The vertex streams of a mesh that is being imported.
+      */
+      struct MeshStreams
+      {
+        foundation::Vector<glm::vec3> positions; //!< The vertex positions.
+        foundation::Vector<glm::vec3> normals; //!< The vertex normals.
+        foundation::Vector<foundation::Color> colors; //!< The vertex colors.
+        foundation::Vector<glm::vec2> uvs; //!< The vertex texture coordinates.
+        foundation::Vector<glm::vec3> tangents; //!< The vertex tangents.
+        foundation::Vector<glm::vec4> bone_weights; //!< The vertex bone weights.
+        foundation::Vector<glm::vec<4, uint32_t>> bone_indices; //!< The vertex bone indices.
+      };
+
+      //--------------------------------------------------------------------------------
+      const foundation::VertexBase& Decode(const foundation::VertexBase& vertex, const foundation::AABB&)
+      {
+        return vertex;
+      }
+
+      //--------------------------------------------------------------------------------
+      template<typename T>
+      const T& Decode(const T& vertex)
+      {
+        return vertex;
+      }
+
+      /**
+      * @brief Appends the vertex data of a sub-mesh to the streams of the mesh, decoding quantized vertex data on the way
+      * @param[in] base (const sulphur::foundation::Vector<Base>&) The base vertex data
+      * @param[in] color (const sulphur::foundation::Vector<Color>&) The color vertex data
+      * @param[in] textured (const sulphur::foundation::Vector<Textured>&) The texture vertex data
+      * @param[in] bones (const sulphur::foundation::Vector<Bones>&) The bone vertex data
+      * @param[in] bounding_box (const sulphur::foundation::AABB&) The bounding box of the sub-mesh
+      * @param[out] streams (sulphur::engine::<anonymous>::MeshStreams&) The streams of the mesh
+      */
+      template<typename Base, typename Color, typename Textured, typename Bones>
+      void AppendVertices(
+        const foundation::Vector<Base>& base,
+        const foundation::Vector<Color>& color,
+        const foundation::Vector<Textured>& textured,
+        const foundation::Vector<Bones>& bones,
+        const foundation::AABB& bounding_box,
+        MeshStreams& streams)
+      {
+        for (size_t i = 0; i < base.size(); ++i)
+        {
+          const foundation::VertexBase& vertex = Decode(base[i], bounding_box);
+          streams.positions.push_back(vertex.position);
+          streams.normals.push_back(vertex.normal);
+        }
+
+        for (size_t i = 0; i < color.size(); ++i)
+        {
+          streams.colors.push_back(Decode(color[i]).color);
+        }
+
+        for (size_t i = 0; i < textured.size(); ++i)
+        {
+          const foundation::VertexTextured& vertex = Decode(textured[i]);
+          streams.uvs.push_back(vertex.uv);
+          streams.tangents.push_back(vertex.tangent);
+        }
+
+        for (size_t i = 0; i < bones.size(); ++i)
+        {
+          const foundation::VertexBones& vertex_bone_data = Decode(bones[i]);
+          streams.bone_indices.push_back(
+            {
+              static_cast<uint32_t>(vertex_bone_data.bone_indices[0]),
+              static_cast<uint32_t>(vertex_bone_data.bone_indices[1]),
+              static_cast<uint32_t>(vertex_bone_data.bone_indices[2]),
+              static_cast<uint32_t>(vertex_bone_data.bone_indices[3])
+            }
+          );
+
+          streams.bone_weights.push_back(
+            {
+              vertex_bone_data.bone_weights[0],
+              vertex_bone_data.bone_weights[1],
+              vertex_bone_data.bone_weights[2],
+              vertex_bone_data.bone_weights[3],
+            }
+          );
+        }
+      }
+    }
+
     //--------------------------------------------------------------------------------
     Mesh* MeshManager::ImportAsset(const foundation::Path& asset_file)
     {
@@ -19,15 +110,24 @@ namespace sulphur
       if (reader.is_ok())
       {
         foundation::MeshData asset_mesh = reader.Read<foundation::MeshData>();
+        if (asset_mesh.sub_meshes.empty() == true)
+        {
+          return nullptr;
+        }
+
+        // Quantized sub-meshes are decoded straight into the streams, so the 
+        // full precision vertex data only exists once
+        size_t vertex_count = 0;
+        for (const foundation::SubMesh& sub_mesh : asset_mesh.sub_meshes)
+        {
+          vertex_count += sub_mesh.vertex_encoding == foundation::VertexEncoding::kQuantized ?
+            sub_mesh.quantized_base.size() : sub_mesh.vertices_base.size();
+        }
 
-        foundation::Vector<glm::vec3> vertex_positions;
-        foundation::Vector<glm::vec3> vertex_normals;
-        foundation::Vector<foundation::Color> vertex_colors;
-        foundation::Vector<glm::vec2> vertex_uvs;
-        foundation::Vector<glm::vec3> vertex_tangents;
+        MeshStreams streams;
+        streams.positions.reserve(vertex_count);
+        streams.normals.reserve(vertex_count);
         foundation::Vector<uint32_t> indices;
-        foundation::Vector<glm::vec4> vertex_bone_weights;
-        foundation::Vector<glm::vec<4, uint32_t>> vertex_bone_indices;
 
         Mesh* mesh = foundation::Memory::Construct<Mesh>();
         mesh->SetBoundingBox(asset_mesh.bounding_box);
@@ -35,24 +135,18 @@ namespace sulphur
 
         for (int i = 0; i < asset_mesh.sub_meshes.size(); ++i)
         {
-          const uint32_t offset = static_cast<uint32_t>(vertex_positions.size());
+          const uint32_t offset = static_cast<uint32_t>(streams.positions.size());
           const foundation::SubMesh& sub_mesh = asset_mesh.sub_meshes[i];
 
-          for (int j = 0; j < sub_mesh.vertices_base.size(); ++j)
+          if (sub_mesh.vertex_encoding == foundation::VertexEncoding::kQuantized)
           {
-            vertex_positions.push_back(sub_mesh.vertices_base[j].position);
-            vertex_normals.push_back(sub_mesh.vertices_base[j].normal);
+            AppendVertices(sub_mesh.quantized_base, sub_mesh.quantized_color, 
+              sub_mesh.quantized_textured, sub_mesh.quantized_bones, sub_mesh.bounding_box, streams);
           }
-
-          for (int j = 0; j < sub_mesh.vertices_color.size(); ++j)
+          else
           {
-            vertex_colors.push_back(sub_mesh.vertices_color[j].color);
-          }
-
-          for (int j = 0; j < sub_mesh.vertices_textured.size(); ++j)
-          {
-            vertex_uvs.push_back(sub_mesh.vertices_textured[j].uv);
-            vertex_tangents.push_back(sub_mesh.vertices_textured[j].tangent);
+            AppendVertices(sub_mesh.vertices_base, sub_mesh.vertices_color,
+              sub_mesh.vertices_textured, sub_mesh.vertices_bones, sub_mesh.bounding_box, streams);
           }
 
           for (int j = 0; j < sub_mesh.indices.size(); ++j)
@@ -60,39 +154,17 @@ namespace sulphur
             indices.push_back(sub_mesh.indices[j] + offset);
           }
 
-          for (int j = 0; j < sub_mesh.vertices_bones.size(); ++j)
-          {
-            const foundation::VertexBones& vertex_bone_data = sub_mesh.vertices_bones[j];
-            vertex_bone_indices.push_back(
-              {
-                static_cast<uint32_t>(vertex_bone_data.bone_indices[0]),
-                static_cast<uint32_t>(vertex_bone_data.bone_indices[1]),
-                static_cast<uint32_t>(vertex_bone_data.bone_indices[2]),
-                static_cast<uint32_t>(vertex_bone_data.bone_indices[3])
-              }
-            );
-
-            vertex_bone_weights.push_back(
-              {
-                vertex_bone_data.bone_weights[0],
-                vertex_bone_data.bone_weights[1],
-                vertex_bone_data.bone_weights[2],
-                vertex_bone_data.bone_weights[3],
-              }
-            );
-          }
-
           mesh->SetIndices(std::move(indices), i);
           indices.clear();
         }
 
-        mesh->SetVertices(std::move(vertex_positions));
-        mesh->SetNormals(std::move(vertex_normals));
-        mesh->SetColors(std::move(vertex_colors));
-        mesh->SetUVs(std::move(vertex_uvs));
-        mesh->SetTangents(std::move(vertex_tangents));
-        mesh->SetBoneWeights(std::move(vertex_bone_weights));
-        mesh->SetBoneIndices(std::move(vertex_bone_indices));
+        mesh->SetVertices(std::move(streams.positions));
+        mesh->SetNormals(std::move(streams.normals));
+        mesh->SetColors(std::move(streams.colors));
+        mesh->SetUVs(std::move(streams.uvs));
+        mesh->SetTangents(std::move(streams.tangents));
+        mesh->SetBoneWeights(std::move(streams.bone_weights));
+        mesh->SetBoneIndices(std::move(streams.bone_indices));
         
         return mesh;
       }
@@ -40,6 +40,13 @@ namespace sulphur
       format_(format),
       creation_flags_(create_flags)
     {
+      const uint block_size = GetBytesPerBlock(format);
+      if (block_size != 0u)
+      {
+        data_.resize(((size_.x + 3u) / 4u) * ((size_.y + 3u) / 4u) * block_size, 0u);
+        return;
+      }
+
       uint elem_size = 1;
       switch (format)
       {
@@ -54,6 +61,8 @@ namespace sulphur
       case TextureFormat::kR32G32B32A32_FLOAT:
         elem_size = 4;
         break;
+      default:
+        break;
       }
 
       data_.resize(size_.x * size_.y * elem_size * 4u, 0u);
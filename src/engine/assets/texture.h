@@ -26,8 +26,46 @@ namespace sulphur
       kR32G32B32A32_FLOAT,
       kR24G8_TYPELESS,
       kR32_TYPELESS,
+      kBC1_UNORM,
+      kBC1_UNORM_SRGB,
+      kBC2_UNORM,
+      kBC2_UNORM_SRGB,
+      kBC3_UNORM,
+      kBC3_UNORM_SRGB,
+      kBC4_UNORM,
+      kBC5_UNORM,
+      kBC6H_UF16,
+      kBC7_UNORM,
+      kBC7_UNORM_SRGB,
     };
 
+    /**
+    * @brief Returns the size of a 4x4 block of a block compressed texture format
+    * @param[in] format (sulphur::engine::TextureFormat) The format of the texture
+    * @return (uint) The size of a block in bytes, 0 if the format isn't block compressed
+    */
+    inline uint GetBytesPerBlock(TextureFormat format)
+    {
+      switch (format)
+      {
+      case TextureFormat::kBC1_UNORM:
+      case TextureFormat::kBC1_UNORM_SRGB:
+      case TextureFormat::kBC4_UNORM:
+        return 8u;
+      case TextureFormat::kBC2_UNORM:
+      case TextureFormat::kBC2_UNORM_SRGB:
+      case TextureFormat::kBC3_UNORM:
+      case TextureFormat::kBC3_UNORM_SRGB:
+      case TextureFormat::kBC5_UNORM:
+      case TextureFormat::kBC6H_UF16:
+      case TextureFormat::kBC7_UNORM:
+      case TextureFormat::kBC7_UNORM_SRGB:
+        return 16u;
+      default:
+        return 0u;
+      }
+    }
+
     /**
     * @enum sulphur::engine::TextureType
     * @brief Describes the type of a texture
@@ -66,7 +104,8 @@ namespace sulphur
       /**
       * @brief Creates a texture from pixel data.
       * @param[in] pixel_data (const sulphur::foundation::Vector <byte>&) The pixel 
-      * data of the texture. Data should be in RGBA8 format.
+      * data of the texture. Data should be in the given format, block compressed 
+      * formats store rows of 4x4 blocks.
       * @param[in] width (uint) The width of the texture in pixels.
       * @param[in] height (uint) The height of the texture in pixels.
       * @param[in] format (TextureFormat) The format of the texture.
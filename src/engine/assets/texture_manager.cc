@@ -2,12 +2,58 @@
 #include "texture.h"
 
 #include <foundation/memory/memory.h>
+#include <foundation/logging/logger.h>
 #include <foundation/pipeline-assets/texture.h>
 
 namespace sulphur
 {
   namespace engine
   {
+    namespace
+    {
+      /**
+      * @brief Finds the format the renderer uploads packaged pixel data with
+      * @param[in] texture_data (const sulphur::foundation::TextureData&) The packaged texture
+      * @param[out] format (sulphur::engine::TextureFormat&) The format of the pixel data
+      * @return (bool) False if the renderer has no format for the pixel data
+      */
+      bool GetTextureFormat(const foundation::TextureData& texture_data, TextureFormat& format)
+      {
+        const bool srgb = texture_data.srgb;
+        switch (texture_data.compression)
+        {
+        case foundation::TextureCompressionType::kNone:
+          format = texture_data.format == foundation::TexelFormat::kHDR ?
+            TextureFormat::kR32G32B32A32_FLOAT : TextureFormat::kR8G8B8A8_UNORM;
+          return true;
+        case foundation::TextureCompressionType::kBC1:
+          format = srgb == true ? TextureFormat::kBC1_UNORM_SRGB : TextureFormat::kBC1_UNORM;
+          return true;
+        case foundation::TextureCompressionType::kBC2:
+          format = srgb == true ? TextureFormat::kBC2_UNORM_SRGB : TextureFormat::kBC2_UNORM;
+          return true;
+        case foundation::TextureCompressionType::kBC3:
+          format = srgb == true ? TextureFormat::kBC3_UNORM_SRGB : TextureFormat::kBC3_UNORM;
+          return true;
+        case foundation::TextureCompressionType::kBC4:
+          format = TextureFormat::kBC4_UNORM;
+          return true;
+        case foundation::TextureCompressionType::kBC5:
+          format = TextureFormat::kBC5_UNORM;
+          return true;
+        case foundation::TextureCompressionType::kBC6:
+          format = TextureFormat::kBC6H_UF16;
+          return true;
+        case foundation::TextureCompressionType::kBC7:
+          format = srgb == true ? TextureFormat::kBC7_UNORM_SRGB : TextureFormat::kBC7_UNORM;
+          return true;
+        default:
+          // RGBM needs decoding in the shaders, which none of them do
+          return false;
+        }
+      }
+    }
+
     //--------------------------------------------------------------------------------
     Texture* TextureManager::ImportAsset(const foundation::Path& asset_file)
     {
@@ -16,9 +62,27 @@ namespace sulphur
       if (reader.is_ok() == true)
       {
         foundation::TextureData texture_data = reader.Read<foundation::TextureData>();
+        if (texture_data.pixel_data.empty() == true)
+        {
+          return nullptr;
+        }
+
+        TextureFormat format;
+        if (GetTextureFormat(texture_data, format) == false)
+        {
+          PS_LOG(Error, "The renderer can't upload the compression type of the texture. Repackage it with another compression type. file: %s",
+            asset_file.GetString().c_str());
+          return nullptr;
+        }
+
+        // The renderer only uses the top level mip, block compressed or not
+        if (texture_data.mip_offsets.size() > 1)
+        {
+          texture_data.pixel_data.resize(texture_data.mip_offsets[1]);
+        }
 
         Texture* texture = foundation::Memory::Construct<Texture>(texture_data.pixel_data, 
-          texture_data.width, texture_data.height);
+          texture_data.width, texture_data.height, format);
         return texture;
       }
 
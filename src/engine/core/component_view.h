@@ -0,0 +1,219 @@
+#pragma once
+
+#include "engine/core/entity_system.h"
+#include "engine/core/world.h"
+
+#include <EASTL/tuple.h>
+
+#include <utility>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    /**
+    * @class sulphur::engine::ComponentView <Components...>
+    * @brief Iterates all entities that have every one of the listed components.
+    * @details The system with the fewest components drives the iteration, the components of
+    *   the other systems are found through the entity system. Each component is yielded as the
+    *   ViewElement of its system, which gives direct access to the system's dense storage.
+    * @remarks Every system of the listed components has to provide:
+    *   - ViewElement: the type yielded for a component
+    *   - void PrepareView(): brings the data that is yielded up-to-date, called when the view is constructed
+    *   - size_t ViewCount() const: the amount of components in the dense storage
+    *   - Entity ViewEntity(size_t index) const: the entity of the component at a dense index
+    *   - size_t ViewIndex(ComponentHandleBase handle) const: the dense index of a component
+    *   - ViewElement ViewAt(size_t index): the yielded element of the component at a dense index
+    * @remarks Components must not be created or destroyed while iterating, as that invalidates
+    *   the dense indices.
+    * @tparam[in] Components (typename...) The component handle types, e.g. sulphur::engine::TransformComponent
+    * @see sulphur::engine::World::View
+    */
+    template<typename... Components>
+    class ComponentView
+    {
+    public:
+      static constexpr size_t kComponentCount = sizeof...(Components); //!< The amount of component types in the view
+
+      /**
+      * @brief Constructs a view, prepares the systems for viewing and selects the smallest system as the driver
+      * @param[in] world (sulphur::engine::World&) The world to iterate the components of
+      */
+      ComponentView(World& world);
+
+      /**
+      * @brief The amount of components in the driving system
+      * @remarks This is an upper bound of the amount of entities the view yields. Ranges passed
+      *   to sulphur::engine::ComponentView::ForEach are in [0, size()).
+      * @return (size_t) The amount of components that are iterated
+      */
+      size_t size() const;
+
+      /**
+      * @brief Calls a function for every entity that has all the components
+      * @param[in] func (Func&&) Function taking an entity and the view element of every
+      *   component, in the order of the template parameters
+      */
+      template<typename Func>
+      void ForEach(Func&& func);
+
+      /**
+      * @brief Calls a function for every entity that has all the components within a chunk of
+      *   the driving system
+      * @details Chunks that don't overlap can be processed independently, for example by
+      *   splitting [0, size()) across jobs.
+      * @param[in] begin (size_t) The first dense index of the driving system to visit
+      * @param[in] end (size_t) One past the last dense index of the driving system to visit
+      * @param[in] func (Func&&) Function taking an entity and the view element of every
+      *   component, in the order of the template parameters
+      */
+      template<typename Func>
+      void ForEach(size_t begin, size_t end, Func&& func);
+
+    private:
+      /**
+      * @brief Visits a chunk of the driving system
+      * @param[in] begin (size_t) The first dense index to visit
+      * @param[in] end (size_t) One past the last dense index to visit
+      * @param[in] func (Func&) The function to call for matching entities
+      */
+      template<typename Func, size_t... I>
+      void ForEachImpl(size_t begin, size_t end, Func& func, std::index_sequence<I...>);
+
+      /**
+      * @brief Gets the entity of a component of the driving system
+      * @param[in] index (size_t) The dense index in the driving system
+      * @return (sulphur::engine::Entity) The entity
+      */
+      template<size_t... I>
+      Entity DriverEntity(size_t index, std::index_sequence<I...>) const;
+
+      /**
+      * @brief Finds the dense index of one of the components of an entity
+      * @param[in] entity (sulphur::engine::Entity) The entity to look-up
+      * @param[in] driver_index (size_t) The dense index in the driving system
+      * @param[out] index (size_t&) The dense index in the system of component I
+      * @return (bool) Does the entity have the component?
+      */
+      template<size_t I>
+      bool FindIndex(Entity entity, size_t driver_index, size_t& index) const;
+
+      EntitySystem* entity_system_; //!< The entity system used to find the components of an entity
+      eastl::tuple<typename Components::System*...> systems_; //!< The systems of the components
+      size_t types_[kComponentCount]; //!< The type-ids of the systems
+      size_t driver_; //!< The index of the driving system in the template parameters
+      size_t count_; //!< The amount of components in the driving system
+    };
+
+    //-------------------------------------------------------------------------
+    template<typename... Components>
+    inline ComponentView<Components...>::ComponentView(World& world) :
+      entity_system_(&world.GetOwner<EntitySystem>()),
+      systems_(&world.GetComponent<typename Components::System>()...),
+      types_{ foundation::type_id<typename Components::System>()... },
+      driver_(0),
+      count_(PS_SIZE_MAX)
+    {
+      const bool prepared[kComponentCount] = { (world.GetComponent<typename Components::System>().PrepareView(), true)... };
+      (void)prepared;
+
+      const size_t counts[kComponentCount] = { world.GetComponent<typename Components::System>().ViewCount()... };
+      for (size_t i = 0; i < kComponentCount; ++i)
+      {
+        if (counts[i] < count_)
+        {
+          driver_ = i;
+          count_ = counts[i];
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename... Components>
+    inline size_t ComponentView<Components...>::size() const
+    {
+      return count_;
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename... Components>
+    template<typename Func>
+    inline void ComponentView<Components...>::ForEach(Func&& func)
+    {
+      ForEachImpl(0, count_, func, std::index_sequence_for<Components...>());
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename... Components>
+    template<typename Func>
+    inline void ComponentView<Components...>::ForEach(size_t begin, size_t end, Func&& func)
+    {
+      ForEachImpl(begin, end < count_ ? end : count_, func, std::index_sequence_for<Components...>());
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename... Components>
+    template<typename Func, size_t... I>
+    inline void ComponentView<Components...>::ForEachImpl(
+      size_t begin, size_t end, Func& func, std::index_sequence<I...> sequence)
+    {
+      size_t indices[kComponentCount];
+      for (size_t i = begin; i < end; ++i)
+      {
+        const Entity entity = DriverEntity(i, sequence);
+
+        // The elements of a braced list are evaluated in order, so the look-ups stop at the first missing component
+        bool found = true;
+        const bool results[] = { (found = found && FindIndex<I>(entity, i, indices[I]))... };
+        static_cast<void>(results);
+        if (found == false)
+        {
+          continue;
+        }
+
+        func(entity, eastl::get<I>(systems_)->ViewAt(indices[I])...);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename... Components>
+    template<size_t... I>
+    inline Entity ComponentView<Components...>::DriverEntity(
+      size_t index, std::index_sequence<I...>) const
+    {
+      Entity entity;
+      const bool results[] = { (driver_ == I ? (entity = eastl::get<I>(systems_)->ViewEntity(index), true) : false)... };
+      static_cast<void>(results);
+      return entity;
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename... Components>
+    template<size_t I>
+    inline bool ComponentView<Components...>::FindIndex(
+      Entity entity, size_t driver_index, size_t& index) const
+    {
+      if (driver_ == I)
+      {
+        index = driver_index;
+        return true;
+      }
+
+      const ComponentHandleBase handle = entity_system_->GetHandle(entity, types_[I]);
+      if (handle.IsValid() == false)
+      {
+        return false;
+      }
+
+      index = eastl::get<I>(systems_)->ViewIndex(handle);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename... Components>
+    inline ComponentView<Components...> World::View()
+    {
+      return ComponentView<Components...>(*this);
+    }
+  }
+}
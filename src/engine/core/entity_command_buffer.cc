@@ -0,0 +1,89 @@
+#include "entity_command_buffer.h"
+
+namespace sulphur
+{
+  namespace engine
+  {
+    //-------------------------------------------------------------------------
+    EntityCommandBuffer::Target::Target(Entity entity) :
+      entity_(entity),
+      deferred_{ 0, 0 },
+      is_deferred_(false)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    EntityCommandBuffer::Target::Target(DeferredEntity entity) :
+      deferred_(entity),
+      is_deferred_(true)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    EntityCommandBuffer::EntityCommandBuffer(EntitySystem& owner, uint32_t index, uint32_t key) :
+      owner_(&owner),
+      index_(index),
+      key_(key),
+      sort_key_(0),
+      placeholder_count_(0)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    void EntityCommandBuffer::set_sort_key(uint32_t sort_key)
+    {
+      sort_key_ = sort_key;
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t EntityCommandBuffer::sort_key() const
+    {
+      return sort_key_;
+    }
+
+    //-------------------------------------------------------------------------
+    DeferredEntity EntityCommandBuffer::Create()
+    {
+      DeferredEntity entity{ index_, placeholder_count_++ };
+      Record(CommandType::kCreate, entity, nullptr);
+      return entity;
+    }
+
+    //-------------------------------------------------------------------------
+    void EntityCommandBuffer::Destroy(Target target)
+    {
+      Record(CommandType::kDestroy, target, nullptr);
+    }
+
+    //-------------------------------------------------------------------------
+    size_t EntityCommandBuffer::size() const
+    {
+      return commands_.size();
+    }
+
+    //-------------------------------------------------------------------------
+    uint32_t EntityCommandBuffer::key() const
+    {
+      return key_;
+    }
+
+    //-------------------------------------------------------------------------
+    EntitySystem& EntityCommandBuffer::owner() const
+    {
+      return *owner_;
+    }
+
+    //-------------------------------------------------------------------------
+    void EntityCommandBuffer::Record(
+      CommandType type, Target target, eastl::function<void(Entity&)>&& apply)
+    {
+      commands_.push_back(Command{
+        type,
+        sort_key_,
+        key_,
+        static_cast<uint32_t>(commands_.size()),
+        target,
+        eastl::move(apply) });
+    }
+  }
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "engine/core/entity_system.h"
+
+#include <foundation/containers/vector.h>
+
+#include <EASTL/functional.h>
+
+#include <cinttypes>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    /**
+    * @struct sulphur::engine::DeferredEntity
+    * @brief Placeholder for an entity that is created when the command buffer that recorded it is played back
+    * @remarks Only valid until the next playback of the entity system's command buffers
+    */
+    struct DeferredEntity
+    {
+      uint32_t buffer; //!< The index of the command buffer that recorded the creation
+      uint32_t index; //!< The index of the placeholder within that buffer
+    };
+
+    /**
+    * @class sulphur::engine::EntityCommandBuffer
+    * @brief Records structural changes to entities so they can be applied at a sync point instead of immediately.
+    * @details Every system or job records into its own buffer, obtained through sulphur::engine::EntitySystem::Commands
+    *   with a key that is the same every run, so recording doesn't need any locking. The entity system plays the
+    *   buffers back in the "end_frame" group, before marked entities are destroyed.
+    * @remarks Commands are played back ordered by sort key, then by the key of their buffer and then by the order
+    *   they were recorded in, so the playback doesn't depend on which thread recorded first. Only one thread may
+    *   record into a buffer at a time; jobs that are split over threads should use a key per chunk of work.
+    *   All creations are played back before the other commands, so placeholders can be used with any sort key.
+    */
+    class EntityCommandBuffer
+    {
+    public:
+      /**
+      * @class sulphur::engine::EntityCommandBuffer::Target
+      * @brief An existing entity or a placeholder that a command applies to
+      */
+      class Target
+      {
+      public:
+        /**
+        * @brief Targets an existing entity
+        * @param[in] entity (sulphur::engine::Entity) The entity
+        */
+        Target(Entity entity);
+        /**
+        * @brief Targets an entity that is created by a command buffer
+        * @param[in] entity (sulphur::engine::DeferredEntity) The placeholder
+        */
+        Target(DeferredEntity entity);
+
+      private:
+        friend EntityCommandBuffer;
+        friend EntitySystem;
+
+        Entity entity_; //!< The existing entity, if this isn't a placeholder
+        DeferredEntity deferred_; //!< The placeholder, if this is one
+        bool is_deferred_; //!< Is this target a placeholder?
+      };
+
+      /**
+      * @brief Constructor
+      * @param[in] owner (sulphur::engine::EntitySystem&) The entity system that plays back this buffer
+      * @param[in] index (uint32_t) The index of this buffer in the entity system
+      * @param[in] key (uint32_t) The key of the system or job that records into this buffer
+      */
+      EntityCommandBuffer(EntitySystem& owner, uint32_t index, uint32_t key);
+
+      /**
+      * @brief Sets the sort key of the commands that are recorded next
+      * @param[in] sort_key (uint32_t) The sort key, commands with lower keys are played back first
+      */
+      void set_sort_key(uint32_t sort_key);
+      /**
+      * @return (uint32_t) The sort key of the commands that are recorded next
+      */
+      uint32_t sort_key() const;
+
+      /**
+      * @brief Records the creation of an entity
+      * @return (sulphur::engine::DeferredEntity) A placeholder that can be used in commands until the playback
+      */
+      DeferredEntity Create();
+      /**
+      * @brief Records the destruction of an entity
+      * @param[in] target (sulphur::engine::EntityCommandBuffer::Target) The entity to destroy
+      */
+      void Destroy(Target target);
+      /**
+      * @brief Records adding a component to an entity
+      * @tparam Component (typename) The component to add
+      * @param[in] target (sulphur::engine::EntityCommandBuffer::Target) The entity to add the component to
+      */
+      template<typename Component>
+      void Add(Target target);
+      /**
+      * @brief Records adding a component to an entity and initializing it
+      * @tparam Component (typename) The component to add
+      * @tparam Init (typename) Function taking the added component
+      * @param[in] target (sulphur::engine::EntityCommandBuffer::Target) The entity to add the component to
+      * @param[in] init (Init&&) Called with the component right after it was added
+      */
+      template<typename Component, typename Init>
+      void Add(Target target, Init&& init);
+      /**
+      * @brief Records removing a component from an entity
+      * @tparam Component (typename) The component to remove
+      * @param[in] target (sulphur::engine::EntityCommandBuffer::Target) The entity to remove the component from
+      */
+      template<typename Component>
+      void Remove(Target target);
+      /**
+      * @brief Records a modification of an entity
+      * @tparam Function (typename) Function taking the entity, called during the playback if the entity is still alive
+      * @param[in] target (sulphur::engine::EntityCommandBuffer::Target) The entity to modify
+      * @param[in] function (Function&&) The modification
+      */
+      template<typename Function>
+      void Modify(Target target, Function&& function);
+
+      /**
+      * @return (size_t) The number of recorded commands that haven't been played back yet
+      */
+      size_t size() const;
+      /**
+      * @return (uint32_t) The key of the system or job that records into this buffer
+      */
+      uint32_t key() const;
+      /**
+      * @return (sulphur::engine::EntitySystem&) The entity system that plays back this buffer
+      */
+      EntitySystem& owner() const;
+
+    private:
+      friend EntitySystem;
+
+      /**
+      * @brief The kinds of commands that can be recorded
+      */
+      enum struct CommandType : uint8_t
+      {
+        kCreate,
+        kDestroy,
+        kModify
+      };
+
+      /**
+      * @struct sulphur::engine::EntityCommandBuffer::Command
+      * @brief A recorded command
+      */
+      struct Command
+      {
+        CommandType type; //!< What the command does
+        uint32_t sort_key; //!< The sort key at the time of recording
+        uint32_t key; //!< The key of the buffer that recorded the command
+        uint32_t sequence; //!< The order within the buffer
+        Target target; //!< The entity the command applies to, unused for creations
+        eastl::function<void(Entity&)> apply; //!< Applies a modification to the entity
+      };
+
+      /**
+      * @brief Records a command
+      * @param[in] type (sulphur::engine::EntityCommandBuffer::CommandType) The kind of command
+      * @param[in] target (sulphur::engine::EntityCommandBuffer::Target) The entity the command applies to
+      * @param[in] apply (eastl::function <void(sulphur::engine::Entity&)>&&) Applies a modification to the entity
+      */
+      void Record(CommandType type, Target target, eastl::function<void(Entity&)>&& apply);
+
+      EntitySystem* owner_; //!< The entity system that plays back this buffer
+      uint32_t index_; //!< The index of this buffer in the entity system
+      uint32_t key_; //!< The key of the system or job that records into this buffer
+      uint32_t sort_key_; //!< The sort key of the commands that are recorded next
+      uint32_t placeholder_count_; //!< The number of placeholders created since the last playback
+      foundation::Vector<Command> commands_; //!< The recorded commands
+    };
+
+    //-------------------------------------------------------------------------
+    template<typename Component>
+    inline void EntityCommandBuffer::Add(Target target)
+    {
+      Modify(target, [](Entity& entity)
+      {
+        entity.Add<Component>();
+      });
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename Component, typename Init>
+    inline void EntityCommandBuffer::Add(Target target, Init&& init)
+    {
+      Modify(target, [init](Entity& entity)
+      {
+        init(entity.Add<Component>());
+      });
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename Component>
+    inline void EntityCommandBuffer::Remove(Target target)
+    {
+      Modify(target, [](Entity& entity)
+      {
+        if (entity.Has<Component>() == true)
+        {
+          entity.Remove(entity.Get<Component>());
+        }
+      });
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename Function>
+    inline void EntityCommandBuffer::Modify(Target target, Function&& function)
+    {
+      Record(CommandType::kModify, target, eastl::function<void(Entity&)>(eastl::forward<Function>(function)));
+    }
+  }
+}
@@ -1,13 +1,158 @@
 #include "entity_component.h"
 
+#include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
+
 namespace sulphur
 {
   namespace engine
   {
 	//-------------------------------------------------------------------------
     EntityComponentData::EntityComponentData(bool with_editor) :
+      component_mask(0),
       with_editor(with_editor)
     {
     }
+
+    //-------------------------------------------------------------------------
+    void ComponentLinks::Resize(size_t entity_count)
+    {
+      if (first_.size() < entity_count)
+      {
+        first_.resize(entity_count, ComponentHandleBase::InvalidHandle());
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ComponentLinks::Add(size_t entity, ComponentHandleBase handle)
+    {
+      Resize(entity + 1);
+      if (first_[entity].IsValid() == false)
+      {
+        first_[entity] = handle;
+        return;
+      }
+      overflow_[entity].push_back(handle);
+    }
+
+    //-------------------------------------------------------------------------
+    bool ComponentLinks::Remove(size_t entity, ComponentHandleBase handle)
+    {
+      if (entity >= first_.size() || first_[entity].IsValid() == false)
+      {
+        return false;
+      }
+
+      auto overflow = overflow_.find(entity);
+      if (first_[entity] == handle)
+      {
+        if (overflow == overflow_.end())
+        {
+          first_[entity] = ComponentHandleBase::InvalidHandle();
+          return true;
+        }
+
+        first_[entity] = overflow->second.front();
+        overflow->second.erase(overflow->second.begin());
+      }
+      else
+      {
+        if (overflow == overflow_.end())
+        {
+          return false;
+        }
+
+        foundation::Vector<ComponentHandleBase>& handles = overflow->second;
+        auto it = eastl::find(handles.begin(), handles.end(), handle);
+        if (it == handles.end())
+        {
+          return false;
+        }
+        handles.erase(it);
+      }
+
+      if (overflow->second.empty() == true)
+      {
+        overflow_.erase(overflow);
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void ComponentLinks::Clear(size_t entity, foundation::Vector<ComponentHandleBase>& handles)
+    {
+      if (entity >= first_.size() || first_[entity].IsValid() == false)
+      {
+        return;
+      }
+
+      handles.push_back(first_[entity]);
+      first_[entity] = ComponentHandleBase::InvalidHandle();
+
+      auto overflow = overflow_.find(entity);
+      if (overflow != overflow_.end())
+      {
+        handles.insert(handles.end(), overflow->second.begin(), overflow->second.end());
+        overflow_.erase(overflow);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    size_t ComponentLinks::Count(size_t entity) const
+    {
+      if (entity >= first_.size() || first_[entity].IsValid() == false)
+      {
+        return 0;
+      }
+
+      auto overflow = overflow_.find(entity);
+      return overflow == overflow_.end() ? 1 : 1 + overflow->second.size();
+    }
+
+    //-------------------------------------------------------------------------
+    size_t ComponentLinks::overflow_count() const
+    {
+      size_t count = 0;
+      for (const auto& overflow : overflow_)
+      {
+        count += overflow.second.size();
+      }
+      return count;
+    }
+
+    //-------------------------------------------------------------------------
+    void ComponentLinks::StoreOverflow(ComponentLink* links) const
+    {
+      // The hash map isn't ordered, the same links have to be stored the same way every frame
+      foundation::Vector<size_t> entities;
+      entities.reserve(overflow_.size());
+      for (const auto& overflow : overflow_)
+      {
+        entities.push_back(overflow.first);
+      }
+      eastl::sort(entities.begin(), entities.end());
+
+      for (size_t entity : entities)
+      {
+        for (ComponentHandleBase handle : overflow_.find(entity)->second)
+        {
+          *links++ = ComponentLink{ entity, handle };
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ComponentLinks::RestoreOverflow(const ComponentLink* links, size_t count)
+    {
+      overflow_.clear();
+      for (size_t i = 0; i < count; ++i)
+      {
+        const ComponentLink& link = links[i];
+        if (link.entity < first_.size() && first_[link.entity].IsValid() == true)
+        {
+          overflow_[link.entity].push_back(link.handle);
+        }
+      }
+    }
   }
-}
\ No newline at end of file
+}
@@ -3,6 +3,9 @@
 #include "handle_base.h"
 
 #include <foundation/containers/vector.h>
+#include <foundation/containers/hash_map.h>
+
+#include <cinttypes>
 
 namespace sulphur
 {
@@ -10,8 +13,8 @@ namespace sulphur
   {
     /**
     * @class sulphur::engine::EntityComponentData
-    * @brief Storage for the component and its type info
-    * @todo Store component types as uint8?
+    * @brief Per-entity storage of which types of components are linked to the entity
+    * @remarks The handles themselves are stored per component type by the sulphur::engine::EntitySystem
     * @todo Move this somewhere else and move some of the functionality that currently is in the entity manager into here.
     * @author Raymi Klingers
     */
@@ -24,9 +27,102 @@ namespace sulphur
       */
       EntityComponentData(bool with_editor = false);
 
-      foundation::Vector<size_t> component_types;//!< Stores the types of the components
-      foundation::Vector<ComponentHandleBase> component_handles;//!< Stores the handles of the components
+      uint64_t component_mask;//!< Has a bit set for every component slot that is linked to the entity @see sulphur::engine::EntitySystem::ComponentType
       bool with_editor; //!< Indicates that the editor instantiated this entity, rather than the game
     };
+
+    /**
+    * @struct sulphur::engine::ComponentLink
+    * @brief A component that is linked to an entity after the first component of the same type, as it is stored
+    */
+    struct ComponentLink
+    {
+      size_t entity; //!< The index of the entity
+      ComponentHandleBase handle; //!< The linked component
+    };
+
+    /**
+    * @class sulphur::engine::ComponentLinks
+    * @brief The handles of the components of one type that are linked to entities, indexed by entity index
+    * @remarks Most entities have at most one component of a type, so the first one is stored in a plain array.
+    *          Any further components of the same type, like the colliders of a compound body, go in an overflow list per entity.
+    */
+    class ComponentLinks
+    {
+    public:
+      /**
+      * @brief Makes room for the components of a number of entities
+      * @param[in] entity_count (size_t) The amount of entities that can be linked
+      */
+      void Resize(size_t entity_count);
+      /**
+      * @brief Links a component to an entity, after the components of the same type that it already has
+      * @param[in] entity (size_t) The index of the entity
+      * @param[in] handle (sulphur::engine::ComponentHandleBase) The component to link
+      */
+      void Add(size_t entity, ComponentHandleBase handle);
+      /**
+      * @brief Removes the link between an entity and one of its components
+      * @param[in] entity (size_t) The index of the entity
+      * @param[in] handle (sulphur::engine::ComponentHandleBase) The component to unlink
+      * @return (bool) Was the component linked to the entity?
+      * @remarks The next component of the entity takes the place of a removed first component.
+      */
+      bool Remove(size_t entity, ComponentHandleBase handle);
+      /**
+      * @brief Removes all links of an entity
+      * @param[in] entity (size_t) The index of the entity
+      * @param[out] handles (sulphur::foundation::Vector <sulphur::engine::ComponentHandleBase>&) The components that were linked, appended in link order
+      */
+      void Clear(size_t entity, foundation::Vector<ComponentHandleBase>& handles);
+      /**
+      * @brief Gets the first component that was linked to an entity
+      * @param[in] entity (size_t) The index of the entity
+      * @return (sulphur::engine::ComponentHandleBase) The component or an invalid handle if the entity has none
+      */
+      ComponentHandleBase First(size_t entity) const;
+      /**
+      * @brief Gets the amount of components that are linked to an entity
+      * @param[in] entity (size_t) The index of the entity
+      * @return (size_t) The amount of components
+      */
+      size_t Count(size_t entity) const;
+      /**
+      * @return (const sulphur::foundation::Vector <sulphur::engine::ComponentHandleBase>&) The first component of every entity
+      */
+      const foundation::Vector<ComponentHandleBase>& first() const;
+      /**
+      * @return (size_t) The amount of components that are linked after the first component of their entity
+      */
+      size_t overflow_count() const;
+      /**
+      * @brief Copies the components that are linked after the first component of their entity
+      * @param[out] links (sulphur::engine::ComponentLink*) Room for overflow_count() links, filled ordered by entity and then in link order
+      */
+      void StoreOverflow(ComponentLink* links) const;
+      /**
+      * @brief Replaces the components that are linked after the first component of their entity
+      * @param[in] links (const sulphur::engine::ComponentLink*) The links as they were stored by StoreOverflow
+      * @param[in] count (size_t) The amount of links
+      * @remarks The first components have to be restored separately, an entity without a first component doesn't get any links.
+      */
+      void RestoreOverflow(const ComponentLink* links, size_t count);
+
+    private:
+      foundation::Vector<ComponentHandleBase> first_; //!< The first component of every entity, invalid if the entity has none
+      foundation::HashMap<size_t, foundation::Vector<ComponentHandleBase>> overflow_; //!< The components after the first one, keyed by entity index
+    };
+
+    //-------------------------------------------------------------------------
+    inline ComponentHandleBase ComponentLinks::First(size_t entity) const
+    {
+      return entity < first_.size() ? first_[entity] : ComponentHandleBase::InvalidHandle();
+    }
+
+    //-------------------------------------------------------------------------
+    inline const foundation::Vector<ComponentHandleBase>& ComponentLinks::first() const
+    {
+      return first_;
+    }
   }
-}
\ No newline at end of file
+}
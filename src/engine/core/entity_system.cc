@@ -7,16 +7,25 @@
 #include "engine/scripting/script_system.h"
 #include "engine/rewinder/rewind_system.h"
 #include "engine/rewinder/systems/entity_storage.h"
+#include "engine/core/entity_command_buffer.h"
+#include "engine/core/prefab.h"
 
 #include <foundation/job/job_graph.h>
 #include <foundation/job/data_policy.h>
+#include <foundation/memory/memory.h>
 #include <lua-classes/entity_system.lua.cc>
 
+#include <EASTL/sort.h>
+
 namespace sulphur
 {
   namespace engine
   {
     Application* Entity::application_ = nullptr;
+    World* Entity::world_ = nullptr;
+    EntitySystem* Entity::system_ = nullptr;
+    std::atomic<uint64_t> EntitySystem::next_commands_generation_(1);
+    thread_local EntitySystem::ThreadCommands EntitySystem::thread_commands_;
 
     //-------------------------------------------------------------------------
     void Entity::InjectDependencies(Application& application)
@@ -34,8 +43,8 @@ namespace sulphur
       * is argueably slower anyway..
       * Because the handle is copied, when converting from derived -> base, all data is lost
       */
-      World& world = application_->GetService<WorldProviderSystem>().GetWorld();
-      EntitySystem& system = world.GetOwner<EntitySystem>();
+      World& world = *world_;
+      EntitySystem& system = *system_;
 
       size_t sid = static_cast<size_t>(id);
       ScriptSystem& ss = application_->GetService<ScriptSystem>();
@@ -62,8 +71,8 @@ namespace sulphur
     //-------------------------------------------------------------------------
     void Entity::RemoveComponent(int id)
     {
-      World& world = application_->GetService<WorldProviderSystem>().GetWorld();
-      EntitySystem& system = world.GetOwner<EntitySystem>();
+      World& world = *world_;
+      EntitySystem& system = *system_;
 
       size_t sid = static_cast<size_t>(id);
       ScriptSystem& ss = application_->GetService<ScriptSystem>();
@@ -84,8 +93,8 @@ namespace sulphur
     //-------------------------------------------------------------------------
     ScriptHandle Entity::GetComponent(int id)
     {
-      World& world = application_->GetService<WorldProviderSystem>().GetWorld();
-      EntitySystem& system = world.GetOwner<EntitySystem>();
+      World& world = *world_;
+      EntitySystem& system = *system_;
 
       size_t sid = static_cast<size_t>(id);
       ScriptSystem& ss = application_->GetService<ScriptSystem>();
@@ -105,7 +114,8 @@ namespace sulphur
 
     //-------------------------------------------------------------------------
     EntitySystem::EntitySystem() :
-      IOwnerSystem("EntitySystem")
+      IOwnerSystem("EntitySystem"),
+      commands_generation_(next_commands_generation_++)
     {
     }
 
@@ -117,6 +127,8 @@ namespace sulphur
       Entity::InjectDependencies(app);
 
       world_ = &app.GetService<WorldProviderSystem>().GetWorld();
+      Entity::world_ = world_;
+      Entity::system_ = this;
 #ifdef PS_EDITOR
       storage_ = foundation::Memory::Construct<EntityRewindStorage>(*this);
       app.GetService<RewindSystem>().Register(storage_->storage_);
@@ -126,17 +138,41 @@ namespace sulphur
       {
         entity_system.DestroyMarkedForDestruction();
       };
+      auto playback_commands = []( EntitySystem& entity_system )
+      {
+        entity_system.PlaybackCommands();
+      };
+      foundation::Job playback = foundation::make_job( "entitysystem_playback_commands", "end_frame",
+        playback_commands, bind_write( *this ) );
+      job_graph.Add( std::move( playback ) );
+
       foundation::Job destroy = foundation::make_job( "destroy", "end_frame",
         destroy_marked_for_destroy, bind_write( *this ) );
+      destroy.set_blocker( "entitysystem_playback_commands" );
       job_graph.Add( std::move( destroy ) );
     }
 
     //-------------------------------------------------------------------------
     void EntitySystem::OnTerminate()
     {
+      if (Entity::system_ == this)
+      {
+        Entity::world_ = nullptr;
+        Entity::system_ = nullptr;
+      }
+
 #ifdef PS_EDITOR
       foundation::Memory::Destruct<EntityRewindStorage>(storage_);
+      storage_ = nullptr;
 #endif
+
+      // Threads can still point to the freed buffers, a new generation makes them look the buffers up again
+      commands_generation_ = next_commands_generation_++;
+      for (EntityCommandBuffer* buffer : command_buffers_)
+      {
+        foundation::Memory::Destruct(buffer);
+      }
+      command_buffers_.clear();
     }
 
     //-------------------------------------------------------------------------
@@ -157,6 +193,7 @@ namespace sulphur
 
         PS_LOG_IF(idx.handle >= (1ull << Entity::kIndexBits), Fatal, "Entity limit exceeded");
       }
+      MarkChanged();
       idx.handle |= static_cast<size_t>(generation_[idx.handle]) << Entity::kIndexBits;
       return idx;
     }
@@ -167,6 +204,76 @@ namespace sulphur
       return Create(false);
     }
 
+    //-------------------------------------------------------------------------
+    void EntitySystem::Reserve(size_t count)
+    {
+      generation_.reserve(generation_.size() + count);
+      entity_components_.reserve(entity_components_.size() + count);
+    }
+
+    //-------------------------------------------------------------------------
+    foundation::Vector<Entity> EntitySystem::Instantiate(
+      const Prefab& prefab, size_t count, const glm::mat4* transforms)
+    {
+      foundation::Vector<Entity> roots;
+      const size_t node_count = prefab.node_count();
+      if (node_count == 0 || count == 0)
+      {
+        return roots;
+      }
+
+      const size_t total = node_count * count;
+      Reserve(total);
+
+      foundation::Vector<Entity> entities;
+      entities.reserve(total);
+      for (size_t i = 0; i < total; ++i)
+      {
+        entities.push_back(Create(false));
+      }
+
+      // The hierarchies are appended as a whole instead of re-parenting every node
+      const size_t transform_type = foundation::type_id<TransformSystem>();
+      TransformSystem& transform_system = static_cast<TransformSystem&>(*GetComponentType(transform_type).system);
+      foundation::Vector<TransformComponent> nodes(total);
+      transform_system.CreateHierarchies(
+        prefab.nodes().data(), node_count, entities.data(), count, transforms, nodes.data());
+
+      foundation::Vector<ComponentHandleBase> handles(nodes.begin(), nodes.end());
+      Link(entities.data(), handles.data(), total, transform_type);
+
+      for (const Prefab::ComponentBatch& batch : prefab.batches_)
+      {
+        IComponentSystem& system = *GetComponentType(batch.type).system;
+        system.Reserve(batch.nodes.size() * count);
+
+        const size_t slot = PrepareSlot(batch.type);
+        const uint64_t bit = 1ull << slot;
+        for (size_t instance = 0; instance < count; ++instance)
+        {
+          Entity* instance_entities = entities.data() + instance * node_count;
+          for (size_t i = 0; i < batch.nodes.size(); ++i)
+          {
+            Entity& entity = instance_entities[batch.nodes[i]];
+            const ComponentHandleBase handle = batch.create[i](system, entity);
+
+            const size_t index = entity.GetIndex();
+            component_handles_[slot].Add(index, handle);
+            entity_components_[index].component_mask |= bit;
+          }
+        }
+      }
+
+      MarkChanged();
+
+      roots.reserve(count);
+      for (size_t instance = 0; instance < count; ++instance)
+      {
+        roots.push_back(entities[instance * node_count]);
+      }
+      return roots;
+    }
+
     //-------------------------------------------------------------------------
     void EntitySystem::Destroy(Entity entity)
     {
@@ -182,49 +289,94 @@ namespace sulphur
     //-------------------------------------------------------------------------
     void EntitySystem::Link(Entity entity, ComponentHandleBase handle, size_t type)
     {
-      EntityComponentData& list = entity_components_[entity.GetIndex()];
-      list.component_handles.push_back(handle);
-      list.component_types.push_back(type);
+      ComponentType& component_type = GetComponentType(type);
+      if (component_type.slot == kInvalidSlot_)
+      {
+        AssignSlot(component_type, type);
+      }
+
+      const size_t index = entity.GetIndex();
+      ComponentLinks& handles = component_handles_[component_type.slot];
+      handles.Resize(generation_.size());
+      handles.Add(index, handle);
+      entity_components_[index].component_mask |= 1ull << component_type.slot;
+      MarkChanged();
+    }
+
+    //-------------------------------------------------------------------------
+    void EntitySystem::Link(
+      const Entity* entities, const ComponentHandleBase* handles, size_t count, size_t type)
+    {
+      const size_t slot = PrepareSlot(type);
+      const uint64_t bit = 1ull << slot;
+      ComponentLinks& slot_handles = component_handles_[slot];
+      for (size_t i = 0; i < count; ++i)
+      {
+        const size_t index = entities[i].GetIndex();
+        slot_handles.Add(index, handles[i]);
+        entity_components_[index].component_mask |= bit;
+      }
+      MarkChanged();
     }
 
     //-------------------------------------------------------------------------
     void EntitySystem::UnLink(Entity entity, ComponentHandleBase handle, size_t type)
     {
-      EntityComponentData& list = entity_components_[entity.GetIndex()];
-      for (int i_type = 0; i_type < list.component_types.size(); ++i_type)
+      if (GetHandle(entity, type).IsValid() == false)
       {
-        if (list.component_types[i_type] == type)
-        {
-          for (int i_handle = i_type; i_handle < list.component_handles.size(); ++i_handle)
-          {
-            if (list.component_handles[i_handle].handle == handle.handle && list.component_types[i_handle] == type)
-            {
-              world_->GetComponent(type).Destroy(handle);
-              // Swap with back and pop
-              list.component_handles[i_handle] = list.component_handles[list.component_handles.size() - 1];
-              list.component_types[i_type] = list.component_types[list.component_types.size() - 1];
-              list.component_handles.pop_back();
-              list.component_types.pop_back();
-              return;
-            }
-          }
-        }
+        return;
+      }
+
+      const size_t slot = component_types_[type].slot;
+      const size_t index = entity.GetIndex();
+      ComponentLinks& handles = component_handles_[slot];
+      if (handles.Remove(index, handle) == false)
+      {
+        return;
+      }
+
+      component_types_[type].system->Destroy(handle);
+      if (handles.Count(index) == 0)
+      {
+        entity_components_[index].component_mask &= ~(1ull << slot);
       }
+      MarkChanged();
     }
 
     //-------------------------------------------------------------------------
-    ComponentHandleBase EntitySystem::GetHandle(Entity entity, size_t type) const
+    void EntitySystem::RegisterComponentType(size_t type)
     {
-      const EntityComponentData& list = entity_components_[entity.GetIndex()];
-      for (int i_type = 0; i_type < list.component_types.size(); ++i_type)
+      if (type >= component_types_.size())
       {
-        if (list.component_types[i_type] == type)
-        {
-          return  list.component_handles[i_type];
-        }
+        component_types_.resize(type + 1);
+      }
+      component_types_[type].system = &world_->GetComponent(type);
+    }
+
+    //-------------------------------------------------------------------------
+    void EntitySystem::AssignSlot(ComponentType& type, size_t type_id)
+    {
+      PS_LOG_IF(slot_types_.size() >= kMaxComponentSlots_, Fatal,
+        "More component types are linked to entities than fit in the component mask");
+
+      type.slot = slot_types_.size();
+      slot_types_.push_back(type_id);
+    }
+
+    //-------------------------------------------------------------------------
+    size_t EntitySystem::PrepareSlot(size_t type)
+    {
+      ComponentType& component_type = GetComponentType(type);
+      if (component_type.slot == kInvalidSlot_)
+      {
+        AssignSlot(component_type, type);
       }
-      return ComponentHandleBase::InvalidHandle();
+
+      component_handles_[component_type.slot].Resize(generation_.size());
+      return component_type.slot;
     }
+
+    //-------------------------------------------------------------------------
     void EntitySystem::DestroyMarkedForDestruction()
     {
       for ( int i_index = static_cast<int>(to_destroy.size()) - 1; i_index >= 0; --i_index )
@@ -233,31 +385,157 @@ namespace sulphur
         to_destroy.pop_back();
       }
     }
+    //-------------------------------------------------------------------------
     void EntitySystem::DestroyImmediate( size_t index )
     {
       ++generation_[index];
       free_indices_.push_back( static_cast<uint>( index ) );
+      MarkChanged();
+
+      uint64_t& mask = entity_components_[index].component_mask;
+      for ( size_t slot = 0; mask != 0; ++slot )
+      {
+        const uint64_t bit = 1ull << slot;
+        if ( ( mask & bit ) == 0 )
+        {
+          continue;
+        }
+
+        ComponentType& type = component_types_[slot_types_[slot]];
+        foundation::Vector<ComponentHandleBase> handles;
+        component_handles_[slot].Clear( index, handles );
+        mask &= ~bit;
+
+        for ( ComponentHandleBase handle : handles )
+        {
+          if ( slot_types_[slot] == foundation::type_id<TransformSystem>() )
+          {
+            TransformSystem& transform_system = static_cast<TransformSystem&>( *type.system );
+
+            TransformComponent target( transform_system, handle.Handle() );
+            foundation::Vector<TransformComponent> children = target.GetChildren();
+            for ( size_t i_child = 0; i_child < children.size(); ++i_child )
+            {
+              DestroyImmediate( children[i_child].GetEntity().GetIndex() );
+            }
+          }
+          type.system->Destroy( handle );
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void EntitySystem::MarkChanged()
+    {
+      if ( storage_ != nullptr )
+      {
+        storage_->MarkChanged();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    EntityCommandBuffer& EntitySystem::Commands(uint32_t key)
+    {
+      if (thread_commands_.generation == commands_generation_ && thread_commands_.key == key)
+      {
+        return *thread_commands_.buffer;
+      }
 
-      EntityComponentData& list = entity_components_[index];
-      for ( size_t i = 0; i < list.component_types.size(); ++i )
+      std::lock_guard<std::mutex> lock(command_buffers_mutex_);
+      thread_commands_.generation = commands_generation_;
+      thread_commands_.key = key;
+      for (EntityCommandBuffer* buffer : command_buffers_)
       {
-        if ( list.component_types[i] == foundation::type_id<TransformSystem>() )
+        if (buffer->key() == key)
         {
-          TransformSystem& transform_system = reinterpret_cast<TransformSystem&>(
-            world_->GetComponent( list.component_types[i] ) );
+          thread_commands_.buffer = buffer;
+          return *buffer;
+        }
+      }
+
+      thread_commands_.buffer = foundation::Memory::Construct<EntityCommandBuffer>(
+        *this, static_cast<uint32_t>(command_buffers_.size()), key);
+      command_buffers_.push_back(thread_commands_.buffer);
+      return *thread_commands_.buffer;
+    }
 
-          TransformComponent target( transform_system, list.component_handles[i].Handle() );
-          foundation::Vector<TransformComponent> children = target.GetChildren();
-          for ( size_t i_child = 0; i_child < children.size(); ++i_child )
+    //-------------------------------------------------------------------------
+    void EntitySystem::PlaybackCommands()
+    {
+      using Command = EntityCommandBuffer::Command;
+      using CommandType = EntityCommandBuffer::CommandType;
+
+      // Take the commands out first, so commands recorded during playback are kept for the next one
+      foundation::Vector<Command> commands;
+      foundation::Vector<foundation::Vector<Entity>> created;
+      {
+        std::lock_guard<std::mutex> lock(command_buffers_mutex_);
+        created.resize(command_buffers_.size());
+        for (EntityCommandBuffer* buffer : command_buffers_)
+        {
+          created[buffer->index_].resize(buffer->placeholder_count_);
+          for (Command& command : buffer->commands_)
           {
-            DestroyImmediate( children[i_child].GetEntity().GetIndex() );
+            commands.push_back(eastl::move(command));
           }
+          buffer->commands_.clear();
+          buffer->placeholder_count_ = 0;
         }
-        world_->GetComponent( list.component_types[i] ).Destroy( list.component_handles[i] );
       }
 
-      list.component_handles.clear();
-      list.component_types.clear();
+      if (commands.empty() == true)
+      {
+        return;
+      }
+
+      // Create all entities first so placeholders can be used with any sort key. Ties are broken by the key of
+      // the buffer instead of its index, as the index depends on which thread asked for its buffer first
+      eastl::sort(commands.begin(), commands.end(), [](const Command& lhs, const Command& rhs)
+      {
+        const bool lhs_create = lhs.type == CommandType::kCreate;
+        const bool rhs_create = rhs.type == CommandType::kCreate;
+        if (lhs_create != rhs_create)
+        {
+          return lhs_create;
+        }
+        if (lhs.sort_key != rhs.sort_key)
+        {
+          return lhs.sort_key < rhs.sort_key;
+        }
+        if (lhs.key != rhs.key)
+        {
+          return lhs.key < rhs.key;
+        }
+        return lhs.sequence < rhs.sequence;
+      });
+
+      for (Command& command : commands)
+      {
+        const EntityCommandBuffer::Target& target = command.target;
+        if (command.type == CommandType::kCreate)
+        {
+          created[target.deferred_.buffer][target.deferred_.index] = Create();
+          continue;
+        }
+
+        Entity entity = target.is_deferred_ == true ?
+          created[target.deferred_.buffer][target.deferred_.index] :
+          target.entity_;
+
+        if (Alive(entity) == false)
+        {
+          continue;
+        }
+
+        if (command.type == CommandType::kDestroy)
+        {
+          Destroy(entity);
+        }
+        else
+        {
+          command.apply(entity);
+        }
+      }
     }
   }
-}
\ No newline at end of file
+}
@@ -8,6 +8,12 @@
 #include <foundation/utils/type_definitions.h>
 #include <foundation/containers/vector.h>
 #include <foundation/containers/deque.h>
+#include <foundation/containers/array.h>
+
+#include <glm/mat4x4.hpp>
+
+#include <mutex>
+#include <atomic>
 
 namespace sulphur
 {
@@ -15,6 +21,8 @@ namespace sulphur
   {
     class EntitySystem;
     class EntityRewindStorage;
+    class EntityCommandBuffer;
+    class Prefab;
 
     /**
     * @class sulphur::engine::Entity : sulphur::engine::ComponentHandleBase
@@ -92,7 +100,11 @@ namespace sulphur
       static void InjectDependencies(Application& application);
 
     private:
-      static Application* application_;
+      friend EntitySystem;
+
+      static Application* application_; //!< The application, used to access services
+      static World* world_; //!< The world of the active entity system, cached so lookups don't go through the world provider
+      static EntitySystem* system_; //!< The entity system of the active world
 
     };
 
@@ -107,7 +119,10 @@ namespace sulphur
     class EntitySystem : public IOwnerSystem<Entity>
     {
       static constexpr uint kMinimumFreeIndices_ = 1024u; //!< Number of free indices before we start to reuse entity slots
+      static constexpr size_t kMaxComponentSlots_ = 64u; //!< Number of component types that fit in the component mask
+      static constexpr size_t kInvalidSlot_ = PS_SIZE_MAX; //!< Slot of component types that were never linked
 
+      friend Entity;
       friend EntityRewindStorage;
     public:
       /**
@@ -131,6 +146,21 @@ namespace sulphur
       */
       Entity Create();
       /**
+      * @brief Makes room for a number of entities that are about to be created.
+      * @param[in] count (size_t) The amount of entities that will be created.
+      */
+      void Reserve(size_t count);
+      /**
+      * @brief Creates instances of a prefab at once.
+      * @param[in] prefab (const sulphur::engine::Prefab&) The prefab to instantiate.
+      * @param[in] count (size_t) The amount of instances.
+      * @param[in] transforms (const glm::mat4*) The world transformation of the root of every instance, the prefab's root transformation is used if nullptr.
+      * @return (sulphur::foundation::Vector <sulphur::engine::Entity>) The root entity of every instance.
+      * @remarks The storage of every involved system is reserved once, every hierarchy is appended to the transforms as a contiguous block and the components are created per type.
+      *          The transforms are created before the other components, so their systems can look them up.
+      */
+      foundation::Vector<Entity> Instantiate(const Prefab& prefab, size_t count, const glm::mat4* transforms = nullptr);
+      /**
       * @brief Adds the entity to the destruction list to be destroyed at the end of the frame.
       * @param[in] entity (sulphur::engine::Entity) The entity to destroy.
       */
@@ -147,10 +177,19 @@ namespace sulphur
       * @param[in] entity (sulphur::engine::Entity) The entity to store the link of.
       * @param[in] handle (sulphur::engine::ComponentHandleBase) The base handle without the type info.
       * @param[in] type (size_t) The type info of the handle.
+      * @remarks An entity can have several components of the same type, like the colliders of a compound body. GetHandle returns the first one.
       * @todo param type should probably be its own type. ComponentHandleType or something.
       */
       void Link(Entity entity, ComponentHandleBase handle, size_t type);
       /**
+      * @brief Stores the links between many entities and their newly created components of one type.
+      * @param[in] entities (const sulphur::engine::Entity*) The entities to store the links of.
+      * @param[in] handles (const sulphur::engine::ComponentHandleBase*) The component of every entity.
+      * @param[in] count (size_t) The amount of entities.
+      * @param[in] type (size_t) The type info of the handles.
+      */
+      void Link(const Entity* entities, const ComponentHandleBase* handles, size_t count, size_t type);
+      /**
       * @brief Removes the link between the entity and the component and destroying the component.
       * @param[in] entity (sulphur::engine::Entity) The entity to remove the link of.
       * @param[in] handle (sulphur::engine::ComponentHandleBase) The base handle without the type info.
@@ -172,7 +211,54 @@ namespace sulphur
       * @param[in] entity (size_t) The entity index to destroy.
       */
       void DestroyMarkedForDestruction();
+
+      /**
+      * @brief Gets the command buffer of a system or job, creating it on first use.
+      * @param[in] key (uint32_t) Identifies the system or job, and orders its commands against those of other buffers with the same sort key. Has to be the same every run for a deterministic playback.
+      * @return (sulphur::engine::EntityCommandBuffer&) The command buffer to record deferred structural changes in.
+      * @remarks Only one thread may record into the buffer of a key at a time.
+      * @see sulphur::engine::EntityCommandBuffer
+      */
+      EntityCommandBuffer& Commands(uint32_t key);
+      /**
+      * @brief Plays back the commands of all buffers in sort key order and clears the buffers.
+      * @remarks Runs in the "end_frame" group before marked entities are destroyed. No other thread may record commands while this runs.
+      */
+      void PlaybackCommands();
     private:
+      /**
+      * @struct sulphur::engine::EntitySystem::ComponentType
+      * @brief Lookup data of a component type, indexed by the type-id of its system
+      */
+      struct ComponentType
+      {
+        IComponentSystem* system = nullptr; //!< The component system, nullptr until the type is first used
+        size_t slot = kInvalidSlot_; //!< The bit in the component mask and the index in component_handles_
+      };
+
+      /**
+      * @brief Gets the lookup data of a component type, resolving its system on first use
+      * @param[in] type (size_t) The type-id of the component system
+      * @return (sulphur::engine::EntitySystem::ComponentType&) The lookup data
+      */
+      ComponentType& GetComponentType(size_t type);
+      /**
+      * @brief Resolves the system of a component type that wasn't used before
+      * @param[in] type (size_t) The type-id of the component system
+      */
+      void RegisterComponentType(size_t type);
+      /**
+      * @brief Assigns a bit in the component mask to a component type that is linked for the first time
+      * @param[in] type (sulphur::engine::EntitySystem::ComponentType&) The type to assign a slot to
+      * @param[in] type_id (size_t) The type-id of the component system
+      */
+      void AssignSlot(ComponentType& type, size_t type_id);
+      /**
+      * @brief Makes sure a component type has a slot with room to link a component to every entity
+      * @param[in] type (size_t) The type-id of the component system
+      * @return (size_t) The slot of the component type
+      */
+      size_t PrepareSlot(size_t type);
 
       /**
       * @brief Adds the entity to be destroyed immediately
@@ -180,6 +266,10 @@ namespace sulphur
       */
       void DestroyImmediate( size_t index );
       /**
+      * @brief Tells the rewinder that the entities or their links changed, so they are stored with the next frame
+      */
+      void MarkChanged();
+      /**
       * @brief Creates a new entity that is owned by the editor
       * @param[in] with_editor (bool) Setting this to true indicates the editor instantiated this
       *                               entity, rather than the local application
@@ -188,31 +278,76 @@ namespace sulphur
       Entity Create(bool with_editor);
 
       World* world_; //!< A pointer to the world that this system is a part of
-      EntityRewindStorage* storage_;//<! A class to glue the data systems of the rewinder together
+      EntityRewindStorage* storage_ = nullptr;//<! A class to glue the data systems of the rewinder together, only created in the editor
 
 
       foundation::Vector<byte> generation_;//!< Stores the current generation of the entity which is used in the Alive function @see sulphur::engine::EntitySystem::Alive.
       foundation::Deque<uint> free_indices_;//!< Stores free entity slots for reuse.
-      foundation::Vector<EntityComponentData> entity_components_;//!< Stores the linking information of the components.
+      foundation::Vector<EntityComponentData> entity_components_;//!< Stores which component types are linked to each entity.
+      foundation::Vector<ComponentType> component_types_;//!< Lookup data of the component types, indexed by type-id.
+      foundation::Vector<size_t> slot_types_;//!< The type-id of each assigned slot.
+      foundation::Array<ComponentLinks, kMaxComponentSlots_> component_handles_;//!< The linked component handles per slot, indexed by entity index.
       foundation::Vector<size_t> to_destroy;//!< Stores entity indices that need to be destroyed.
+
+      /**
+      * @struct sulphur::engine::EntitySystem::ThreadCommands
+      * @brief The command buffer a thread used last, with its key and the generation of the command buffers it belongs to
+      */
+      struct ThreadCommands
+      {
+        EntityCommandBuffer* buffer = nullptr; //!< The command buffer, only valid if the generation matches
+        uint64_t generation = 0; //!< The sulphur::engine::EntitySystem::commands_generation_ the buffer was created in
+        uint32_t key = 0; //!< The key of the command buffer
+      };
+
+      std::mutex command_buffers_mutex_;//!< Guards the creation of command buffers.
+      foundation::Vector<EntityCommandBuffer*> command_buffers_;//!< The command buffers of all keys that recorded commands.
+      uint64_t commands_generation_;//!< Unique across entity systems and renewed when the command buffers are freed, so stale thread buffers are never dereferenced.
+      static std::atomic<uint64_t> next_commands_generation_;//!< The next generation to hand out.
+      static thread_local ThreadCommands thread_commands_;//!< The command buffer the calling thread used last.
     };
 
+    //-------------------------------------------------------------------------
+    inline EntitySystem::ComponentType& EntitySystem::GetComponentType(size_t type)
+    {
+      if (type >= component_types_.size() || component_types_[type].system == nullptr)
+      {
+        RegisterComponentType(type);
+      }
+      return component_types_[type];
+    }
+
+    //-------------------------------------------------------------------------
+    inline ComponentHandleBase EntitySystem::GetHandle(Entity entity, size_t type) const
+    {
+      if (type >= component_types_.size())
+      {
+        return ComponentHandleBase::InvalidHandle();
+      }
+
+      const size_t slot = component_types_[type].slot;
+      const size_t index = entity.GetIndex();
+      if (slot == kInvalidSlot_ || (entity_components_[index].component_mask & (1ull << slot)) == 0)
+      {
+        return ComponentHandleBase::InvalidHandle();
+      }
+      return component_handles_[slot].First(index);
+    }
+
     //-------------------------------------------------------------------------
     template<typename Component>
     inline Component Entity::Add()
     {
-      World& world = application_->GetService<WorldProviderSystem>().GetWorld();
-      EntitySystem& system = world.GetOwner<EntitySystem>();
+      using System = typename Component::System;
+      const size_t type = foundation::type_id<System>();
 
-      Component component = (static_cast<typename Component::System&>(
-        world.GetComponent(foundation::type_id<typename Component::System>())
-        )).template
+      Component component = static_cast<System&>(*system_->GetComponentType(type).system).template
         Create<Component>(*this);
 
-      system.Link(
+      system_->Link(
         *this,
         *static_cast<ComponentHandleBase*>(&component),
-        foundation::type_id<typename Component::System>());
+        type);
 
       return component;
     }
@@ -221,10 +356,7 @@ namespace sulphur
     template<typename Component>
     inline void Entity::Remove(Component handle)
     {
-      World& world = application_->GetService<WorldProviderSystem>().GetWorld();
-      EntitySystem& system = world.GetOwner<EntitySystem>();
-
-      system.UnLink(
+      system_->UnLink(
         *this,
         *static_cast<ComponentHandleBase*>(&handle),
         foundation::type_id<typename Component::System>());
@@ -234,21 +366,18 @@ namespace sulphur
     template<typename Component>
     inline Component Entity::Get() const
     {
-      World& world = application_->GetService<WorldProviderSystem>().GetWorld();
-      EntitySystem& system = world.GetOwner<EntitySystem>();
+      using System = typename Component::System;
+      const size_t type = foundation::type_id<System>();
 
-      ComponentHandleBase avoid_error = system.GetHandle(*this, foundation::type_id<typename Component::System>());
-      return Component(world.GetComponent<typename Component::System>(), avoid_error.Handle());
+      ComponentHandleBase avoid_error = system_->GetHandle(*this, type);
+      return Component(static_cast<System&>(*system_->GetComponentType(type).system), avoid_error.Handle());
     }
     
     //-------------------------------------------------------------------------
     template<typename Component>
     inline bool Entity::Has() const
     {
-      World& world = application_->GetService<WorldProviderSystem>().GetWorld();
-      EntitySystem& system = world.GetOwner<EntitySystem>();
-
-      ComponentHandleBase avoid_error = system.GetHandle(*this, foundation::type_id<typename Component::System>());
+      ComponentHandleBase avoid_error = system_->GetHandle(*this, foundation::type_id<typename Component::System>());
       return avoid_error != Component::InvalidHandle();
     }
   }
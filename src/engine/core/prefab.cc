@@ -0,0 +1,82 @@
+#include "prefab.h"
+
+#include <foundation/logging/logger.h>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    //-------------------------------------------------------------------------
+    size_t Prefab::AddNode(
+      size_t parent,
+      const glm::vec3& local_position,
+      const glm::quat& local_rotation,
+      const glm::vec3& local_scale,
+      const foundation::String& name)
+    {
+      if (nodes_.empty() == true)
+      {
+        PS_LOG_IF(parent != HierarchyNode::kNoParent, Warning,
+          "The first node of a prefab is its root, the parent is ignored");
+        parent = HierarchyNode::kNoParent;
+      }
+      else
+      {
+        // Walk up from the last node, the parent has to be on that path to stay depth-first
+        size_t ancestor = nodes_.size() - 1;
+        while (ancestor != HierarchyNode::kNoParent && ancestor != parent)
+        {
+          ancestor = nodes_[ancestor].parent;
+        }
+
+        if (parent == HierarchyNode::kNoParent || ancestor != parent)
+        {
+          PS_LOG(Error, "Prefab nodes have to be added depth-first, the parent has to be the last node or one of its ancestors");
+          return kInvalidNode;
+        }
+
+        ++nodes_[parent].child_count;
+      }
+
+      nodes_.push_back(HierarchyNode{ parent, 0, local_position, local_rotation, local_scale, name });
+      return nodes_.size() - 1;
+    }
+
+    //-------------------------------------------------------------------------
+    Prefab::ComponentBatch* Prefab::GetBatch(size_t type, size_t node)
+    {
+      if (node >= nodes_.size())
+      {
+        PS_LOG(Error, "Attempted to add a component to a node that isn't part of the prefab");
+        return nullptr;
+      }
+
+      if (type == foundation::type_id<TransformSystem>())
+      {
+        PS_LOG(Warning, "Every prefab node already has a transform, use the node's values instead");
+        return nullptr;
+      }
+
+      for (ComponentBatch& batch : batches_)
+      {
+        if (batch.type != type)
+        {
+          continue;
+        }
+
+        for (size_t other : batch.nodes)
+        {
+          if (other == node)
+          {
+            PS_LOG(Warning, "Prefab node already has a component of this type");
+            return nullptr;
+          }
+        }
+        return &batch;
+      }
+
+      batches_.push_back(ComponentBatch{ type });
+      return &batches_.back();
+    }
+  }
+}
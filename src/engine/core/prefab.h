@@ -0,0 +1,147 @@
+#pragma once
+
+#include "engine/systems/components/transform_system.h"
+
+#include <foundation/containers/vector.h>
+#include <foundation/containers/string.h>
+#include <foundation/utils/type_set.h>
+
+#include <EASTL/functional.h>
+
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    class IComponentSystem;
+
+    /**
+    * @class sulphur::engine::Prefab
+    * @brief A template of entities, their hierarchy and their components that can be instantiated many times at once.
+    * @details Every node of the prefab becomes an entity with a transform. The nodes are stored in depth-first order,
+    *   so every instance is appended to the transform hierarchy as one contiguous block. Components are grouped per
+    *   component type, so every system is only looked up and reserved once per instantiation.
+    * @remarks Prefabs are built in code and owned by the caller. They are not assets; there is no prefab file format
+    *   or builder step, so they can't be authored in the editor or loaded from a package.
+    * @see sulphur::engine::EntitySystem::Instantiate
+    */
+    class Prefab
+    {
+    public:
+      static constexpr size_t kInvalidNode = PS_SIZE_MAX; //!< Returned when a node couldn't be added
+
+      /**
+      * @brief Adds a node to the prefab
+      * @param[in] parent (size_t) The index of the parent node, sulphur::engine::HierarchyNode::kNoParent for the root
+      * @param[in] local_position (const glm::vec3&) The position relative to the parent
+      * @param[in] local_rotation (const glm::quat&) The rotation relative to the parent
+      * @param[in] local_scale (const glm::vec3&) The scale relative to the parent
+      * @param[in] name (const sulphur::foundation::String&) The name of the node's transform
+      * @remarks The first node has to be the root and is the only node without a parent. To keep the nodes depth-first,
+      *   the parent has to be the last added node or one of its ancestors.
+      * @return (size_t) The index of the node or sulphur::engine::Prefab::kInvalidNode if the parent isn't valid
+      */
+      size_t AddNode(
+        size_t parent,
+        const glm::vec3& local_position = glm::vec3(0.0f),
+        const glm::quat& local_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+        const glm::vec3& local_scale = glm::vec3(1.0f),
+        const foundation::String& name = "");
+
+      /**
+      * @brief Adds a component to a node
+      * @tparam Component (typename) The component handle type, e.g. sulphur::engine::MeshRenderComponent
+      * @param[in] node (size_t) The index of the node
+      */
+      template<typename Component>
+      void AddComponent(size_t node);
+      /**
+      * @brief Adds a component to a node and sets its initial values
+      * @tparam Component (typename) The component handle type, e.g. sulphur::engine::MeshRenderComponent
+      * @tparam Init (typename) Function taking the created component
+      * @param[in] node (size_t) The index of the node
+      * @param[in] init (Init&&) Called with every instance of the component right after it was created
+      */
+      template<typename Component, typename Init>
+      void AddComponent(size_t node, Init&& init);
+
+      /**
+      * @return (size_t) The amount of nodes, which is the amount of entities per instance
+      */
+      size_t node_count() const;
+      /**
+      * @return (const sulphur::foundation::Vector <sulphur::engine::HierarchyNode>&) The nodes in depth-first order
+      */
+      const foundation::Vector<HierarchyNode>& nodes() const;
+
+    private:
+      friend class EntitySystem;
+
+      using CreateFunc = eastl::function<ComponentHandleBase(IComponentSystem&, Entity&)>; //!< Creates and initializes a component
+
+      /**
+      * @struct sulphur::engine::Prefab::ComponentBatch
+      * @brief The components of a single type in the prefab
+      */
+      struct ComponentBatch
+      {
+        size_t type; //!< The type-id of the component's system
+        foundation::Vector<size_t> nodes; //!< The node of every component
+        foundation::Vector<CreateFunc> create; //!< Creates every component
+      };
+
+      /**
+      * @brief Finds or adds the batch of a component type
+      * @param[in] type (size_t) The type-id of the component's system
+      * @param[in] node (size_t) The node the component is added to
+      * @return (sulphur::engine::Prefab::ComponentBatch*) The batch or nullptr if the component can't be added to the node
+      */
+      ComponentBatch* GetBatch(size_t type, size_t node);
+
+      foundation::Vector<HierarchyNode> nodes_; //!< The nodes in depth-first order
+      foundation::Vector<ComponentBatch> batches_; //!< The components per type, in the order the types were first added
+    };
+
+    //-------------------------------------------------------------------------
+    template<typename Component>
+    inline void Prefab::AddComponent(size_t node)
+    {
+      AddComponent<Component>(node, [](Component&) {});
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename Component, typename Init>
+    inline void Prefab::AddComponent(size_t node, Init&& init)
+    {
+      using System = typename Component::System;
+
+      ComponentBatch* batch = GetBatch(foundation::type_id<System>(), node);
+      if (batch == nullptr)
+      {
+        return;
+      }
+
+      batch->nodes.push_back(node);
+      batch->create.push_back([init](IComponentSystem& system, Entity& entity)
+      {
+        Component component = static_cast<System&>(system).template Create<Component>(entity);
+        init(component);
+        return *static_cast<ComponentHandleBase*>(&component);
+      });
+    }
+
+    //-------------------------------------------------------------------------
+    inline size_t Prefab::node_count() const
+    {
+      return nodes_.size();
+    }
+
+    //-------------------------------------------------------------------------
+    inline const foundation::Vector<HierarchyNode>& Prefab::nodes() const
+    {
+      return nodes_;
+    }
+  }
+}
@@ -62,6 +62,12 @@ namespace sulphur
       return *current_world_;
     }
 
+    //--------------------------------------------------------------------------
+    bool WorldProviderSystem::HasWorld() const
+    {
+      return current_world_ != nullptr;
+    }
+
     //--------------------------------------------------------------------------
     void WorldProviderSystem::OnInitialize(Application& app, foundation::JobGraph& job_graph)
     {
@@ -81,9 +87,13 @@ namespace sulphur
       }
     }
 
+    //--------------------------------------------------------------------------
+    uint64_t World::next_id_ = 1;
+
     //--------------------------------------------------------------------------
     World::World() :
-      BaseResource("World")
+      BaseResource("World"),
+      id_(next_id_++)
     {
       DebugRenderSystem::SetupDebugAssets();
 
@@ -22,6 +22,9 @@ namespace sulphur
     class IPhysics;
     class World;
 
+    template<typename... Components>
+    class ComponentView;
+
     /**
     * @class sulphur::engine::WorldProviderSystem : sulphur::engine::IServiceSystem <sulphur::engine::WorldProviderSystem>
     * @brief A service system that manages the creation, deletion, and notification of worlds.
@@ -55,6 +58,11 @@ namespace sulphur
       * @return (sulphur::engine::World) The world instance the is currently active
       */
       World& GetWorld();
+      /**
+      * @brief Checks if a world currently exists
+      * @return (bool) Does a world exist?
+      */
+      bool HasWorld() const;
 
       /**
       * @see IServiceSystem::OnInitialize
@@ -177,9 +185,30 @@ namespace sulphur
         return components_.Get(idx);
       }
 
+      /**
+      * @brief Creates a view that iterates all entities that have every one of the listed components
+      * @tparam[in] Components (typename...) The component handle types to iterate
+      * @return (sulphur::engine::ComponentView <Components...>) The view
+      * @remarks Defined in engine/core/component_view.h, which has to be included to use this
+      * @see sulphur::engine::ComponentView
+      */
+      template<typename... Components>
+      ComponentView<Components...> View();
+
+      /**
+      * @brief Gets the identifier of this world
+      * @return (uint64_t) An identifier that no other world has, not even one that is created at the same address
+      */
+      uint64_t id() const
+      {
+        return id_;
+      }
+
     private:
       SystemSet<IOwnerSystemBase> owners_; //!< A unique set of all owner systems in this world
       SystemSet<IComponentSystem> components_; //!< A unique set of all component systems in this world
+      uint64_t id_; //!< The identifier of this world
+      static uint64_t next_id_; //!< The identifier of the next world that is created
 
     };
 
@@ -90,6 +90,13 @@ namespace sulphur
       */
       virtual void SetBoneMatrices(const foundation::Vector<glm::mat4>& bone_matrices) = 0;
 
+      /**
+      * @brief Sets bone matrices that are shared between instances, placing them in the space of one instance
+      * @param[in] bone_matrices (const foundation::Vector<glm::mat4>&) The bone matrices in model space.
+      * @param[in] bone_space (const glm::mat4&) The affine transform of the instance, applied to every bone matrix as it is bound.
+      */
+      virtual void SetBoneMatrices(const foundation::Vector<glm::mat4>& bone_matrices, const glm::mat4& bone_space) = 0;
+
       /**
       * @see sulphur::engine::IRenderer::Draw
       * @brief Sets the material to be used for the next Draw() call.
@@ -1,6 +1,7 @@
 #include "physics_system.h"
 
 #include "engine/systems/components/transform_system.h"
+#include "engine/core/world.h"
 #include "engine/application/application.h"
 #include "engine/scripting/script_system.h"
 #include "engine/assets/asset_system.h"
@@ -25,7 +26,11 @@ namespace sulphur
     //-------------------------------------------------------------------------
     PhysicsSystem::PhysicsSystem() :
       IServiceSystem("PhysicsSystem"),
-      script_system_(nullptr)
+      script_system_(nullptr),
+      world_provider_(nullptr),
+      world_id_(0),
+      transform_system_(nullptr),
+      transform_consumer_(ChangeTracker::kInvalidConsumer)
     {
     }
 
@@ -64,6 +69,11 @@ namespace sulphur
       job_graph.Add(std::move(fixed_update_job));
 
       script_system_ = &app.GetService<ScriptSystem>();
+      // The world is created after the services are initialized, so the transform system is looked up on the first step
+      world_provider_ = &app.GetService<WorldProviderSystem>();
+      world_id_ = 0;
+      transform_system_ = nullptr;
+      transform_consumer_ = ChangeTracker::kInvalidConsumer;
       PhysicsSystem::self_ = this;
     
       callbacks_.bodies_ = static_cast<physics::PhysicsBody**>(
@@ -94,6 +104,8 @@ namespace sulphur
 
       callbacks_.size_ = 0;
       fallback_mesh_.Release();
+
+      DetachTransformSystem();
     }
 
     //-------------------------------------------------------------------------
@@ -418,32 +430,39 @@ namespace sulphur
     //-------------------------------------------------------------------------
     void PhysicsSystem::GatherChangedTransforms()
     {
-      // Naive sync check approach, but it's functional.
-      for (EntityBodyMapIt pair = bodies_.begin(); pair != bodies_.end(); ++pair)
+      World& world = world_provider_->GetWorld();
+      TransformSystem& transform_system = world.GetComponent<TransformSystem>();
+      if (world_id_ != world.id())
       {
-        TransformComponent trans = pair->first.Get<TransformComponent>();
-        glm::vec3 world_pos = trans.GetWorldPosition();
-        glm::quat world_rot = trans.GetWorldRotation();
+        // A new world can be allocated at the address of the previous one, so worlds are told apart by their identifier
+        DetachTransformSystem();
+
+        // Changes made before registering aren't reported, so sync every body once
+        world_id_ = world.id();
+        transform_system_ = &transform_system;
+        transform_consumer_ = transform_system.changes().AddConsumer();
 
-        bool needs_sync = world_pos != pair->second->GetTranslation();
-        if (needs_sync == false)
+        for (EntityBodyMapIt pair = bodies_.begin(); pair != bodies_.end(); ++pair)
         {
-          // Check rotation. Glm throws an uninitialised variable warning with normal quat compare 
-          // so it's done like this instead.
-          // Transform rotation is obtained by decomposing, hence the epsilon*2 is necessary
-          // to catch near-identical rotations.
-          glm::quat phys_rot = pair->second->GetRotation();
-          needs_sync = glm::epsilonNotEqual(world_rot.x, phys_rot.x, FLT_EPSILON*2) ||
-                       glm::epsilonNotEqual(world_rot.y, phys_rot.y, FLT_EPSILON*2) ||
-                       glm::epsilonNotEqual(world_rot.z, phys_rot.z, FLT_EPSILON*2) ||
-                       glm::epsilonNotEqual(world_rot.w, phys_rot.w, FLT_EPSILON*2);
+          changes_.push_back(pair);
         }
+        return;
+      }
 
-        if (needs_sync == true)
+      if (bodies_.empty() == true)
+      {
+        transform_system.changes().Clear(transform_consumer_);
+        return;
+      }
+
+      transform_system.ForEachChanged(transform_consumer_, [this, &transform_system](TransformComponent transform)
+      {
+        EntityBodyMapIt pair = bodies_.find(transform_system.GetEntity(transform));
+        if (pair != bodies_.end())
         {
           changes_.push_back(pair);
         }
-      }
+      });
     }
 
     //-------------------------------------------------------------------------
@@ -692,8 +711,26 @@ namespace sulphur
         {
           transform.SetWorldPosition(body->GetTranslation());
           transform.SetWorldRotation(body->GetRotation());
+
+          // The transform already matches the body, the changes of its children are kept
+          transform_system_->changes().ClearChanged(transform_consumer_, transform.Handle());
         }
       }
     }
+
+    //-------------------------------------------------------------------------
+    void PhysicsSystem::DetachTransformSystem()
+    {
+      // The consumer was destroyed along with the transform system of a world that no longer exists
+      if (transform_system_ != nullptr && world_provider_->HasWorld() == true &&
+        world_provider_->GetWorld().id() == world_id_)
+      {
+        transform_system_->changes().RemoveConsumer(transform_consumer_);
+      }
+
+      world_id_ = 0;
+      transform_system_ = nullptr;
+      transform_consumer_ = ChangeTracker::kInvalidConsumer;
+    }
   }
 }
@@ -26,6 +26,7 @@ namespace sulphur
   namespace engine
   {
     class ScriptSystem;
+    class WorldProviderSystem;
 
     /**
     * @class sulphur::engine::PhysicsSystem : public sulphur::engine::IServiceSystem<PhysicsSystem>
@@ -150,7 +151,8 @@ namespace sulphur
       physics::PhysicsBody* GetPhysicsBody(Entity entity);
 
       /**
-      * @brief Called every update and gathers changes in the transforms
+      * @brief Called every update and gathers the transforms of physics bodies that changed since the last step
+      * @remarks Only visits the transforms reported by the transform system's change tracker
       */
       void GatherChangedTransforms();
 
@@ -247,8 +249,13 @@ namespace sulphur
     private:
       /**
       * @brief Internal function used to synchronise states between physics and the engine.
+      * @remarks The changes it makes to the transforms of the bodies are cleared, so they aren't synced back to the bodies.
       */
       void SyncPhysicsToEngine();
+      /**
+      * @brief Unregisters from the change tracker of the transform system, if its world still exists
+      */
+      void DetachTransformSystem();
 
       static PhysicsSystem* self_; //!< Instance to current active physiscs system for use in scripting
 
@@ -269,6 +276,11 @@ namespace sulphur
       physics::PlatformPhysics* physics_; //!< A pointer to the platform-specific physics wrapper
       ScriptSystem* script_system_; //!< Cached local scripting system;
 
+      WorldProviderSystem* world_provider_; //!< The provider of the world that the bodies belong to
+      uint64_t world_id_; //!< The identifier of the world of sulphur::engine::PhysicsSystem::transform_system_
+      TransformSystem* transform_system_; //!< The transform system that sulphur::engine::PhysicsSystem::transform_consumer_ is registered with
+      size_t transform_consumer_; //!< The consumer of the transform changes
+
       /**
       * @enum For internal use of callbacks administration
       */
@@ -0,0 +1,408 @@
+#include "engine/rewinder/history_buffer.h"
+#include "engine/rewinder/snapshot_pool.h"
+#include <foundation/utils/compression.h>
+#include <foundation/logging/logger.h>
+#include <EASTL/algorithm.h>
+#include <cassert>
+#include <cstring>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    namespace
+    {
+      //--------------------------------------------------------------------------
+      void XorBlock(char* dst, const char* src, size_t size)
+      {
+        for (size_t i = 0; i < size; ++i)
+        {
+          dst[i] ^= src[i];
+        }
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    FrameStorage& HistoryBuffer::Capture()
+    {
+      Unshare();
+      Release(capture_);
+      return capture_;
+    }
+
+    //--------------------------------------------------------------------------
+    FrameStorage& HistoryBuffer::Repeat()
+    {
+      assert(size_ > 0 && "Only a stored frame can be repeated");
+
+      Unshare();
+      Release(capture_);
+      capture_.data = newest_.data;
+      return capture_;
+    }
+
+    //--------------------------------------------------------------------------
+    void HistoryBuffer::Commit()
+    {
+      assert(frames_.empty() == false && "Frames can't be stored in a history buffer without capacity");
+
+      if (size_ == frames_.size())
+      {
+        // The frame after the oldest one can't refer to it anymore
+        if (size_ > 1 && At(1).keyframe == false)
+        {
+          MakeKeyframe(1);
+        }
+
+        Release(At(0));
+        oldest_ = (oldest_ + 1) % frames_.size();
+        --size_;
+        decoded_index_ = decoded_index_ == 0 || decoded_index_ == PS_SIZE_MAX ? PS_SIZE_MAX : decoded_index_ - 1;
+      }
+
+      const bool keyframe = size_ == 0 ||
+        since_keyframe_ + 1 >= keyframe_interval_ ||
+        newest_.data.size() != capture_.data.size();
+      since_keyframe_ = keyframe == true ? 0 : since_keyframe_ + 1;
+
+      Encode(capture_, keyframe == true ? nullptr : &newest_, frames_[(oldest_ + size_) % frames_.size()]);
+      ++size_;
+
+      // The captured frame is what the next frame is compressed against
+      for (size_t i = 0; i < newest_.data.size() && i < capture_.data.size(); ++i)
+      {
+        if (newest_.data[i].data == capture_.data[i].data)
+        {
+          newest_.data[i].data = nullptr;
+        }
+      }
+      Release(newest_);
+      newest_.data.swap(capture_.data);
+    }
+
+    //--------------------------------------------------------------------------
+    const FrameStorage& HistoryBuffer::Decode(size_t index)
+    {
+      assert(index < size_);
+
+      if (index == size_ - 1)
+      {
+        return newest_;
+      }
+
+      size_t keyframe = index;
+      while (At(keyframe).keyframe == false)
+      {
+        --keyframe;
+      }
+
+      // Continue from the decoded frame when it is part of the same chain of deltas
+      size_t first = keyframe;
+      if (decoded_index_ != PS_SIZE_MAX && decoded_index_ >= keyframe && decoded_index_ <= index)
+      {
+        first = decoded_index_ + 1;
+      }
+
+      for (size_t i = first; i <= index; ++i)
+      {
+        Apply(At(i));
+      }
+      decoded_index_ = index;
+
+      return decoded_;
+    }
+
+    //--------------------------------------------------------------------------
+    void HistoryBuffer::Clear()
+    {
+      for (EncodedFrame& frame : frames_)
+      {
+        Release(frame);
+      }
+      Unshare();
+      Release(capture_);
+      Release(newest_);
+      Release(decoded_);
+      Release(promoted_);
+
+      oldest_ = 0;
+      size_ = 0;
+      since_keyframe_ = 0;
+      decoded_index_ = PS_SIZE_MAX;
+    }
+
+    //--------------------------------------------------------------------------
+    void HistoryBuffer::set_capacity(size_t capacity)
+    {
+      if (capacity == frames_.size())
+      {
+        return;
+      }
+
+      const size_t kept = eastl::min(size_, capacity);
+      if (kept == 0)
+      {
+        Clear();
+        frames_.clear();
+        frames_.resize(capacity);
+        return;
+      }
+
+      // The oldest kept frame can't refer to the dropped frames
+      const size_t dropped = size_ - kept;
+      if (dropped > 0 && At(dropped).keyframe == false)
+      {
+        MakeKeyframe(dropped);
+      }
+
+      // Unroll the ring so the oldest kept frame ends up first
+      foundation::Vector<EncodedFrame> frames(capacity);
+      for (size_t i = 0; i < size_; ++i)
+      {
+        EncodedFrame& frame = At(i);
+        if (i < dropped)
+        {
+          Release(frame);
+        }
+        else
+        {
+          frames[i - dropped].blocks.swap(frame.blocks);
+          frames[i - dropped].keyframe = frame.keyframe;
+        }
+      }
+
+      frames_.swap(frames);
+      oldest_ = 0;
+      size_ = kept;
+      decoded_index_ = PS_SIZE_MAX;
+    }
+
+    //--------------------------------------------------------------------------
+    size_t HistoryBuffer::capacity() const
+    {
+      return frames_.size();
+    }
+
+    //--------------------------------------------------------------------------
+    size_t HistoryBuffer::size() const
+    {
+      return size_;
+    }
+
+    //--------------------------------------------------------------------------
+    void HistoryBuffer::set_keyframe_interval(size_t interval)
+    {
+      keyframe_interval_ = eastl::max(interval, static_cast<size_t>(1));
+    }
+
+    //--------------------------------------------------------------------------
+    size_t HistoryBuffer::keyframe_interval() const
+    {
+      return keyframe_interval_;
+    }
+
+    //--------------------------------------------------------------------------
+    const FrameStorage& HistoryBuffer::newest() const
+    {
+      return newest_;
+    }
+
+    //--------------------------------------------------------------------------
+    size_t HistoryBuffer::compressed_bytes() const
+    {
+      return compressed_bytes_;
+    }
+
+    //--------------------------------------------------------------------------
+    size_t HistoryBuffer::memory_usage() const
+    {
+      size_t usage = compressed_bytes_;
+      for (const FrameData& data : newest_.data)
+      {
+        usage += SnapshotPool::SizeOf(data.data);
+      }
+      for (const FrameData& data : decoded_.data)
+      {
+        usage += SnapshotPool::SizeOf(data.data);
+      }
+      return usage;
+    }
+
+    //--------------------------------------------------------------------------
+    HistoryBuffer::EncodedFrame& HistoryBuffer::At(size_t index)
+    {
+      return frames_[(oldest_ + index) % frames_.size()];
+    }
+
+    //--------------------------------------------------------------------------
+    void HistoryBuffer::Encode(const FrameStorage& raw, const FrameStorage* previous, EncodedFrame& encoded)
+    {
+      SnapshotPool& pool = SnapshotPool::Instance();
+
+      Release(encoded);
+      encoded.keyframe = previous == nullptr;
+      encoded.blocks.resize(raw.data.size());
+
+      for (size_t i = 0; i < raw.data.size(); ++i)
+      {
+        const FrameData& data = raw.data[i];
+        EncodedBlock& block = encoded.blocks[i];
+        block.data = nullptr;
+        block.compressed_size = 0;
+        block.raw_size = SnapshotPool::SizeOf(data.data);
+        block.size = data.size;
+        block.delta = false;
+        block.compressed = false;
+
+        if (block.raw_size == 0)
+        {
+          continue;
+        }
+
+        const char* source = static_cast<const char*>(data.data);
+        if (previous != nullptr && SnapshotPool::SizeOf(previous->data[i].data) == block.raw_size)
+        {
+          // Blocks that didn't change since the previous frame aren't stored at all, repeated blocks are the same memory
+          if (source == previous->data[i].data || memcmp(source, previous->data[i].data, block.raw_size) == 0)
+          {
+            block.delta = true;
+            continue;
+          }
+
+          // Unchanged bytes turn into zeros, which compress to almost nothing
+          delta_.resize(block.raw_size);
+          memcpy(delta_.data(), source, block.raw_size);
+          XorBlock(delta_.data(), static_cast<const char*>(previous->data[i].data), block.raw_size);
+          source = delta_.data();
+          block.delta = true;
+        }
+
+        const int raw_size = static_cast<int>(block.raw_size);
+        const int worst_case_size = foundation::Compressor::GetWorstCaseSize(raw_size);
+        scratch_.resize(static_cast<size_t>(worst_case_size));
+        const int compressed_size = foundation::Compressor::Compress(source, raw_size,
+          scratch_.data(), worst_case_size, foundation::CompressionType::kFast);
+
+        if (compressed_size > 0 && compressed_size < raw_size)
+        {
+          block.compressed = true;
+          block.compressed_size = static_cast<size_t>(compressed_size);
+          source = scratch_.data();
+        }
+        else
+        {
+          block.compressed_size = block.raw_size;
+        }
+
+        block.data = pool.Allocate(block.compressed_size);
+        memcpy(block.data, source, block.compressed_size);
+        compressed_bytes_ += block.compressed_size;
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    void HistoryBuffer::Apply(const EncodedFrame& encoded)
+    {
+      SnapshotPool& pool = SnapshotPool::Instance();
+
+      for (size_t i = encoded.blocks.size(); i < decoded_.data.size(); ++i)
+      {
+        pool.Release(decoded_.data[i].data);
+      }
+      decoded_.data.resize(encoded.blocks.size(), FrameData{ nullptr, 0 });
+
+      for (size_t i = 0; i < encoded.blocks.size(); ++i)
+      {
+        const EncodedBlock& block = encoded.blocks[i];
+        FrameData& data = decoded_.data[i];
+        data.size = block.size;
+
+        // A delta always has a block of the same size to apply to
+        if (SnapshotPool::SizeOf(data.data) != block.raw_size)
+        {
+          assert(block.delta == false);
+          pool.Release(data.data);
+          data.data = pool.Allocate(block.raw_size);
+        }
+
+        if (block.raw_size == 0 || (block.delta == true && block.data == nullptr))
+        {
+          continue;
+        }
+
+        char* target = static_cast<char*>(data.data);
+        const char* source = static_cast<const char*>(block.data);
+        if (block.compressed == true)
+        {
+          char* output = target;
+          if (block.delta == true)
+          {
+            scratch_.resize(block.raw_size);
+            output = scratch_.data();
+          }
+
+          const int size = foundation::Decompressor::Decompress(source, static_cast<int>(block.compressed_size),
+            output, static_cast<int>(block.raw_size));
+          PS_LOG_IF(static_cast<size_t>(size) != block.raw_size, Error,
+            "Failed to decompress a stored frame, the restored data will be invalid");
+          source = output;
+        }
+
+        if (block.delta == true)
+        {
+          XorBlock(target, source, block.raw_size);
+        }
+        else if (source != target)
+        {
+          memcpy(target, source, block.raw_size);
+        }
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    void HistoryBuffer::MakeKeyframe(size_t index)
+    {
+      Encode(Decode(index), nullptr, promoted_);
+
+      EncodedFrame& frame = At(index);
+      Release(frame);
+      frame.blocks.swap(promoted_.blocks);
+      frame.keyframe = true;
+    }
+
+    //--------------------------------------------------------------------------
+    void HistoryBuffer::Release(FrameStorage& frame)
+    {
+      SnapshotPool& pool = SnapshotPool::Instance();
+      for (FrameData& data : frame.data)
+      {
+        pool.Release(data.data);
+      }
+      frame.data.clear();
+    }
+
+    //--------------------------------------------------------------------------
+    void HistoryBuffer::Unshare()
+    {
+      for (size_t i = 0; i < capture_.data.size() && i < newest_.data.size(); ++i)
+      {
+        if (capture_.data[i].data == newest_.data[i].data)
+        {
+          capture_.data[i].data = nullptr;
+        }
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    void HistoryBuffer::Release(EncodedFrame& frame)
+    {
+      SnapshotPool& pool = SnapshotPool::Instance();
+      for (EncodedBlock& block : frame.blocks)
+      {
+        pool.Release(block.data);
+        compressed_bytes_ -= block.compressed_size;
+      }
+      frame.blocks.clear();
+    }
+  }
+}
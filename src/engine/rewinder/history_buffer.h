@@ -0,0 +1,169 @@
+#pragma once
+#include "engine/rewinder/frame_storage.h"
+#include <foundation/containers/vector.h>
+#include <foundation/utils/type_definitions.h>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    /**
+    * @class sulphur::engine::HistoryBuffer
+    * @brief A fixed capacity ring buffer of the frames stored for a single system, compressed against each other.
+    * @details Every keyframe_interval frames a keyframe is stored, which has every block LZ4 compressed on its own.
+    *   The frames in between store the XOR of every block with the same block of the previous frame, which is mostly
+    *   zeros for data that didn't change and compresses to almost nothing. When the buffer is full, the oldest frame
+    *   is replaced and the frame after it is turned into a keyframe if needed. All blocks come from the
+    *   sulphur::engine::SnapshotPool, so a full buffer stores frames without allocating.
+    * @remarks The frames aren't released on destruction, call Clear first. Different history buffers can commit
+    *   frames on different threads at the same time.
+    */
+    class HistoryBuffer
+    {
+    public:
+      static constexpr size_t kDefaultKeyframeInterval = 30;//<! The default amount of frames from one keyframe to the next
+      static constexpr size_t kRawFrameCount = 3;//<! The uncompressed frames a buffer holds at most: the captured, the newest and the decoded frame
+
+      /**
+      * @brief Gets the frame to capture the next frame in.
+      * @return (sulphur::engine::FrameStorage&) An empty frame, its blocks have to be allocated from the sulphur::engine::SnapshotPool.
+      */
+      FrameStorage& Capture();
+      /**
+      * @brief Captures the newest frame again without copying it, for data that didn't change since.
+      * @remarks The buffer can't be empty. The captured frame shares its blocks with the newest frame until it is committed.
+      * @return (sulphur::engine::FrameStorage&) The captured frame, which must not be changed.
+      */
+      FrameStorage& Repeat();
+      /**
+      * @brief Compresses the captured frame and adds it, replacing the oldest frame when the buffer is full.
+      * @remarks The capacity has to be larger than 0.
+      */
+      void Commit();
+      /**
+      * @brief Reconstructs a stored frame.
+      * @param[in] index (size_t) The frame index, 0 being the oldest frame that is still stored.
+      * @remarks Decoding the frame after the previously decoded frame only applies one delta, other frames are
+      *   decoded starting at their keyframe.
+      * @return (const sulphur::engine::FrameStorage&) The frame with data, valid until the next call to the buffer.
+      */
+      const FrameStorage& Decode(size_t index);
+      /**
+      * @brief Releases all stored frames.
+      */
+      void Clear();
+
+      /**
+      * @brief Changes the maximum amount of frames, keeping the newest frames that still fit.
+      * @param[in] capacity (size_t) The maximum amount of frames.
+      */
+      void set_capacity(size_t capacity);
+      /**
+      * @return (size_t) The maximum amount of frames.
+      */
+      size_t capacity() const;
+      /**
+      * @return (size_t) The amount of stored frames.
+      */
+      size_t size() const;
+      /**
+      * @brief Changes how often keyframes are stored, affects the frames stored from now on.
+      * @param[in] interval (size_t) The amount of frames from one keyframe to the next, 1 stores keyframes only.
+      */
+      void set_keyframe_interval(size_t interval);
+      /**
+      * @return (size_t) The amount of frames from one keyframe to the next.
+      */
+      size_t keyframe_interval() const;
+      /**
+      * @return (const sulphur::engine::FrameStorage&) The newest frame uncompressed, empty if no frame is stored.
+      */
+      const FrameStorage& newest() const;
+      /**
+      * @return (size_t) The amount of bytes that the compressed frames take up.
+      */
+      size_t compressed_bytes() const;
+      /**
+      * @return (size_t) The amount of bytes that the compressed frames and the uncompressed newest and decoded frames take up.
+      */
+      size_t memory_usage() const;
+
+    private:
+      /**
+      * @struct sulphur::engine::HistoryBuffer::EncodedBlock
+      * @brief A compressed block of a frame.
+      */
+      struct EncodedBlock
+      {
+        void* data;//<! The compressed data, allocated from the pool, nullptr for a delta without changes
+        size_t compressed_size;//<! The size of the compressed data in bytes
+        size_t raw_size;//<! The size of the block in bytes before compression
+        size_t size;//<! Number of elements stored in the block, as passed to the restore functions
+        bool delta;//<! Is the block the XOR with the same block of the previous frame?
+        bool compressed;//<! Is the data compressed? Data that doesn't get smaller is stored as is
+      };
+      /**
+      * @struct sulphur::engine::HistoryBuffer::EncodedFrame
+      * @brief A compressed frame.
+      */
+      struct EncodedFrame
+      {
+        foundation::Vector<EncodedBlock> blocks;//<! The compressed blocks
+        bool keyframe = false;//<! Can the frame be decoded without the frames before it?
+      };
+
+      /**
+      * @brief Gets a frame in the ring.
+      * @param[in] index (size_t) The frame index, 0 being the oldest frame.
+      * @return (sulphur::engine::HistoryBuffer::EncodedFrame&) The frame.
+      */
+      EncodedFrame& At(size_t index);
+      /**
+      * @brief Compresses a frame.
+      * @param[in] raw (const sulphur::engine::FrameStorage&) The frame to compress.
+      * @param[in] previous (const sulphur::engine::FrameStorage*) The frame before it or nullptr to store a keyframe.
+      * @param[out] encoded (sulphur::engine::HistoryBuffer::EncodedFrame&) The compressed frame, its blocks have to be released.
+      */
+      void Encode(const FrameStorage& raw, const FrameStorage* previous, EncodedFrame& encoded);
+      /**
+      * @brief Applies a compressed frame to the decoded frame.
+      * @param[in] encoded (const sulphur::engine::HistoryBuffer::EncodedFrame&) The frame to apply.
+      */
+      void Apply(const EncodedFrame& encoded);
+      /**
+      * @brief Turns a frame into a keyframe, so the frames before it can be dropped.
+      * @param[in] index (size_t) The frame index.
+      */
+      void MakeKeyframe(size_t index);
+      /**
+      * @brief Returns the blocks of a raw frame to the pool, keeping the storage of the frame for reuse.
+      * @param[in] frame (sulphur::engine::FrameStorage&) The frame to release.
+      */
+      static void Release(FrameStorage& frame);
+      /**
+      * @brief Forgets the blocks of the captured frame that are shared with the newest frame, so they are released once.
+      */
+      void Unshare();
+      /**
+      * @brief Returns the blocks of a compressed frame to the pool, keeping the storage of the frame for reuse.
+      * @param[in] frame (sulphur::engine::HistoryBuffer::EncodedFrame&) The frame to release.
+      */
+      void Release(EncodedFrame& frame);
+
+      foundation::Vector<EncodedFrame> frames_;//<! The ring of frames, its size is the capacity
+      size_t oldest_ = 0;//<! The index of the oldest frame in the ring
+      size_t size_ = 0;//<! The amount of stored frames
+      size_t keyframe_interval_ = kDefaultKeyframeInterval;//<! The amount of frames from one keyframe to the next
+      size_t since_keyframe_ = 0;//<! The amount of frames stored since the last keyframe
+      size_t compressed_bytes_ = 0;//<! The amount of bytes that the compressed frames take up
+
+      FrameStorage capture_;//<! The frame that is being captured
+      FrameStorage newest_;//<! The newest frame uncompressed, which the next frame is compressed against
+      FrameStorage decoded_;//<! The most recently decoded frame
+      size_t decoded_index_ = PS_SIZE_MAX;//<! The index of the decoded frame, PS_SIZE_MAX if it is invalid
+      EncodedFrame promoted_;//<! The storage that a frame is turned into a keyframe in
+      foundation::Vector<char> delta_;//<! Buffer for the XOR of a block with the previous frame
+      foundation::Vector<char> scratch_;//<! Buffer for compressing and decompressing
+    };
+  }
+}
@@ -0,0 +1,218 @@
+#include "engine/rewinder/rewind_recorder.h"
+#include "engine/rewinder/rewind_recording.h"
+#include "engine/rewinder/snapshot_pool.h"
+#include <foundation/utils/compression.h>
+#include <foundation/logging/logger.h>
+#include <cassert>
+#include <cstring>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    namespace
+    {
+      //--------------------------------------------------------------------------
+      template<typename T>
+      void Append(foundation::Vector<char>& buffer, const T& value)
+      {
+        const char* data = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), data, data + sizeof(T));
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    RewindRecorder::~RewindRecorder()
+    {
+      Close();
+    }
+
+    //--------------------------------------------------------------------------
+    bool RewindRecorder::Open(const char* path, size_t system_count)
+    {
+      Close();
+
+      file_.open(path, std::ios::binary | std::ios::trunc);
+      if (file_.is_open() == false)
+      {
+        PS_LOG(Warning, "Could not create rewind recording %s", path);
+        return false;
+      }
+
+      RewindRecording::Header header = {};
+      header.magic = RewindRecording::kMagic;
+      header.version = RewindRecording::kVersion;
+      header.system_count = static_cast<uint32_t>(system_count);
+      file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+      offset_ = sizeof(header);
+      frame_count_ = 0;
+      stopping_ = false;
+      open_ = true;
+      thread_ = std::thread([this]() { Run(); });
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindRecorder::Close()
+    {
+      if (open_ == false)
+      {
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+      }
+      condition_.notify_all();
+      thread_.join();
+
+      open_ = false;
+      staging_.clear();
+      free_.clear();
+      index_.clear();
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindRecorder::Begin()
+    {
+      assert(open_ == true);
+
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this]() { return pending_.size() < kMaxPendingFrames; });
+      if (free_.empty() == false)
+      {
+        staging_.swap(free_.back());
+        free_.pop_back();
+      }
+      staging_.clear();
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindRecorder::Add(const FrameStorage& storage)
+    {
+      RewindRecording::SystemHeader system = {};
+      system.block_count = storage.data.size();
+      Append(staging_, system);
+
+      for (const FrameData& data : storage.data)
+      {
+        RewindRecording::BlockHeader block = {};
+        block.size = data.size;
+        block.raw_size = SnapshotPool::SizeOf(data.data);
+        Append(staging_, block);
+
+        // Pad the data so every block is aligned once the frame is decompressed
+        const size_t offset = staging_.size();
+        staging_.resize(offset + RewindRecording::Align(static_cast<size_t>(block.raw_size)), 0);
+        if (block.raw_size > 0)
+        {
+          memcpy(staging_.data() + offset, data.data, static_cast<size_t>(block.raw_size));
+        }
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindRecorder::Submit()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back();
+        pending_.back().swap(staging_);
+      }
+      condition_.notify_all();
+      ++frame_count_;
+    }
+
+    //--------------------------------------------------------------------------
+    bool RewindRecorder::is_open() const
+    {
+      return open_;
+    }
+
+    //--------------------------------------------------------------------------
+    size_t RewindRecorder::frame_count() const
+    {
+      return frame_count_;
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindRecorder::Run()
+    {
+      for (;;)
+      {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          condition_.wait(lock, [this]() { return pending_.empty() == false || stopping_ == true; });
+          if (pending_.empty() == true)
+          {
+            break;
+          }
+          writing_.swap(pending_);
+        }
+        condition_.notify_all();
+
+        for (const foundation::Vector<char>& frame : writing_)
+        {
+          Write(frame);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (foundation::Vector<char>& frame : writing_)
+        {
+          free_.push_back();
+          free_.back().swap(frame);
+        }
+        writing_.clear();
+      }
+
+      Flush();
+
+      RewindRecording::Footer footer = {};
+      footer.index_offset = offset_;
+      footer.frame_count = index_.size();
+      footer.magic = RewindRecording::kMagic;
+      file_.write(reinterpret_cast<const char*>(index_.data()), index_.size() * sizeof(uint64_t));
+      file_.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+      file_.close();
+
+      PS_LOG_IF(file_.fail() == true, Error, "Failed to write the rewind recording");
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindRecorder::Write(const foundation::Vector<char>& frame)
+    {
+      const int raw_size = static_cast<int>(frame.size());
+      const int worst_case_size = foundation::Compressor::GetWorstCaseSize(raw_size);
+      compressed_.resize(static_cast<size_t>(worst_case_size));
+      const int compressed_size = foundation::Compressor::Compress(frame.data(), raw_size,
+        compressed_.data(), worst_case_size, foundation::CompressionType::kFast);
+      PS_LOG_IF(compressed_size <= 0, Error, "Failed to compress a rewind recording frame, it is stored uncompressed");
+
+      // Frames that don't get smaller are stored as is, so every submitted frame ends up in the recording
+      const bool compressed = compressed_size > 0 && compressed_size < raw_size;
+      const char* record = compressed == true ? compressed_.data() : frame.data();
+      const uint32_t record_size = static_cast<uint32_t>(compressed == true ? compressed_size : raw_size);
+
+      index_.push_back(offset_);
+      Append(chunk_, compressed == true ? record_size : record_size | RewindRecording::kUncompressed);
+      chunk_.insert(chunk_.end(), record, record + record_size);
+      offset_ += sizeof(uint32_t) + static_cast<uint64_t>(record_size);
+
+      if (chunk_.size() >= kChunkSize)
+      {
+        Flush();
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindRecorder::Flush()
+    {
+      // Flushing every chunk keeps the recording readable if the application stops without closing it
+      file_.write(chunk_.data(), chunk_.size());
+      file_.flush();
+      chunk_.clear();
+    }
+  }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "engine/rewinder/frame_storage.h"
+#include <foundation/containers/vector.h>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    /**
+    * @class sulphur::engine::RewindRecorder
+    * @brief Streams stored frames to a recording on disk from a background thread.
+    * @details Frames are copied into a staging buffer on the calling thread and handed to the writer thread, which
+    *   compresses every frame on its own and appends it to the file in chunks. The frame index is written when the
+    *   recording is closed. The format is described and read by sulphur::engine::RewindRecording.
+    * @remarks Begin, Add and Submit have to be called from one thread. When the writer can't keep up, Begin
+    *   waits until it has caught up, so no frames are lost.
+    */
+    class RewindRecorder
+    {
+    public:
+      static constexpr size_t kChunkSize = 1024 * 1024;//<! The amount of bytes that is gathered before writing to the file
+      static constexpr size_t kMaxPendingFrames = 64;//<! The amount of frames that can wait for the writer
+
+      /**
+      * @brief Closes the recording
+      */
+      ~RewindRecorder();
+
+      /**
+      * @brief Creates a recording and starts the writer, closing the previous recording.
+      * @param[in] path (const char*) The file to write to, it is overwritten.
+      * @param[in] system_count (size_t) The amount of systems stored per frame.
+      * @return (bool) False if the file couldn't be created.
+      */
+      bool Open(const char* path, size_t system_count);
+      /**
+      * @brief Writes the remaining frames and the frame index and stops the writer.
+      */
+      void Close();
+
+      /**
+      * @brief Starts recording a frame.
+      */
+      void Begin();
+      /**
+      * @brief Adds the data of the next system to the frame.
+      * @param[in] storage (const sulphur::engine::FrameStorage&) The data, its blocks have to be allocated from the sulphur::engine::SnapshotPool.
+      */
+      void Add(const FrameStorage& storage);
+      /**
+      * @brief Hands the frame to the writer.
+      */
+      void Submit();
+
+      /**
+      * @return (bool) Is a recording opened?
+      */
+      bool is_open() const;
+      /**
+      * @return (size_t) The amount of frames that were submitted to the recording.
+      */
+      size_t frame_count() const;
+
+    private:
+      /**
+      * @brief The loop of the writer thread.
+      */
+      void Run();
+      /**
+      * @brief Compresses a frame and adds it to the chunk, frames that don't compress are added as is.
+      * @param[in] frame (const sulphur::foundation::Vector <char>&) The staged frame.
+      */
+      void Write(const foundation::Vector<char>& frame);
+      /**
+      * @brief Writes the chunk to the file.
+      */
+      void Flush();
+
+      std::ofstream file_;//<! The recording, only used by the writer while it runs
+      std::thread thread_;//<! The writer
+      std::mutex mutex_;//<! Guards the pending and free frames and the stop flag
+      std::condition_variable condition_;//<! Signals new frames to the writer and finished frames to Begin
+      foundation::Vector<foundation::Vector<char>> pending_;//<! Frames waiting for the writer
+      foundation::Vector<foundation::Vector<char>> free_;//<! Staging buffers the writer is done with
+      bool stopping_ = false;//<! Should the writer stop once all pending frames are written?
+      bool open_ = false;//<! Is a recording opened?
+
+      foundation::Vector<char> staging_;//<! The frame that is being recorded
+      size_t frame_count_ = 0;//<! The amount of submitted frames
+
+      foundation::Vector<foundation::Vector<char>> writing_;//<! The frames the writer took from the pending frames
+      foundation::Vector<char> compressed_;//<! Buffer for compressing a frame
+      foundation::Vector<char> chunk_;//<! Compressed frames that still have to be written
+      foundation::Vector<uint64_t> index_;//<! The offset of every frame record
+      uint64_t offset_ = 0;//<! The offset at which the next frame record is written
+    };
+  }
+}
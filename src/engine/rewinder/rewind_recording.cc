@@ -0,0 +1,219 @@
+#include "engine/rewinder/rewind_recording.h"
+#include "engine/rewinder/snapshot_pool.h"
+#include <foundation/utils/compression.h>
+#include <foundation/logging/logger.h>
+#include <cassert>
+#include <cstring>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    //--------------------------------------------------------------------------
+    size_t RewindRecording::Align(size_t size)
+    {
+      return (size + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+    }
+
+    //--------------------------------------------------------------------------
+    RewindRecording::~RewindRecording()
+    {
+      Close();
+    }
+
+    //--------------------------------------------------------------------------
+    bool RewindRecording::Open(const char* path)
+    {
+      Close();
+
+      if (file_.Open(path) == false || file_.size() < sizeof(Header))
+      {
+        PS_LOG(Warning, "Could not open rewind recording %s", path);
+        file_.Close();
+        return false;
+      }
+
+      Header header;
+      memcpy(&header, file_.data(), sizeof(Header));
+      if (header.magic != kMagic || header.version == 0 || header.version > kVersion)
+      {
+        PS_LOG(Warning, "%s is not a rewind recording or has an unsupported version", path);
+        file_.Close();
+        return false;
+      }
+      system_count_ = header.system_count;
+
+      Footer footer = {};
+      if (file_.size() >= sizeof(Header) + sizeof(Footer))
+      {
+        memcpy(&footer, file_.data() + file_.size() - sizeof(Footer), sizeof(Footer));
+      }
+
+      const size_t index_size = static_cast<size_t>(footer.frame_count) * sizeof(uint64_t);
+      if (footer.magic == kMagic && footer.index_offset >= sizeof(Header) &&
+        footer.index_offset + index_size + sizeof(Footer) == file_.size())
+      {
+        index_.resize(static_cast<size_t>(footer.frame_count));
+        memcpy(index_.data(), file_.data() + footer.index_offset, index_size);
+      }
+      else
+      {
+        PS_LOG(Warning, "Rewind recording %s wasn't closed, its frames are recovered", path);
+        Scan(file_.size());
+      }
+
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindRecording::Close()
+    {
+      SnapshotPool::Instance().Release(decompressed_);
+      decompressed_ = nullptr;
+      frames_.clear();
+      index_.clear();
+      system_count_ = 0;
+      file_.Close();
+    }
+
+    //--------------------------------------------------------------------------
+    bool RewindRecording::Read(size_t frame)
+    {
+      if (frame >= index_.size())
+      {
+        return false;
+      }
+
+      // Frame records are a compressed size followed by the compressed frame, or a flagged size and the raw frame
+      const size_t offset = static_cast<size_t>(index_[frame]);
+      uint32_t record_size = 0;
+      if (offset + sizeof(uint32_t) <= file_.size())
+      {
+        memcpy(&record_size, file_.data() + offset, sizeof(uint32_t));
+      }
+
+      const bool uncompressed = (record_size & kUncompressed) != 0;
+      const uint32_t compressed_size = record_size & ~kUncompressed;
+      if (compressed_size < sizeof(int) || compressed_size > file_.size() - offset - sizeof(uint32_t))
+      {
+        PS_LOG(Error, "Rewind recording frame %zu is corrupt", frame);
+        return false;
+      }
+
+      const char* compressed = reinterpret_cast<const char*>(file_.data() + offset + sizeof(uint32_t));
+      const int raw_size = uncompressed == true ?
+        static_cast<int>(compressed_size) : foundation::Decompressor::GetDecompressedSize(compressed);
+      if (raw_size <= 0)
+      {
+        PS_LOG(Error, "Rewind recording frame %zu is corrupt", frame);
+        return false;
+      }
+
+      SnapshotPool& pool = SnapshotPool::Instance();
+      if (SnapshotPool::SizeOf(decompressed_) < static_cast<size_t>(raw_size))
+      {
+        pool.Release(decompressed_);
+        decompressed_ = pool.Allocate(static_cast<size_t>(raw_size));
+      }
+
+      // The mapped file doesn't keep the blocks aligned, so uncompressed frames are copied too
+      if (uncompressed == true)
+      {
+        memcpy(decompressed_, compressed, compressed_size);
+      }
+      else if (foundation::Decompressor::Decompress(compressed, static_cast<int>(compressed_size),
+        static_cast<char*>(decompressed_), raw_size) != raw_size)
+      {
+        PS_LOG(Error, "Rewind recording frame %zu is corrupt", frame);
+        return false;
+      }
+
+      // The blocks are used in place, they are aligned within the decompressed frame
+      byte* data = static_cast<byte*>(decompressed_);
+      const byte* end = data + raw_size;
+      frames_.resize(system_count_);
+      for (FrameStorage& storage : frames_)
+      {
+        SystemHeader system;
+        if (static_cast<size_t>(end - data) < sizeof(SystemHeader))
+        {
+          PS_LOG(Error, "Rewind recording frame %zu is corrupt", frame);
+          return false;
+        }
+        memcpy(&system, data, sizeof(SystemHeader));
+        data += sizeof(SystemHeader);
+
+        storage.data.resize(static_cast<size_t>(system.block_count));
+        for (FrameData& block_data : storage.data)
+        {
+          BlockHeader block;
+          if (static_cast<size_t>(end - data) < sizeof(BlockHeader))
+          {
+            PS_LOG(Error, "Rewind recording frame %zu is corrupt", frame);
+            return false;
+          }
+          memcpy(&block, data, sizeof(BlockHeader));
+          data += sizeof(BlockHeader);
+
+          const size_t padded_size = Align(static_cast<size_t>(block.raw_size));
+          if (static_cast<size_t>(end - data) < padded_size)
+          {
+            PS_LOG(Error, "Rewind recording frame %zu is corrupt", frame);
+            return false;
+          }
+
+          block_data.data = block.raw_size == 0 ? nullptr : data;
+          block_data.size = static_cast<size_t>(block.size);
+          data += padded_size;
+        }
+      }
+
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    const FrameStorage& RewindRecording::system_frame(size_t system) const
+    {
+      assert(system < frames_.size());
+      return frames_[system];
+    }
+
+    //--------------------------------------------------------------------------
+    bool RewindRecording::is_open() const
+    {
+      return file_.is_open();
+    }
+
+    //--------------------------------------------------------------------------
+    size_t RewindRecording::frame_count() const
+    {
+      return index_.size();
+    }
+
+    //--------------------------------------------------------------------------
+    size_t RewindRecording::system_count() const
+    {
+      return system_count_;
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindRecording::Scan(size_t end)
+    {
+      // The last record may have been cut off while it was being written
+      size_t offset = sizeof(Header);
+      while (end - offset > sizeof(uint32_t))
+      {
+        uint32_t compressed_size;
+        memcpy(&compressed_size, file_.data() + offset, sizeof(uint32_t));
+        compressed_size &= ~kUncompressed;
+        if (compressed_size == 0 || compressed_size > end - offset - sizeof(uint32_t))
+        {
+          break;
+        }
+
+        index_.push_back(offset);
+        offset += sizeof(uint32_t) + compressed_size;
+      }
+    }
+  }
+}
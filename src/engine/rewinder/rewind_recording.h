@@ -0,0 +1,130 @@
+#pragma once
+#include "engine/rewinder/frame_storage.h"
+#include <foundation/io/mapped_file.h>
+#include <foundation/containers/vector.h>
+#include <foundation/utils/type_definitions.h>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    /**
+    * @class sulphur::engine::RewindRecording
+    * @brief Reads a recording written by sulphur::engine::RewindRecorder.
+    * @details The file is memory-mapped, so only the frames that are restored are loaded from disk. Every frame is
+    *   compressed on its own, or stored as is if it doesn't compress, and found through the frame index at the end
+    *   of the file, which makes reading any frame cost the same. Recordings that weren't closed, for example because the application crashed, have
+    *   no index. Their frames are found by walking the frame records when the recording is opened.
+    */
+    class RewindRecording
+    {
+    public:
+      static constexpr uint32_t kMagic = 0x57525350;//<! "PSRW", marks the start and the end of a recording
+      static constexpr uint32_t kVersion = 2;//<! The version of the recording format, version 1 recordings have no uncompressed frames
+      static constexpr uint32_t kUncompressed = 0x80000000u;//<! Set in the size of a frame record that is stored as is, because compressing it didn't make it smaller
+      static constexpr size_t kBlockAlignment = 16;//<! The alignment of the blocks in a decompressed frame
+
+      /**
+      * @struct sulphur::engine::RewindRecording::Header
+      * @brief Stored at the start of the file.
+      */
+      struct Header
+      {
+        uint32_t magic;//<! sulphur::engine::RewindRecording::kMagic
+        uint32_t version;//<! sulphur::engine::RewindRecording::kVersion
+        uint32_t system_count;//<! The amount of systems stored per frame
+        uint32_t padding;//<! Unused
+      };
+      /**
+      * @struct sulphur::engine::RewindRecording::Footer
+      * @brief Stored at the end of the file, after the frame index.
+      */
+      struct Footer
+      {
+        uint64_t index_offset;//<! The offset of the frame index, which holds the offset of every frame record
+        uint64_t frame_count;//<! The amount of frames in the recording
+        uint32_t magic;//<! sulphur::engine::RewindRecording::kMagic
+        uint32_t padding;//<! Unused
+      };
+      /**
+      * @struct sulphur::engine::RewindRecording::SystemHeader
+      * @brief Stored in a decompressed frame in front of the blocks of every system.
+      */
+      struct SystemHeader
+      {
+        uint64_t block_count;//<! The amount of blocks the system stored
+        uint64_t padding;//<! Unused, keeps the blocks aligned
+      };
+      /**
+      * @struct sulphur::engine::RewindRecording::BlockHeader
+      * @brief Stored in a decompressed frame in front of every block.
+      */
+      struct BlockHeader
+      {
+        uint64_t size;//<! Number of elements stored in the block
+        uint64_t raw_size;//<! The size of the block in bytes, the data is padded to kBlockAlignment
+      };
+
+      /**
+      * @brief Rounds a block size up to the block alignment.
+      * @param[in] size (size_t) The size in bytes.
+      * @return (size_t) The padded size in bytes.
+      */
+      static size_t Align(size_t size);
+
+      /**
+      * @brief Closes the recording
+      */
+      ~RewindRecording();
+
+      /**
+      * @brief Maps a recording and reads its frame index.
+      * @param[in] path (const char*) The recording.
+      * @return (bool) False if the file isn't a recording.
+      */
+      bool Open(const char* path);
+      /**
+      * @brief Unmaps the recording.
+      */
+      void Close();
+      /**
+      * @brief Decompresses a frame.
+      * @param[in] frame (size_t) The frame index, 0 being the first recorded frame.
+      * @return (bool) False if the frame doesn't exist or is corrupt.
+      */
+      bool Read(size_t frame);
+
+      /**
+      * @brief Gets the data that a system stored in the frame that was read last.
+      * @param[in] system (size_t) The index of the system in the order it registered with the rewinder.
+      * @return (const sulphur::engine::FrameStorage&) The data, valid until the next read.
+      */
+      const FrameStorage& system_frame(size_t system) const;
+      /**
+      * @return (bool) Is a recording opened?
+      */
+      bool is_open() const;
+      /**
+      * @return (size_t) The amount of frames in the recording.
+      */
+      size_t frame_count() const;
+      /**
+      * @return (size_t) The amount of systems stored per frame.
+      */
+      size_t system_count() const;
+
+    private:
+      /**
+      * @brief Finds the frame records of a recording that has no index.
+      * @param[in] end (size_t) The end of the frame records in the file.
+      */
+      void Scan(size_t end);
+
+      foundation::MappedFile file_;//<! The mapped recording
+      foundation::Vector<uint64_t> index_;//<! The offset of every frame record
+      foundation::Vector<FrameStorage> frames_;//<! The data per system of the frame that was read last
+      void* decompressed_ = nullptr;//<! The frame that was read last, allocated from the snapshot pool
+      size_t system_count_ = 0;//<! The amount of systems stored per frame
+    };
+  }
+}
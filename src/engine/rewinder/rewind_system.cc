@@ -1,6 +1,8 @@
 #include "engine/rewinder/rewind_system.h"
 #include "engine/rewinder/rewindable_storage_base.h"
 #include "engine/rewinder/system_stored_data.h"
+#include "engine/rewinder/snapshot_pool.h"
+#include "engine/rewinder/rewind_recording.h"
 #include <foundation/job/job_graph.h>
 #include <foundation/job/job.h>
 #include <foundation/job/data_policy.h>
@@ -11,25 +13,19 @@ namespace sulphur
   namespace engine
   {
     //--------------------------------------------------------------------------
-    void HistoryBuffer::Add(const FrameStorage& frame)
-    {
-      frame_data_.push_back(frame);
-    }
-
-    //--------------------------------------------------------------------------
-    FrameStorage& HistoryBuffer::operator[](size_t index )
-    {
-      return frame_data_[index];
-    }
-
     RewindSystem::RewindSystem()
       :
       IServiceSystem( "Rewinder" ),
+      workers_( kCaptureThreads ),
       frames_to_skip_( 0 ),
-      frame_limit_( 0 ),
+      frames_skipped_( 0 ),
+      frame_limit_( kDefaultFrameLimit ),
+      keyframe_interval_( HistoryBuffer::kDefaultKeyframeInterval ),
+      async_capture_( true ),
       frame_to_restore_( -1 ),
       prev_restored_frame( -1 ),
-      active_( false )
+      active_( false ),
+      pool_reserved_( false )
     {}
 
     //--------------------------------------------------------------------------
@@ -54,40 +50,197 @@ namespace sulphur
       foundation::Job rewind_store_job = make_job("store", "store_rewind",
         store_rewind, bind_write(*this));
       job_graph.Add(std::move(rewind_store_job));
+
+      ReservePool();
     }
 
     //--------------------------------------------------------------------------
     void RewindSystem::OnTerminate()
     {
+      WaitForCapture();
+      recorder_.Close();
+      for (HistoryBuffer& history : systems_frame_data_)
+      {
+        history.Clear();
+      }
+      systems_frame_data_.clear();
+      systems_storage_.clear();
+      SnapshotPool::Instance().Clear();
+      pool_reserved_ = false;
     }
 
     //--------------------------------------------------------------------------
     void RewindSystem::Register(RewindStorage& system_storage_data)
     {
+      WaitForCapture();
       systems_storage_.push_back(&system_storage_data);
       systems_frame_data_.push_back(HistoryBuffer());
+      systems_frame_data_.back().set_capacity(frame_limit_);
+      systems_frame_data_.back().set_keyframe_interval(keyframe_interval_);
+      pool_reserved_ = false;
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindSystem::ReservePool()
+    {
+      WaitForCapture();
+
+      foundation::Vector<size_t> sizes;
+      for (const HistoryBuffer& history : systems_frame_data_)
+      {
+        if (history.size() == 0)
+        {
+          return;
+        }
+
+        for (const FrameData& data : history.newest().data)
+        {
+          sizes.push_back(SnapshotPool::SizeOf(data.data));
+        }
+      }
+
+      // The newest frames hold their blocks already, the captured and decoded frames take theirs from the pool
+      SnapshotPool::Instance().Reserve(sizes, HistoryBuffer::kRawFrameCount - 1);
+      pool_reserved_ = true;
     }
 
     //--------------------------------------------------------------------------
     void RewindSystem::RestoreFrame()
     {
+      WaitForCapture();
+      if (frame_to_restore_ < 0 || static_cast<size_t>(frame_to_restore_) >= stored_frames())
+      {
+        return;
+      }
+
       for (size_t i = 0; i < systems_storage_.size(); ++i)
       {
         // Call restore function of system storage data
-        systems_storage_[i]->Restore( systems_frame_data_[i][frame_to_restore_] );
+        systems_storage_[i]->Restore( systems_frame_data_[i].Decode(frame_to_restore_) );
       }
     }
 
     //--------------------------------------------------------------------------
     void RewindSystem::StoreFrame()
     {
+      // The previous frame has to be compressed before the next one is compared to it
+      WaitForCapture();
+
+      // Restored frames are already in the history
+      const bool recording = recorder_.is_open();
+      if (IsRewinding() == true || (frame_limit_ == 0 && recording == false))
+      {
+        return;
+      }
+
       // Check if we need to skip this frame
+      if (frames_skipped_ < frames_to_skip_)
+      {
+        ++frames_skipped_;
+        return;
+      }
+      frames_skipped_ = 0;
+
+      if (recording == true)
+      {
+        recorder_.Begin();
+      }
+
+      if (frame_limit_ == 0)
+      {
+        // Only record the frame
+        for ( size_t i = 0; i < systems_storage_.size(); ++i )
+        {
+          systems_storage_[i]->Store( record_frame_ );
+          recorder_.Add( record_frame_ );
+          for (FrameData& data : record_frame_.data)
+          {
+            SnapshotPool::Instance().Release(data.data);
+          }
+          record_frame_.data.clear();
+        }
+        recorder_.Submit();
+        return;
+      }
+
+      if (pool_reserved_ == false)
+      {
+        ReservePool();
+      }
+
+      // Systems that didn't change repeat the newest frame, only the others are copied
+      captures_.clear();
+      changed_.clear();
       for ( size_t i = 0; i < systems_storage_.size(); ++i )
       {
-        // Call store function of system storage data
-        systems_frame_data_[i].Add( systems_storage_[i]->Store() );
+        HistoryBuffer& history = systems_frame_data_[i];
+        if (history.size() > 0 && systems_storage_[i]->HasChanged() == false)
+        {
+          captures_.push_back(&history.Repeat());
+        }
+        else
+        {
+          captures_.push_back(&history.Capture());
+          changed_.push_back(i);
+        }
       }
-      return;
+
+      // Call store function of system storage data, copying the data so the systems can change it right away.
+      // The systems are copied in parallel, but the copies have to be done before the systems change their data again.
+      if (async_capture_ == true && changed_.size() > 1)
+      {
+        workers_.Dispatch(changed_.size(), [this](size_t i)
+        {
+          const size_t system = changed_[i];
+          systems_storage_[system]->Store( *captures_[system] );
+        });
+        workers_.Wait();
+      }
+      else
+      {
+        for ( size_t system : changed_ )
+        {
+          systems_storage_[system]->Store( *captures_[system] );
+        }
+      }
+
+      if (recording == true)
+      {
+        for (FrameStorage* frame : captures_)
+        {
+          recorder_.Add( *frame );
+        }
+        recorder_.Submit();
+      }
+
+      // Compress the copies against the previous frame, per system in parallel with the next frame
+      if (async_capture_ == true)
+      {
+        workers_.Dispatch(systems_frame_data_.size(), [this](size_t system)
+        {
+          systems_frame_data_[system].Commit();
+        });
+      }
+      else
+      {
+        for (HistoryBuffer& history : systems_frame_data_)
+        {
+          history.Commit();
+        }
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindSystem::WaitForCapture()
+    {
+      workers_.Wait();
+    }
+
+    //--------------------------------------------------------------------------
+    size_t RewindSystem::stored_frames()
+    {
+      WaitForCapture();
+      return systems_frame_data_.empty() == true ? 0 : systems_frame_data_[0].size();
     }
 
     //--------------------------------------------------------------------------
@@ -104,26 +257,89 @@ namespace sulphur
     }
 
     //--------------------------------------------------------------------------
-    void RewindSystem::StoreToDisk(const char*)
+    bool RewindSystem::StoreToDisk(const char* filename)
+    {
+      WaitForCapture();
+      if (recorder_.Open(filename, systems_storage_.size()) == false)
+      {
+        return false;
+      }
+
+      const size_t frame_count = stored_frames();
+      for (size_t frame = 0; frame < frame_count; ++frame)
+      {
+        recorder_.Begin();
+        for (HistoryBuffer& history : systems_frame_data_)
+        {
+          recorder_.Add(history.Decode(frame));
+        }
+        recorder_.Submit();
+      }
+
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindSystem::StopRecording()
     {
+      recorder_.Close();
+    }
+
+    //--------------------------------------------------------------------------
+    bool RewindSystem::IsRecording()
+    {
+      return recorder_.is_open();
+    }
+
+    //--------------------------------------------------------------------------
+    bool RewindSystem::RestoreRecordedFrame(RewindRecording& recording, size_t frame)
+    {
+      if (recording.system_count() != systems_storage_.size())
+      {
+        PS_LOG(Warning, "The rewind recording has %zu systems, but %zu systems are registered",
+          recording.system_count(), systems_storage_.size());
+        return false;
+      }
+
+      if (recording.Read(frame) == false)
+      {
+        return false;
+      }
+
+      for (size_t i = 0; i < systems_storage_.size(); ++i)
+      {
+        systems_storage_[i]->Restore( recording.system_frame(i) );
+      }
+      return true;
     }
 
     //--------------------------------------------------------------------------
     size_t RewindSystem::CalculateTotalMemoryUsage()
     {
-      return size_t();
+      size_t total = 0;
+      for (size_t i = 0; i < systems_frame_data_.size(); ++i)
+      {
+        total += CalculateSystemMemoryUsage(i);
+      }
+      return total;
     }
 
     //--------------------------------------------------------------------------
-    size_t RewindSystem::CalculateSystemMemoryUsage(size_t)
+    size_t RewindSystem::CalculateSystemMemoryUsage(size_t system)
     {
-      return size_t();
+      WaitForCapture();
+      if (system >= systems_frame_data_.size())
+      {
+        return 0;
+      }
+      return systems_frame_data_[system].memory_usage();
     }
 
     //--------------------------------------------------------------------------
     void RewindSystem::set_frames_to_skip(size_t frames_to_skip)
     {
       frames_to_skip_ = frames_to_skip;
+      frames_skipped_ = 0;
     }
 
     //--------------------------------------------------------------------------
@@ -135,7 +351,12 @@ namespace sulphur
     //--------------------------------------------------------------------------
     void RewindSystem::set_frame_limit(size_t frame_limit)
     {
+      WaitForCapture();
       frame_limit_ = frame_limit;
+      for (HistoryBuffer& history : systems_frame_data_)
+      {
+        history.set_capacity(frame_limit_);
+      }
     }
 
     //--------------------------------------------------------------------------
@@ -144,6 +365,36 @@ namespace sulphur
       return frame_limit_;
     }
 
+    //--------------------------------------------------------------------------
+    void RewindSystem::set_keyframe_interval(size_t keyframe_interval)
+    {
+      WaitForCapture();
+      keyframe_interval_ = keyframe_interval;
+      for (HistoryBuffer& history : systems_frame_data_)
+      {
+        history.set_keyframe_interval(keyframe_interval_);
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    size_t RewindSystem::keyframe_interval()
+    {
+      return keyframe_interval_;
+    }
+
+    //--------------------------------------------------------------------------
+    void RewindSystem::set_async_capture(bool async_capture)
+    {
+      WaitForCapture();
+      async_capture_ = async_capture;
+    }
+
+    //--------------------------------------------------------------------------
+    bool RewindSystem::async_capture()
+    {
+      return async_capture_;
+    }
+
     //--------------------------------------------------------------------------
     void RewindSystem::set_frame_to_restore(int frame)
     {
@@ -1,6 +1,8 @@
 #pragma once
 #include "engine/systems/service_system.h"
-#include "engine/rewinder/frame_storage.h"
+#include "engine/rewinder/history_buffer.h"
+#include "engine/rewinder/rewind_recorder.h"
+#include <foundation/job/worker_group.h>
 #include <foundation/containers/vector.h>
 
 namespace sulphur
@@ -8,28 +10,7 @@ namespace sulphur
   namespace engine
   {
     class RewindStorage;
-    /**
-    * @class sulphur::engine::HistoryBuffer
-    * @brief The rewind system which is used to be able to rewind frames.
-    * @todo Implement this with a ring buffer and maybe move this to its own file.
-    * @author Raymi Klingers
-    */
-    class HistoryBuffer
-    {
-    public:
-      /**
-      * @brief Adds a frame to the data which pops out the oldest when over its size limit.
-      * @param[in] frame (const sulphur::engine::FrameStorage&) The system storage data
-      */
-      void Add(const FrameStorage& frame);
-      /**
-      * @brief Adds a frame to the data which pops out the oldest when over its size limit.
-      * @param[in] index (size_t) The frame index
-      * @return (sulphur::engine::FrameStorage&) The frame with data.
-      */
-      FrameStorage& operator[](size_t index);
-      foundation::Vector<FrameStorage> frame_data_;//<! Storing the data per frame
-    };
+    class RewindRecording;
     /**
     * @struct sulphur::engine::RewindSystem : public sulphur::engine::IServiceSystem <sulphur::engine::RewindSystem>
     * @brief The rewind system which is used as a main control point to rewind frames.
@@ -39,6 +20,9 @@ namespace sulphur
     class RewindSystem : public IServiceSystem<RewindSystem>
     {
     public:
+      static constexpr size_t kDefaultFrameLimit = 600;//<! The default maximum amount of stored frames
+      static constexpr size_t kCaptureThreads = 2;//<! The worker threads of the rewinder that copy and compress the stored frames
+
       /**
       * @brief The constructor of the system
       */
@@ -58,14 +42,31 @@ namespace sulphur
       */
       void Register(RewindStorage& system_storage_data );
       /**
+      * @brief Fills the snapshot pool with the blocks that the uncompressed frames of the registered systems need,
+      *   so capturing and restoring frames reuses them instead of allocating.
+      * @remarks The blocks are sized after the newest stored frame of every system, so nothing is reserved before every
+      *   registered system stored a frame. Called by OnInitialize, and by StoreFrame after systems registered.
+      */
+      void ReservePool();
+      /**
       * @brief Function to restore the state of all rewinded systems to the given state.
+      * @remarks Does nothing when no frame needs to be restored or the frame isn't stored (anymore).
       */
       void RestoreFrame();
       /**
       * @brief Function to stores the state of all registered systems.
+      * @remarks Stores one frame out of every frames_to_skip + 1 frames and nothing while rewinding.
+      *   When frame_limit frames are stored, the oldest frame is replaced. The data is copied before this returns, but with
+      *   async capture the systems are copied in parallel and compressed on worker threads while the next frame runs.
+      *   Systems that track their changes and didn't change since the last stored frame aren't copied at all.
       */
       void StoreFrame();
       /**
+      * @brief Simple getter for the amount of stored frames
+      * @return (size_t) The amount of frames that can be restored
+      */
+      size_t stored_frames();
+      /**
       * @brief Function to check if we are rewinding
       * @return (bool) Whether the rewind system is rewinding
       */
@@ -76,17 +77,38 @@ namespace sulphur
       */
       bool WasRewinding();
       /**
-      * @brief Stores the currents data in a file on the disk to free up a lot of memory
-      * @param[in] system_storage_data (sulphur::engine::SystemStorageData) The file to store the data in
+      * @brief Starts recording to a file on the disk, beginning with the frames that are stored in memory
+      * @param[in] filename (const char*) The file to store the data in, it is overwritten
+      * @remarks Every frame stored from now on is appended to the file from a background thread until
+      *   StopRecording is called. With a frame limit of 0 frames are only recorded, without keeping them in memory.
+      * @return (bool) False if the file couldn't be created
+      * @see sulphur::engine::RewindRecording
+      */
+      bool StoreToDisk(const char* filename);
+      /**
+      * @brief Stops recording, writing the remaining frames and the frame index to the file
+      */
+      void StopRecording();
+      /**
+      * @brief Simple getter for the recording state
+      * @return (bool) Whether frames are being recorded to disk
+      */
+      bool IsRecording();
+      /**
+      * @brief Restores a frame from a recording
+      * @param[in] recording (sulphur::engine::RewindRecording&) A recording of the same registered systems
+      * @param[in] frame (size_t) The frame index in the recording
+      * @return (bool) False if the recording doesn't match the registered systems or the frame can't be read
       */
-      void StoreToDisk(const char* filename);
+      bool RestoreRecordedFrame(RewindRecording& recording, size_t frame);
       /**
-      * @brief Calculates the amount of memory that all the systems consume to store rewind data for the given length of rewind time.
+      * @brief Calculates the amount of memory that all the systems consume to store the frames that are in memory.
       * @return (size_t) The amount of memory in bytes
       */
       size_t CalculateTotalMemoryUsage();
       /**
-      * @brief Calculates the amount of memory that one system consumes to store rewind data for the given length of rewind time.
+      * @brief Calculates the amount of memory that one system consumes to store the frames that are in memory.
+      * @param[in] system (size_t) The index of the system in the order it registered
       * @return (size_t) The amount of memory in bytes
       */
       size_t CalculateSystemMemoryUsage(size_t system);
@@ -100,7 +122,8 @@ namespace sulphur
       */
       size_t frames_to_skip();
       /**
-      * @brief Simple setter for the maximum frames 
+      * @brief Simple setter for the maximum frames, the oldest frames that don't fit anymore are released
+      * @remarks A limit of 0 stops storing frames
       */
       void set_frame_limit(size_t frame_limit);
       /**
@@ -109,7 +132,30 @@ namespace sulphur
       */
       size_t frame_limit();
       /**
+      * @brief Simple setter for the amount of frames from one keyframe to the next
+      * @remarks The frames in between are stored as compressed differences with the frame before them.
+      *   A longer interval saves memory but makes restoring a random frame slower, 1 stores keyframes only.
+      */
+      void set_keyframe_interval(size_t keyframe_interval);
+      /**
+      * @brief Simple getter for the keyframe interval
+      * @return (size_t) The amount of frames from one keyframe to the next
+      */
+      size_t keyframe_interval();
+      /**
+      * @brief Simple setter for compressing stored frames on worker threads
+      * @remarks Restored frames are the same either way, synchronous capture only moves the compression back into StoreFrame.
+      *   Async capture runs on the rewinder's own workers, so the workers of the application are never kept busy by it.
+      */
+      void set_async_capture(bool async_capture);
+      /**
+      * @brief Simple getter for compressing stored frames on worker threads
+      * @return (bool) Whether frames are compressed on worker threads
+      */
+      bool async_capture();
+      /**
       * @brief Simple setter for the frame that needs to be restored
+      * @remarks The frame is an index into the stored frames, 0 being the oldest, and -1 when no frame needs to be restored
       */
       void set_frame_to_restore(int frame);
       /**
@@ -127,13 +173,27 @@ namespace sulphur
       */
       bool active();
     private:
+      /**
+      * @brief Waits until the frame that was stored last is compressed
+      */
+      void WaitForCapture();
+
       foundation::Vector<HistoryBuffer> systems_frame_data_;//<! A history buffer per system to store its data in.
       foundation::Vector<RewindStorage*> systems_storage_;//<! References to the systems their system storage data.
+      RewindRecorder recorder_;//<! Streams the stored frames to disk while recording.
+      FrameStorage record_frame_;//<! The frame that is stored when frames are recorded without being kept in memory.
+      foundation::Vector<FrameStorage*> captures_;//<! The frames that the systems are copied into by StoreFrame, one per system.
+      foundation::Vector<size_t> changed_;//<! The systems that are copied by StoreFrame, the others repeat their newest frame.
+      foundation::WorkerGroup workers_;//<! Copy and compress the stored frames of the systems in parallel, separate from the workers of the application.
       size_t frames_to_skip_;//<! Number of frames to skip before storing a frame.
+      size_t frames_skipped_;//<! Number of frames skipped since the last stored frame.
       size_t frame_limit_;//<! Maximum frames stored
+      size_t keyframe_interval_;//<! Amount of frames from one keyframe to the next
+      bool async_capture_;//<! Are stored frames compressed on worker threads?
       int frame_to_restore_;//<! The frame to restore and is -1 when no frame needs to be restored.
       int prev_restored_frame;//<! The frame to restore and is -1 when no frame needs to be restored.
       bool active_;//< The aciveness of the rewinder
+      bool pool_reserved_;//<! Is the snapshot pool filled for the registered systems?
     };
   }
 }
\ No newline at end of file
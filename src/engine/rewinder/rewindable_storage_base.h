@@ -41,12 +41,22 @@ namespace sulphur
       * @brief A function to prepare the data  in the storage for restoring an older state.
       */
       virtual void PrepareRestore( const FrameStorage& storage ) = 0;
+      /**
+      * @brief Marks the data as changed, so it is copied the next time a frame is stored.
+      * @remarks Only storages that set track_changes_ have to call this, on the main thread whenever their data changes.
+      */
+      void MarkChanged()
+      {
+        changed_ = true;
+      }
     public:
       uint64_t size_;//!< Size of the current storage.
       uint64_t capacity_;//!< Capacity of the current storage.
       uint64_t* element_sizes_;//!< The size of the elements
       void** element_list_;//!< Pointer to an external list which gives simple access to the data.
       const uint64_t num_elements_;//!< Number of elements
+      bool track_changes_ = false;//!< Does the storage call MarkChanged when its data changes? Storages that don't are copied every stored frame.
+      bool changed_ = true;//!< Did the data change since it was last stored or restored?
     };
   }
 }
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "engine/rewinder/snapshot_pool.h"
+
+#include <foundation/memory/memory.h>
+#include <foundation/logging/logger.h>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    //-------------------------------------------------------------------------
+    SnapshotPool& SnapshotPool::Instance()
+    {
+      static SnapshotPool pool;
+      return pool;
+    }
+
+    //-------------------------------------------------------------------------
+    void* SnapshotPool::Allocate(size_t size)
+    {
+      if (size == 0)
+      {
+        return nullptr;
+      }
+
+      const size_t size_class = ClassOf(size);
+      const size_t block_size = kMinBlockSize << size_class;
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      used_bytes_ += block_size;
+
+      void* block;
+      foundation::Vector<void*>& free_list = free_lists_[size_class];
+      if (free_list.empty() == true)
+      {
+        block = AllocateBlock(size_class);
+      }
+      else
+      {
+        block = free_list.back();
+        free_list.pop_back();
+        free_bytes_ -= block_size;
+      }
+
+      HeaderOf(block)->size = size;
+      return block;
+    }
+
+    //-------------------------------------------------------------------------
+    void SnapshotPool::Release(void* block)
+    {
+      if (block == nullptr)
+      {
+        return;
+      }
+
+      const size_t size_class = HeaderOf(block)->size_class;
+      const size_t block_size = kMinBlockSize << size_class;
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      used_bytes_ -= block_size;
+      free_bytes_ += block_size;
+      free_lists_[size_class].push_back(block);
+    }
+
+    //-------------------------------------------------------------------------
+    size_t SnapshotPool::SizeOf(const void* block)
+    {
+      return block == nullptr ? 0 : HeaderOf(block)->size;
+    }
+
+    //-------------------------------------------------------------------------
+    void SnapshotPool::Reserve(size_t size, size_t count)
+    {
+      if (size == 0)
+      {
+        return;
+      }
+
+      const size_t size_class = ClassOf(size);
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      foundation::Vector<void*>& free_list = free_lists_[size_class];
+      free_list.reserve(count);
+      while (free_list.size() < count)
+      {
+        free_list.push_back(AllocateBlock(size_class));
+        free_bytes_ += kMinBlockSize << size_class;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void SnapshotPool::Reserve(const foundation::Vector<size_t>& sizes, size_t count)
+    {
+      size_t class_counts[kClassCount] = {};
+      for (size_t size : sizes)
+      {
+        if (size != 0)
+        {
+          ++class_counts[ClassOf(size)];
+        }
+      }
+
+      for (size_t size_class = 0; size_class < kClassCount; ++size_class)
+      {
+        if (class_counts[size_class] != 0)
+        {
+          Reserve(kMinBlockSize << size_class, class_counts[size_class] * count);
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void SnapshotPool::Clear()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (foundation::Vector<void*>& free_list : free_lists_)
+      {
+        for (void* block : free_list)
+        {
+          foundation::Memory::Deallocate(static_cast<byte*>(block) - kAlignment);
+        }
+        free_list.clear();
+        free_list.shrink_to_fit();
+      }
+      free_bytes_ = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t SnapshotPool::used_bytes() const
+    {
+      return used_bytes_;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t SnapshotPool::free_bytes() const
+    {
+      return free_bytes_;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t SnapshotPool::heap_allocations() const
+    {
+      return heap_allocations_;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t SnapshotPool::ClassOf(size_t size)
+    {
+      size_t size_class = 0;
+      while ((kMinBlockSize << size_class) < size)
+      {
+        ++size_class;
+      }
+
+      PS_LOG_IF(size_class >= kClassCount, Fatal, "Snapshot block is larger than the largest size class");
+      return size_class;
+    }
+
+    //-------------------------------------------------------------------------
+    void* SnapshotPool::AllocateBlock(size_t size_class)
+    {
+      ++heap_allocations_;
+
+      // The header takes a whole alignment unit, so the block itself stays aligned
+      byte* memory = static_cast<byte*>(
+        foundation::Memory::Allocate(kAlignment + (kMinBlockSize << size_class), kAlignment));
+      reinterpret_cast<Header*>(memory)->size_class = size_class;
+      reinterpret_cast<Header*>(memory)->size = 0;
+      return memory + kAlignment;
+    }
+
+    //-------------------------------------------------------------------------
+    SnapshotPool::Header* SnapshotPool::HeaderOf(const void* block)
+    {
+      return reinterpret_cast<Header*>(const_cast<byte*>(static_cast<const byte*>(block)) - kAlignment);
+    }
+  }
+}
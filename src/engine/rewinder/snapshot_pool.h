@@ -0,0 +1,117 @@
+#pragma once
+#include <foundation/containers/vector.h>
+#include <foundation/utils/type_definitions.h>
+#include <mutex>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    /**
+    * @class sulphur::engine::SnapshotPool
+    * @brief Recycles the memory blocks that the rewinder stores frames in.
+    * @details Blocks are grouped in power of two size classes. A released block is kept in the free list of its
+    *   class, so once the history is full every stored frame reuses the blocks of the frame it replaces.
+    * @remarks Thread-safe, frames are compressed on worker threads while the next frame is captured. The pooled
+    *   blocks are freed by sulphur::engine::RewindSystem::OnTerminate.
+    */
+    class SnapshotPool
+    {
+    public:
+      static constexpr size_t kAlignment = 64; //!< The alignment of every block
+      static constexpr size_t kMinBlockSize = 64; //!< The size of the smallest size class
+      static constexpr size_t kClassCount = 48; //!< The amount of size classes
+
+      /**
+      * @brief Gets the pool that is shared by all rewind storages
+      * @return (sulphur::engine::SnapshotPool&) The pool
+      */
+      static SnapshotPool& Instance();
+
+      /**
+      * @brief Gets a block from the pool, allocating one if its size class is empty
+      * @param[in] size (size_t) The size of the block in bytes
+      * @return (void*) The block aligned to sulphur::engine::SnapshotPool::kAlignment, nullptr if size is 0
+      */
+      void* Allocate(size_t size);
+      /**
+      * @brief Returns a block to the pool
+      * @param[in] block (void*) A block that was allocated from this pool, may be nullptr
+      */
+      void Release(void* block);
+      /**
+      * @brief Gets the size that a block was allocated with
+      * @param[in] block (const void*) A block that was allocated from this pool, may be nullptr
+      * @return (size_t) The size in bytes that was passed to Allocate, 0 for nullptr
+      */
+      static size_t SizeOf(const void* block);
+      /**
+      * @brief Fills the pool with blocks up front
+      * @param[in] size (size_t) The size of the blocks in bytes
+      * @param[in] count (size_t) The amount of free blocks the size class should hold at least
+      */
+      void Reserve(size_t size, size_t count);
+      /**
+      * @brief Fills the pool with the blocks of a number of frames up front
+      * @param[in] sizes (const foundation::Vector<size_t>&) The sizes of the blocks of one frame in bytes
+      * @param[in] count (size_t) The amount of frames the pool should hold free blocks for at least
+      * @remarks Blocks of different sizes can share a size class, the class gets enough blocks for all of them
+      */
+      void Reserve(const foundation::Vector<size_t>& sizes, size_t count);
+      /**
+      * @brief Frees all blocks that are in the pool, blocks that are in use stay valid
+      */
+      void Clear();
+
+      /**
+      * @return (size_t) The amount of bytes in blocks that are in use
+      */
+      size_t used_bytes() const;
+      /**
+      * @return (size_t) The amount of bytes in blocks that are in the pool
+      */
+      size_t free_bytes() const;
+      /**
+      * @return (size_t) The amount of blocks that were allocated from the heap since the pool was created
+      */
+      size_t heap_allocations() const;
+
+    private:
+      /**
+      * @brief Gets the size class of a block
+      * @param[in] size (size_t) The size of the block in bytes
+      * @return (size_t) The index of the size class
+      */
+      static size_t ClassOf(size_t size);
+      /**
+      * @struct sulphur::engine::SnapshotPool::Header
+      * @brief Stored in front of every block
+      */
+      struct Header
+      {
+        size_t size_class; //!< The size class of the block
+        size_t size; //!< The size the block was allocated with
+      };
+      static_assert(sizeof(Header) <= kAlignment, "The header has to fit in front of the aligned block");
+
+      /**
+      * @brief Gets the header of a block
+      * @param[in] block (const void*) The block
+      * @return (sulphur::engine::SnapshotPool::Header*) The header in front of the block
+      */
+      static Header* HeaderOf(const void* block);
+      /**
+      * @brief Allocates a block of a size class from the heap
+      * @param[in] size_class (size_t) The size class
+      * @return (void*) The block
+      */
+      void* AllocateBlock(size_t size_class);
+
+      std::mutex mutex_; //!< Guards the free lists and the counters
+      foundation::Vector<void*> free_lists_[kClassCount]; //!< The free blocks per size class
+      size_t used_bytes_ = 0; //!< The amount of bytes in blocks that are in use
+      size_t free_bytes_ = 0; //!< The amount of bytes in blocks that are in the pool
+      size_t heap_allocations_ = 0; //!< The amount of blocks allocated from the heap
+    };
+  }
+}
@@ -1,6 +1,7 @@
 #include "engine/rewinder/system_stored_data.h"
 #include "engine/rewinder/frame_storage.h"
 #include "engine/rewinder/rewindable_storage_base.h"
+#include "engine/rewinder/snapshot_pool.h"
 #include "engine/systems/system_data.h"
 
 #include <foundation/memory/memory.h>
@@ -13,15 +14,16 @@ namespace sulphur
     template<>
     inline void* Store( SystemDataBase* storage, size_t )
     {
+      // Only the free handles that weren't reused yet are stored, so the free list doesn't have to be compacted every frame
       size_t element_sizes[]{
         storage->sparse_array_.size() * sizeof( SparseHandle ),
         storage->dense_to_sparse_array_.size() * sizeof( DenseHandle ),
         storage->generation_.size() * sizeof( unsigned char ),
-        storage->free_list_.size() * sizeof( size_t )
+        storage->FreeCount() * sizeof( size_t )
       };
       // Buffer sizes of the container [sparse, dense to sparse, generation, freelist]
       size_t buffer_size = sizeof( size_t ) * 4 + element_sizes[0] + element_sizes[1] + element_sizes[2] + element_sizes[3];
-      void* raw_array = foundation::Memory::Allocate( buffer_size, 64 );
+      void* raw_array = SnapshotPool::Instance().Allocate( buffer_size );
       void* start = raw_array;
       for ( int i = 0; i < 4; ++i )
       {
@@ -35,7 +37,7 @@ namespace sulphur
         storage->sparse_array_.data(),
         storage->dense_to_sparse_array_.data(),
         storage->generation_.data(),
-        storage->free_list_.data()
+        storage->free_list_.data() + storage->free_list_head_
       };
       for ( int i = 0; i < 4; ++i )
       {
@@ -57,6 +59,7 @@ namespace sulphur
       storage->dense_to_sparse_array_.resize( buffer_sizes[1] );
       storage->generation_.resize( buffer_sizes[2] );
       storage->free_list_.resize( buffer_sizes[3] );
+      storage->free_list_head_ = 0;
       void* data = buffer_sizes + 4;
       void* buffers[]
       {
@@ -75,17 +78,17 @@ namespace sulphur
       }
     }
     //-------------------------------------------------------------------------
-    FrameStorage RewindStorage::Store()
+    void RewindStorage::Store(FrameStorage& storage)
     {
       storage_data_->PrepareStore();
+      storage_data_->changed_ = false;
       element_list_ = storage_data_->element_list_;
-      FrameStorage storage;
+      storage.data.clear();
       for (int i = 0; i < store_functions_.size(); ++i)
       {
          storage.data.push_back( FrameData{ store_functions_[i]( element_list_[i],
             storage_data_->element_sizes_[i] ), storage_data_->element_sizes_[i] } );
       }
-      return storage;
     }
     //-------------------------------------------------------------------------
     void RewindStorage::Restore(const FrameStorage& storage)
@@ -95,6 +98,13 @@ namespace sulphur
       {
         restore_functions_[i](element_list_[i], storage.data[i].data, storage.data[i].size);
       }
+      // The restored data differs from the newest stored frame
+      storage_data_->changed_ = true;
+    }
+    //-------------------------------------------------------------------------
+    bool RewindStorage::HasChanged() const
+    {
+      return storage_data_->track_changes_ == false || storage_data_->changed_ == true;
     }
     //-------------------------------------------------------------------------
     void RewindStorage::AddSystemStorageFunction()
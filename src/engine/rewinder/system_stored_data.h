@@ -17,6 +17,7 @@ namespace sulphur
     * @tparam T (typename) The type to specialize on
     * @param[in] buffer (T*) A buffer of the type to store
     * @param[in] size (size_t) The num elements in the buffer
+    * @remarks The returned block has to come from sulphur::engine::SnapshotPool, which gets it back when the frame is released
     */
     template<typename T>
     inline void* Store(T* buffer, size_t size);
@@ -95,9 +96,9 @@ namespace sulphur
       }
       /*
       * @brief Invokes all the store function ptrs with the container to store the data of a frame.
-      * @return (FrameStorage) Returns the stored frame
+      * @param[out] storage (sulphur::engine::FrameStorage&) An empty frame to store the data in, its capacity is reused
       */
-      FrameStorage Store();
+      void Store(FrameStorage& storage);
 
       /*
       * @brief Invokes all the restore function ptrs with the container to restore the data of a frame.
@@ -105,6 +106,11 @@ namespace sulphur
       */
       void Restore(const FrameStorage& storage);
       /*
+      * @brief Checks if the data has to be copied to store a frame
+      * @return (bool) False if the storage tracks its changes and didn't change since it was last stored or restored
+      */
+      bool HasChanged() const;
+      /*
       * @brief Simple function to avoid the long template function names
       * @tparam T (typename) The current function pair type
       * @param[in] typed_func (T&&) The current function pair
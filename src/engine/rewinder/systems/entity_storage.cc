@@ -1,6 +1,7 @@
 #include "engine/rewinder/systems/entity_storage.h"
 #include "engine/core/entity_system.h"
 #include "engine/rewinder/system_stored_data.h"
+#include "engine/rewinder/snapshot_pool.h"
 
 #include <foundation/memory/memory.h>
 
@@ -12,7 +13,7 @@ namespace sulphur
     template<>
     inline void* Store(byte* buffer, size_t size)
     {
-      void* raw_array = foundation::Memory::Allocate(size*sizeof(byte), 64);
+      void* raw_array = SnapshotPool::Instance().Allocate( size*sizeof(byte) );
       memcpy_s(raw_array, size, buffer, size);
       return raw_array;
     }
@@ -34,40 +35,13 @@ namespace sulphur
     {
       //@ todo implement restoring of the data
     }
-    /**
-    * @struct sulphur::engine::StoredEntityComponentData
-    * @brief A struct with the data that is going to be stored for rewinding
-    * @todo find a better place for this
-    * @author Raymi Klingers
-    */
-    struct StoredEntityComponentData
-    {
-      size_t type_size;//<! How many types of components an entity has
-      size_t handle_size;//<! How many number of component handles an entity has
-      size_t* component_types;//<! The type array
-      ComponentHandleBase* handles;//<! The handle array
-    };
     //-------------------------------------------------------------------------
     template<>
     inline void* Store(EntityComponentData* buffer, size_t size)
     {
-      StoredEntityComponentData* data = static_cast<StoredEntityComponentData*>(foundation::Memory::Allocate(size * sizeof(EntityComponentData), 64));
-      for (int i = 0; i < size; ++i)
-      {
-        data[i].type_size = buffer[i].component_types.size();
-        data[i].component_types = static_cast<size_t*>(foundation::Memory::Allocate(data[i].type_size * sizeof(size_t), 64));
-        for (int dataI = 0; dataI < data[i].type_size; ++dataI)
-        {
-          data[i].component_types[dataI] = buffer[i].component_types[dataI];
-        }
-        data[i].handle_size = buffer[i].component_types.size();
-        data[i].handles = static_cast<ComponentHandleBase*>(foundation::Memory::Allocate(data[i].type_size * sizeof(ComponentHandleBase), 64));
-        for (int dataI = 0; dataI < data[i].type_size; ++dataI)
-        {
-          data[i].handles[dataI] = buffer[i].component_handles[dataI];
-        }
-      }
-      return data;
+      void* raw_array = SnapshotPool::Instance().Allocate( size * sizeof(EntityComponentData) );
+      memcpy_s(raw_array, size * sizeof(EntityComponentData), buffer, size * sizeof(EntityComponentData));
+      return raw_array;
     }
     //-------------------------------------------------------------------------
     template<>
@@ -75,16 +49,44 @@ namespace sulphur
     {
       //@ todo implement restoring of the data
     }
+    //-------------------------------------------------------------------------
+    template<>
+    inline void* Store(ComponentHandleBase* buffer, size_t)
+    {
+      return buffer;
+    }
+    //-------------------------------------------------------------------------
+    template<>
+    inline void Restore(ComponentHandleBase* /*buffer*/, void* /*old*/, size_t)
+    {
+      //@ todo implement restoring of the data
+    }
+    //-------------------------------------------------------------------------
+    template<>
+    inline void* Store(ComponentLink* buffer, size_t)
+    {
+      return buffer;
+    }
+    //-------------------------------------------------------------------------
+    template<>
+    inline void Restore(ComponentLink* /*buffer*/, void* /*old*/, size_t)
+    {
+      //@ todo implement restoring of the data
+    }
     //--------------------------------------------------------------------------
     EntityRewindStorage::EntityRewindStorage(EntitySystem& system):
-      RewindStorageBase(element_list_, element_sizes_,3),
+      RewindStorageBase(element_list_, element_sizes_,5),
       storage_(RewindStorage(
         reinterpret_cast<RewindStorageBase*>(this),
         StoreFunc<byte>(),
         StoreFunc<uint>(),
-        StoreFunc<EntityComponentData>())),
+        StoreFunc<EntityComponentData>(),
+        StoreFunc<ComponentHandleBase>(),
+        StoreFunc<ComponentLink>())),
       system_(system)
     {
+      // The entity system marks the storage when entities are created, destroyed or linked
+      track_changes_ = true;
     }
 
     //--------------------------------------------------------------------------
@@ -99,9 +101,8 @@ namespace sulphur
       element_sizes_[1] = system_.free_indices_.size();
       if (system_.free_indices_.size() != 0)
       {
-        uint* raw_array = static_cast<uint*>(foundation::Memory::Allocate(
-          system_.free_indices_.size(),
-          64));
+        uint* raw_array = static_cast<uint*>(SnapshotPool::Instance().Allocate(
+          system_.free_indices_.size() * sizeof(uint)));
         size_t iterator = 0;
         for (uint& i : system_.free_indices_)
         {
@@ -116,6 +117,54 @@ namespace sulphur
       }
       element_list_[2] = system_.entity_components_.data();
       element_sizes_[2] = system_.entity_components_.size();
+
+      // The first handle of every slot is stored back to back, each covering all entities
+      const size_t entity_count = system_.entity_components_.size();
+      element_sizes_[3] = system_.slot_types_.size() * entity_count;
+      if (element_sizes_[3] != 0)
+      {
+        ComponentHandleBase* raw_array = static_cast<ComponentHandleBase*>(SnapshotPool::Instance().Allocate(
+          element_sizes_[3] * sizeof(ComponentHandleBase)));
+        for (size_t slot = 0; slot < system_.slot_types_.size(); ++slot)
+        {
+          const foundation::Vector<ComponentHandleBase>& handles = system_.component_handles_[slot].first();
+          ComponentHandleBase* slot_array = raw_array + slot * entity_count;
+          for (size_t i = 0; i < entity_count; ++i)
+          {
+            slot_array[i] = i < handles.size() ? handles[i] : ComponentHandleBase::InvalidHandle();
+          }
+        }
+        element_list_[3] = raw_array;
+      }
+      else
+      {
+        element_list_[3] = nullptr;
+      }
+
+      // Further components of a type follow per slot, every slot ends with a link without an entity
+      element_sizes_[4] = system_.slot_types_.size();
+      for (size_t slot = 0; slot < system_.slot_types_.size(); ++slot)
+      {
+        element_sizes_[4] += system_.component_handles_[slot].overflow_count();
+      }
+      if (element_sizes_[4] != 0)
+      {
+        ComponentLink* raw_array = static_cast<ComponentLink*>(SnapshotPool::Instance().Allocate(
+          element_sizes_[4] * sizeof(ComponentLink)));
+        ComponentLink* slot_array = raw_array;
+        for (size_t slot = 0; slot < system_.slot_types_.size(); ++slot)
+        {
+          const ComponentLinks& links = system_.component_handles_[slot];
+          links.StoreOverflow(slot_array);
+          slot_array += links.overflow_count();
+          *slot_array++ = ComponentLink{ PS_SIZE_MAX, ComponentHandleBase::InvalidHandle() };
+        }
+        element_list_[4] = raw_array;
+      }
+      else
+      {
+        element_list_[4] = nullptr;
+      }
     }
   }
 }
\ No newline at end of file
@@ -30,8 +30,8 @@ namespace sulphur
       */
       void PrepareStore() override;
     public:
-      void* element_list_[3];//<! List of the data that needs to be stored, in this case the entity component data, generation and freelist which will be cut down later on
-      size_t element_sizes_[3];//<! The size of the arrays
+      void* element_list_[5];//<! List of the data that needs to be stored, in this case the generation, freelist, component masks, first component handles and further component handles which will be cut down later on
+      size_t element_sizes_[5];//<! The size of the arrays
       RewindStorage storage_;//<! The system that stores the obtained data
       EntitySystem& system_;//<! Reference to the system to obtain the data
     };
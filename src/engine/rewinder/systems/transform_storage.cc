@@ -1,5 +1,6 @@
 #include "engine/rewinder/systems/transform_storage.h"
 #include "engine/systems/components/transform_system.h"
+#include "engine/rewinder/snapshot_pool.h"
 namespace sulphur
 {
   namespace engine
@@ -8,7 +9,7 @@ namespace sulphur
     template<>
     inline void* Store(SparseHandle* buffer, size_t size)
     {
-      void* raw_array = foundation::Memory::Allocate(size * sizeof( SparseHandle ), 64);
+      void* raw_array = SnapshotPool::Instance().Allocate( size * sizeof( SparseHandle ) );
       memcpy_s(raw_array, size * sizeof( SparseHandle ), buffer, size * sizeof( SparseHandle ) );
       return raw_array;
     }
@@ -22,7 +23,7 @@ namespace sulphur
     template<>
     inline void* Store(DenseHandle* buffer, size_t size)
     {
-      void* raw_array = foundation::Memory::Allocate(size * sizeof( DenseHandle ), 64);
+      void* raw_array = SnapshotPool::Instance().Allocate( size * sizeof( DenseHandle ) );
       memcpy_s(raw_array, size * sizeof( DenseHandle ), buffer, size * sizeof( DenseHandle ) );
       return raw_array;
     }
@@ -34,17 +35,23 @@ namespace sulphur
     }
     //-------------------------------------------------------------------------
     template<>
-    inline void* Store( TransformSystem::TransformData* buffer, size_t size)
+    inline void* Store( TransformSystem::TransformHotData* buffer, size_t size)
     {      
-      void* raw_array = foundation::Memory::Allocate(size*sizeof( TransformSystem::TransformData ), 64);
-      memcpy_s(raw_array, size * sizeof( TransformSystem::TransformData ), buffer, size * sizeof( TransformSystem::TransformData ) );
+      void* raw_array = SnapshotPool::Instance().Allocate( size*sizeof( TransformSystem::TransformHotData ) );
+      memcpy_s(raw_array, size * sizeof( TransformSystem::TransformHotData ), buffer, size * sizeof( TransformSystem::TransformHotData ) );
       return raw_array;
     }
     //-------------------------------------------------------------------------
     template<>
-    inline void Restore( TransformSystem::TransformData* buffer, void* old, size_t size)
+    inline void Restore( TransformSystem::TransformHotData* buffer, void* old, size_t size)
     {
-       memcpy_s( buffer, size * sizeof( TransformSystem::TransformData ), old, size * sizeof( TransformSystem::TransformData ) );
+      memcpy_s( buffer, size * sizeof( TransformSystem::TransformHotData ), old, size * sizeof( TransformSystem::TransformHotData ) );
+
+      // The cold data isn't stored, so the cached inverse matrices don't belong to the restored frame
+      for (size_t i = 0; i < size; ++i)
+      {
+        buffer[i].flags |= static_cast<int>(TransformSystem::DirtyFlags::kWorldToLocal);
+      }
     }
     //-------------------------------------------------------------------------
     TransformRewindStorage::TransformRewindStorage(TransformSystem& system)
@@ -54,7 +61,7 @@ namespace sulphur
         reinterpret_cast<RewindStorageBase*>(this),
         StoreFunc<SparseHandle>(),
         StoreFunc<DenseHandle>(),
-        StoreFunc<TransformSystem::TransformData>()),
+        StoreFunc<TransformSystem::TransformHotData>()),
       system_(system)
     {
     }
@@ -65,6 +72,10 @@ namespace sulphur
       system_.sparse_array_.resize( storage.data[0].size );
       system_.dense_to_sparse_array_.resize( storage.data[1].size );
       system_.data_.Get()->resize(storage.data[2].size);
+
+      // Every transform may differ in the restored frame, so all consumers have to see them as changed
+      system_.changes_.MarkAll(storage.data[0].size);
+
       element_list_[0] = system_.sparse_array_.data();
       element_sizes_[0] = system_.sparse_array_.size();
       element_list_[1] = system_.dense_to_sparse_array_.data();
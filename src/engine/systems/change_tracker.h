@@ -0,0 +1,284 @@
+#pragma once
+
+#include <foundation/utils/type_definitions.h>
+#include <foundation/containers/vector.h>
+
+#include <EASTL/algorithm.h>
+
+#include <cinttypes>
+#include <cassert>
+
+namespace sulphur
+{
+  namespace engine
+  {
+    /**
+    * @class sulphur::engine::ChangeTracker
+    * @brief Keeps track of which components of a system changed, so consumers only have to visit those instead of polling every component.
+    * @details Components are identified by their sparse index. A mutation sets a single bit in a shared bitset, using one word per
+    *   64 components. Every consumer has its own bitset that works as its read cursor: when a consumer reads, the shared bits are
+    *   handed to all consumers first, so each consumer sees every change exactly once no matter how often the others read.
+    * @remarks Consumers have to check whether a changed index is still alive, as destroyed components aren't removed from the bitsets.
+    */
+    class ChangeTracker
+    {
+    public:
+      static constexpr size_t kInvalidConsumer = PS_SIZE_MAX; //!< Returned when no consumer is registered
+      static constexpr size_t kBitsPerWord = 64; //!< The amount of components that share a word in the bitsets
+
+      /**
+      * @brief Registers a consumer that reads the changes
+      * @remarks Only changes made after the registration are reported to the consumer
+      * @return (size_t) The identifier of the consumer
+      */
+      size_t AddConsumer();
+      /**
+      * @brief Unregisters a consumer, its identifier may be reused by the next registration
+      * @param[in] consumer (size_t) The identifier of the consumer
+      */
+      void RemoveConsumer(size_t consumer);
+
+      /**
+      * @brief Marks a component as changed for all consumers
+      * @param[in] index (size_t) The sparse index of the component
+      */
+      void MarkChanged(size_t index);
+      /**
+      * @brief Marks a range of components as changed for all consumers, e.g. after the data was replaced as a whole
+      * @param[in] count (size_t) The amount of components starting at sparse index 0
+      */
+      void MarkAll(size_t count);
+
+      /**
+      * @brief Checks if a component changed since the consumer last read it
+      * @param[in] consumer (size_t) The identifier of the consumer
+      * @param[in] index (size_t) The sparse index of the component
+      * @return (bool) Has the component changed?
+      */
+      bool IsChanged(size_t consumer, size_t index) const;
+
+      /**
+      * @brief Calls a function for every component that changed since the consumer last read and clears the changes of the consumer
+      * @param[in] consumer (size_t) The identifier of the consumer
+      * @param[in] func (Func&&) Function taking the sparse index of a changed component
+      * @remarks Words without any changes are skipped as a whole. Changes made from within the function are reported on the next read.
+      */
+      template<typename Func>
+      void ForEachChanged(size_t consumer, Func&& func);
+
+      /**
+      * @brief Clears the changes of a consumer without visiting them
+      * @param[in] consumer (size_t) The identifier of the consumer
+      */
+      void Clear(size_t consumer);
+      /**
+      * @brief Clears a single change of a consumer, e.g. one the consumer made itself
+      * @param[in] consumer (size_t) The identifier of the consumer
+      * @param[in] index (size_t) The sparse index of the component
+      */
+      void ClearChanged(size_t consumer, size_t index);
+
+    private:
+      /**
+      * @brief Hands the shared bits to the bitsets of all consumers and clears them
+      */
+      void Flush();
+
+      /**
+      * @brief Sets a bit in a bitset, growing the bitset if needed
+      * @param[in] bits (sulphur::foundation::Vector <uint64_t>&) The bitset
+      * @param[in] index (size_t) The bit to set
+      */
+      static void SetBit(foundation::Vector<uint64_t>& bits, size_t index);
+      /**
+      * @brief Tests a bit in a bitset
+      * @param[in] bits (const sulphur::foundation::Vector <uint64_t>&) The bitset
+      * @param[in] index (size_t) The bit to test
+      * @return (bool) Is the bit set?
+      */
+      static bool TestBit(const foundation::Vector<uint64_t>& bits, size_t index);
+
+      /**
+      * @struct sulphur::engine::ChangeTracker::Consumer
+      * @brief The changes that a consumer hasn't read yet
+      */
+      struct Consumer
+      {
+        foundation::Vector<uint64_t> bits; //!< The unread changes, one bit per sparse index
+        bool active; //!< Is the consumer registered?
+      };
+
+      foundation::Vector<uint64_t> pending_; //!< Changes that haven't been handed to the consumers yet
+      bool has_pending_ = false; //!< Are any bits set in sulphur::engine::ChangeTracker::pending_?
+      foundation::Vector<Consumer> consumers_; //!< The registered consumers, indexed by identifier
+    };
+
+    //-------------------------------------------------------------------------
+    inline size_t ChangeTracker::AddConsumer()
+    {
+      // Changes made before the registration belong to the other consumers
+      Flush();
+
+      for (size_t i = 0; i < consumers_.size(); ++i)
+      {
+        if (consumers_[i].active == false)
+        {
+          consumers_[i].bits.clear();
+          consumers_[i].active = true;
+          return i;
+        }
+      }
+
+      consumers_.push_back(Consumer{ foundation::Vector<uint64_t>(), true });
+      return consumers_.size() - 1;
+    }
+
+    //-------------------------------------------------------------------------
+    inline void ChangeTracker::RemoveConsumer(size_t consumer)
+    {
+      assert(consumer < consumers_.size() && consumers_[consumer].active == true);
+      consumers_[consumer].active = false;
+      consumers_[consumer].bits.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    inline void ChangeTracker::MarkChanged(size_t index)
+    {
+      SetBit(pending_, index);
+      has_pending_ = true;
+    }
+
+    //-------------------------------------------------------------------------
+    inline void ChangeTracker::MarkAll(size_t count)
+    {
+      if (count == 0)
+      {
+        return;
+      }
+
+      const size_t words = (count + kBitsPerWord - 1) / kBitsPerWord;
+      if (pending_.size() < words)
+      {
+        pending_.resize(words, 0);
+      }
+
+      for (size_t i = 0; i < words - 1; ++i)
+      {
+        pending_[i] = ~0ull;
+      }
+
+      const size_t tail = count % kBitsPerWord;
+      pending_[words - 1] |= tail == 0 ? ~0ull : (1ull << tail) - 1;
+      has_pending_ = true;
+    }
+
+    //-------------------------------------------------------------------------
+    inline bool ChangeTracker::IsChanged(size_t consumer, size_t index) const
+    {
+      assert(consumer < consumers_.size() && consumers_[consumer].active == true);
+      return TestBit(pending_, index) || TestBit(consumers_[consumer].bits, index);
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename Func>
+    inline void ChangeTracker::ForEachChanged(size_t consumer, Func&& func)
+    {
+      assert(consumer < consumers_.size() && consumers_[consumer].active == true);
+      Flush();
+
+      // Swapped out so reads by other consumers from within the function can't flush into the bits being visited
+      foundation::Vector<uint64_t> bits;
+      bits.swap(consumers_[consumer].bits);
+
+      for (size_t word = 0; word < bits.size(); ++word)
+      {
+        uint64_t mask = bits[word];
+        for (size_t bit = 0; mask != 0; ++bit, mask >>= 1)
+        {
+          if ((mask & 1) != 0)
+          {
+            func(word * kBitsPerWord + bit);
+          }
+        }
+      }
+
+      // Hand the storage back if nothing was marked in the meantime
+      if (consumers_[consumer].bits.empty() == true)
+      {
+        bits.clear();
+        bits.swap(consumers_[consumer].bits);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    inline void ChangeTracker::Clear(size_t consumer)
+    {
+      assert(consumer < consumers_.size() && consumers_[consumer].active == true);
+      Flush();
+      consumers_[consumer].bits.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    inline void ChangeTracker::ClearChanged(size_t consumer, size_t index)
+    {
+      assert(consumer < consumers_.size() && consumers_[consumer].active == true);
+      Flush();
+
+      foundation::Vector<uint64_t>& bits = consumers_[consumer].bits;
+      const size_t word = index / kBitsPerWord;
+      if (word < bits.size())
+      {
+        bits[word] &= ~(1ull << (index % kBitsPerWord));
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    inline void ChangeTracker::Flush()
+    {
+      if (has_pending_ == false)
+      {
+        return;
+      }
+
+      for (Consumer& consumer : consumers_)
+      {
+        if (consumer.active == false)
+        {
+          continue;
+        }
+
+        if (consumer.bits.size() < pending_.size())
+        {
+          consumer.bits.resize(pending_.size(), 0);
+        }
+
+        for (size_t i = 0; i < pending_.size(); ++i)
+        {
+          consumer.bits[i] |= pending_[i];
+        }
+      }
+
+      eastl::fill(pending_.begin(), pending_.end(), 0ull);
+      has_pending_ = false;
+    }
+
+    //-------------------------------------------------------------------------
+    inline void ChangeTracker::SetBit(foundation::Vector<uint64_t>& bits, size_t index)
+    {
+      const size_t word = index / kBitsPerWord;
+      if (word >= bits.size())
+      {
+        bits.resize(word + 1, 0);
+      }
+
+      bits[word] |= 1ull << (index % kBitsPerWord);
+    }
+
+    //-------------------------------------------------------------------------
+    inline bool ChangeTracker::TestBit(const foundation::Vector<uint64_t>& bits, size_t index)
+    {
+      const size_t word = index / kBitsPerWord;
+      return word < bits.size() && (bits[word] & (1ull << (index % kBitsPerWord))) != 0;
+    }
+  }
+}
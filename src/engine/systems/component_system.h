@@ -47,6 +47,13 @@ namespace sulphur
       * @remarks Reference doesn't matter here and might actually be slower than just a copy
       */
       virtual void Destroy(ComponentHandleBase handle) = 0;
+      /**
+      * @brief Makes room for a number of components that are about to be created in bulk
+      * @param[in] count (size_t) The amount of components that will be created
+      * @remarks Does nothing by default, systems that store their data contiguously override this
+      *   to grow their storage once instead of once per component
+      */
+      virtual void Reserve(size_t count);
     };
     
     //-------------------------------------------------------------------------
@@ -55,6 +62,11 @@ namespace sulphur
     {
     }
 
+    //-------------------------------------------------------------------------
+    inline void IComponentSystem::Reserve(size_t)
+    {
+    }
+
     //-------------------------------------------------------------------------
     template<typename ComponentT>
     inline ComponentT IComponentSystem::Create(Entity&)
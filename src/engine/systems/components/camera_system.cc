@@ -4,6 +4,7 @@
 #include "engine/application/application.h"
 #include "engine/rewinder/rewind_system.h"
 #include "engine/rewinder/system_stored_data.h"
+#include "engine/rewinder/snapshot_pool.h"
 
 #include <foundation/job/data_policy.h>
 #include <foundation/job/job.h>
@@ -26,7 +27,7 @@ namespace sulphur
     template<typename T>
     inline void* Store( T* buffer, size_t size )
     {
-      void* raw_array = foundation::Memory::Allocate( size * sizeof( T ), 64 );
+      void* raw_array = SnapshotPool::Instance().Allocate( size * sizeof( T ) );
       memcpy_s( raw_array, size * sizeof( T ), buffer, size * sizeof( T ) );
       return raw_array;
     }
@@ -449,6 +449,12 @@ namespace sulphur
       physics_service_->DestroyPhysicsBody(ent);
     }
 
+    //-------------------------------------------------------------------------
+    void ColliderSystem::Reserve(size_t count)
+    {
+      component_data_.data.Reserve(component_data_.data.size() + count);
+    }
+
     //-------------------------------------------------------------------------
     Entity ColliderSystem::GetEntity(ColliderComponent handle) const
     {
@@ -617,6 +617,10 @@ namespace sulphur
       * @see sulphur::engine::IComponentSystem::Destroy
       */
       void Destroy(ComponentHandleBase handle) override;
+      /**
+      * @see sulphur::engine::IComponentSystem::Reserve
+      */
+      void Reserve(size_t count) override;
 
       /**
       * @brief Retrieve the entity from the component by data index.
@@ -3,6 +3,8 @@
 #include "engine/application/application.h"
 #include "engine/rewinder/rewind_system.h"
 #include "engine/rewinder/system_stored_data.h"
+#include "engine/rewinder/snapshot_pool.h"
+
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace sulphur
@@ -31,7 +33,7 @@ namespace sulphur
     template<>
     inline void* Store( foundation::Color* buffer, size_t size )
     {
-      void* raw_array = foundation::Memory::Allocate( size * sizeof( foundation::Color ), 64 );
+      void* raw_array = SnapshotPool::Instance().Allocate( size * sizeof( foundation::Color ) );
       memcpy_s( raw_array, size * sizeof( foundation::Color ), buffer, size * sizeof( foundation::Color ) );
       return raw_array;
     }
@@ -45,7 +47,7 @@ namespace sulphur
     template<>
     inline void* Store( float* buffer, size_t size )
     {
-      void* raw_array = foundation::Memory::Allocate( size * sizeof( float ), 64 );
+      void* raw_array = SnapshotPool::Instance().Allocate( size * sizeof( float ) );
       memcpy_s( raw_array, size * sizeof( float ), buffer, size * sizeof( float ) );
       return raw_array;
     }
@@ -59,7 +61,7 @@ namespace sulphur
     template<>
     inline void* Store( LightType* buffer, size_t size )
     {
-      void* raw_array = foundation::Memory::Allocate( size * sizeof( LightType ), 64 );
+      void* raw_array = SnapshotPool::Instance().Allocate( size * sizeof( LightType ) );
       memcpy_s( raw_array, size * sizeof( LightType ), buffer, size * sizeof( LightType ) );
       return raw_array;
     }
@@ -123,6 +123,10 @@ namespace sulphur
       void Destroy(ComponentHandleBase handle) override {
         component_data_.data.Remove(handle);
       };
+
+      void Reserve(size_t count) override {
+        component_data_.data.Reserve(component_data_.data.size() + count);
+      };
       
       //----------------------------------------Component functions------------------------------------------------------
       /**
@@ -2,6 +2,7 @@
 
 #include "engine/systems/components/transform_system.h"
 #include "engine/systems/components/camera_system.h"
+#include "engine/core/component_view.h"
 
 #include "engine/application/application.h"
 #include "engine/assets/asset_system.h"
@@ -12,6 +13,7 @@
 #include <foundation/job/data_policy.h>
 #include <foundation/job/job.h>
 #include <foundation/job/job_graph.h>
+#include <foundation/math/transform_kernels.h>
 #include <graphics/platform/pipeline_state.h>
 
 #include <lua-classes/mesh_render_system.lua.cc>
@@ -31,6 +33,7 @@ namespace sulphur
     {
       World& world = app.GetService<WorldProviderSystem>().GetWorld();
 
+      world_ = &world;
       camera_system_ = &world.GetComponent<CameraSystem>();
       tranform_system_ = &world.GetComponent<TransformSystem>();
       renderer_ = &app.platform_renderer();
@@ -103,6 +106,12 @@ namespace sulphur
       }
     }
 
+    //------------------------------------------------------------------------------------------------------
+    void MeshRenderSystem::Reserve(size_t count)
+    {
+      component_data_.data.Reserve(component_data_.data.size() + count);
+    }
+
     //------------------------------------------------------------------------------------------------------
     void MeshRenderSystem::RenderMeshes()
     {
@@ -114,6 +123,8 @@ namespace sulphur
 
       // TODO: Set per frame data ?
       foundation::Vector<CameraComponent> cameras = camera_system_->GetCameras();
+      ComponentView<MeshRenderComponent, TransformComponent> view =
+        world_->View<MeshRenderComponent, TransformComponent>();
 
       // IF I CAN FIGURE OUT WHAT MESHES RENDER ON THE SAME CAMERA, I CAN MODIFY THE MVP AND USE THE SAME STATE
       for (CameraComponent& camera : cameras)
@@ -129,26 +140,25 @@ namespace sulphur
         // TODO: Render batches for this camera
         // -> Use Material passes
 
-        for (size_t i = 0; i < component_data_.data.size(); ++i)
+        view.ForEach([&](Entity, size_t i, const TransformSystem::ViewElement& transform)
         {
-          TransformComponent transform =
-            component_data_.entity[i].Get<TransformComponent>();
-
           // Layer culling
-          if (component_data_.visible[i] == false || camera.GetLayerMask().ContainsLayer(transform.GetSortingLayer()) == false)
+          if (component_data_.visible[i] == false || camera.GetLayerMask().ContainsLayer(transform.sorting_layer) == false)
           {
-            continue;
+            return;
           }
 
           // Frustum culling
+          glm::vec3 world_scale;
+          foundation::DecomposeTransforms(&transform.local_to_world, nullptr, nullptr, &world_scale, 1);
           const foundation::Sphere bounding_sphere = component_data_.mesh[i]->bounding_sphere().
-            Transform(transform.GetWorldPosition(), transform.GetWorldScale());
+            Transform(glm::vec3(transform.local_to_world[3]), world_scale);
           if(camera.GetFrustum().Intersects(bounding_sphere) == false)
           {
-            continue;
+            return;
           }
 
-          renderer_->SetModelMatrix(transform.GetLocalToWorld());
+          renderer_->SetModelMatrix(transform.local_to_world);
 
           renderer_->SetMesh(component_data_.mesh[i]);
 
@@ -190,7 +200,7 @@ namespace sulphur
               renderer_->Draw(offset.size, offset.offset);
             }
           }
-        }
+        });
       }
     }
 
@@ -16,6 +16,7 @@ namespace sulphur
 {
   namespace engine 
   {
+    class World;
     class CameraSystem;
     class TransformSystem;
     class MeshRenderSystem;
@@ -204,6 +205,40 @@ namespace sulphur
       * @see sulphur::engine::IComponentSystem::Destroy
       */
       void Destroy(ComponentHandleBase handle) override;
+      /**
+      * @see sulphur::engine::IComponentSystem::Reserve
+      */
+      void Reserve(size_t count) override;
+
+      using ViewElement = size_t; //!< Components are yielded to views as their index in component_data_
+
+      /**
+      * @see sulphur::engine::ComponentView
+      */
+      void PrepareView() {}
+      /**
+      * @see sulphur::engine::ComponentView
+      * @return (size_t) The amount of mesh renderers
+      */
+      size_t ViewCount() const { return component_data_.data.size(); }
+      /**
+      * @see sulphur::engine::ComponentView
+      * @param[in] index (size_t) The data index of the component
+      * @return (sulphur::engine::Entity) The entity of the component
+      */
+      Entity ViewEntity(size_t index) const { return component_data_.entity[index]; }
+      /**
+      * @see sulphur::engine::ComponentView
+      * @param[in] handle (sulphur::engine::ComponentHandleBase) The component to look-up
+      * @return (size_t) The data index of the component
+      */
+      size_t ViewIndex(ComponentHandleBase handle) const { return component_data_.data.GetDataIndex(handle); }
+      /**
+      * @see sulphur::engine::ComponentView
+      * @param[in] index (size_t) The data index of the component
+      * @return (size_t) The data index of the component
+      */
+      ViewElement ViewAt(size_t index) const { return index; }
 
       /**
       * @brief Create a new mesh renderer component for this entity and also creates a TransformComponent if it wasn't attached yet
@@ -300,6 +335,7 @@ namespace sulphur
       */
       void UpdateMaterials(foundation::Vector<MaterialHandle>& material, size_t expected_count);
 
+      World* world_; //!< The world this system is a part of
       CameraSystem* camera_system_;
       TransformSystem* tranform_system_;
       IRenderer* renderer_;
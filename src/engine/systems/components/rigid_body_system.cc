@@ -5,6 +5,7 @@
 #include "engine/systems/components/transform_system.h"
 #include "engine/systems/components/collider_system.h"
 #include "engine/rewinder/system_stored_data.h"
+#include "engine/rewinder/snapshot_pool.h"
 #include "engine/rewinder/rewind_system.h"
 
 #include <foundation/logging/logger.h>
@@ -42,7 +43,7 @@ namespace sulphur
     {
 
       PhysicsData* raw_array = reinterpret_cast<PhysicsData*>(
-        foundation::Memory::Allocate( size * sizeof( PhysicsData ), 64 ));
+        SnapshotPool::Instance().Allocate( size * sizeof( PhysicsData ) ));
       for ( size_t i = 0; i < size; ++i )
       {
         raw_array[i] =
@@ -89,7 +90,7 @@ namespace sulphur
     template<>
     inline void* Store( Entity* buffer, size_t size )
     {
-      void* raw_array = foundation::Memory::Allocate( size * sizeof( Entity ), 64 );
+      void* raw_array = SnapshotPool::Instance().Allocate( size * sizeof( Entity ) );
       memcpy_s( raw_array, size * sizeof( Entity ), buffer, size * sizeof( Entity ) );
       return raw_array;
     }
@@ -166,6 +167,12 @@ namespace sulphur
       physics_service_->DestroyPhysicsBody(ent);
     }
 
+    //-------------------------------------------------------------------------
+    void RigidBodySystem::Reserve(size_t count)
+    {
+      component_data_.data.Reserve(component_data_.data.size() + count);
+    }
+
     //-------------------------------------------------------------------------
     RigidBodyComponent::RigidBodyComponent() :
       system_(nullptr)
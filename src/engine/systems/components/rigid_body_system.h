@@ -326,6 +326,10 @@ namespace sulphur
       * @see sulphur::engine::IComponentSystem::Destroy
       */
       void Destroy(ComponentHandleBase handle) override;
+      /**
+      * @see sulphur::engine::IComponentSystem::Reserve
+      */
+      void Reserve(size_t count) override;
 
       /**
       * @see sulphur::engine::IComponentSystem::Create
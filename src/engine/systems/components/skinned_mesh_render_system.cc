@@ -1,6 +1,7 @@
 #include "skinned_mesh_render_system.h"
 
 #include "engine/core/entity_system.h"
+#include "engine/core/component_view.h"
 #include "engine/systems/components/transform_system.h"
 #include "engine/systems/components/camera_system.h"
 
@@ -19,17 +20,90 @@
 #include <foundation/job/job_graph.h>
 #include <graphics/platform/pipeline_state.h>
 #include <foundation/memory/memory.h>
+#include <foundation/math/transform_kernels.h>
+#include <foundation/utils/shapes.h>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/transform.hpp>
 
+#include <EASTL/algorithm.h>
+#include <cfloat>
+#include <cstring>
+
 #include <lua-classes/skinned_mesh_render_system.lua.cc>
 
 namespace sulphur
 {
   namespace engine
   {
+    namespace
+    {
+      const unsigned int kMaxCursorSteps = 4; //!< The amount of keys a cursor steps forward before searching the remaining keys
+
+      /**
+      * @brief Finds the last key before a playback time, starting from the key that was found the previous time.
+      * @param[in] keyframes (const sulphur::foundation::Vector<sulphur::engine::Keyframe<T>>&) The keys, sorted by time. Can't be empty.
+      * @param[in] playback_time (float) The playback time in ticks.
+      * @param[in,out] cursor (unsigned int&) The key that was found the previous time, updated to the key that is found now.
+      * @returns (unsigned int) The index of the key, UINT_MAX if no key comes before the playback time.
+      * @remarks Playing forward finds the key in a few steps. Larger jumps and jumps back, like seeking or
+      *          looping, fall back to a binary search.
+      */
+      template<typename T>
+      unsigned int FindKey(
+        const foundation::Vector<Keyframe<T>>& keyframes,
+        float playback_time,
+        unsigned int& cursor)
+      {
+        const unsigned int count = static_cast<unsigned int>(keyframes.size());
+        unsigned int index = cursor < count ? cursor : 0;
+
+        const Keyframe<T>* first = keyframes.begin();
+        const Keyframe<T>* last = keyframes.begin() + index;
+
+        if (keyframes[index].time < playback_time)
+        {
+          for (unsigned int step = 0; step < kMaxCursorSteps; ++step)
+          {
+            if (index + 1 == count || keyframes[index + 1].time >= playback_time)
+            {
+              cursor = index;
+              return index;
+            }
+            ++index;
+          }
+
+          first = keyframes.begin() + index + 1;
+          last = keyframes.end();
+        }
+
+        const Keyframe<T>* next = eastl::lower_bound(first, last, playback_time,
+          [](const Keyframe<T>& key, float time) { return key.time < time; });
+
+        if (next == keyframes.begin())
+        {
+          cursor = 0;
+          return UINT_MAX;
+        }
+
+        cursor = static_cast<unsigned int>(next - keyframes.begin()) - 1;
+        return cursor;
+      }
+
+      /**
+      * @brief Combines the asset ids of a skeleton and an animation into the key of their remap table.
+      * @param[in] skeleton (const sulphur::engine::SkeletonHandle&) The skeleton.
+      * @param[in] animation (const sulphur::engine::AnimationHandle&) The animation.
+      * @returns (uint64_t) The key.
+      */
+      uint64_t RemapKey(const SkeletonHandle& skeleton, const AnimationHandle& animation)
+      {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(static_cast<int>(skeleton))) << 32) |
+          static_cast<uint32_t>(static_cast<int>(animation));
+      }
+    }
+
     //------------------------------------------------------------------------------------------------------
     SkinnedMeshRenderSystem::SkinnedMeshRenderSystem() :
       IComponentSystem("SkinnedMeshRenderSystem")
@@ -41,9 +115,11 @@ namespace sulphur
     {
       World& world = app.GetService<WorldProviderSystem>().GetWorld();
 
+      world_ = &world;
       camera_system_ = &(world.GetComponent<CameraSystem>());
       tranform_system_ = &(world.GetComponent<TransformSystem>());
       renderer_ = &(app.platform_renderer());
+      workers_ = &(app.workers());
 
       { // SkinnedMeshRenderSystem Update Animation States Job, starts after MeshRenderSystem Render Meshes job
         const auto function = [](SkinnedMeshRenderSystem& system)
@@ -85,6 +161,15 @@ namespace sulphur
     {
       // Release all asset handles
       component_data_.data.Clear();
+      remaps_.clear();
+      remap_lookup_.clear();
+      free_remaps_.clear();
+      animation_updates_.clear();
+      lod_cameras_.clear();
+      pose_scratch_.clear();
+      pose_cache_.clear();
+      shared_poses_.clear();
+      pose_cache_stats_ = PoseCacheStats();
     }
 
     //------------------------------------------------------------------------------------------------------
@@ -109,7 +194,20 @@ namespace sulphur
           0.0f,
           false,
           1.0f,
-          foundation::Vector<glm::mat4>()
+          foundation::Vector<glm::mat4>(),
+          SkeletonAnimationRemap::kNone,
+          foundation::Vector<KeyframeCursor>(),
+          0.0f,
+          2u,
+          0.0f,
+          foundation::Vector<bool>(),
+          false,
+          false,
+          foundation::Vector<AnimationLayer>(),
+          foundation::Vector<AnimationLayer>(),
+          0.0f,
+          SkeletonAnimationRemap::kNone,
+          glm::mat4(1.0f)
         )
       );
     }
@@ -123,10 +221,61 @@ namespace sulphur
       }
     }
 
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderSystem::Reserve(size_t count)
+    {
+      component_data_.data.Reserve(component_data_.data.size() + count);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    size_t SkinnedMeshRenderSystem::ViewCount() const
+    {
+      return component_data_.data.size();
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    Entity SkinnedMeshRenderSystem::ViewEntity(size_t index) const
+    {
+      return component_data_.entity[index];
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    size_t SkinnedMeshRenderSystem::ViewIndex(ComponentHandleBase handle) const
+    {
+      return component_data_.data.GetDataIndex(handle);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    SkinnedMeshRenderSystem::ViewElement SkinnedMeshRenderSystem::ViewAt(size_t index) const
+    {
+      return index;
+    }
+
     //------------------------------------------------------------------------------------------------------
     void SkinnedMeshRenderSystem::UpdateAnimationStates()
     {
-      for (int i = 0; i < component_data_.data.size(); ++i)
+      // Shared poses only live for a single frame
+      pose_cache_.clear();
+      pose_cache_stats_ = PoseCacheStats();
+
+      // Every component is tested against what all cameras see
+      lod_cameras_.clear();
+      foundation::Vector<CameraComponent> cameras = camera_system_->GetCameras();
+      for (CameraComponent& camera : cameras)
+      {
+        lod_cameras_.push_back({ 
+          &camera.GetFrustum(), 
+          camera.GetTransform().GetWorldPosition(), 
+          camera.GetLayerMask() 
+        });
+      }
+
+      EvictRemaps();
+
+      const unsigned int frame = foundation::Frame::frame_count();
+
+      world_->View<SkinnedMeshRenderComponent, TransformComponent>().ForEach(
+        [this, frame](Entity entity, size_t i, const TransformSystem::ViewElement& transform)
       {
         if (component_data_.is_playing[i] == true && component_data_.playback_speed[i] > 0.0f)
         {
@@ -134,10 +283,18 @@ namespace sulphur
             foundation::Frame::delta_time() * component_data_.playback_speed[i];
 
           SkeletonHandle skeleton = component_data_.skeleton[i];
+
+          // Finished cross fades replace the animation, so this goes first
+          UpdateAnimationLayers(i, skeleton);
+
           AnimationHandle animation = component_data_.animation[i];
 
           if (skeleton.IsValid() && animation.IsValid())
           {
+            // Handles may have been changed without going through the component
+            unsigned int& remap = component_data_.animation_remap[i];
+            remap = UseRemap(remap, skeleton, animation);
+
             component_data_.local_playback_time_in_ticks[i] =
               std::fmodf(
                 animation->ticks_per_second() * component_data_.global_playback_time_in_seconds[i],
@@ -145,15 +302,263 @@ namespace sulphur
               );
 
             component_data_.bone_matrices[i].resize(skeleton->bones().size());
+            component_data_.keyframe_cursors[i].resize(animation->animation_channels().size());
+
+            // Level of detail, based on the nearest camera that sees the component
+            bool visible = lod_cameras_.empty();
+            float distance = lod_cameras_.empty() == true ? 0.0f : FLT_MAX;
 
-            CalculateBoneTransform(
-              i, 
-              skeleton->root_node_index(), 
-              component_data_.entity[i].Get<TransformComponent>().GetLocalToWorld()
+            const MeshHandle& mesh = component_data_.mesh[i];
+            if (component_data_.visible[i] == true && mesh.IsValid() == true)
+            {
+              glm::vec3 world_scale;
+              foundation::DecomposeTransforms(&transform.local_to_world, nullptr, nullptr, &world_scale, 1);
+              const foundation::Sphere bounding_sphere = mesh->bounding_sphere().
+                Transform(glm::vec3(transform.local_to_world[3]), world_scale);
+
+              for (LodCamera& camera : lod_cameras_)
+              {
+                if (camera.layer_mask.ContainsLayer(transform.sorting_layer) == true &&
+                  camera.frustum->Intersects(bounding_sphere) == true)
+                {
+                  visible = true;
+                  distance = eastl::min(distance, 
+                    glm::length(bounding_sphere.center - camera.position) - bounding_sphere.radius);
+                }
+              }
+            }
+
+            const bool was_culled = component_data_.animation_culled[i];
+            component_data_.animation_culled[i] = visible == false;
+
+            if (visible == false && component_data_.animate_when_culled[i] == false)
+            {
+              UnsharePose(i);
+              return;
+            }
+
+            // Components that come into view are updated right away, the others are spread over the frames
+            const float lod_distance = component_data_.lod_distance[i];
+            if (visible == false || (was_culled == false && lod_distance > 0.0f && distance > lod_distance))
+            {
+              if (IsLodUpdateFrame(frame, entity, component_data_.lod_update_interval[i]) == false)
+              {
+                UnsharePose(i);
+                return;
+              }
+            }
+
+            const float bone_cull_distance = component_data_.bone_cull_distance[i];
+            const bool skip_optional_bones = bone_cull_distance > 0.0f && distance > bone_cull_distance;
+
+            // The pose only depends on the remap table and the playback time, unless more is blended in
+            const float pose_cache_step = component_data_.pose_cache_step[i] * animation->ticks_per_second();
+            bool shares_pose = pose_cache_step > 0.0f &&
+              skip_optional_bones == false &&
+              component_data_.cross_fades[i].empty() == true;
+
+            for (const AnimationLayer& layer : component_data_.animation_layers[i])
+            {
+              shares_pose = shares_pose == true && 
+                (layer.weight <= 0.0f || layer.remap == SkeletonAnimationRemap::kNone);
+            }
+
+            unsigned int shared_pose = SkeletonAnimationRemap::kNone;
+            if (shares_pose == true)
+            {
+              // Rounding the playback time down lets components that are close in time share a pose. Components
+              // that evaluate their own pose, because of blending or bone culling, keep the exact playback time.
+              float& playback_time = component_data_.local_playback_time_in_ticks[i];
+              playback_time = std::floor(playback_time / pose_cache_step) * pose_cache_step;
+
+              uint32_t playback_time_bits;
+              memcpy(&playback_time_bits, &component_data_.local_playback_time_in_ticks[i], sizeof(uint32_t));
+              const uint64_t key = static_cast<uint64_t>(remap) << 32 | playback_time_bits;
+
+              ++pose_cache_stats_.lookups;
+              foundation::HashMap<uint64_t, unsigned int>::iterator it = pose_cache_.find(key);
+              const bool hit = it != pose_cache_.end();
+
+              if (hit == true)
+              {
+                ++pose_cache_stats_.hits;
+              }
+              else
+              {
+                // The first component to need the pose evaluates it for all the others
+                shared_pose = static_cast<unsigned int>(pose_cache_.size());
+                it = pose_cache_.insert(eastl::make_pair(key, shared_pose)).first;
+
+                // Sized when it is evaluated, the components that keep last frame's pose copy it first
+                if (shared_poses_.size() <= shared_pose)
+                {
+                  shared_poses_.resize(shared_pose + 1);
+                }
+              }
+
+              // The component renders the shared pose, placed by the renderer as the bone matrices are bound
+              component_data_.shared_pose[i] = it->second;
+              component_data_.bone_space[i] = remaps_[remap].inverse_root * transform.local_to_world;
+
+              if (hit == true)
+              {
+                return;
+              }
+            }
+            else
+            {
+              component_data_.shared_pose[i] = SkeletonAnimationRemap::kNone;
+            }
+
+            animation_updates_.push_back({ 
+              static_cast<unsigned int>(i), 
+              transform.local_to_world, 
+              skip_optional_bones,
+              shared_pose
+            });
+          }
+          else
+          {
+            UnsharePose(i);
+          }
+        }
+        else
+        {
+          UnsharePose(i);
+        }
+      });
+
+      // Every component only writes its own bone matrices and cursors, so the batches are independent
+      const size_t batch_count = (animation_updates_.size() + kAnimationBatchSize - 1) / kAnimationBatchSize;
+      if (pose_scratch_.size() < batch_count)
+      {
+        pose_scratch_.resize(batch_count);
+      }
+
+      const auto calculate_batch = [this](size_t batch)
+      {
+        const size_t first = batch * kAnimationBatchSize;
+        const size_t last = eastl::min(first + kAnimationBatchSize, animation_updates_.size());
+
+        for (size_t i = first; i < last; ++i)
+        {
+          const AnimationUpdate& update = animation_updates_[i];
+
+          // Shared poses are kept in model space, every user applies its own transform
+          if (update.shared_pose != SkeletonAnimationRemap::kNone)
+          {
+            foundation::Vector<glm::mat4>& shared_pose = shared_poses_[update.shared_pose];
+            shared_pose.resize(component_data_.skeleton[update.component_index]->bones().size());
+            CalculateBoneTransforms(
+              update.component_index,
+              glm::mat4(1.0f),
+              glm::mat4(1.0f),
+              update.skip_optional_bones,
+              pose_scratch_[batch],
+              shared_pose
             );
+            continue;
           }
+
+          CalculateBoneTransforms(
+            update.component_index,
+            update.local_to_world,
+            remaps_[component_data_.animation_remap[update.component_index]].inverse_root,
+            update.skip_optional_bones,
+            pose_scratch_[batch],
+            component_data_.bone_matrices[update.component_index]
+          );
         }
+      };
+
+      if (batch_count > 1)
+      {
+        workers_->Dispatch(batch_count, calculate_batch);
+        workers_->Wait();
       }
+      else if (batch_count == 1)
+      {
+        calculate_batch(0);
+      }
+
+      animation_updates_.clear();
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderSystem::UnsharePose(size_t component_index)
+    {
+      GetBoneMatrices(component_index);
+      component_data_.shared_pose[component_index] = SkeletonAnimationRemap::kNone;
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderSystem::UpdateAnimationLayers(size_t component_index, const SkeletonHandle& skeleton)
+    {
+      const float delta_time = foundation::Frame::delta_time();
+
+      foundation::Vector<AnimationLayer>& cross_fades = component_data_.cross_fades[component_index];
+      for (size_t i = cross_fades.size(); i > 0; --i)
+      {
+        UpdateAnimationLayer(cross_fades[i - 1], skeleton, delta_time);
+      }
+
+      // A cross fade that is fully blended in hides the animation and the older cross fades
+      for (size_t i = cross_fades.size(); i > 0; --i)
+      {
+        AnimationLayer& finished = cross_fades[i - 1];
+        if (finished.weight < 1.0f)
+        {
+          continue;
+        }
+
+        component_data_.animation[component_index] = finished.animation;
+        component_data_.animation_remap[component_index] = finished.remap;
+        component_data_.global_playback_time_in_seconds[component_index] = finished.playback_time_in_seconds;
+        component_data_.playback_speed[component_index] = finished.playback_speed;
+        component_data_.keyframe_cursors[component_index].swap(finished.keyframe_cursors);
+
+        cross_fades.erase(cross_fades.begin(), cross_fades.begin() + i);
+        break;
+      }
+
+      for (AnimationLayer& layer : component_data_.animation_layers[component_index])
+      {
+        UpdateAnimationLayer(layer, skeleton, delta_time);
+      }
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderSystem::UpdateAnimationLayer(
+      AnimationLayer& layer, 
+      const SkeletonHandle& skeleton, 
+      float delta_time)
+    {
+      layer.playback_time_in_seconds += delta_time * layer.playback_speed;
+
+      if (layer.weight < layer.target_weight)
+      {
+        layer.weight = eastl::min(layer.weight + layer.fade_speed * delta_time, layer.target_weight);
+      }
+      else if (layer.weight > layer.target_weight)
+      {
+        layer.weight = eastl::max(layer.weight - layer.fade_speed * delta_time, layer.target_weight);
+      }
+
+      const AnimationHandle& animation = layer.animation;
+      if (skeleton.IsValid() == false || animation.IsValid() == false)
+      {
+        layer.remap = SkeletonAnimationRemap::kNone;
+        return;
+      }
+
+      layer.remap = UseRemap(layer.remap, skeleton, animation);
+
+      layer.playback_time_in_ticks = std::fmodf(
+        animation->ticks_per_second() * layer.playback_time_in_seconds,
+        animation->duration()
+      );
+
+      layer.keyframe_cursors.resize(animation->animation_channels().size());
     }
 
     //------------------------------------------------------------------------------------------------------
@@ -166,6 +571,8 @@ namespace sulphur
       }
 
       foundation::Vector<CameraComponent> cameras = camera_system_->GetCameras();
+      ComponentView<SkinnedMeshRenderComponent, TransformComponent> view =
+        world_->View<SkinnedMeshRenderComponent, TransformComponent>();
 
       for (CameraComponent& camera : cameras)
       {
@@ -178,13 +585,20 @@ namespace sulphur
           camera.GetDepthBuffer(),
           camera.GetRenderTarget());
 
-        for (size_t i = 0; i < component_data_.data.size(); ++i)
+        view.ForEach([&](Entity, size_t i, const TransformSystem::ViewElement& transform)
         {
-          TransformComponent transform = component_data_.entity[i].Get<TransformComponent>();
-          
-          renderer_->SetModelMatrix(transform.GetLocalToWorld());
+          renderer_->SetModelMatrix(transform.local_to_world);
           renderer_->SetMesh(component_data_.mesh[i]);
-          renderer_->SetBoneMatrices(component_data_.bone_matrices[i]);
+
+          const unsigned int shared_pose = component_data_.shared_pose[i];
+          if (shared_pose == SkeletonAnimationRemap::kNone)
+          {
+            renderer_->SetBoneMatrices(component_data_.bone_matrices[i]);
+          }
+          else
+          {
+            renderer_->SetBoneMatrices(shared_poses_[shared_pose], component_data_.bone_space[i]);
+          }
         
           foundation::Vector<MaterialHandle>& materials = component_data_.materials[i];
           size_t submesh_count = component_data_.mesh[i]->GetSubmeshCount();
@@ -236,7 +650,7 @@ namespace sulphur
               renderer_->Draw(offset.size, offset.offset);
             }
           }
-        }
+        });
       }
     }
 
@@ -246,6 +660,26 @@ namespace sulphur
       return component_data_;
     }
 
+    //------------------------------------------------------------------------------------------------------
+    const SkinnedMeshRenderSystem::PoseCacheStats& SkinnedMeshRenderSystem::pose_cache_stats() const
+    {
+      return pose_cache_stats_;
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    const foundation::Vector<glm::mat4>& SkinnedMeshRenderSystem::GetBoneMatrices(size_t component_index)
+    {
+      foundation::Vector<glm::mat4>& bone_matrices = component_data_.bone_matrices[component_index];
+      const unsigned int shared_pose = component_data_.shared_pose[component_index];
+      if (shared_pose != SkeletonAnimationRemap::kNone)
+      {
+        const foundation::Vector<glm::mat4>& pose = shared_poses_[shared_pose];
+        bone_matrices.resize(pose.size());
+        foundation::MultiplyAffine(component_data_.bone_space[component_index], pose.data(), bone_matrices.data(), pose.size());
+      }
+      return bone_matrices;
+    }
+
     //------------------------------------------------------------------------------------------------------
     SkinnedMeshRenderComponent::SkinnedMeshRenderComponent() :
       system_(nullptr)
@@ -514,6 +948,11 @@ namespace sulphur
         Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kAnimation)>(*this);
 
       animation = animation_handle;
+      system_->AssignRemap(*this);
+
+      // Setting the animation cuts any cross fade short
+      system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kCrossFades)>(*this).clear();
     }
 
     //------------------------------------------------------------------------------------------------------
@@ -544,6 +983,11 @@ namespace sulphur
         Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kSkeleton)>(*this);
 
       skeleton = skeleton_handle;
+      system_->AssignRemap(*this);
+
+      // Bone indices of the previous skeleton mean nothing to the new one
+      system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kOptionalBones)>(*this).clear();
     }
 
     //------------------------------------------------------------------------------------------------------
@@ -653,98 +1097,655 @@ namespace sulphur
     }
 
     //------------------------------------------------------------------------------------------------------
-    const foundation::Vector<glm::mat4>& SkinnedMeshRenderComponent::GetBoneMatrices() const
+    void SkinnedMeshRenderComponent::SetLodDistance(float distance)
+    {
+      float& lod_distance = system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kLodDistance)>(*this);
+
+      lod_distance = eastl::max(distance, 0.0f);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    float SkinnedMeshRenderComponent::GetLodDistance() const
+    {
+      return system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kLodDistance)>(*this);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::SetLodUpdateInterval(int frames)
+    {
+      unsigned int& interval = system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kLodUpdateInterval)>(*this);
+
+      interval = static_cast<unsigned int>(eastl::max(frames, 1));
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    int SkinnedMeshRenderComponent::GetLodUpdateInterval() const
+    {
+      return static_cast<int>(system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kLodUpdateInterval)>(*this));
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::SetBoneCullDistance(float distance)
+    {
+      float& bone_cull_distance = system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kBoneCullDistance)>(*this);
+
+      bone_cull_distance = eastl::max(distance, 0.0f);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    float SkinnedMeshRenderComponent::GetBoneCullDistance() const
+    {
+      return system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kBoneCullDistance)>(*this);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::SetBoneOptional(foundation::String bone_name, bool optional)
+    {
+      const SkeletonHandle skeleton = GetSkeleton();
+      if (skeleton.IsValid() == false)
+      {
+        PS_LOG(Warning, "Can't mark bone %s as optional without a skeleton", bone_name.c_str());
+        return;
+      }
+
+      const auto bone = skeleton->bone_names().find(bone_name);
+      if (bone == skeleton->bone_names().end())
+      {
+        PS_LOG(Warning, "The skeleton has no bone named %s", bone_name.c_str());
+        return;
+      }
+
+      foundation::Vector<bool>& optional_bones = system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kOptionalBones)>(*this);
+
+      if (optional_bones.size() < skeleton->bones().size())
+      {
+        optional_bones.resize(skeleton->bones().size(), false);
+      }
+
+      optional_bones[bone->second] = optional;
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    bool SkinnedMeshRenderComponent::IsBoneOptional(foundation::String bone_name) const
+    {
+      const SkeletonHandle skeleton = GetSkeleton();
+      if (skeleton.IsValid() == false)
+      {
+        return false;
+      }
+
+      const auto bone = skeleton->bone_names().find(bone_name);
+      const foundation::Vector<bool>& optional_bones = system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kOptionalBones)>(*this);
+
+      return bone != skeleton->bone_names().end() &&
+        bone->second < optional_bones.size() &&
+        optional_bones[bone->second] == true;
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::SetAnimateWhenCulled(bool animate_when_culled)
+    {
+      bool& animate = system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kAnimateWhenCulled)>(*this);
+
+      animate = animate_when_culled;
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    bool SkinnedMeshRenderComponent::AnimatesWhenCulled() const
+    {
+      return system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kAnimateWhenCulled)>(*this);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    bool SkinnedMeshRenderComponent::IsAnimationCulled() const
+    {
+      return system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kAnimationCulled)>(*this);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::SetPoseCacheStep(float step)
+    {
+      float& pose_cache_step = system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kPoseCacheStep)>(*this);
+
+      pose_cache_step = eastl::max(step, 0.0f);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    float SkinnedMeshRenderComponent::GetPoseCacheStep() const
     {
       return system_->data().data.
-        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kBoneMatrices)>(*this);
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kPoseCacheStep)>(*this);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::CrossFade(AnimationHandle animation_handle, float duration)
+    {
+      if (duration <= 0.0f || GetAnimation().IsValid() == false)
+      {
+        SetAnimation(animation_handle);
+        SetPlaybackTime(0.0f);
+        return;
+      }
+
+      AnimationLayer cross_fade;
+      cross_fade.animation = animation_handle;
+      cross_fade.target_weight = 1.0f;
+      cross_fade.fade_speed = 1.0f / duration;
+
+      system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kCrossFades)>(*this).push_back(cross_fade);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::CrossFade(ScriptableAsset* animation, float duration)
+    {
+      if (animation->type() != ScriptableAsset::AssetTypes::kAnimation)
+      {
+        return;
+      }
+
+      BaseAssetHandle* h = animation->GetHandle();
+      AnimationHandle* m = static_cast<AnimationHandle*>(h);
+
+      CrossFade(*m, duration);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    int SkinnedMeshRenderComponent::AddLayer(AnimationHandle animation_handle, float weight)
+    {
+      if (animation_handle.IsValid() == false)
+      {
+        PS_LOG(Warning, "Can't add an animation layer without a valid animation");
+        return -1;
+      }
+
+      foundation::Vector<AnimationLayer>& layers = system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kAnimationLayers)>(*this);
+
+      AnimationLayer layer;
+      layer.animation = animation_handle;
+      layer.weight = glm::clamp(weight, 0.0f, 1.0f);
+      layer.target_weight = layer.weight;
+      layers.push_back(layer);
+
+      return static_cast<int>(layers.size()) - 1;
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    int SkinnedMeshRenderComponent::AddLayer(ScriptableAsset* animation, float weight)
+    {
+      if (animation->type() != ScriptableAsset::AssetTypes::kAnimation)
+      {
+        return -1;
+      }
+
+      BaseAssetHandle* h = animation->GetHandle();
+      AnimationHandle* m = static_cast<AnimationHandle*>(h);
+
+      return AddLayer(*m, weight);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::RemoveLayer(int layer)
+    {
+      if (GetLayer(layer) == nullptr)
+      {
+        return;
+      }
+
+      foundation::Vector<AnimationLayer>& layers = system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kAnimationLayers)>(*this);
+
+      layers.erase(layers.begin() + layer);
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    int SkinnedMeshRenderComponent::GetLayerCount() const
+    {
+      return static_cast<int>(system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kAnimationLayers)>(*this).size());
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::SetLayerWeight(int layer, float weight)
+    {
+      AnimationLayer* animation_layer = GetLayer(layer);
+      if (animation_layer != nullptr)
+      {
+        animation_layer->weight = glm::clamp(weight, 0.0f, 1.0f);
+        animation_layer->target_weight = animation_layer->weight;
+      }
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    float SkinnedMeshRenderComponent::GetLayerWeight(int layer) const
+    {
+      const AnimationLayer* animation_layer = GetLayer(layer);
+      return animation_layer != nullptr ? animation_layer->weight : 0.0f;
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::FadeLayer(int layer, float weight, float duration)
+    {
+      AnimationLayer* animation_layer = GetLayer(layer);
+      if (animation_layer == nullptr)
+      {
+        return;
+      }
+
+      if (duration <= 0.0f)
+      {
+        SetLayerWeight(layer, weight);
+        return;
+      }
+
+      animation_layer->target_weight = glm::clamp(weight, 0.0f, 1.0f);
+      animation_layer->fade_speed = 
+        glm::abs(animation_layer->target_weight - animation_layer->weight) / duration;
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::SetLayerPlaybackTime(int layer, float playback_time)
+    {
+      AnimationLayer* animation_layer = GetLayer(layer);
+      if (animation_layer != nullptr)
+      {
+        animation_layer->playback_time_in_seconds = playback_time;
+      }
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    float SkinnedMeshRenderComponent::GetLayerPlaybackTime(int layer) const
+    {
+      const AnimationLayer* animation_layer = GetLayer(layer);
+      return animation_layer != nullptr ? animation_layer->playback_time_in_seconds : 0.0f;
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderComponent::SetLayerPlaybackSpeed(int layer, float playback_speed)
+    {
+      AnimationLayer* animation_layer = GetLayer(layer);
+      if (animation_layer != nullptr)
+      {
+        animation_layer->playback_speed = playback_speed;
+      }
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    float SkinnedMeshRenderComponent::GetLayerPlaybackSpeed(int layer) const
+    {
+      const AnimationLayer* animation_layer = GetLayer(layer);
+      return animation_layer != nullptr ? animation_layer->playback_speed : 0.0f;
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    AnimationLayer* SkinnedMeshRenderComponent::GetLayer(int layer) const
+    {
+      foundation::Vector<AnimationLayer>& layers = system_->data().data.
+        Get<static_cast<size_t>(SkinnedMeshRenderComponentElements::kAnimationLayers)>(*this);
+
+      if (layer < 0 || static_cast<size_t>(layer) >= layers.size())
+      {
+        PS_LOG(Warning, "Animation layer %i doesn't exist", layer);
+        return nullptr;
+      }
+
+      return &layers[layer];
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    const foundation::Vector<glm::mat4>& SkinnedMeshRenderComponent::GetBoneMatrices() const
+    {
+      return system_->GetBoneMatrices(system_->data().data.GetDataIndex(*this));
     }
 
     //------------------------------------------------------------------------------------------------------
-    void SkinnedMeshRenderSystem::CalculateBoneTransform(
+    void SkinnedMeshRenderSystem::CalculateBoneTransforms(
       unsigned int component_index,
-      unsigned int node_index,
-      const glm::mat4& parent_transform
+      const glm::mat4& local_to_world,
+      const glm::mat4& bone_space,
+      bool skip_optional_bones,
+      PoseScratch& scratch,
+      foundation::Vector<glm::mat4>& bone_matrices
     )
     {
-      const SkeletalNode& node = component_data_.skeleton[component_index]->node_at(node_index);
+      const SkeletonHandle& skeleton = component_data_.skeleton[component_index];
+      const SkeletonAnimationRemap& remap = remaps_[component_data_.animation_remap[component_index]];
+      const foundation::Vector<Bone>& bones = skeleton->bones();
+      const foundation::Vector<bool>& optional_bones = component_data_.optional_bones[component_index];
+
+      SamplePose(
+        remap,
+        component_data_.local_playback_time_in_ticks[component_index],
+        component_data_.keyframe_cursors[component_index],
+        optional_bones,
+        skip_optional_bones,
+        scratch.pose
+      );
+
+      // Cross fades override the animation, the layers override both. Nodes a layer has no channel for keep
+      // the pose below it, instead of being blended towards the rest pose.
+      for (foundation::Vector<AnimationLayer>* layers : 
+        { &component_data_.cross_fades[component_index], &component_data_.animation_layers[component_index] })
+      {
+        for (AnimationLayer& layer : *layers)
+        {
+          if (layer.weight <= 0.0f || layer.remap == SkeletonAnimationRemap::kNone)
+          {
+            continue;
+          }
+
+          const SkeletonAnimationRemap& layer_remap = remaps_[layer.remap];
+          SamplePose(
+            layer_remap,
+            layer.playback_time_in_ticks,
+            layer.keyframe_cursors,
+            optional_bones,
+            skip_optional_bones,
+            scratch.layer_pose
+          );
+
+          foundation::BlendPoses(scratch.pose, scratch.layer_pose, eastl::min(layer.weight, 1.0f),
+            layer_remap.channel_mask.data());
+        }
+      }
+
+      scratch.local_transforms.resize(remap.nodes.size());
+      foundation::ComposePose(scratch.pose, scratch.local_transforms.data());
+
+      scratch.node_transforms.resize(remap.nodes.size());
+      ComposeBoneMatrices(
+        remap,
+        scratch.local_transforms.data(),
+        bones,
+        local_to_world,
+        bone_space,
+        scratch.node_transforms.data(),
+        bone_matrices.data()
+      );
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderSystem::ComposeBoneMatrices(
+      const SkeletonAnimationRemap& remap,
+      const glm::mat4* local_transforms,
+      const foundation::Vector<Bone>& bones,
+      const glm::mat4& local_to_world,
+      const glm::mat4& bone_space,
+      glm::mat4* node_transforms,
+      glm::mat4* bone_matrices
+    )
+    {
+      // Parents come first, so their global transform is always known by the time a child is reached
+      for (size_t i = 0; i < remap.nodes.size(); ++i)
+      {
+        const SkeletonAnimationRemap::Node& node = remap.nodes[i];
 
-      glm::mat4 node_transform = node.transform;
+        const glm::mat4& parent_transform = node.parent == SkeletonAnimationRemap::kNone ?
+          local_to_world : node_transforms[node.parent];
 
-      unsigned int animation_channel_index = UINT_MAX;
-      GetChannelByNodeName(component_index, node.name, &animation_channel_index);
+        glm::mat4& global_transform = node_transforms[i];
+        foundation::MultiplyAffine(parent_transform, local_transforms[i], global_transform);
+
+        if (node.bone != SkeletonAnimationRemap::kNone)
+        {
+          bone_matrices[node.bone] =
+            bone_space *
+            global_transform *
+            bones[node.bone].offset;
+        }
+      }
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    bool SkinnedMeshRenderSystem::IsLodUpdateFrame(unsigned int frame, Entity entity, unsigned int interval)
+    {
+      // The entity keeps its slot in the schedule when components are removed and the others move down
+      const unsigned int offset = static_cast<unsigned int>(entity.GetIndex() % interval);
+      return (frame + offset) % interval == 0;
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderSystem::SamplePose(
+      const SkeletonAnimationRemap& remap,
+      float playback_time,
+      foundation::Vector<KeyframeCursor>& cursors,
+      const foundation::Vector<bool>& optional_bones,
+      bool skip_optional_bones,
+      foundation::PoseSoA& pose
+    ) const
+    {
+      const foundation::Vector<AnimationChannel>& channels = remap.animation->animation_channels();
+      pose.Resize(remap.nodes.size());
 
-      if (animation_channel_index != UINT_MAX)
+      for (size_t i = 0; i < remap.nodes.size(); ++i)
       {
+        const SkeletonAnimationRemap::Node& node = remap.nodes[i];
+
+        // Optional leaf bones keep the pose of the skeleton, which keeps them attached to their parent
+        const bool skipped = skip_optional_bones == true &&
+          node.leaf == true &&
+          node.bone < optional_bones.size() &&
+          optional_bones[node.bone] == true;
+
+        if (node.channel == SkeletonAnimationRemap::kNone || skipped == true)
+        {
+          pose.Copy(i, remap.rest_pose, i);
+          continue;
+        }
+
         // process the animation channel
         // set node transform to be result of interpolated animation channel
-        const AnimationChannel& channel = component_data_.
-          animation[component_index]->animation_channels()[animation_channel_index];
+        const AnimationChannel& channel = channels[node.channel];
+        KeyframeCursor& cursor = cursors[node.channel];
 
-        float& local_playback_time = component_data_.local_playback_time_in_ticks[component_index];
+        glm::vec3 position;
+        glm::quat rotation;
+        glm::vec3 scale;
 
-        glm::vec3 position = ProcessKeyframes(
-          local_playback_time,
-          channel.position_keys
-        );
-        glm::quat rotation = ProcessKeyframes(
-          local_playback_time,
-          channel.rotation_keys
-        );
-        glm::vec3 scale = ProcessKeyframes(
-          local_playback_time,
-          channel.scale_keys
-        );
+        if (channel.compressed == true)
+        {
+          position = ProcessKeyframes(playback_time, channel.position_track);
+          rotation = ProcessKeyframes(playback_time, channel.rotation_track);
+          scale = ProcessKeyframes(playback_time, channel.scale_track);
+        }
+        else
+        {
+          position = ProcessKeyframes(
+            playback_time,
+            channel.position_keys,
+            cursor.position
+          );
+          rotation = ProcessKeyframes(
+            playback_time,
+            channel.rotation_keys,
+            cursor.rotation
+          );
+          scale = ProcessKeyframes(
+            playback_time,
+            channel.scale_keys,
+            cursor.scale
+          );
+        }
+
+        pose.Set(i, position, rotation, scale);
+      }
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    unsigned int SkinnedMeshRenderSystem::GetRemap(
+      const SkeletonHandle& skeleton,
+      const AnimationHandle& animation)
+    {
+      if (skeleton.IsValid() == false || animation.IsValid() == false)
+      {
+        return SkeletonAnimationRemap::kNone;
+      }
+
+      const uint64_t key = RemapKey(skeleton, animation);
+
+      foundation::HashMap<uint64_t, unsigned int>::iterator it = remap_lookup_.find(key);
+      if (it != remap_lookup_.end())
+      {
+        remaps_[it->second].last_used = foundation::Frame::frame_count();
+        return it->second;
+      }
 
-        glm::mat4 position_matrix = glm::translate(position);
-        glm::mat4 rotation_matrix = glm::toMat4(rotation);
-        glm::mat4 scaling_matrix = glm::scale(scale);
+      // Resolve every name once, evaluating a pose only uses the indices
+      SkeletonAnimationRemap remap;
+      remap.skeleton = skeleton;
+      remap.animation = animation;
+      remap.inverse_root = glm::inverse(skeleton->root_node().transform);
+      remap.last_used = foundation::Frame::frame_count();
 
-        node_transform = position_matrix * rotation_matrix * scaling_matrix;
+      const foundation::Vector<SkeletalNode>& nodes = skeleton->nodes();
+      const foundation::Vector<AnimationChannel>& channels = animation->animation_channels();
+      remap.nodes.reserve(nodes.size());
+
+      // Flatten the hierarchy depth-first, so every parent is stored before its children
+      foundation::Vector<SkeletonAnimationRemap::Node> stack;
+      stack.push_back({ skeleton->root_node_index(), SkeletonAnimationRemap::kNone });
+
+      while (stack.empty() == false)
+      {
+        SkeletonAnimationRemap::Node node = stack.back();
+        stack.pop_back();
+
+        const SkeletalNode& skeletal_node = nodes[node.node];
+        node.bone = SkeletonAnimationRemap::kNone;
+        node.channel = SkeletonAnimationRemap::kNone;
+
+        const auto bone = skeleton->bone_names().find(skeletal_node.name);
+        if (bone != skeleton->bone_names().end())
+        {
+          node.bone = bone->second;
+        }
+
+        for (size_t i = 0; i < channels.size(); ++i)
+        {
+          if (channels[i].bone_name == skeletal_node.name)
+          {
+            node.channel = static_cast<unsigned int>(i);
+            break;
+          }
+        }
+
+        node.leaf = skeletal_node.children.empty();
+
+        const unsigned int parent = static_cast<unsigned int>(remap.nodes.size());
+        remap.nodes.push_back(node);
+
+        for (size_t i = skeletal_node.children.size(); i > 0; --i)
+        {
+          stack.push_back({ skeletal_node.children[i - 1], parent });
+        }
       }
 
-      glm::mat4 global_transform = parent_transform * node_transform;
+      // The local transforms of the skeleton are used wherever the animation doesn't move a node
+      foundation::Vector<glm::mat4> rest_transforms(remap.nodes.size());
+      for (size_t i = 0; i < remap.nodes.size(); ++i)
+      {
+        rest_transforms[i] = nodes[remap.nodes[i].node].transform;
+      }
 
-      SkeletonHandle skeleton = component_data_.skeleton[component_index];
+      foundation::Vector<glm::vec3> rest_positions(remap.nodes.size());
+      foundation::Vector<glm::quat> rest_rotations(remap.nodes.size());
+      foundation::Vector<glm::vec3> rest_scales(remap.nodes.size());
+      foundation::DecomposeTransforms(rest_transforms.data(), 
+        rest_positions.data(), rest_rotations.data(), rest_scales.data(), rest_transforms.size());
 
-      if (skeleton->bone_names().find(node.name) != skeleton->bone_names().end())
+      remap.rest_pose.Resize(remap.nodes.size());
+      for (size_t i = 0; i < remap.nodes.size(); ++i)
       {
-        foundation::Vector<glm::mat4>& bone_matrices = 
-          component_data_.bone_matrices[component_index];
+        remap.rest_pose.Set(i, rest_positions[i], rest_rotations[i], rest_scales[i]);
+      }
 
-        bone_matrices[component_data_.skeleton[component_index]->bone_names().at(node.name)] =
-          glm::inverse(component_data_.skeleton[component_index]->root_node().transform) *
-          global_transform *
-          skeleton->bones()[skeleton->bone_names().at(node.name)].offset;
+      // Layers and cross fades only blend the nodes their animation moves
+      remap.channel_mask.resize(remap.rest_pose.tx.size(), 0.0f);
+      for (size_t i = 0; i < remap.nodes.size(); ++i)
+      {
+        remap.channel_mask[i] = remap.nodes[i].channel == SkeletonAnimationRemap::kNone ? 0.0f : 1.0f;
       }
 
-      for (size_t i = 0; i < node.children.size(); i++)
+      unsigned int index;
+      if (free_remaps_.empty() == false)
       {
-        CalculateBoneTransform(component_index, node.children[i], global_transform);
+        index = free_remaps_.back();
+        free_remaps_.pop_back();
+        remaps_[index] = eastl::move(remap);
       }
+      else
+      {
+        index = static_cast<unsigned int>(remaps_.size());
+        remaps_.push_back(eastl::move(remap));
+      }
+
+      remap_lookup_.insert(eastl::make_pair(key, index));
+      return index;
     }
 
     //------------------------------------------------------------------------------------------------------
-    void SkinnedMeshRenderSystem::GetChannelByNodeName(
-      unsigned int component_index,
-      const foundation::String& node_name,
-      unsigned int* out_channel_index) const
+    unsigned int SkinnedMeshRenderSystem::UseRemap(
+      unsigned int remap,
+      const SkeletonHandle& skeleton,
+      const AnimationHandle& animation)
     {
-      AnimationHandle animation = component_data_.animation[component_index];
+      // Released tables hold no handles, so a stale index never matches
+      if (remap == SkeletonAnimationRemap::kNone ||
+        remaps_[remap].skeleton != skeleton ||
+        remaps_[remap].animation != animation)
+      {
+        return GetRemap(skeleton, animation);
+      }
+
+      remaps_[remap].last_used = foundation::Frame::frame_count();
+      return remap;
+    }
 
-      for (int i = 0; i < animation->animation_channels().size(); ++i)
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderSystem::EvictRemaps()
+    {
+      const unsigned int frame = foundation::Frame::frame_count();
+      for (size_t i = 0; i < remaps_.size(); ++i)
       {
-        if (animation->animation_channels()[i].bone_name == node_name)
+        SkeletonAnimationRemap& remap = remaps_[i];
+        if (remap.skeleton.IsValid() == false || frame - remap.last_used < kRemapEvictionFrames)
         {
-          *out_channel_index = i;
-          break;
+          continue;
         }
+
+        remap_lookup_.erase(RemapKey(remap.skeleton, remap.animation));
+
+        // Releasing the handles lets the assets unload, the slot is reused by the next table
+        remap = SkeletonAnimationRemap();
+        free_remaps_.push_back(static_cast<unsigned int>(i));
       }
     }
 
+    //------------------------------------------------------------------------------------------------------
+    void SkinnedMeshRenderSystem::AssignRemap(ComponentHandleBase handle)
+    {
+      const size_t i = component_data_.data.GetDataIndex(handle);
+      component_data_.animation_remap[i] = GetRemap(component_data_.skeleton[i], component_data_.animation[i]);
+    }
+
     //------------------------------------------------------------------------------------------------------
     glm::vec3 SkinnedMeshRenderSystem::ProcessKeyframes(
       float playback_time,
-      const foundation::Vector<Vector3Keyframe>& keyframes) const
+      const foundation::Vector<Vector3Keyframe>& keyframes,
+      unsigned int& cursor) const
     {
       if (keyframes.size() == 0)
       {
@@ -756,24 +1757,15 @@ namespace sulphur
         return keyframes[0].value;
       }
 
-      unsigned int current_key_index = UINT_MAX;
-      unsigned int next_key_index = UINT_MAX;
-
-      for (int i = static_cast<int>(keyframes.size()) - 1; i >= 0; i--)
-      {
-        if (keyframes[i].time < playback_time)
-        {
-          current_key_index = static_cast<unsigned int>(i);
-          break;
-        }
-      }
+      const unsigned int current_key_index = FindKey(keyframes, playback_time, cursor);
 
       if (current_key_index == UINT_MAX)
       {
         return keyframes[0].value;
       }
 
-      next_key_index = static_cast<unsigned int>(fmod(current_key_index + 1, keyframes.size()));
+      const unsigned int next_key_index = 
+        (current_key_index + 1) % static_cast<unsigned int>(keyframes.size());
 
       float delta_time = keyframes[next_key_index].time - keyframes[current_key_index].time;
       float factor = (playback_time - keyframes[current_key_index].time) / delta_time;
@@ -788,7 +1780,8 @@ namespace sulphur
     //------------------------------------------------------------------------------------------------------
     glm::quat SkinnedMeshRenderSystem::ProcessKeyframes(
       float playback_time,
-      const foundation::Vector<QuaternionKeyframe>& keyframes) const
+      const foundation::Vector<QuaternionKeyframe>& keyframes,
+      unsigned int& cursor) const
     {
       if (keyframes.size() == 0)
       {
@@ -800,24 +1793,15 @@ namespace sulphur
         return keyframes[0].value;
       }
 
-      unsigned int current_key_index = UINT_MAX;
-      unsigned int next_key_index = UINT_MAX;
-
-      for (int i = static_cast<int>(keyframes.size()) - 1; i >= 0; i--)
-      {
-        if (keyframes[i].time < playback_time)
-        {
-          current_key_index = static_cast<unsigned int>(i);
-          break;
-        }
-      }
+      const unsigned int current_key_index = FindKey(keyframes, playback_time, cursor);
 
       if (current_key_index == UINT_MAX)
       {
         return keyframes[0].value;
       }
 
-      next_key_index = static_cast<unsigned int>(fmod(current_key_index + 1, keyframes.size()));
+      const unsigned int next_key_index = 
+        (current_key_index + 1) % static_cast<unsigned int>(keyframes.size());
 
       float delta_time = keyframes[next_key_index].time - keyframes[current_key_index].time;
       float factor = (playback_time - keyframes[current_key_index].time) / delta_time;
@@ -827,5 +1811,21 @@ namespace sulphur
 
       return glm::slerp(start, end, factor);
     }
+
+    //------------------------------------------------------------------------------------------------------
+    glm::vec3 SkinnedMeshRenderSystem::ProcessKeyframes(
+      float playback_time,
+      const foundation::AnimationVectorTrack& track) const
+    {
+      return track.Evaluate(playback_time, glm::vec3(1.0f, 1.0f, 1.0f));
+    }
+
+    //------------------------------------------------------------------------------------------------------
+    glm::quat SkinnedMeshRenderSystem::ProcessKeyframes(
+      float playback_time,
+      const foundation::AnimationRotationTrack& track) const
+    {
+      return track.Evaluate(playback_time);
+    }
   }
 }
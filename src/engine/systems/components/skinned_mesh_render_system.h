@@ -4,14 +4,24 @@
 #include "engine/systems/component_system.h"
 #include "engine/scripting/scriptable_object.h"
 #include "engine/assets/scriptable_asset_system.h"
+#include "engine/utilities/layer.h"
 
 #include <foundation/containers/vector.h>
 #include <foundation/containers/hash_map.h>
+#include <foundation/job/worker_group.h>
+#include <foundation/math/transform_kernels.h>
 
 #include <glm/mat4x4.hpp>
 
 namespace sulphur
 {
+  namespace foundation
+  {
+    class AnimationVectorTrack;
+    class AnimationRotationTrack;
+    class Frustum;
+  }
+
   namespace engine
   {
     template<typename T>
@@ -30,6 +40,7 @@ namespace sulphur
     using MaterialHandle = AssetHandle<Material>;
 
     class Skeleton;
+    struct Bone;
     using SkeletonHandle = AssetHandle<Skeleton>;
 
     class Animation;
@@ -40,9 +51,11 @@ namespace sulphur
 
     class Entity;
     class IRenderer;
+    class World;
     class CameraSystem;
     class TransformSystem;
     class SkinnedMeshRenderSystem;
+    struct AnimationLayer;
 
     /**
     * @class sulphur::engine::SkinnedMeshRenderComponent
@@ -294,16 +307,214 @@ namespace sulphur
       */
       SCRIPT_FUNC() float GetPlaybackSpeed() const;
 
+      /**
+      * @brief Sets the distance from which the animation is updated at a reduced rate.
+      * @param[in] distance (float) The distance in world units to the nearest camera that sees this component.
+      * @remarks A distance of 0 disables this, the animation then only updates at a reduced rate when it is
+      *          culled and SetAnimateWhenCulled() is enabled.
+      */
+      SCRIPT_FUNC() void SetLodDistance(float distance);
+
+      /**
+      * @brief Retrieves the distance from which the animation is updated at a reduced rate.
+      * @returns (float) The distance in world units, 0 if it is disabled.
+      */
+      SCRIPT_FUNC() float GetLodDistance() const;
+
+      /**
+      * @brief Sets how often the animation is updated when it is far away or culled.
+      * @param[in] frames (int) The animation is updated once every this many frames, at least 1.
+      * @remarks Updates of different components are spread over the frames.
+      */
+      SCRIPT_FUNC() void SetLodUpdateInterval(int frames);
+
+      /**
+      * @brief Retrieves how often the animation is updated when it is far away or culled.
+      * @returns (int) The amount of frames between updates.
+      */
+      SCRIPT_FUNC() int GetLodUpdateInterval() const;
+
+      /**
+      * @brief Sets the distance from which optional bones are no longer animated.
+      * @param[in] distance (float) The distance in world units to the nearest camera that sees this component.
+      * @remarks Optional bones keep the pose of the skeleton past this distance. A distance of 0 disables this.
+      */
+      SCRIPT_FUNC() void SetBoneCullDistance(float distance);
+
+      /**
+      * @brief Retrieves the distance from which optional bones are no longer animated.
+      * @returns (float) The distance in world units, 0 if it is disabled.
+      */
+      SCRIPT_FUNC() float GetBoneCullDistance() const;
+
+      /**
+      * @brief Marks a bone of the skeleton as optional, so it isn't animated past the bone cull distance.
+      * @param[in] bone_name (sulphur::foundation::String) The name of the bone.
+      * @param[in] optional (bool) Whether the bone is optional.
+      * @remarks Only bones without child nodes are ever skipped, like fingers or facial bones. The marks are
+      *          cleared when the skeleton changes.
+      */
+      SCRIPT_FUNC() void SetBoneOptional(foundation::String bone_name, bool optional);
+
+      /**
+      * @brief Retrieves whether a bone of the skeleton is marked as optional.
+      * @param[in] bone_name (sulphur::foundation::String) The name of the bone.
+      * @returns (bool) Whether the bone is optional.
+      */
+      SCRIPT_FUNC() bool IsBoneOptional(foundation::String bone_name) const;
+
+      /**
+      * @brief Sets whether the animation keeps updating while no camera sees this component.
+      * @param[in] animate_when_culled (bool) Whether the animation keeps updating, at the LOD update interval.
+      * @remarks Enable this when something depends on the bone matrices of a component that isn't rendered.
+      */
+      SCRIPT_FUNC() void SetAnimateWhenCulled(bool animate_when_culled);
+
+      /**
+      * @brief Retrieves whether the animation keeps updating while no camera sees this component.
+      * @returns (bool) Whether the animation keeps updating.
+      */
+      SCRIPT_FUNC() bool AnimatesWhenCulled() const;
+
+      /**
+      * @brief Retrieves whether no camera saw this component during the last animation update.
+      * @returns (bool) Whether the component was culled by every camera.
+      */
+      SCRIPT_FUNC() bool IsAnimationCulled() const;
+
+      /**
+      * @brief Sets the step the playback time is rounded down to, so that components playing the same animation
+      *        on the same skeleton at about the same time can share one evaluated pose.
+      * @param[in] step (float) The step in seconds, 0 evaluates the pose of this component on its own.
+      * @remarks Components with active cross fades or layers, or past their bone cull distance, are never shared
+      *          and play at their exact playback time.
+      * @see sulphur::engine::SkinnedMeshRenderSystem::pose_cache_stats
+      */
+      SCRIPT_FUNC() void SetPoseCacheStep(float step);
+
+      /**
+      * @brief Retrieves the step the playback time is rounded down to for sharing poses.
+      * @returns (float) The step in seconds, 0 if this component doesn't share poses.
+      */
+      SCRIPT_FUNC() float GetPoseCacheStep() const;
+
+      /**
+      * @brief Blends from the current animation to another animation over time.
+      * @param[in] animation (sulphur::engine::AnimationHandle) The animation to blend to, it starts playing from the start.
+      * @param[in] duration (float) The duration of the blend in seconds, 0 or less switches right away.
+      * @remarks Once the blend is done, the animation becomes the animation of this component as if it was set
+      *          with SetAnimation(). Cross fades happen below the layers and don't change their indices.
+      * @remarks Cross fades only progress while the animation is playing.
+      */
+      void CrossFade(AnimationHandle animation, float duration);
+
+      /**
+      * @brief Scriptable version of CrossFade().
+      * @param[in] animation (sulphur::engine::ScriptableAsset*) A scriptable asset which type is kAnimation.
+      * @param[in] duration (float) The duration of the blend in seconds, 0 or less switches right away.
+      */
+      SCRIPT_FUNC() void CrossFade(ScriptableAsset* animation, float duration);
+
+      /**
+      * @brief Adds an animation layer, which is blended over the animation and the layers below it.
+      * @param[in] animation (sulphur::engine::AnimationHandle) The animation of the layer, it starts playing from the start.
+      * @param[in] weight (float) How much the layer overrides the layers below it, from 0 to 1.
+      * @returns (int) The index of the layer, -1 if the animation is invalid.
+      * @remarks Layers play at the same time as the animation of this component. Bones the animation of the
+      *          layer has no channel for keep the pose of the layers below it.
+      */
+      int AddLayer(AnimationHandle animation, float weight);
+
+      /**
+      * @brief Scriptable version of AddLayer().
+      * @param[in] animation (sulphur::engine::ScriptableAsset*) A scriptable asset which type is kAnimation.
+      * @param[in] weight (float) How much the layer overrides the layers below it, from 0 to 1.
+      * @returns (int) The index of the layer, -1 if the animation is invalid.
+      */
+      SCRIPT_FUNC() int AddLayer(ScriptableAsset* animation, float weight);
+
+      /**
+      * @brief Removes an animation layer.
+      * @param[in] layer (int) The index of the layer.
+      * @remarks The layers above it move down one index.
+      */
+      SCRIPT_FUNC() void RemoveLayer(int layer);
+
+      /**
+      * @brief Retrieves the amount of animation layers.
+      * @returns (int) The amount of layers.
+      */
+      SCRIPT_FUNC() int GetLayerCount() const;
+
+      /**
+      * @brief Sets how much an animation layer overrides the layers below it, stopping its fade.
+      * @param[in] layer (int) The index of the layer.
+      * @param[in] weight (float) The weight, from 0 to 1.
+      */
+      SCRIPT_FUNC() void SetLayerWeight(int layer, float weight);
+
+      /**
+      * @brief Retrieves how much an animation layer overrides the layers below it.
+      * @param[in] layer (int) The index of the layer.
+      * @returns (float) The weight, from 0 to 1.
+      */
+      SCRIPT_FUNC() float GetLayerWeight(int layer) const;
+
+      /**
+      * @brief Changes the weight of an animation layer over time.
+      * @param[in] layer (int) The index of the layer.
+      * @param[in] weight (float) The weight to fade to, from 0 to 1.
+      * @param[in] duration (float) The duration of the fade in seconds, 0 or less sets the weight right away.
+      * @remarks Layers that are faded out are kept, they are skipped until their weight increases again.
+      */
+      SCRIPT_FUNC() void FadeLayer(int layer, float weight, float duration);
+
+      /**
+      * @brief Sets the playback time of an animation layer.
+      * @param[in] layer (int) The index of the layer.
+      * @param[in] playback_time (float) The new playback time in seconds.
+      */
+      SCRIPT_FUNC() void SetLayerPlaybackTime(int layer, float playback_time);
+
+      /**
+      * @brief Retrieves the playback time of an animation layer.
+      * @param[in] layer (int) The index of the layer.
+      * @returns (float) The playback time in seconds.
+      */
+      SCRIPT_FUNC() float GetLayerPlaybackTime(int layer) const;
+
+      /**
+      * @brief Sets the playback speed of an animation layer.
+      * @param[in] layer (int) The index of the layer.
+      * @param[in] playback_speed (float) The new playback speed, 1.0 being 100%.
+      */
+      SCRIPT_FUNC() void SetLayerPlaybackSpeed(int layer, float playback_speed);
+
+      /**
+      * @brief Retrieves the playback speed of an animation layer.
+      * @param[in] layer (int) The index of the layer.
+      * @returns (float) The playback speed, 1.0 being 100%.
+      */
+      SCRIPT_FUNC() float GetLayerPlaybackSpeed(int layer) const;
+
       /**
       * @brief Retrieves the bone matrices as they are currently calculated for the animation.
       * @returns (const sulphur::foundation::Vector<glm::mat4>&) The bone matrices as they are currently calculated for the animation.
       * @remarks These bone matrices get calculated once per frame by the parent SkinnedMeshRenderSystem.
       * @remarks These bone matrices are the ones that are sent to the GPU for processing by the vertex shader.
       * @remarks These bone matrices are transformed appropriately to the current state of the animation.
+      * @remarks Components that share a pose are rendered from the shared pose, their bone matrices are placed from it when they are retrieved.
       */
       const foundation::Vector<glm::mat4>& GetBoneMatrices() const;
 
     private:
+      /**
+      * @brief Retrieves an animation layer of this component.
+      * @param[in] layer (int) The index of the layer.
+      * @returns (sulphur::engine::AnimationLayer*) The layer, nullptr if the index is invalid.
+      */
+      AnimationLayer* GetLayer(int layer) const;
+
       SkinnedMeshRenderSystem* system_; //!< The system that owns this component
     };
 
@@ -323,7 +534,83 @@ namespace sulphur
       kLocalPlaybackTime,
       kIsPlaying,
       kPlaybackSpeed,
-      kBoneMatrices
+      kBoneMatrices,
+      kAnimationRemap,
+      kKeyframeCursors,
+      kLodDistance,
+      kLodUpdateInterval,
+      kBoneCullDistance,
+      kOptionalBones,
+      kAnimateWhenCulled,
+      kAnimationCulled,
+      kAnimationLayers,
+      kCrossFades,
+      kPoseCacheStep,
+      kSharedPose,
+      kBoneSpace
+    };
+
+    /**
+    * @struct sulphur::engine::SkeletonAnimationRemap
+    * @brief Maps every node of a skeleton to its bone and to the channel of an animation that drives it, so
+    * evaluating a pose doesn't have to look anything up by name.
+    * @remarks Built once per combination of skeleton and animation by the SkinnedMeshRenderSystem, and released
+    * again when no component used it for a while. Changing the channels of an animation that is in use invalidates
+    * its remap tables.
+    */
+    struct SkeletonAnimationRemap
+    {
+      static constexpr unsigned int kNone = UINT_MAX; //!< Marks a node without a parent, bone or channel, and a component without a remap table
+
+      /**
+      * @struct sulphur::engine::SkeletonAnimationRemap::Node
+      * @brief A node of the flattened skeleton.
+      */
+      struct Node
+      {
+        unsigned int node; //!< The index of the node in the skeleton
+        unsigned int parent; //!< The index of the parent in the flattened skeleton, kNone for the root
+        unsigned int bone; //!< The index of the bone the node drives, kNone if it has none
+        unsigned int channel; //!< The index of the animation channel that moves the node, kNone if it has none
+        bool leaf; //!< Does the node have no children?
+      };
+
+      SkeletonHandle skeleton; //!< The skeleton the table was built for, held until the table is released so its asset id can't be reused
+      AnimationHandle animation; //!< The animation the table was built for, held until the table is released so its asset id can't be reused
+      foundation::Vector<Node> nodes; //!< The nodes reachable from the root, every parent comes before its children
+      foundation::PoseSoA rest_pose; //!< The local transform of the skeleton per flattened node, used where nothing animates it
+      foundation::Vector<float> channel_mask; //!< 1 per flattened node the animation has a channel for and 0 otherwise, padded like the rest pose
+      glm::mat4 inverse_root; //!< The inverse of the root node transform
+      unsigned int last_used; //!< The frame the table was last used in
+    };
+
+    /**
+    * @struct sulphur::engine::KeyframeCursor
+    * @brief The keys an animation channel was last sampled at for a single component. Playing forward
+    * continues from these keys instead of searching the channel.
+    */
+    struct KeyframeCursor
+    {
+      unsigned int position = 0; //!< The index of the last sampled position key
+      unsigned int rotation = 0; //!< The index of the last sampled rotation key
+      unsigned int scale = 0; //!< The index of the last sampled scale key
+    };
+
+    /**
+    * @struct sulphur::engine::AnimationLayer
+    * @brief An animation that is blended over the animation of a SkinnedMeshRenderComponent.
+    */
+    struct AnimationLayer
+    {
+      AnimationHandle animation; //!< The animation of the layer
+      unsigned int remap = SkeletonAnimationRemap::kNone; //!< The index of the remap table of the skeleton and the animation
+      float playback_time_in_seconds = 0.0f; //!< The playback time
+      float playback_time_in_ticks = 0.0f; //!< The playback time within the animation
+      float playback_speed = 1.0f; //!< The playback speed multiplier
+      float weight = 0.0f; //!< How much the layer overrides the layers below it, from 0 to 1
+      float target_weight = 0.0f; //!< The weight the layer fades to
+      float fade_speed = 0.0f; //!< The change in weight per second while fading
+      foundation::Vector<KeyframeCursor> keyframe_cursors; //!< The keyframe cursors per animation channel
     };
 
     
@@ -359,6 +646,19 @@ namespace sulphur
       bool* is_playing; //!< Array of playing flags per component.
       float* playback_speed; //!< Array of playback speed multipliers per components.
       foundation::Vector<glm::mat4>* bone_matrices; //!< Array of transform bone matrices arrays per component.
+      unsigned int* animation_remap; //!< Array of indices of the remap table of the skeleton and animation per component.
+      foundation::Vector<KeyframeCursor>* keyframe_cursors; //!< Array of keyframe cursors per animation channel per component.
+      float* lod_distance; //!< Array of distances from which the animation updates at a reduced rate per component.
+      unsigned int* lod_update_interval; //!< Array of frames between animation updates when far away or culled per component.
+      float* bone_cull_distance; //!< Array of distances from which optional bones aren't animated per component.
+      foundation::Vector<bool>* optional_bones; //!< Array of optional flags per bone index per component.
+      bool* animate_when_culled; //!< Array of flags to keep animating while culled per component.
+      bool* animation_culled; //!< Array of flags whether every camera culled the component during the last update per component.
+      foundation::Vector<AnimationLayer>* animation_layers; //!< Array of animation layers per component.
+      foundation::Vector<AnimationLayer>* cross_fades; //!< Array of animations that are being cross faded to, oldest first, per component.
+      float* pose_cache_step; //!< Array of steps in seconds the playback time is rounded to for sharing poses, 0 when not shared, per component.
+      unsigned int* shared_pose; //!< Array of indices of the shared pose that is rendered, SkeletonAnimationRemap::kNone when the bone matrices are rendered, per component.
+      glm::mat4* bone_space; //!< Array of transforms that place the shared pose at the component, the inverse root transform followed by the transform of the entity, per component.
 
       /** 
       * @brief Short-hand for the system data of this component. Allows easy access of data that is 
@@ -378,7 +678,20 @@ namespace sulphur
         float,
         bool,
         float,
-        foundation::Vector<glm::mat4>
+        foundation::Vector<glm::mat4>,
+        unsigned int,
+        foundation::Vector<KeyframeCursor>,
+        float,
+        unsigned int,
+        float,
+        foundation::Vector<bool>,
+        bool,
+        bool,
+        foundation::Vector<AnimationLayer>,
+        foundation::Vector<AnimationLayer>,
+        float,
+        unsigned int,
+        glm::mat4
       >;
 
       ComponentSystemData data; //!< System data of the component.
@@ -395,6 +708,36 @@ namespace sulphur
       public IComponentSystem
     {
     public:
+      /**
+      * @struct sulphur::engine::SkinnedMeshRenderSystem::PoseScratch
+      * @brief Scratch space for calculating the bone matrices of a component.
+      */
+      struct PoseScratch
+      {
+        foundation::PoseSoA pose; //!< The blended local pose
+        foundation::PoseSoA layer_pose; //!< The local pose that is blended in
+        foundation::Vector<glm::mat4> local_transforms; //!< The local transform per flattened node
+        foundation::Vector<glm::mat4> node_transforms; //!< The global transform per flattened node
+      };
+
+      /**
+      * @struct sulphur::engine::SkinnedMeshRenderSystem::PoseCacheStats
+      * @brief How well the components that share poses did so during the last animation update.
+      */
+      struct PoseCacheStats
+      {
+        size_t lookups = 0; //!< The amount of components that looked up a shared pose
+        size_t hits = 0; //!< The amount of components that found a pose another component evaluated
+
+        /**
+        * @returns (float) The fraction of lookups that were hits, 0 without any lookups.
+        */
+        float hit_rate() const
+        {
+          return lookups == 0 ? 0.0f : static_cast<float>(hits) / static_cast<float>(lookups);
+        }
+      };
+
       /** Default constructor */
       SkinnedMeshRenderSystem();
 
@@ -422,6 +765,40 @@ namespace sulphur
       * @see sulphur::engine::IComponentSystem::Destroy
       */
       void Destroy(ComponentHandleBase handle) override;
+      /**
+      * @see sulphur::engine::IComponentSystem::Reserve
+      */
+      void Reserve(size_t count) override;
+
+      using ViewElement = size_t; //!< Components are yielded to views as their index in component_data_
+
+      /**
+      * @see sulphur::engine::ComponentView
+      */
+      void PrepareView() {}
+      /**
+      * @see sulphur::engine::ComponentView
+      * @return (size_t) The amount of skinned mesh renderers
+      */
+      size_t ViewCount() const;
+      /**
+      * @see sulphur::engine::ComponentView
+      * @param[in] index (size_t) The data index of the component
+      * @return (sulphur::engine::Entity) The entity of the component
+      */
+      Entity ViewEntity(size_t index) const;
+      /**
+      * @see sulphur::engine::ComponentView
+      * @param[in] handle (sulphur::engine::ComponentHandleBase) The component to look-up
+      * @return (size_t) The data index of the component
+      */
+      size_t ViewIndex(ComponentHandleBase handle) const;
+      /**
+      * @see sulphur::engine::ComponentView
+      * @param[in] index (size_t) The data index of the component
+      * @return (size_t) The data index of the component
+      */
+      ViewElement ViewAt(size_t index) const;
 
       /**
       * @brief Create a new SkinnedMeshRenderComponent for this entity and also creates a 
@@ -432,65 +809,190 @@ namespace sulphur
       SkinnedMeshRenderComponent Create(Entity& entity);
 
       /**
-      * @brief Calculates the bone matrix of a given node index based on the current animation and skeleton.
+      * @brief Calculates the bone matrices of a component based on its current animation and skeleton.
       * @param[in] component_index (unsigned int) The index of the component for which the bones should be calculated.
-      * @param[in] node_index (unsigned int) The index of the node for which you want to calculate the bone matrix.
-      * @param[in] parent_transform (const glm::mat4&) The transform of the parent node.
-      * @remarks This is a recursive function that traverses the entire hierarchy of nodes until there are no
-      *          more child nodes left.
-      * @remarks Recommended usage is to call this function with the index of the root node and the transform
-      *          of the entity the eventual bone matrices will be applied on.
-      * @remarks This function automatically updates the bone_matrices_ array for the given component.
-      */
-      void CalculateBoneTransform(
+      * @param[in] local_to_world (const glm::mat4&) The transform of the entity the bone matrices will be applied on.
+      * @param[in] bone_space (const glm::mat4&) The transform applied to every bone matrix, the inverse root
+      *            transform of the skeleton for the bone matrices that are rendered.
+      * @param[in] skip_optional_bones (bool) Should optional bones keep the pose of the skeleton?
+      * @param[out] scratch (sulphur::engine::SkinnedMeshRenderSystem::PoseScratch&) Scratch space for the poses and transforms.
+      * @param[out] bone_matrices (sulphur::foundation::Vector<glm::mat4>&) The bone matrices, sized to the bones of the skeleton.
+      * @remarks Samples the animation, the cross fades and the layers into local poses and blends them, before
+      *          walking the flattened skeleton of the component's remap table in a single loop. The remap table
+      *          has to be assigned before calling this function.
+      * @remarks It only touches data of the component and the output, so different components can be calculated
+      *          on different threads.
+      */
+      void CalculateBoneTransforms(
         unsigned int component_index,
-        unsigned int node_index,
-        const glm::mat4& parent_transform
+        const glm::mat4& local_to_world,
+        const glm::mat4& bone_space,
+        bool skip_optional_bones,
+        PoseScratch& scratch,
+        foundation::Vector<glm::mat4>& bone_matrices
       );
 
       /**
-      * @brief Retrieves the index of an animation channel based on a node's name.
-      * @param[in] component_index (unsigned int) The index of the component from where the animation channel should be searched for.
-      * @param[in] node_name (const sulphur::foundation::String&) The name of the node for which you want the index of the animation channel.
-      * @param[out] out_channel_index (unsigned int*) The index of the animation channel will be outputted in this argument.
-      * @remarks If there is no animation channel that can be found for a given node name, out_channel_index
-      *          will not be modified at all.
+      * @brief Walks a flattened skeleton to turn the local transforms of its nodes into bone matrices.
+      * @param[in] remap (const sulphur::engine::SkeletonAnimationRemap&) The remap table with the flattened skeleton.
+      * @param[in] local_transforms (const glm::mat4*) The local transform per flattened node.
+      * @param[in] bones (const sulphur::foundation::Vector<sulphur::engine::Bone>&) The bones of the skeleton.
+      * @param[in] local_to_world (const glm::mat4&) The transform of the entity the bone matrices will be applied on.
+      * @param[in] bone_space (const glm::mat4&) The transform applied to every bone matrix.
+      * @param[out] node_transforms (glm::mat4*) The global transform per flattened node.
+      * @param[out] bone_matrices (glm::mat4*) The bone matrices, one per bone of the skeleton.
+      * @remarks Shared poses are walked with identity transforms, placing them with the inverse root transform
+      *          followed by the transform of the entity results in the same bone matrices.
       */
-      void GetChannelByNodeName(
-        unsigned int component_index,
-        const foundation::String& node_name,
-        unsigned int* out_channel_index) const;
+      static void ComposeBoneMatrices(
+        const SkeletonAnimationRemap& remap,
+        const glm::mat4* local_transforms,
+        const foundation::Vector<Bone>& bones,
+        const glm::mat4& local_to_world,
+        const glm::mat4& bone_space,
+        glm::mat4* node_transforms,
+        glm::mat4* bone_matrices
+      );
+
+      /**
+      * @brief Checks whether a component that is updated at its LOD update interval is updated this frame.
+      * @param[in] frame (unsigned int) The frame count.
+      * @param[in] entity (sulphur::engine::Entity) The entity of the component.
+      * @param[in] interval (unsigned int) The LOD update interval of the component, at least 1.
+      * @return (bool) Is the component updated this frame?
+      * @remarks The updates are staggered by entity, so the components don't all update on the same frame.
+      */
+      static bool IsLodUpdateFrame(unsigned int frame, Entity entity, unsigned int interval);
+
+      /**
+      * @brief Samples the local pose of an animation.
+      * @param[in] remap (const sulphur::engine::SkeletonAnimationRemap&) The remap table of the skeleton and the animation.
+      * @param[in] playback_time (float) The playback time in ticks.
+      * @param[in,out] cursors (sulphur::foundation::Vector<sulphur::engine::KeyframeCursor>&) The keyframe cursors per animation channel.
+      * @param[in] optional_bones (const sulphur::foundation::Vector<bool>&) The optional flags per bone index.
+      * @param[in] skip_optional_bones (bool) Should optional bones keep the pose of the skeleton?
+      * @param[out] pose (sulphur::foundation::PoseSoA&) The local transform per flattened node.
+      */
+      void SamplePose(
+        const SkeletonAnimationRemap& remap,
+        float playback_time,
+        foundation::Vector<KeyframeCursor>& cursors,
+        const foundation::Vector<bool>& optional_bones,
+        bool skip_optional_bones,
+        foundation::PoseSoA& pose
+      ) const;
+
+      /**
+      * @brief Retrieves the remap table of a skeleton and an animation, building it the first time.
+      * @param[in] skeleton (const sulphur::engine::SkeletonHandle&) The skeleton.
+      * @param[in] animation (const sulphur::engine::AnimationHandle&) The animation played on the skeleton.
+      * @returns (unsigned int) The index of the remap table, SkeletonAnimationRemap::kNone if either handle is invalid.
+      */
+      unsigned int GetRemap(const SkeletonHandle& skeleton, const AnimationHandle& animation);
+
+      /**
+      * @brief Checks that a remap table index still belongs to a skeleton and an animation, and marks the table as used.
+      * @param[in] remap (unsigned int) The remap table index, which may be stale or SkeletonAnimationRemap::kNone.
+      * @param[in] skeleton (const sulphur::engine::SkeletonHandle&) The skeleton.
+      * @param[in] animation (const sulphur::engine::AnimationHandle&) The animation played on the skeleton.
+      * @returns (unsigned int) The index of the remap table, retrieved again if the index didn't match.
+      */
+      unsigned int UseRemap(unsigned int remap, const SkeletonHandle& skeleton, const AnimationHandle& animation);
+
+      /**
+      * @brief Releases the remap tables that weren't used for kRemapEvictionFrames, so their assets can be unloaded.
+      * @remarks Components can keep the index of a released table, UseRemap retrieves a new table for them.
+      */
+      void EvictRemaps();
+
+      /**
+      * @brief Points a component at the remap table of its current skeleton and animation.
+      * @param[in] handle (sulphur::engine::ComponentHandleBase) The component.
+      */
+      void AssignRemap(ComponentHandleBase handle);
 
       /**
       * @brief Processes a set of Vector3Keyframes based on a given playback time in ticks, returning the exact
       *        value of the animation sequence at the given playback time.
       * @param[in] playback_time (float) The playback time of the animation in ticks.
       * @param[in] keyframes (const sulphur::foundation::Vector<sulphur::engine::Vector3Keyframe>&) The keyframes of the animation sequence that should be processed.
+      * @param[in,out] cursor (unsigned int&) The key that was sampled last, the search starts from here and it is updated to the key that is sampled now.
       * @remarks If the number of keyframes passed in is 0, the return value will be vec3(1, 1, 1).
       * @remarks If the number of keyframes passed in is 1, the return value will be keyframes[0].value.
       */
       glm::vec3 ProcessKeyframes(
         float playback_time,
-        const foundation::Vector<Vector3Keyframe>& keyframes) const;
+        const foundation::Vector<Vector3Keyframe>& keyframes,
+        unsigned int& cursor) const;
 
       /**
       * @brief Processes a set of QuaternionKeyframes based on a given playback time in ticks, returning the exact
       *        value of the animation sequence at the given playback time.
       * @param[in] playback_time (float) The playback time of the animation in ticks.
       * @param[in] keyframes (const sulphur::foundation::Vector<sulphur::engine::QuaternionKeyframe>&) The keyframes of the animation sequence that should be processed.
+      * @param[in,out] cursor (unsigned int&) The key that was sampled last, the search starts from here and it is updated to the key that is sampled now.
       * @remarks If the number of keyframes passed in is 0, the return value will be quat(1, 0, 0, 0).
       * @remarks If the number of keyframes passed in is 1, the return value will be keyframes[0].value.
       */
       glm::quat ProcessKeyframes(
         float playback_time,
-        const foundation::Vector<QuaternionKeyframe>& keyframes) const;
+        const foundation::Vector<QuaternionKeyframe>& keyframes,
+        unsigned int& cursor) const;
+
+      /**
+      * @brief Samples a compressed position or scale track at a given playback time in ticks.
+      * @param[in] playback_time (float) The playback time of the animation in ticks.
+      * @param[in] track (const sulphur::foundation::AnimationVectorTrack&) The compressed track to sample.
+      * @remarks If the track holds no keys, the return value will be vec3(1, 1, 1).
+      */
+      glm::vec3 ProcessKeyframes(
+        float playback_time,
+        const foundation::AnimationVectorTrack& track) const;
+
+      /**
+      * @brief Samples a compressed rotation track at a given playback time in ticks.
+      * @param[in] playback_time (float) The playback time of the animation in ticks.
+      * @param[in] track (const sulphur::foundation::AnimationRotationTrack&) The compressed track to sample.
+      * @remarks If the track holds no keys, the return value will be quat(1, 0, 0, 0).
+      */
+      glm::quat ProcessKeyframes(
+        float playback_time,
+        const foundation::AnimationRotationTrack& track) const;
       
     private:
       /**
       * @brief Updates all the AnimationStates in the SkinnedMeshRenderSystem.
+      * @remarks Playback times and remap tables are updated on the calling thread, the bone matrices are
+      *          calculated in batches of kAnimationBatchSize components on the workers of the application.
+      * @remarks Components that no camera sees aren't updated, unless they animate when culled. Those and
+      *          components past their LOD distance are updated once every LOD update interval.
+      * @remarks Components with a pose cache step evaluate every pose they have in common once, the bone
+      *          matrices of the others are derived from that pose afterwards.
       */
       void UpdateAnimationStates();
 
+      /**
+      * @brief Advances the cross fades and layers of a component, finishing cross fades that are done.
+      * @param[in] component_index (size_t) The index of the component.
+      * @param[in] skeleton (const sulphur::engine::SkeletonHandle&) The skeleton of the component.
+      */
+      void UpdateAnimationLayers(size_t component_index, const SkeletonHandle& skeleton);
+
+      /**
+      * @brief Gives a component that isn't updated this frame its own copy of the shared pose it rendered.
+      * @param[in] component_index (size_t) The index of the component.
+      * @remarks The shared poses are evaluated again every frame, so they can't be referenced by a component that keeps its pose.
+      */
+      void UnsharePose(size_t component_index);
+
+      /**
+      * @brief Advances the playback time and weight of an animation layer.
+      * @param[in,out] layer (sulphur::engine::AnimationLayer&) The layer.
+      * @param[in] skeleton (const sulphur::engine::SkeletonHandle&) The skeleton the layer animates.
+      * @param[in] delta_time (float) The time since the last update in seconds.
+      */
+      void UpdateAnimationLayer(AnimationLayer& layer, const SkeletonHandle& skeleton, float delta_time);
+
       /**
       * @brief Renders all the SkinnedMeshRenderComponents in the World to the screen.
       */
@@ -503,12 +1005,66 @@ namespace sulphur
       */
       SkinnedMeshRenderSystemData& data();
 
+      /**
+      * @returns (const sulphur::engine::SkinnedMeshRenderSystem::PoseCacheStats&) How well poses were shared during the last animation update.
+      */
+      const PoseCacheStats& pose_cache_stats() const;
+
+      /**
+      * @brief Retrieves the bone matrices of a component, placing the shared pose it renders if it has one.
+      * @param[in] component_index (size_t) The index of the component.
+      * @returns (const sulphur::foundation::Vector<glm::mat4>&) The bone matrices of the component.
+      * @remarks Components that share a pose are rendered straight from the shared pose, so their own bone matrices
+      *          are only filled when they are retrieved.
+      */
+      const foundation::Vector<glm::mat4>& GetBoneMatrices(size_t component_index);
+
     private:
+      World* world_;                      //!< Keep a pointer to the World this system is a part of.
       CameraSystem* camera_system_;       //!< Keep a pointer to the CameraSystem.
       TransformSystem* tranform_system_;  //!< Keep a pointer to the TransformSystem.
       IRenderer* renderer_;               //!< Keep a pointer to the IRenderer.
 
       SkinnedMeshRenderSystemData component_data_; //!< An instance of the container that stores per-component data
+
+      static constexpr unsigned int kRemapEvictionFrames = 300; //!< The amount of frames a remap table can go unused before it is released
+
+      foundation::Vector<SkeletonAnimationRemap> remaps_; //!< The remap tables of the skeletons and animations that are combined, released tables are reused
+      foundation::HashMap<uint64_t, unsigned int> remap_lookup_; //!< The remap table index per pair of skeleton and animation asset ids
+      foundation::Vector<unsigned int> free_remaps_; //!< The indices of the released remap tables
+
+      /**
+      * @struct sulphur::engine::SkinnedMeshRenderSystem::AnimationUpdate
+      * @brief A component whose bone matrices have to be calculated this frame.
+      */
+      struct AnimationUpdate
+      {
+        unsigned int component_index; //!< The index of the component
+        glm::mat4 local_to_world; //!< The transform of the entity of the component
+        bool skip_optional_bones; //!< Is the component past its bone cull distance?
+        unsigned int shared_pose; //!< The shared pose the component evaluates, SkeletonAnimationRemap::kNone if it evaluates its own bone matrices
+      };
+
+      /**
+      * @struct sulphur::engine::SkinnedMeshRenderSystem::LodCamera
+      * @brief What a camera sees, used to pick the level of detail of the animations.
+      */
+      struct LodCamera
+      {
+        const foundation::Frustum* frustum; //!< The frustum of the camera
+        glm::vec3 position; //!< The position of the camera in world space
+        LayerMask layer_mask; //!< The layers the camera renders
+      };
+
+      static constexpr size_t kAnimationBatchSize = 16; //!< The amount of components a worker calculates the bone matrices of at a time
+
+      foundation::Vector<AnimationUpdate> animation_updates_; //!< The components to calculate the bone matrices of this frame
+      foundation::HashMap<uint64_t, unsigned int> pose_cache_; //!< The shared pose index per remap table and rounded playback time of this frame
+      foundation::Vector<foundation::Vector<glm::mat4>> shared_poses_; //!< The bone matrices in model space per shared pose, rendered by every component that shares them until they are evaluated again next frame
+      PoseCacheStats pose_cache_stats_; //!< How well poses were shared during the last animation update
+      foundation::Vector<LodCamera> lod_cameras_; //!< The cameras of this frame
+      foundation::Vector<PoseScratch> pose_scratch_; //!< Scratch space per batch
+      foundation::WorkerGroup* workers_ = nullptr; //!< The workers of the application, calculate the bone matrices of the batches in parallel
     };
   }
 }
\ No newline at end of file
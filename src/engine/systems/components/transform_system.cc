@@ -8,6 +8,8 @@
 
 #include <foundation/job/job_graph.h>
 #include <foundation/job/data_policy.h>
+#include <foundation/math/transform_kernels.h>
+#include <foundation/job/worker_group.h>
 
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -85,94 +87,6 @@ namespace sulphur
       return quaternion;
     }
     
-    //-------------------------------------------------------------------------
-    // Source glm::decompose();
-    // Make a linear combination of two vectors and return the result.
-    glm::vec3 Combine(
-      glm::vec3 const& a,
-      glm::vec3 const& b,
-      float ascl, float bscl)
-    {
-      return (a * ascl) + (b * bscl);
-    }
-
-    void Decompose(const glm::mat4& model_matrix, glm::vec3& scale, glm::quat& orientation, glm::vec3& translation)
-    {
-      // Take care of translation (easy).
-      translation = glm::vec3(model_matrix[3]);
-
-      glm::mat3x3 row(model_matrix);
-      
-      // Compute X scale factor and normalize first row.
-      scale.x = glm::length(row[0]);
-      row[0] /= scale.x;
-
-      // Compute XY shear factor and make 2nd row orthogonal to 1st.
-      row[1] += (row[0] * -glm::dot(row[0], row[1]));
-
-      // Now, compute Y scale and normalize 2nd row.
-      scale.y = glm::length(row[1]);
-      row[1] /= scale.y;
-
-      // Compute XZ and YZ shears, orthogonalize 3rd row.
-      row[2] += (row[0] * -glm::dot(row[0], row[2]));
-      row[2] += (row[1] * -glm::dot(row[1], row[2]));
-
-      // Next, get Z scale and normalize 3rd row.
-      scale.z = glm::length(row[2]);
-      row[2] /= scale.z;
-
-      // At this point, the matrix (in rows[]) is orthonormal.
-      // Check for a coordinate system flip.  If the determinant
-      // is -1, then negate the matrix and the scaling factors.
-      glm::vec3 pdum3 = glm::cross(row[1], row[2]);
-      if (glm::dot(row[0], pdum3) < 0)
-      {
-        scale *= -1.0f;
-
-        for (glm::length_t i = 0; i < 3; i++)
-          row[i] *= -1.0f;
-      }
-
-      float root, trace = row[0].x + row[1].y + row[2].z;
-      if (trace > 0.0f)
-      {
-        root = glm::sqrt(trace + 1.0f);
-        orientation.w = 0.5f * root;
-        root = 0.5f / root;
-        orientation.x = root * (row[1].z - row[2].y);
-        orientation.y = root * (row[2].x - row[0].z);
-        orientation.z = root * (row[0].y - row[1].x);
-      } // End if > 0
-      else
-      {
-        constexpr int next[3] = { 1, 2, 0 };
-
-        int i = 0;
-
-        if (row[1].y > row[0].x)
-        {
-          i = 1;
-        }
-
-        if (row[2].z > row[i][i])
-        {
-          i = 2;
-        }
-
-        int j = next[i];
-        int k = next[j];
-
-        root = glm::sqrt(row[i][i] - row[j][j] - row[k][k] + 1.0f);
-
-        orientation[i] = 0.5f * root;
-        root = 0.5f / root;
-        orientation[j] = root * (row[i][j] + row[j][i]);
-        orientation[k] = root * (row[i][k] + row[k][i]);
-        orientation.w = root * (row[j][k] - row[k][j]);
-      } // End if <= 0
-    }
-
     //-------------------------------------------------------------------------
     TransformComponent::TransformComponent() :
       system_(nullptr)
@@ -726,18 +640,28 @@ namespace sulphur
     //-------------------------------------------------------------------------
     void TransformSystem::OnInitialize(Application& app, foundation::JobGraph& job_graph)
     {
+      frame_consumer_ = changes_.AddConsumer();
+      workers_ = &app.workers();
+
       const auto clear_changed_flag = [](TransformSystem& transform_system)
       {
-        for (TransformData& t : *transform_system.data_)
-        {
-          t.changed = false;
-        }
+        transform_system.changes_.Clear(transform_system.frame_consumer_);
       };
 
       // NOTE: Should be moved to update onces all globals are handled correctly
       foundation::Job renderer_endframe_job = make_job("transformsystem_clearchangedflag", "render", 
                                                        clear_changed_flag, bind_write(*this));
       job_graph.Add(std::move(renderer_endframe_job));
+
+      const auto propagate = [](TransformSystem& transform_system)
+      {
+        transform_system.PropagateTransforms();
+      };
+
+      // The renderer's start frame job waits for this one, so all rendering reads up to date matrices
+      foundation::Job propagate_job = make_job("transformsystem_propagate", "render",
+                                               propagate, bind_write(*this));
+      job_graph.Add(std::move(propagate_job));
       rewind_storage_ = foundation::Memory::Construct<TransformRewindStorage>(*this);
       app.GetService<RewindSystem>().Register(rewind_storage_->storage_);
     }
@@ -745,6 +669,7 @@ namespace sulphur
     //-------------------------------------------------------------------------
     void TransformSystem::OnTerminate()
     {
+      changes_.RemoveConsumer(frame_consumer_);
       foundation::Memory::Destruct(rewind_storage_);
     }
     
@@ -767,24 +692,115 @@ namespace sulphur
 
       TransformComponent ret(*this, sparse_array_.size());
       
-      TransformData new_data;
-      new_data.flags |= static_cast<int>(DirtyFlags::kLocal);
-      new_data.flags |= static_cast<int>(DirtyFlags::kParent);
-      new_data.local_to_parent = glm::mat4(1.0f);
-      new_data.parent = root_;
+      TransformHotData new_data;
+      new_data.local_to_world = glm::mat4(1.0f);
+      new_data.local_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+      new_data.local_position = glm::vec3(0.0f);
+      new_data.local_scale = glm::vec3(1.0f);
+      new_data.parent = root_.handle;
       new_data.child_count = 0;
-      new_data.entity = entity;
+      new_data.flags = static_cast<int>(DirtyFlags::kLocal);
+      new_data.flags |= static_cast<int>(DirtyFlags::kParent);
 
-      new_data.name = "Transform " + foundation::to_string(ret.handle);
+      // The rewinder can shrink the sparse array, so the cold data may already be larger
+      if (cold_data_.size() <= ret.handle)
+      {
+        cold_data_.resize(ret.handle + 1);
+      }
+
+      TransformColdData& new_cold_data = cold_data_[ret.handle];
+      new_cold_data.world_to_local = glm::mat4(1.0f);
+      new_cold_data.name = "Transform " + foundation::to_string(ret.handle);
+      new_cold_data.entity = entity;
+      new_cold_data.sorting_layer = SortingLayer();
 
       ++root_child_count_;
       
       dense_to_sparse_array_.emplace_back(ret.handle);
       sparse_array_.emplace_back(data_->size());
-      data_->emplace_back(eastl::move(new_data));
+      data_->emplace_back(new_data);
+      changes_.MarkChanged(ret.handle);
       return ret;
     }
     
+    //-------------------------------------------------------------------------
+    void TransformSystem::Reserve(size_t count)
+    {
+      const size_t capacity = sparse_array_.size() + count;
+      sparse_array_.reserve(capacity);
+      dense_to_sparse_array_.reserve(data_->size() + count);
+      data_->reserve(data_->size() + count);
+      cold_data_.reserve(capacity);
+    }
+
+    //-------------------------------------------------------------------------
+    void TransformSystem::CreateHierarchies(
+      const HierarchyNode* nodes,
+      size_t node_count,
+      const Entity* entities,
+      size_t copy_count,
+      const glm::mat4* root_transforms,
+      TransformComponent* out)
+    {
+      if (node_count == 0 || copy_count == 0)
+      {
+        return;
+      }
+
+      assert(nodes[0].parent == HierarchyNode::kNoParent && "The first node of a hierarchy has to be its root");
+
+      const size_t total = node_count * copy_count;
+      Reserve(total);
+
+      // The rewinder can shrink the sparse array, so the cold data may already be larger
+      if (cold_data_.size() < sparse_array_.size() + total)
+      {
+        cold_data_.resize(sparse_array_.size() + total);
+      }
+
+      TransformHotData data;
+      data.local_to_world = glm::mat4(1.0f);
+      data.flags = static_cast<int>(DirtyFlags::kLocal) | static_cast<int>(DirtyFlags::kParent);
+
+      for (size_t copy = 0; copy < copy_count; ++copy)
+      {
+        const size_t first = sparse_array_.size();
+
+        for (size_t i = 0; i < node_count; ++i)
+        {
+          const HierarchyNode& node = nodes[i];
+          const size_t handle = first + i;
+
+          data.local_rotation = node.local_rotation;
+          data.local_position = node.local_position;
+          data.local_scale = node.local_scale;
+          data.parent = node.parent == HierarchyNode::kNoParent ? root_.handle : first + node.parent;
+          data.child_count = node.child_count;
+
+          if (i == 0 && root_transforms != nullptr)
+          {
+            // The root's parent is the root node, so its local transformation is its world transformation
+            DecomposeLocal(data, root_transforms[copy]);
+          }
+
+          TransformColdData& cold_data = cold_data_[handle];
+          cold_data.world_to_local = glm::mat4(1.0f);
+          cold_data.name = node.name.empty() == true ? "Transform " + foundation::to_string(handle) : node.name;
+          cold_data.entity = entities[copy * node_count + i];
+          cold_data.sorting_layer = SortingLayer();
+
+          dense_to_sparse_array_.emplace_back(handle);
+          sparse_array_.emplace_back(data_->size());
+          data_->emplace_back(data);
+          changes_.MarkChanged(handle);
+
+          out[copy * node_count + i] = TransformComponent(*this, handle);
+        }
+
+        ++root_child_count_;
+      }
+    }
+
     //-------------------------------------------------------------------------
     void TransformSystem::Destroy(ComponentHandleBase handle)
     {
@@ -794,10 +810,10 @@ namespace sulphur
       }
       
       // First decrease parents child count
-      TransformData& data = LookUpData(handle);
-      if (data.parent != root_)
+      TransformHotData& data = LookUpData(handle);
+      if (data.parent != root_.handle)
       {
-        TransformData& old_parent_data = LookUpData(data.parent);
+        TransformHotData& old_parent_data = (*data_)[sparse_array_[data.parent].handle];
         old_parent_data.child_count--;
       }
       else
@@ -806,15 +822,13 @@ namespace sulphur
       }
 
       const size_t removed_idx = sparse_array_[handle.Handle()].handle;
-      TransformData* data_begin = data_->begin();
+      TransformHotData* data_begin = data_->begin();
 
       // Recursively remove all children
       for (int i = 0; i < data.child_count; ++i)
       {
         size_t h = dense_to_sparse_array_[removed_idx + 1 + i].handle;
-
-        TransformData& d = *(data_begin + h);
-        d.entity.Remove<TransformComponent>(TransformComponent(*this, h));
+        cold_data_[h].entity.Remove<TransformComponent>(TransformComponent(*this, h));
       }
 
       // Delete myself
@@ -849,7 +863,7 @@ namespace sulphur
     }
 
     //-------------------------------------------------------------------------
-    void TransformSystem::CalculateChildCount(foundation::Vector<TransformData>::iterator& transform_data, size_t& out_child_count)
+    void TransformSystem::CalculateChildCount(TransformHotData*& transform_data, size_t& out_child_count)
     {
       out_child_count += transform_data->child_count;
 
@@ -861,11 +875,11 @@ namespace sulphur
     }
     
     //-------------------------------------------------------------------------
-    TransformSystem::TransformData& TransformSystem::FindRootNode(TransformData& child_node, size_t& out_offset)
+    TransformSystem::TransformHotData& TransformSystem::FindRootNode(TransformHotData& child_node, size_t& out_offset)
     {
-      TransformData* node = &child_node;
+      TransformHotData* node = &child_node;
 
-      while (node->parent != root_)
+      while (node->parent != root_.handle)
       {
         ++out_offset;
         --node;
@@ -881,7 +895,7 @@ namespace sulphur
         return;
 
       const size_t temp_room = std::abs(offset);
-      foundation::Vector<TransformData> temp_storage;
+      foundation::Vector<TransformHotData> temp_storage;
       foundation::Vector<DenseHandle> temp_storage_dense;
       foundation::Vector<SparseHandle> temp_storage_sparse;
 
@@ -889,7 +903,7 @@ namespace sulphur
       temp_storage_dense.reserve(temp_room);
       temp_storage_sparse.reserve(temp_room);
       
-      TransformData* data_begin = data_->begin();
+      TransformHotData* data_begin = data_->begin();
       DenseHandle* dense_begin = dense_to_sparse_array_.begin();
       if (offset < 0)
       {
@@ -932,7 +946,7 @@ namespace sulphur
         // Store offset into temp storage
         for (size_t i = first_it + offset; i < first_it; ++i)
         {
-          TransformData& t = *(data_begin + i);
+          TransformHotData& t = *(data_begin + i);
           temp_storage.emplace_back(eastl::move(t));
 
           DenseHandle& dense = *(dense_begin + i);
@@ -988,7 +1002,7 @@ namespace sulphur
         // Store offset into temp storage
         for (size_t i = last_it; i < last_it + offset; ++i)
         {
-          TransformData& t = *(data_begin + i);
+          TransformHotData& t = *(data_begin + i);
           temp_storage.emplace_back(eastl::move(t));
 
           const DenseHandle& dense = *(dense_begin + i);
@@ -1017,8 +1031,8 @@ namespace sulphur
         return;
       }
 
-      TransformData& data = LookUpData(handle);
-      if (data.parent == parent || parent.IsValid() == false)
+      TransformHotData& data = LookUpData(handle);
+      if (data.parent == parent.Handle() || parent.IsValid() == false)
       {
         return;
       }
@@ -1026,29 +1040,26 @@ namespace sulphur
       CleanIfDirty(data, CleanFlags::kWorld);
 
       // Reduce child count on old parent
-      if (data.parent != root_)
+      if (data.parent != root_.handle)
       {
-        LookUpData(data.parent).child_count--;
+        (*data_)[sparse_array_[data.parent].handle].child_count--;
       }
       else
       {
         --root_child_count_;
       }
 
-      // Update the matrix to the parent's matrix
-      TransformData& parent_data = LookUpData(parent);
-      data.local_to_parent = parent_data.cached_world_to_local * data.cached_local_to_world;
+      // Update the local transformation relative to the parent's matrix
+      DecomposeLocal(data, GetWorldToLocal(parent) * data.local_to_world);
 
       // Invalidate this node so it can update 
       data.flags |= static_cast<int>(DirtyFlags::kParent);
-      data.parent = parent;
-
-      // TODO: Might need to invalidate the children too
+      data.parent = parent.Handle();
 
       // Calculate the amount to move the data
       const size_t parent_idx = sparse_array_[parent.Handle()].handle;
       const size_t child_idx = sparse_array_[handle.Handle()].handle;
-      TransformData* begin = data_->begin() + child_idx;
+      TransformHotData* begin = data_->begin() + child_idx;
       size_t child_count = 1;
       CalculateChildCount(begin, child_count);
 
@@ -1057,7 +1068,7 @@ namespace sulphur
       CalculateChildCount(begin, parent_offset);
 
       // Increase the parents child count after calculating it's old child count
-      parent_data.child_count++;
+      LookUpData(parent).child_count++;
 
       size_t first_it = child_idx;
       size_t last_it = child_idx + child_count;
@@ -1070,38 +1081,41 @@ namespace sulphur
       }
 
       MoveData(first_it, last_it, offset);
+
+      // The children inherit the new parent's transformation
+      MarkChanged(handle);
     }
     
     //-------------------------------------------------------------------------
     void TransformSystem::UnsetParent(TransformComponent handle)
     {
-      TransformData& data = LookUpData(handle);
+      TransformHotData& data = LookUpData(handle);
 
-      if (data.parent == root_)
+      if (data.parent == root_.handle)
       {
         return;
       }
 
       TransformComponent root = GetRoot(handle); // Calculate root before changing any data
       const size_t root_idx = sparse_array_[root.Handle()].handle;
-      TransformData* root_begin = data_->begin() + root_idx;
+      TransformHotData* root_begin = data_->begin() + root_idx;
       size_t root_child_count = 1;
       CalculateChildCount(root_begin, root_child_count);
 
       CleanIfDirty(data, CleanFlags::kWorld);
-      data.local_to_parent = data.cached_local_to_world;
+      DecomposeLocal(data, data.local_to_world);
 
-      TransformData& parent_data = LookUpData(data.parent);
+      TransformHotData& parent_data = (*data_)[sparse_array_[data.parent].handle];
       
       data.flags |= static_cast<int>(DirtyFlags::kParent);
-      data.parent = root_;
+      data.parent = root_.handle;
 
       parent_data.child_count--;
       ++root_child_count_;
       
       // Move data to after the last child in this tree node
       const size_t child_idx = sparse_array_[handle.Handle()].handle;
-      TransformData* begin = data_->begin() + child_idx;
+      TransformHotData* begin = data_->begin() + child_idx;
       size_t child_child_count = 1;
       CalculateChildCount(begin, child_child_count);
 
@@ -1110,6 +1124,7 @@ namespace sulphur
       int offset = (int)(data_->size() - child_child_count) - (int)child_idx;
       
       MoveData(first_it, last_it, offset);
+      MarkChanged(handle);
     }
 
     //-------------------------------------------------------------------------
@@ -1130,7 +1145,7 @@ namespace sulphur
 
       for (size_t i = 0; i < child_count; ++i)
       {
-        if ((*data_)[first_child_index + i].parent != parent)
+        if ((*data_)[first_child_index + i].parent != parent.Handle())
         {
           continue;
         }
@@ -1166,7 +1181,7 @@ namespace sulphur
           return sibling_index;
         }
 
-        if ((*data_)[first_child_idx + i].parent != parent)
+        if ((*data_)[first_child_idx + i].parent != parent.Handle())
         {
           continue;
         }
@@ -1205,7 +1220,7 @@ namespace sulphur
       {
         for (int i = 0; i < sibling_offset; ++offset)
         {
-          if ((*data_)[child_index + child_count + offset].parent == parent)
+          if ((*data_)[child_index + child_count + offset].parent == parent.Handle())
           {
             ++i;
           }
@@ -1215,7 +1230,7 @@ namespace sulphur
       {
         for (int i = 0; i > sibling_offset; --offset)
         {
-          if ((*data_)[child_index + offset].parent == parent)
+          if ((*data_)[child_index + offset].parent == parent.Handle())
           {
             --i;
           }
@@ -1242,7 +1257,7 @@ namespace sulphur
 
       for (size_t i = 0, child_index = 0; child_index < child_count; ++i)
       {
-        if (recursive == false && (*data_)[first_child_idx + i].parent != handle)
+        if (recursive == false && (*data_)[first_child_idx + i].parent != handle.Handle())
         {
           continue;
         }
@@ -1255,116 +1270,280 @@ namespace sulphur
       return children;
     }
 
+    //-------------------------------------------------------------------------
+    glm::mat4 TransformSystem::GetWorldToLocal(TransformComponent handle)
+    {
+      TransformHotData& data = LookUpData(handle);
+      CleanIfDirty(data, CleanFlags::kWorld);
+
+      TransformColdData& cold_data = LookUpColdData(handle);
+      if ((data.flags & static_cast<int>(DirtyFlags::kWorldToLocal)) != 0)
+      {
+        const bool scale_zero =
+          glm::vec3(data.local_to_world[0]) == glm::vec3(0.0f) ||
+          glm::vec3(data.local_to_world[1]) == glm::vec3(0.0f) ||
+          glm::vec3(data.local_to_world[2]) == glm::vec3(0.0f);
+        PS_LOG_IF(scale_zero, Warning,
+          "Accessed world-to-local matrix of an object with an effective scale of 0");
+
+        foundation::InverseAffine(&data.local_to_world, &cold_data.world_to_local, 1);
+        data.flags &= ~static_cast<int>(DirtyFlags::kWorldToLocal);
+      }
+
+      return cold_data.world_to_local;
+    }
+
     //-------------------------------------------------------------------------
     glm::vec3 TransformSystem::GetWorldPosition(TransformComponent handle)
     {
-      TransformData& data = LookUpData(handle);
+      TransformHotData& data = LookUpData(handle);
       CleanIfDirty(data, CleanFlags::kWorld);
-      return data.cached_world_position;
+      return glm::vec3(data.local_to_world[3]);
     }
     
     //-------------------------------------------------------------------------
     glm::quat TransformSystem::GetWorldRotation(TransformComponent handle)
     {
-      TransformData& data = LookUpData(handle);
+      TransformHotData& data = LookUpData(handle);
       CleanIfDirty(data, CleanFlags::kWorld);
-      return data.cached_world_rotation;
+
+      glm::quat rotation;
+      foundation::DecomposeTransforms(&data.local_to_world, nullptr, &rotation, nullptr, 1);
+      return rotation;
     }
     
     //-------------------------------------------------------------------------
     glm::vec3 TransformSystem::GetWorldScale(TransformComponent handle)
     {
-      TransformData& data = LookUpData(handle);
+      TransformHotData& data = LookUpData(handle);
       CleanIfDirty(data, CleanFlags::kWorld);
-      return data.cached_world_scale;
+
+      glm::vec3 scale;
+      foundation::DecomposeTransforms(&data.local_to_world, nullptr, nullptr, &scale, 1);
+      return scale;
     }
 
     //-------------------------------------------------------------------------
     glm::vec3 TransformSystem::GetLocalPosition(TransformComponent handle)
     {
-      TransformData& data = LookUpData(handle);
-      CleanIfDirty(data, CleanFlags::kLocal);
-      return data.cached_local_position;
+      return LookUpData(handle).local_position;
     }
 
     //-------------------------------------------------------------------------
     glm::quat TransformSystem::GetLocalRotation(TransformComponent handle)
     {
-      TransformData& data = LookUpData(handle);
-      CleanIfDirty(data, CleanFlags::kLocal);
-      return data.cached_local_rotation;
+      return LookUpData(handle).local_rotation;
     }
 
     //-------------------------------------------------------------------------
     glm::vec3 TransformSystem::GetLocalScale(TransformComponent handle)
     {
-      TransformData& data = LookUpData(handle);
-      CleanIfDirty(data, CleanFlags::kLocal);
-      return data.cached_local_scale;
+      return LookUpData(handle).local_scale;
     }
 
     //-------------------------------------------------------------------------
     SortingLayer TransformSystem::GetSortingLayer(TransformComponent handle) const
     {
-      return LookUpData(handle).sorting_layer;
+      return LookUpColdData(handle).sorting_layer;
     }
 
     //-------------------------------------------------------------------------
     void TransformSystem::SetSortingLayer(TransformComponent handle, const SortingLayer& sorting_layer)
     {
-      LookUpData(handle).sorting_layer = sorting_layer;
+      LookUpColdData(handle).sorting_layer = sorting_layer;
+    }
+
+    //-------------------------------------------------------------------------
+    glm::mat4 TransformSystem::ComposeLocal(const TransformHotData& data)
+    {
+      glm::mat4 local_to_parent;
+      foundation::ComposeTransforms(
+        &data.local_position,
+        &data.local_rotation,
+        &data.local_scale,
+        &local_to_parent,
+        1);
+      return local_to_parent;
+    }
+
+    //-------------------------------------------------------------------------
+    void TransformSystem::DecomposeLocal(TransformHotData& data, const glm::mat4& local_to_parent)
+    {
+      foundation::DecomposeTransforms(
+        &local_to_parent,
+        &data.local_position,
+        &data.local_rotation,
+        &data.local_scale,
+        1);
     }
 
     //-------------------------------------------------------------------------
-    void TransformSystem::CleanIfDirty(TransformData& data, CleanFlags flag)
+    void TransformSystem::PropagateTransforms()
     {
-      auto rebuild_world = [](TransformData& data, TransformData* parent = nullptr)
+      const size_t num_nodes = data_->size();
+      const TransformHotData* data_begin = data_->begin();
+
+      propagate_depths_.resize(num_nodes);
+      propagate_levels_.clear();
+
+      // Find the depth of every node and which nodes are dirty, parents always precede their children
+      size_t num_dirty = 0;
+      for (size_t i = 0; i < num_nodes; ++i)
       {
-        if (parent == nullptr)
+        const TransformHotData& node = data_begin[i];
+
+        uint32_t depth = 0;
+        bool parent_dirty = false;
+        if (node.parent != root_.handle)
         {
-          data.cached_local_to_world = data.local_to_parent;
-          data.cached_world_to_local = glm::inverse(data.cached_local_to_world);
+          const uint32_t parent_depth = propagate_depths_[sparse_array_[node.parent].handle];
+          parent_dirty = (parent_depth & kDirtyDepth) != 0;
+          depth = (parent_depth & ~kDirtyDepth) + 1;
         }
-        else
+
+        if (parent_dirty == true || (node.flags & static_cast<int>(DirtyFlags::kWorld)) != 0)
+        {
+          if (propagate_levels_.size() < depth + 2)
+          {
+            propagate_levels_.resize(depth + 2, 0);
+          }
+          ++propagate_levels_[depth + 1];
+          ++num_dirty;
+
+          depth |= kDirtyDepth;
+        }
+
+        propagate_depths_[i] = depth;
+      }
+
+      if (num_dirty == 0)
+      {
+        return;
+      }
+
+      // Sort the dirty nodes by depth, afterwards every entry contains the end of its level
+      for (size_t i = 1; i < propagate_levels_.size(); ++i)
+      {
+        propagate_levels_[i] += propagate_levels_[i - 1];
+      }
+
+      propagate_order_.resize(num_dirty);
+      for (size_t i = 0; i < num_nodes; ++i)
+      {
+        const uint32_t depth = propagate_depths_[i];
+        if ((depth & kDirtyDepth) != 0)
         {
-          data.cached_local_to_world = parent->cached_local_to_world * data.local_to_parent;
-          data.cached_world_to_local = glm::inverse(data.cached_local_to_world);
+          propagate_order_[propagate_levels_[depth & ~kDirtyDepth]++] = i;
         }
+      }
 
-        Decompose(
-          data.cached_local_to_world, 
-          data.cached_world_scale,
-          data.cached_world_rotation,
-          data.cached_world_position);
-
-        Decompose(
-          data.local_to_parent,
-          data.cached_local_scale,
-          data.cached_local_rotation,
-          data.cached_local_position);
-      };
-      
-      if (flag != CleanFlags::kNone)
+      // Nodes only depend on the level above them, so every level is split into independent batches
+      size_t level_begin = 0;
+      for (size_t level = 0; level + 1 < propagate_levels_.size(); ++level)
       {
-        size_t unused = 0;
-        TransformData* begin = &FindRootNode(data, unused);
-        TransformData* end = &data; ++end;
+        const size_t level_end = propagate_levels_[level];
+        const size_t batch_count = (level_end - level_begin + kPropagateBatchSize - 1) / kPropagateBatchSize;
+
+        const auto propagate_batch = [this, level_begin, level_end](size_t batch)
+        {
+          const size_t batch_begin = level_begin + batch * kPropagateBatchSize;
+          const size_t batch_end = eastl::min(batch_begin + kPropagateBatchSize, level_end);
+          PropagateBatch(propagate_order_.data() + batch_begin, propagate_order_.data() + batch_end);
+        };
 
-        TransformData* parent = nullptr;
-        bool rebuild = false;
-        for (TransformData* it = begin; it != end; ++it)
+        // The next level reads the matrices of this one, so every level waits for its batches
+        if (batch_count > 1 && workers_ != nullptr)
         {
-          if (rebuild == false && it->flags == 0)
+          workers_->Dispatch(batch_count, propagate_batch);
+          workers_->Wait();
+        }
+        else
+        {
+          for (size_t batch = 0; batch < batch_count; ++batch)
           {
-            continue;
+            propagate_batch(batch);
           }
-          rebuild = true;
+        }
+
+        level_begin = level_end;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void TransformSystem::PropagateBatch(const size_t* begin, const size_t* end)
+    {
+      TransformHotData* data_begin = data_->begin();
+      const size_t count = end - begin;
+      assert(count <= kPropagateBatchSize);
+
+      // Build all local matrices of the batch at once
+      glm::vec3 positions[kPropagateBatchSize];
+      glm::quat rotations[kPropagateBatchSize];
+      glm::vec3 scales[kPropagateBatchSize];
+      glm::mat4 local_to_parent[kPropagateBatchSize];
+      for (size_t i = 0; i < count; ++i)
+      {
+        const TransformHotData& node = data_begin[begin[i]];
+        positions[i] = node.local_position;
+        rotations[i] = node.local_rotation;
+        scales[i] = node.local_scale;
+      }
+
+      foundation::ComposeTransforms(positions, rotations, scales, local_to_parent, count);
 
-          parent = it->parent == root_ ? nullptr : &LookUpData(it->parent); // TODO: Get parent directly
-          rebuild_world(*it, parent);
+      for (size_t i = 0; i < count; ++i)
+      {
+        TransformHotData& node = data_begin[begin[i]];
 
-          it->flags = 0;
+        if (node.parent == root_.handle)
+        {
+          node.local_to_world = local_to_parent[i];
+        }
+        else
+        {
+          const TransformHotData& parent = data_begin[sparse_array_[node.parent].handle];
+          foundation::MultiplyAffine(parent.local_to_world, local_to_parent[i], node.local_to_world);
         }
+
+        // The inverse is only calculated when it is requested
+        node.flags = static_cast<int>(DirtyFlags::kWorldToLocal);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void TransformSystem::CleanIfDirty(TransformHotData& data, CleanFlags flag)
+    {
+      // Changing a node invalidates its whole subtree, so a clean node has clean parents
+      if (flag == CleanFlags::kNone || (data.flags & static_cast<int>(DirtyFlags::kWorld)) == 0)
+      {
+        return;
+      }
+
+      size_t unused = 0;
+      TransformHotData* begin = &FindRootNode(data, unused);
+      TransformHotData* end = &data; ++end;
+
+      bool rebuild = false;
+      for (TransformHotData* it = begin; it != end; ++it)
+      {
+        if (rebuild == false && (it->flags & static_cast<int>(DirtyFlags::kWorld)) == 0)
+        {
+          continue;
+        }
+        rebuild = true;
+
+        if (it->parent == root_.handle)
+        {
+          it->local_to_world = ComposeLocal(*it);
+        }
+        else
+        {
+          const TransformHotData& parent = (*data_)[sparse_array_[it->parent].handle]; // TODO: Get parent directly
+          foundation::MultiplyAffine(parent.local_to_world, ComposeLocal(*it), it->local_to_world);
+        }
+
+        // The inverse is only calculated when it is requested
+        it->flags = static_cast<int>(DirtyFlags::kWorldToLocal);
       }
     }
   }
@@ -2,6 +2,7 @@
 
 #include "engine/core/entity_system.h"
 #include "engine/systems/component_system.h"
+#include "engine/systems/change_tracker.h"
 #include "engine/scripting/scriptable_object.h"
 #include "engine/utilities/layer.h"
 
@@ -16,6 +17,11 @@
 
 namespace sulphur
 {
+  namespace foundation
+  {
+    class WorkerGroup;
+  }
+
   namespace engine
   {
     class TransformSystem;
@@ -583,6 +589,23 @@ namespace sulphur
 
     };
 
+    /**
+    * @struct sulphur::engine::HierarchyNode
+    * @brief Describes a node of a hierarchy that is created as a whole
+    * @see sulphur::engine::TransformSystem::CreateHierarchies
+    */
+    struct HierarchyNode
+    {
+      static constexpr size_t kNoParent = PS_SIZE_MAX; //!< The parent of the hierarchy's root
+
+      size_t parent; //!< The index of the parent node in the hierarchy, nodes have to be ordered depth-first
+      size_t child_count; //!< The amount of direct children
+      glm::vec3 local_position; //!< The position relative to the parent
+      glm::quat local_rotation; //!< The rotation relative to the parent
+      glm::vec3 local_scale; //!< The scale relative to the parent
+      foundation::String name; //!< The name of the node, a default name is used when empty
+    };
+
     /**
     * @class sulphur::engine::TransformSystem : public sulphur::engine::IComponentSystem<sulphur::engine::TransformComponent>
     * @brief Manages the internal data and lifetime for all instances of sulphur::engine::TransformComponent
@@ -593,7 +616,7 @@ namespace sulphur
     public:
       friend TransformRewindStorage;//<! Workaround to give access to the data since this system is not using system data
     private:
-      struct TransformData;//<! Forward declaration of the transform data
+      struct TransformHotData;//<! Forward declaration of the hierarchy-ordered transform data
     public:
       template<typename T>
       friend inline void* Store( T* buffer, size_t size );//<! Hack since it is not using system data
@@ -620,6 +643,30 @@ namespace sulphur
       */
       TransformComponent Create(Entity& entity);
 
+      /**
+      * @see sulphur::engine::IComponentSystem::Reserve
+      */
+      void Reserve(size_t count) override;
+
+      /**
+      * @brief Creates copies of a hierarchy at once, appending each copy to the end of the hierarchy
+      * @param[in] nodes (const sulphur::engine::HierarchyNode*) The nodes of the hierarchy in depth-first order, starting with its root
+      * @param[in] node_count (size_t) The amount of nodes in the hierarchy
+      * @param[in] entities (const sulphur::engine::Entity*) The entities owning the nodes, node_count entities per copy
+      * @param[in] copy_count (size_t) The amount of copies to create
+      * @param[in] root_transforms (const glm::mat4*) The world transformation of the root of every copy, uses the root's local transformation if nullptr
+      * @param[out] out (sulphur::engine::TransformComponent*) The created components, node_count per copy
+      * @remarks The roots are attached to the root node. As every copy is appended as a contiguous block, no existing data has to move.
+      * @remarks The components aren't linked to the entities, that's left to the caller.
+      */
+      void CreateHierarchies(
+        const HierarchyNode* nodes,
+        size_t node_count,
+        const Entity* entities,
+        size_t copy_count,
+        const glm::mat4* root_transforms,
+        TransformComponent* out);
+
       /**
       * @see sulphur::engine::BaseSystem::OnInitialize
       */
@@ -672,6 +719,21 @@ namespace sulphur
       */
       bool HasChanged(TransformComponent handle) const;
 
+      /**
+      * @brief The change tracker of the transforms, systems that react to moved transforms register a consumer with it
+      * @remarks A transform is marked when it's created and when it or any of its parents is moved
+      * @return (sulphur::engine::ChangeTracker&) The change tracker, indexed by sparse handle
+      */
+      ChangeTracker& changes();
+      /**
+      * @brief Calls a function for every transform that changed since a consumer last read the changes
+      * @param[in] consumer (size_t) The consumer registered with sulphur::engine::TransformSystem::changes
+      * @param[in] func (Func&&) Function taking the sulphur::engine::TransformComponent that changed
+      * @remarks Transforms that were destroyed after they changed are skipped
+      */
+      template<typename Func>
+      void ForEachChanged(size_t consumer, Func&& func);
+
       /**
       * @brief Gets the entity associated with the specified node
       * @param[in] handle (sulphur::engine::TransformComponent) The node of which to return the associated entity
@@ -821,6 +883,57 @@ namespace sulphur
       */
       void SetSortingLayer(TransformComponent handle, const SortingLayer& sorting_layer);
 
+      /**
+      * @brief Rebuilds the local-to-world matrices of all nodes that have changed, level by level
+      * @remarks Runs once per frame before rendering, so reads afterwards don't need to walk the hierarchy.
+      *          Nodes changed after this pass are still rebuilt lazily when they are accessed.
+      * @remarks Levels with more than one batch are spread over the workers of the application.
+      */
+      void PropagateTransforms();
+
+      /**
+      * @struct sulphur::engine::TransformSystem::ViewElement
+      * @brief The transform data yielded by sulphur::engine::ComponentView
+      * @remarks Modifications still have to go through sulphur::engine::TransformComponent
+      */
+      struct ViewElement
+      {
+        const glm::mat4& local_to_world; //!< The local-to-world matrix as of the last propagation
+        const SortingLayer& sorting_layer; //!< The sorting layer of the node
+      };
+
+      /**
+      * @see sulphur::engine::ComponentView
+      * @remarks Propagates the transforms that changed since the last propagation, so views never yield stale matrices
+      */
+      void PrepareView() { PropagateTransforms(); }
+      /**
+      * @see sulphur::engine::ComponentView
+      * @return (size_t) The amount of transforms
+      */
+      size_t ViewCount() const;
+      /**
+      * @see sulphur::engine::ComponentView
+      * @param[in] index (size_t) The hierarchy index of the transform
+      * @return (sulphur::engine::Entity) The entity of the transform
+      */
+      Entity ViewEntity(size_t index) const;
+      /**
+      * @see sulphur::engine::ComponentView
+      * @param[in] handle (sulphur::engine::ComponentHandleBase) The transform to look-up
+      * @return (size_t) The hierarchy index of the transform
+      */
+      size_t ViewIndex(ComponentHandleBase handle) const;
+      /**
+      * @see sulphur::engine::ComponentView
+      * @param[in] index (size_t) The hierarchy index of the transform
+      * @return (sulphur::engine::TransformSystem::ViewElement) The data of the transform
+      * @remarks This doesn't clean the matrix, so views can be split across threads.
+      *          sulphur::engine::TransformSystem::PrepareView propagates the transforms when the view is constructed,
+      *          so the transforms can't be changed while they are viewed.
+      */
+      ViewElement ViewAt(size_t index) const;
+
     private:
       /**
       * @struct sulphur::engine::SparseHandle
@@ -858,41 +971,36 @@ namespace sulphur
       };
 
       /**
-      * @struct sulphur::engine::TransformData
-      * @brief The internal data per-component
+      * @struct sulphur::engine::TransformSystem::TransformHotData
+      * @brief The per-component data used by hierarchy passes, stored in hierarchy order
+      * @remarks Only contains trivially copyable data so the rewinder can copy it as a whole
       * @author Maarten ten Velden
       */
-      struct TransformData
+      struct TransformHotData
       {
-        /// Disable copying to prevent accidental mistakes
-        TransformData() = default;
-        TransformData(const TransformData&) = delete;
-        TransformData(TransformData&&) = default;
-        TransformData& operator=(TransformData&&) = default;
-
-        TransformComponent parent;
-        size_t child_count;
-
-        /// Cached values (don't edit directly)
-        glm::vec3 cached_local_position;
-        glm::quat cached_local_rotation;
-        glm::vec3 cached_local_scale;
-        glm::vec3 cached_world_position;
-        glm::quat cached_world_rotation;
-        glm::vec3 cached_world_scale;
-
-        glm::mat4 local_to_parent;
-        glm::mat4 cached_local_to_world;
-        glm::mat4 cached_world_to_local;
+        glm::mat4 local_to_world; //!< Cached transformation from local to world space (don't edit directly)
 
-        int flags; //!< Any of the sulphur::engine::DirtyFlags or'ed together
+        glm::quat local_rotation; //!< The rotation relative to the parent
+        glm::vec3 local_position; //!< The position relative to the parent
+        glm::vec3 local_scale; //!< The scale relative to the parent
 
-        bool changed;
+        size_t parent; //!< The sparse handle of the parent, equal to the root's handle if the node has no parent
+        size_t child_count; //!< The amount of direct children
 
-        foundation::String name;
+        int flags; //!< Any of the sulphur::engine::DirtyFlags or'ed together
+      };
 
-        Entity entity;
-        SortingLayer sorting_layer;
+      /**
+      * @struct sulphur::engine::TransformSystem::TransformColdData
+      * @brief The per-component data that is rarely accessed, indexed by the component's sparse handle
+      * @remarks Does not move when the hierarchy is re-ordered
+      */
+      struct TransformColdData
+      {
+        glm::mat4 world_to_local; //!< Lazily calculated inverse of sulphur::engine::TransformSystem::TransformHotData::local_to_world
+        foundation::String name; //!< The name of the node
+        Entity entity; //!< The entity owning the component
+        SortingLayer sorting_layer; //!< The sorting layer used when rendering the entity
       };
 
       /**
@@ -903,6 +1011,8 @@ namespace sulphur
         kClean = 0, //!< Default state, nothing needs to be rebuilt
         kLocal = 1 << 0, //!< The node's local transformation components have changed
         kParent = 1 << 1, //!< The node has received a new parent
+        kWorldToLocal = 1 << 2, //!< The cached world-to-local matrix is out of date
+        kWorld = kLocal | kParent //!< The flags that require the local-to-world matrix to be rebuilt
       };
       /**
       * @brief An enumerator to indicate which components of a node require recalculating
@@ -910,47 +1020,84 @@ namespace sulphur
       enum struct CleanFlags : int
       {
         kNone = 0, //!< Nothing will be recalculated
-        kLocal = 1 << 0,//!< Local transformation data will be recalculated
-        kWorld = 1 << 1, //!< All transformation data and that of any of the node's parents will be recalculated
+        kWorld = 1 << 1, //!< The node's local-to-world matrix and that of any of the node's parents will be recalculated
       };
       
       /**
       * @brief Calculates the child count starting at root node
-      * @param[in] root_node (foundation::Vector<TransformData>::iterator&) Pointer to the node for which to calculate the child count
+      * @param[in] root_node (sulphur::engine::TransformSystem::TransformHotData*&) Pointer to the node for which to calculate the child count
       * @param[out] out_child_count (size_t) The amount of children this root node has
       * @remarks This is excluding the root node
       */
-      void CalculateChildCount(foundation::Vector<TransformData>::iterator& root_node, size_t& out_child_count);
+      void CalculateChildCount(TransformHotData*& root_node, size_t& out_child_count);
 
       /**
       * @brief Finds the top-most node of this child
-      * @param[in] child_node (TransformData&) Pointer to the child node to find the root for
+      * @param[in] child_node (TransformHotData&) Pointer to the child node to find the root for
       * @param[out] out_offset (size_t&) The amount of nodes it moved up or down the hierarchy to get to the root node
       * @return The top-most node of this child
       */
-      TransformData& FindRootNode(TransformData& child_node, size_t& out_offset);
+      TransformHotData& FindRootNode(TransformHotData& child_node, size_t& out_offset);
 
       foundation::Vector<SparseHandle> sparse_array_; //!< @todo Delegate to specialized class
       foundation::Vector<DenseHandle> dense_to_sparse_array_; //!< @Todo Delegate to specialized class
-      foundation::Resource<foundation::Vector<TransformData>> data_ = foundation::Resource<foundation::Vector<TransformData>>("TransformData"); //!< @todo Delegate to specialized class
+      foundation::Resource<foundation::Vector<TransformHotData>> data_ = foundation::Resource<foundation::Vector<TransformHotData>>("TransformData"); //!< @todo Delegate to specialized class
+      foundation::Vector<TransformColdData> cold_data_; //!< Rarely accessed data, indexed by sparse handle
       
       TransformComponent root_; //!< A handle-representation of the root node
       size_t root_child_count_; //!< The amount of entities that have the root node as a parent
 
       TransformRewindStorage* rewind_storage_; //<! A class to feed the data to the rewinder 
 
+      ChangeTracker changes_; //!< The transforms that changed, indexed by sparse handle
+      size_t frame_consumer_; //!< The consumer of sulphur::engine::TransformSystem::changes_ that is cleared every frame, used by sulphur::engine::TransformSystem::HasChanged
+
+      static constexpr size_t kPropagateBatchSize = 64; //!< The maximum amount of nodes of a level updated as one batch
+      static constexpr uint32_t kDirtyDepth = 1u << 31; //!< Marks the depth of a dirty node in sulphur::engine::TransformSystem::propagate_depths_
+
+      foundation::Vector<uint32_t> propagate_depths_; //!< The depth of every node in hierarchy order, with the top bit set if the node is dirty
+      foundation::Vector<size_t> propagate_order_; //!< The hierarchy indices of the dirty nodes sorted by depth
+      foundation::Vector<size_t> propagate_levels_; //!< The end of every level in sulphur::engine::TransformSystem::propagate_order_
+      foundation::WorkerGroup* workers_ = nullptr; //!< The workers of the application, update the batches of a level in parallel
+
       /**
       * @brief Rebuild the data of a transform node
-      * @param[in] data (sulphur::engine::TransformData&) The internal data to clean
+      * @param[in] data (sulphur::engine::TransformSystem::TransformHotData&) The internal data to clean
       * @param[in] flag (sulphur::engine::CleanFlags) Any of the sulphur::engine::CleanFlags
       * @remarks If sulphur::engine::CleanFlags::kWorld is specified the cleaning process will clean the node's parents as well
+      * @remarks Fallback for nodes changed after sulphur::engine::TransformSystem::PropagateTransforms ran this frame
+      */
+      void CleanIfDirty(TransformHotData& data, CleanFlags flag);
+      /**
+      * @brief Rebuilds the local-to-world matrices of a batch of nodes
+      * @param[in] begin (const size_t*) The first hierarchy index of the batch
+      * @param[in] end (const size_t*) One past the last hierarchy index of the batch
+      * @remarks The parents of the nodes must be up to date. Nodes of the same depth don't depend on each other,
+      *          so batches of a single level can be processed in any order.
+      */
+      void PropagateBatch(const size_t* begin, const size_t* end);
+      /**
+      * @brief Calculates the local-to-parent matrix from the local position, rotation and scale
+      * @param[in] data (const sulphur::engine::TransformSystem::TransformHotData&) The node to calculate the matrix of
+      * @return (glm::mat4) The local-to-parent matrix
       */
-      void CleanIfDirty(TransformData& data, CleanFlags flag);
+      static glm::mat4 ComposeLocal(const TransformHotData& data);
+      /**
+      * @brief Sets the local position, rotation and scale of a node from a local-to-parent matrix
+      * @param[in] data (sulphur::engine::TransformSystem::TransformHotData&) The node to set the local transformation of
+      * @param[in] local_to_parent (const glm::mat4&) The local-to-parent matrix
+      */
+      static void DecomposeLocal(TransformHotData& data, const glm::mat4& local_to_parent);
+      /**
+      * @brief Marks a node and all of its children as changed so their matrices are rebuilt on the next access
+      * @param[in] handle (sulphur::engine::TransformComponent) The node that was changed
+      */
+      void MarkChanged(TransformComponent handle);
       /**
       * @brief Look up the internal data of associated with a component handle
       * @param[in] handle (sulphur::engine::TransformComponent) The component of which to look-up the data
       */
-      const TransformData& LookUpData(ComponentHandleBase handle) const
+      const TransformHotData& LookUpData(ComponentHandleBase handle) const
       {
         assert(handle != root_ && "Attempted to access/modify the root node");
         assert(handle.Handle() < sparse_array_.size());
@@ -961,11 +1108,30 @@ namespace sulphur
       * @brief Look up the internal data of associated with a component handle
       * @param[in] handle (sulphur::engine::TransformComponent) The component of which to look-up the data
       */
-      TransformData& LookUpData(ComponentHandleBase handle)
+      TransformHotData& LookUpData(ComponentHandleBase handle)
       {
-        return const_cast<TransformData&>(
+        return const_cast<TransformHotData&>(
           static_cast<const TransformSystem*>(this)->LookUpData(handle));
       }
+      /**
+      * @brief Look up the rarely accessed data associated with a component handle
+      * @param[in] handle (sulphur::engine::TransformComponent) The component of which to look-up the data
+      */
+      const TransformColdData& LookUpColdData(ComponentHandleBase handle) const
+      {
+        assert(handle != root_ && "Attempted to access/modify the root node");
+        assert(handle.Handle() < cold_data_.size());
+        return cold_data_[handle.Handle()];
+      }
+      /**
+      * @brief Look up the rarely accessed data associated with a component handle
+      * @param[in] handle (sulphur::engine::TransformComponent) The component of which to look-up the data
+      */
+      TransformColdData& LookUpColdData(ComponentHandleBase handle)
+      {
+        return const_cast<TransformColdData&>(
+          static_cast<const TransformSystem*>(this)->LookUpColdData(handle));
+      }
 
       /**
       * @brief Moves transform data between `first` and `last` offset spaces
@@ -980,43 +1146,32 @@ namespace sulphur
     //-------------------------------------------------------------------------
     inline glm::mat4 TransformSystem::GetLocal(TransformComponent handle) const
     {
-      return LookUpData(handle).local_to_parent;
+      return ComposeLocal(LookUpData(handle));
     }
 
     //-------------------------------------------------------------------------
     inline glm::mat4 TransformSystem::GetLocalToWorld(TransformComponent handle)
     {
-      TransformData& data = LookUpData(handle);
-      CleanIfDirty(data, CleanFlags::kWorld);
-      return data.cached_local_to_world;
-    }
-
-    //-------------------------------------------------------------------------
-    inline glm::mat4 TransformSystem::GetWorldToLocal(TransformComponent handle)
-    {
-      TransformData& data = LookUpData(handle);
+      TransformHotData& data = LookUpData(handle);
       CleanIfDirty(data, CleanFlags::kWorld);
-
-      const bool scale_zero =
-        data.cached_world_scale.x == 0.0f ||
-        data.cached_world_scale.y == 0.0f ||
-        data.cached_world_scale.z == 0.0f;
-      PS_LOG_IF(scale_zero, Warning,
-        "Accessed world-to-local matrix of an object with an effective scale of 0");
-
-      return data.cached_world_to_local;
+      return data.local_to_world;
     }
 
     //-------------------------------------------------------------------------
     inline bool TransformSystem::HasParent(TransformComponent handle) const
     {
-      return LookUpData(handle).parent != root_;
+      return LookUpData(handle).parent != root_.handle;
     }
 
     //-------------------------------------------------------------------------
     inline TransformComponent TransformSystem::GetParent(TransformComponent handle) const
     {
-      return LookUpData(handle).parent;
+      const size_t parent = LookUpData(handle).parent;
+      if (parent == root_.handle)
+      {
+        return root_;
+      }
+      return TransformComponent(*const_cast<TransformSystem*>(this), parent);
     }
 
     //-------------------------------------------------------------------------
@@ -1039,13 +1194,62 @@ namespace sulphur
     //-------------------------------------------------------------------------
     inline Entity TransformSystem::GetEntity(TransformComponent handle)
     {
-      return LookUpData(handle).entity;
+      return LookUpColdData(handle).entity;
+    }
+
+    //-------------------------------------------------------------------------
+    inline size_t TransformSystem::ViewCount() const
+    {
+      return data_->size();
+    }
+
+    //-------------------------------------------------------------------------
+    inline Entity TransformSystem::ViewEntity(size_t index) const
+    {
+      return cold_data_[dense_to_sparse_array_[index].handle].entity;
+    }
+
+    //-------------------------------------------------------------------------
+    inline size_t TransformSystem::ViewIndex(ComponentHandleBase handle) const
+    {
+      return sparse_array_[handle.handle].handle;
+    }
+
+    //-------------------------------------------------------------------------
+    inline TransformSystem::ViewElement TransformSystem::ViewAt(size_t index) const
+    {
+      const TransformHotData& data = (*data_)[index];
+      assert((data.flags & static_cast<int>(DirtyFlags::kWorld)) == 0 &&
+        "Transforms were viewed before they were propagated or after they were changed");
+      return ViewElement{
+        data.local_to_world,
+        cold_data_[dense_to_sparse_array_[index].handle].sorting_layer };
     }
 
     //-------------------------------------------------------------------------
     inline bool TransformSystem::HasChanged(TransformComponent handle) const
     {
-      return LookUpData(handle).changed;
+      assert(handle != root_ && "Attempted to access/modify the root node");
+      return changes_.IsChanged(frame_consumer_, handle.Handle());
+    }
+
+    //-------------------------------------------------------------------------
+    inline ChangeTracker& TransformSystem::changes()
+    {
+      return changes_;
+    }
+
+    //-------------------------------------------------------------------------
+    template<typename Func>
+    inline void TransformSystem::ForEachChanged(size_t consumer, Func&& func)
+    {
+      changes_.ForEachChanged(consumer, [this, &func](size_t index)
+      {
+        if (index < sparse_array_.size() && sparse_array_[index].handle < data_->size())
+        {
+          func(TransformComponent(*this, index));
+        }
+      });
     }
 
     //-------------------------------------------------------------------------
@@ -1061,7 +1265,7 @@ namespace sulphur
         {
           size_t index = sparse_array_[handle.Handle()].handle;
 
-          TransformData* begin = data_->begin() + index;
+          TransformHotData* begin = data_->begin() + index;
           size_t child_count = 0;
           CalculateChildCount(begin, child_count);
 
@@ -1090,79 +1294,41 @@ namespace sulphur
     //-------------------------------------------------------------------------
     inline void TransformSystem::SetLocalPosition(TransformComponent handle, const glm::vec3& position)
     {
-      TransformData& data = LookUpData(handle);
-      CleanIfDirty(data, CleanFlags::kWorld);
-
-      data.local_to_parent = glm::translate(glm::mat4(1.0f), position);
-      data.local_to_parent *= glm::mat4_cast(data.cached_local_rotation);
-      data.local_to_parent = glm::scale(data.local_to_parent, data.cached_local_scale);
-
-      data.flags |= static_cast<int>(DirtyFlags::kLocal);
-      data.changed = true;
-
-
-      size_t parent_index = sparse_array_[handle.Handle()].handle;
-      size_t child_count = GetChildCount(handle, true);
-
-      TransformData* begin = data_->begin() + parent_index;
-      TransformData* end = begin + child_count + 1;
-
-      for (TransformData* it = begin; it != end; ++it)
-      {
-        it->flags |= static_cast<int>(DirtyFlags::kLocal);
-        it->changed = true;
-      }
+      LookUpData(handle).local_position = position;
+      MarkChanged(handle);
     }
 
     //-------------------------------------------------------------------------
     inline void TransformSystem::SetLocalRotation(TransformComponent handle, const glm::quat& rotation)
     {
-      TransformData& data = LookUpData(handle);
-      CleanIfDirty(data, CleanFlags::kWorld);
-
-      data.local_to_parent = glm::translate(glm::mat4(1.0f), data.cached_local_position);
-      data.local_to_parent *= glm::mat4_cast(rotation);
-      data.local_to_parent = glm::scale(data.local_to_parent, data.cached_local_scale);
-      
-      data.flags |= static_cast<int>(DirtyFlags::kLocal);
-      data.changed = true;
-
-      size_t parent_index = sparse_array_[handle.Handle()].handle;
-      size_t child_count = GetChildCount(handle, true);
-
-      TransformData* begin = data_->begin() + parent_index;
-      TransformData* end = begin + child_count + 1;
-
-      for (TransformData* it = begin; it != end; ++it)
-      {
-        it->flags |= static_cast<int>(DirtyFlags::kLocal);
-        it->changed = true;
-      }
+      LookUpData(handle).local_rotation = rotation;
+      MarkChanged(handle);
     }
 
     //-------------------------------------------------------------------------
     inline void TransformSystem::SetLocalScale(TransformComponent handle, const glm::vec3& scale)
     {
-      TransformData& data = LookUpData(handle);
-      CleanIfDirty(data, CleanFlags::kWorld);
-
-      data.local_to_parent = glm::translate(glm::mat4(1.0f), data.cached_local_position);
-      data.local_to_parent *= glm::mat4_cast(data.cached_local_rotation);
-      data.local_to_parent = glm::scale(data.local_to_parent, scale);
-
-      data.flags |= static_cast<int>(DirtyFlags::kLocal);
-      data.changed = true;
+      LookUpData(handle).local_scale = scale;
+      MarkChanged(handle);
+    }
 
+    //-------------------------------------------------------------------------
+    inline void TransformSystem::MarkChanged(TransformComponent handle)
+    {
       size_t parent_index = sparse_array_[handle.Handle()].handle;
       size_t child_count = GetChildCount(handle, true);
 
-      TransformData* begin = data_->begin() + parent_index;
-      TransformData* end = begin + child_count + 1;
+      TransformHotData* begin = data_->begin() + parent_index;
+      TransformHotData* end = begin + child_count + 1;
 
-      for (TransformData* it = begin; it != end; ++it)
+      for (TransformHotData* it = begin; it != end; ++it)
       {
         it->flags |= static_cast<int>(DirtyFlags::kLocal);
-        it->changed = true;
+      }
+
+      for (size_t i = parent_index; i <= parent_index + child_count; ++i)
+      {
+        changes_.MarkChanged(dense_to_sparse_array_[i].handle);
       }
     }
   }
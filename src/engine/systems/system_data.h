@@ -7,6 +7,7 @@
 #include <foundation/utils/type_definitions.h>
 #include <foundation/utils/template_util.h>
 #include <foundation/memory/memory.h>
+#include <foundation/memory/virtual_memory.h>
 #include <foundation/containers/array.h>
 #include <foundation/containers/vector.h>
 #include <foundation/containers/deque.h>
@@ -152,12 +153,55 @@ namespace sulphur
       */
       SystemDataBase( void** element_list, uint64_t* element_sizes, uint64_t num_elements )
         :
-        RewindStorageBase( element_list, element_sizes, num_elements )
+        RewindStorageBase( element_list, element_sizes, num_elements ),
+        free_list_head_( 0 )
       {}
+      /*
+      * @brief Gets the number of sparse handles that are waiting to be reused
+      * @return (size_t) The number of free sparse handles
+      */
+      size_t FreeCount() const
+      {
+        return free_list_.size() - free_list_head_;
+      }
+      /*
+      * @brief Adds a sparse handle to the back of the free list
+      * @param[in] index (size_t) The sparse handle that is no longer used
+      */
+      void PushFree( size_t index )
+      {
+        free_list_.push_back( index );
+      }
+      /*
+      * @brief Takes the sparse handle that has been free the longest from the free list
+      * @remarks Reusing the oldest handle first delays the wrap-around of its generation
+      * @return (size_t) The sparse handle to reuse
+      */
+      size_t PopFree()
+      {
+        const size_t index = free_list_[free_list_head_++];
+        // Drop the consumed handles once they make up half of the list, keeping this amortized O(1)
+        if ( free_list_head_ * 2 >= free_list_.size() )
+        {
+          free_list_.erase( free_list_.begin(), free_list_.begin() + free_list_head_ );
+          free_list_head_ = 0;
+        }
+        return index;
+      }
+      /*
+      * @brief Removes the consumed handles from the front of the free list, so the free sparse handles are stored contiguously from the start of free_list_
+      */
+      void CompactFreeList()
+      {
+        free_list_.erase( free_list_.begin(), free_list_.begin() + free_list_head_ );
+        free_list_head_ = 0;
+      }
+
       foundation::Vector<SparseHandle> sparse_array_;//!< Array with indices that maps to the actual data indices.
       foundation::Vector<DenseHandle> dense_to_sparse_array_;//!< Array with indices that maps from the actual data index to its sparse array index.
       foundation::Vector<unsigned char> generation_;//!< generation of the sparse handles.
-      foundation::Vector<size_t> free_list_;//!< Free list of sparse handles.
+      foundation::Vector<size_t> free_list_;//!< Queue of free sparse handles, the ones before free_list_head_ have already been reused.
+      size_t free_list_head_;//!< Index of the oldest free sparse handle in free_list_.
     };
 
 
@@ -165,7 +209,7 @@ namespace sulphur
     * @class sulphur::engine::SystemData <...Types> : public SystemDataBase
     * @brief A vector like container that stores the types in SoA format and uses a slot map to access the elements. Currently tuned towards the entity systems so it should be templatized on the variables of a component
     * @remarks Assumed POD like elements but we're using it like a general container now so...
-    * @todo Improve the freelist as it should be possible to implement it without having to waste some memory
+    * @remarks Every element buffer has its own range of reserved address space and grows in place by committing chunks of kChunkSize elements, so growing never moves the elements and pointers to them stay valid. The buffers stay contiguous, as systems and the rewinder access them through raw pointers. Only exceeding the reserved element count moves the elements to a larger range.
     * @author Raymi Klingers
     */
     template<typename ... Types>
@@ -174,6 +218,8 @@ namespace sulphur
     private:
       constexpr const static int kReuseThreshold = 1024;//!< How many empty slots we need before we start reusing
     public:
+      constexpr const static size_t kChunkSize = 1024;//!< How many elements are committed at once when the buffers are full
+      constexpr const static size_t kReservedBytes = 256ull << 20;//!< The address space reserved for all element buffers together, memory is only committed when it is used
       template<size_t Index>
       using element_type = foundation::indexed_type<Index, Types...>;//!< Alias to get an element at index
 
@@ -187,6 +233,7 @@ namespace sulphur
       SystemData(void** element_list = nullptr) :
         SystemDataBase( buffers_, buffer_sizes_, ElementCount + 1 ),
         buffer_(nullptr),
+        reserved_(0),
         external_element_list(element_list)
       {
         for ( int i = 0; i < ElementCount; ++i )
@@ -201,11 +248,8 @@ namespace sulphur
       */
       ~SystemData()
       {
-        if (buffer_ != nullptr)
-        {
-          foundation::Memory::Deallocate(buffer_);
-          buffer_ = nullptr;
-        }
+        foundation::VirtualMemory::Release(buffer_);
+        buffer_ = nullptr;
       }
 
       /*
@@ -237,7 +281,7 @@ namespace sulphur
         return size_;
       }
       /*
-      * @brief Gets the number of elements thast can be stored before a reallocation is needed
+      * @brief Gets the number of elements that can be stored before more memory has to be committed
       * @return (size_t) The capacity size
       */
       size_t capacity() const
@@ -249,7 +293,7 @@ namespace sulphur
       * @param handle (sulphur::engine::ComponentHandleBase) A handle to obtain the data index from
       * @return (size_t) The data index
       */
-      size_t GetDataIndex(ComponentHandleBase handle)
+      size_t GetDataIndex(ComponentHandleBase handle) const
       {
         return sparse_array_[handle.GetIndex()].inner_handle;
       }
@@ -271,25 +315,7 @@ namespace sulphur
       */
       size_t Add(const Types&... args)
       {
-        if (size_ == capacity_)
-        {
-          // Reallocation should be refactored.
-          Reallocate(capacity_ * 2 + 1);
-        }
-        size_t ret;
-        if (free_list_.size() >= kReuseThreshold)
-        {
-          ret = free_list_.front();
-          free_list_.erase( free_list_.begin() );
-          dense_to_sparse_array_.emplace_back(ret);
-        }
-        else
-        {
-          generation_.push_back(0);
-          ret = sparse_array_.size();
-          dense_to_sparse_array_.emplace_back(sparse_array_.size());
-          sparse_array_.emplace_back(size_);
-        }
+        const size_t ret = AllocateSlot();
         ForEachElementVariadic<add_element>(args...);
         return (ret | ((size_t)generation_[ret] << ComponentHandleBase::kIndexBits));
       }
@@ -302,29 +328,37 @@ namespace sulphur
       template<typename ...MyTypes>
       size_t Add(MyTypes&&...args)
       {
-        if (size_ == capacity_)
-        {
-          // Reallocation should be refactored.
-          Reallocate(capacity_ * 2 + 1);
-        }
-        size_t ret;
-        if (free_list_.size() >= kReuseThreshold)
+        const size_t ret = AllocateSlot();
+        ForEachElementVariadic<add_element>(eastl::forward<MyTypes>(args)...);
+        return ret | ((size_t)generation_[ret] << ComponentHandleBase::kIndexBits);
+      }
+      /*
+      * @brief Commits the memory for a number of components up front.
+      * @param[in] new_capacity (size_t) The number of components to reserve space for.
+      * @remarks Does nothing if the capacity is already large enough.
+      */
+      void Reserve(size_t new_capacity)
+      {
+        if (new_capacity > capacity_)
         {
-          ret = free_list_.front();
-          free_list_.erase(free_list_.begin());
-          sparse_array_[ret].inner_handle = dense_to_sparse_array_.size();
-          dense_to_sparse_array_.emplace_back(ret);
+          Reallocate(new_capacity);
         }
-        else
+      }
+      /*
+      * @brief Releases the unused capacity of the element buffers and the handle arrays.
+      * @remarks The element buffers keep their addresses, only the pages past the last element are decommitted.
+      */
+      void Compact()
+      {
+        if (capacity_ != size_)
         {
-          generation_.push_back(0);
-          ret = sparse_array_.size();
-          dense_to_sparse_array_.emplace_back(sparse_array_.size());
-          sparse_array_.emplace_back(size_);
+          Reallocate(size_);
         }
-
-        ForEachElementVariadic<add_element>(eastl::forward<MyTypes>(args)...);
-        return ret | ((size_t)generation_[ret] << ComponentHandleBase::kIndexBits);
+        CompactFreeList();
+        free_list_.shrink_to_fit();
+        sparse_array_.shrink_to_fit();
+        dense_to_sparse_array_.shrink_to_fit();
+        generation_.shrink_to_fit();
       }
       /*
       * @brief Removes the component that the handle indexes to.
@@ -335,7 +369,7 @@ namespace sulphur
         size_t index = remove_index.GetIndex();
         Remove(sparse_array_[index]);
         ++generation_[index];
-        free_list_.emplace_back(index);
+        PushFree(index);
       }
       /*
       * @brief Get the component variable from an index and a handle.
@@ -621,6 +655,7 @@ namespace sulphur
       /*
       * @struct sulphur::foundation::SystemData::calculate_element_buffer_size : public sulphur::foundation::SystemData::for_each_element_method_base
       * @brief Calculates the buffer size by looking at all the alignment requirements of the element buffers.
+      * @remarks Every element buffer starts at a page, so its memory can be committed separately.
       * @author Raymi Klingers
       */
       struct calculate_element_buffer_size : public for_each_element_method_base
@@ -639,31 +674,77 @@ namespace sulphur
             .set_buffer((element_type<Index>*)buffer_size, size);
 
           buffer_size +=
-            AlignUp((const void*)(size * sizeof(element_type<Index>)), 64);
+            AlignUp((const void*)(size * sizeof(element_type<Index>)), foundation::VirtualMemory::page_size());
         }
       };
       /*
-      * @struct sulphur::foundation::SystemData::copy_over_element : public sulphur::foundation::SystemData::for_each_element_method_base
-      * @brief Calculates the buffer size by looking at all the alignment requirements of the element buffers.
+      * @struct sulphur::foundation::SystemData::commit_element_buffer : public sulphur::foundation::SystemData::for_each_element_method_base
+      * @brief Commits or decommits the pages of the element buffers for a new capacity.
+      */
+      struct commit_element_buffer : public for_each_element_method_base
+      {
+        /*
+        * @brief Used to iteratively commit the pages that the new capacity needs and decommit the ones it doesn't
+        * @tparam Index (size_t) Current index
+        * @param[in] this_ptr (sulphur::engine::SystemData<Types...>*) A pointer to the system data on which this is called
+        * @param[in] old_capacity (size_t) The number of elements that are committed
+        * @param[in] new_capacity (size_t) The number of elements that have to be committed
+        */
+        template<size_t Index>
+        inline void Iterate(SystemData<Types...>* this_ptr, size_t old_capacity, size_t new_capacity) const
+        {
+          const size_t page_size = foundation::VirtualMemory::page_size();
+          const size_t old_size = AlignUp((const void*)(old_capacity * sizeof(element_type<Index>)), page_size);
+          const size_t new_size = AlignUp((const void*)(new_capacity * sizeof(element_type<Index>)), page_size);
+          char* buffer = reinterpret_cast<char*>(this_ptr->ElementBuffer<Index>());
+
+          if (new_size > old_size)
+          {
+            const bool committed = foundation::VirtualMemory::Commit(buffer + old_size, new_size - old_size);
+            PS_LOG_IF(committed == false, Fatal, "Out of memory while growing the system data");
+          }
+          else if (new_size < old_size)
+          {
+            foundation::VirtualMemory::Decommit(buffer + new_size, old_size - new_size);
+          }
+        }
+      };
+      /*
+      * @struct sulphur::foundation::SystemData::move_over_element : public sulphur::foundation::SystemData::for_each_element_method_base
+      * @brief Moves the elements from the old buffers to the new buffers.
       * @author Raymi Klingers
       */
-      struct copy_over_element : public for_each_element_method_base
+      struct move_over_element : public for_each_element_method_base
       {
         /*
-        * @brief Used to iteratively copy over the elements buffers to the new buffer
+        * @brief Used to iteratively move over the elements buffers to the new buffer
         * @tparam Index (size_t) Current index
         * @param[in] this_ptr (sulphur::engine::SystemData<Types...>*) A pointer to the system data on which this is called
-        * @param[in] old_elements (eastl::tuple<sulphur::engine::ArrayPtr<Types>...>) The old buffer to copy from
+        * @param[in] old_elements (eastl::tuple<sulphur::engine::ArrayPtr<Types>...>) The old buffer to move from
+        * @remarks Trivially copyable columns are copied in one go, others are move constructed and the moved-from elements destructed.
         */
         template<size_t Index>
         inline void Iterate(
           SystemData<Types...>* this_ptr,
           eastl::tuple<ArrayPtr<Types>...>old_elements)
         {
-          for (int i = 0; i < this_ptr->size_; ++i)
+          using Type = element_type<Index>;
+          Type* old_buffer = eastl::get<Index>(old_elements).buffer;
+          if (this_ptr->size_ == 0)
+          {
+            return;
+          }
+
+          if (eastl::is_trivially_copyable<Type>::value)
+          {
+            memcpy(this_ptr->ElementBuffer<Index>(), old_buffer, this_ptr->size_ * sizeof(Type));
+            return;
+          }
+
+          for (size_t i = 0; i < this_ptr->size_; ++i)
           {
-            new (&(this_ptr->ElementBuffer<Index>()[i]))
-              element_type<Index>(eastl::move(eastl::get<Index>(old_elements).buffer[i]));
+            new (&(this_ptr->ElementBuffer<Index>()[i])) Type(eastl::move(old_buffer[i]));
+            old_buffer[i].~Type();
           }
         }
       };
@@ -789,31 +870,80 @@ namespace sulphur
 
     private:
       /*
-      * @brief Reallocates the memory buffer with the given size.
-      * @param new_size (size_t) The new size of the buffer.
+      * @brief Grows the buffers if needed and assigns a sparse handle to the component that is about to be added at the back.
+      * @return (size_t) The index of the sparse handle.
+      */
+      size_t AllocateSlot()
+      {
+        if (size_ == capacity_)
+        {
+          Reallocate(capacity_ + kChunkSize);
+        }
+        size_t ret;
+        if (FreeCount() >= kReuseThreshold)
+        {
+          ret = PopFree();
+          sparse_array_[ret].inner_handle = size_;
+          dense_to_sparse_array_.emplace_back(ret);
+        }
+        else
+        {
+          generation_.push_back(0);
+          ret = sparse_array_.size();
+          dense_to_sparse_array_.emplace_back(sparse_array_.size());
+          sparse_array_.emplace_back(size_);
+        }
+        return ret;
+      }
+      /*
+      * @brief Changes the number of elements the buffers can store.
+      * @param new_size (size_t) The new capacity of the buffers, must be at least size().
+      * @remarks Commits or decommits memory in place while the reserved address space suffices. Otherwise a larger range is reserved and the elements are moved to it.
       */
       void Reallocate(size_t new_size)
       {
-        // Allocate the new data
+        if (buffer_ != nullptr && new_size <= reserved_)
+        {
+          ForEachElement<commit_element_buffer>(static_cast<size_t>(capacity_), new_size);
+          capacity_ = new_size;
+          return;
+        }
+
+        // Reserve the new address space, at least doubling it so moves stay rare
+        const size_t reserved = eastl::max(new_size, eastl::max(reserved_ * 2, ReservedCount()));
         size_t buffer_size = 0;
         eastl::tuple<ArrayPtr<Types>...> old_elements = elements_;
         elements_ = eastl::tuple<ArrayPtr<Types>...>();
 
-        // Initialize the new buffer
-        ForEachElement<calculate_element_buffer_size>(new_size, buffer_size);
-        void* new_buffer = foundation::Memory::Allocate(buffer_size);
+        ForEachElement<calculate_element_buffer_size>(reserved, buffer_size);
+        void* new_buffer = foundation::VirtualMemory::Reserve(buffer_size);
+        PS_LOG_IF(new_buffer == nullptr, Fatal, "Could not reserve the address space of the system data");
         ForEachElement<offset_element_buffer>(new_buffer);
+        ForEachElement<commit_element_buffer>(size_t(0), new_size);
 
-        // Copy over the data
-        ForEachElement<copy_over_element>(old_elements);
+        // Move over the data
+        ForEachElement<move_over_element>(old_elements);
 
         // Set the new data
         capacity_ = new_size;
-        if (buffer_ != nullptr)
+        reserved_ = reserved;
+        foundation::VirtualMemory::Release(buffer_);
+        buffer_ = new_buffer;
+      }
+      /*
+      * @brief Gets the number of elements that fit in sulphur::engine::SystemData::kReservedBytes
+      * @return (size_t) The number of elements to reserve address space for, at least a chunk
+      */
+      static size_t ReservedCount()
+      {
+        const size_t sizes[] = { size_t(0), sizeof(Types)... };
+        size_t row_size = 0;
+        for (size_t size : sizes)
         {
-          foundation::Memory::Deallocate(buffer_);
+          row_size += size;
         }
-        buffer_ = new_buffer;
+        const size_t count = row_size == 0 ? 0 : kReservedBytes / row_size;
+        return count < kChunkSize ? kChunkSize : count;
       }
       void PrepareRestore( const FrameStorage& storage) override
       {
@@ -822,26 +952,8 @@ namespace sulphur
         {
           RemoveLast();
         }
-        // If our capacity is big enough don't allocate something new
-        if (storage.data[0].size >= capacity())
-        {
-          // Allocate the new data
-          size_t buffer_size = 0;
-          eastl::tuple<ArrayPtr<Types>...> old_elements = elements_;
-          elements_ = eastl::tuple<ArrayPtr<Types>...>();
-
-          // Initialize the new buffer
-          ForEachElement<calculate_element_buffer_size>( storage.data[0].size, buffer_size);
-          void* new_buffer = foundation::Memory::Allocate(buffer_size);
-          ForEachElement<offset_element_buffer>(new_buffer);
-          // Set the new data
-          capacity_ = storage.data[0].size;
-          if (buffer_ != nullptr)
-          {
-            foundation::Memory::Deallocate(buffer_);
-          }
-          buffer_ = new_buffer;
-        }
+        // There are no elements left, so growing the buffers doesn't move anything
+        Reserve(static_cast<size_t>(storage.data[0].size));
         buffers_[ElementCount] = this;
       }      
       virtual void PrepareStore() override
@@ -854,7 +966,8 @@ namespace sulphur
         buffers_[ElementCount] = this;
       }
     private:
-      void* buffer_;//!< The memory buffer that contains all the data.
+      void* buffer_;//!< The reserved address space that contains all the element buffers.
+      size_t reserved_;//!< The number of elements the address space of every element buffer is reserved for.
       eastl::tuple<ArrayPtr<Types>...> elements_;//!< Typed element list.
       size_t buffer_sizes_[ElementCount];//!< Information for the rewind storage base
       void* buffers_[ElementCount + 1];//!< Information for the rewind storage base
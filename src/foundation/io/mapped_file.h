@@ -0,0 +1,12 @@
+#pragma once
+
+#ifdef PS_WIN32
+#include "foundation/win32/win32_mapped_file.h"
+namespace sulphur 
+{
+  namespace foundation 
+  {
+    using MappedFile = Win32MappedFile;
+  }
+}
+#endif
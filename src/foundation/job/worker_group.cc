@@ -0,0 +1,133 @@
+#include "foundation/job/worker_group.h"
+#include <EASTL/algorithm.h>
+
+namespace sulphur
+{
+  namespace foundation
+  {
+    //-------------------------------------------------------------------------
+    WorkerGroup::WorkerGroup(size_t thread_count) :
+      thread_count_(thread_count)
+    {
+      if (thread_count_ == 0)
+      {
+        const size_t hardware_threads = static_cast<size_t>(std::thread::hardware_concurrency());
+        thread_count_ = eastl::max(hardware_threads, static_cast<size_t>(2)) - 1;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    WorkerGroup::~WorkerGroup()
+    {
+      Wait();
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+      }
+      wake_.notify_all();
+
+      for (std::thread& thread : threads_)
+      {
+        thread.join();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void WorkerGroup::Dispatch(size_t count, eastl::function<void(size_t)> work)
+    {
+      Wait();
+      if (count == 0)
+      {
+        return;
+      }
+
+      if (threads_.empty() == true)
+      {
+        threads_.reserve(thread_count_);
+        for (size_t i = 0; i < thread_count_; ++i)
+        {
+          threads_.push_back(std::thread([this]() { Run(); }));
+        }
+      }
+
+      {
+        // A worker can still pick up the finished dispatch until the lock is taken here
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return active_ == 0; });
+        work_ = eastl::move(work);
+        count_ = count;
+        next_ = 0;
+        remaining_ = count;
+        ++generation_;
+      }
+      wake_.notify_all();
+    }
+
+    //-------------------------------------------------------------------------
+    void WorkerGroup::Wait()
+    {
+      if (remaining_ != 0)
+      {
+        Work();
+      }
+
+      // Workers that are still leaving the loop would otherwise see the counters of the next dispatch
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [this]() { return remaining_ == 0 && active_ == 0; });
+    }
+
+    //-------------------------------------------------------------------------
+    bool WorkerGroup::IsBusy() const
+    {
+      return remaining_ != 0;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t WorkerGroup::thread_count() const
+    {
+      return thread_count_;
+    }
+
+    //-------------------------------------------------------------------------
+    void WorkerGroup::Run()
+    {
+      size_t generation = 0;
+      for (;;)
+      {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          wake_.wait(lock, [&]() { return generation_ != generation || stopping_ == true; });
+          if (stopping_ == true)
+          {
+            return;
+          }
+          generation = generation_;
+          ++active_;
+        }
+
+        Work();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        --active_;
+        done_.notify_all();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void WorkerGroup::Work()
+    {
+      for (size_t i = next_++; i < count_; i = next_++)
+      {
+        work_(i);
+
+        if (--remaining_ == 0)
+        {
+          // Lock so the waiting thread can't miss the notification between its check and its wait
+          std::lock_guard<std::mutex> lock(mutex_);
+          done_.notify_all();
+        }
+      }
+    }
+  }
+}
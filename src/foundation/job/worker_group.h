@@ -0,0 +1,86 @@
+#pragma once
+#include "foundation/containers/vector.h"
+#include <EASTL/functional.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace sulphur
+{
+  namespace foundation
+  {
+    /**
+     * @class sulphur::foundation::WorkerGroup
+     * @brief A fixed set of worker threads that run the iterations of a loop in parallel
+     * @details Dispatch returns immediately, so the work can overlap with whatever the calling thread does next.
+     *          Wait blocks until every iteration is done and lets the calling thread help with the remaining ones.
+     * @remarks Dispatch and Wait have to be called from one thread. The threads are started on the first dispatch.
+     */
+    class WorkerGroup
+    {
+    public:
+      /**
+       * @brief Create a worker group
+       * @param[in] thread_count (size_t) The amount of worker threads, 0 uses one less than the hardware threads
+       */
+      explicit WorkerGroup(size_t thread_count = 0);
+
+      /**
+       * @brief Wait for the dispatched work and join the threads
+       */
+      ~WorkerGroup();
+
+      WorkerGroup(const WorkerGroup&) = delete;
+      WorkerGroup& operator=(const WorkerGroup&) = delete;
+
+      /**
+       * @brief Start running a function for every index in [0, count), waiting for the previous dispatch first
+       * @param[in] count (size_t) The amount of iterations
+       * @param[in] work (eastl::function<void(size_t)>) The function to run per index, called from any thread
+       */
+      void Dispatch(size_t count, eastl::function<void(size_t)> work);
+
+      /**
+       * @brief Block until all iterations of the last dispatch are done, running iterations on the calling thread
+       */
+      void Wait();
+
+      /**
+       * @brief Check if the last dispatch is still running
+       * @return (bool) True if not every iteration is done
+       */
+      bool IsBusy() const;
+
+      /**
+       * @see thread_count_
+       */
+      size_t thread_count() const;
+
+    private:
+      /**
+       * @brief The loop of a worker thread
+       */
+      void Run();
+
+      /**
+       * @brief Run iterations until none are left
+       */
+      void Work();
+
+      size_t thread_count_; //!< The amount of worker threads
+      Vector<std::thread> threads_; //!< The worker threads, started on the first dispatch
+      std::mutex mutex_; //!< Guards the generation, the active workers and the stop flag
+      std::condition_variable wake_; //!< Signals a new dispatch to the workers
+      std::condition_variable done_; //!< Signals that the last iteration finished
+      size_t generation_ = 0; //!< Increased on every dispatch, so workers notice new work
+      size_t active_ = 0; //!< The amount of workers that are running iterations
+      bool stopping_ = false; //!< Should the workers exit?
+
+      eastl::function<void(size_t)> work_; //!< The function of the current dispatch
+      size_t count_ = 0; //!< The amount of iterations of the current dispatch
+      std::atomic<size_t> next_{ 0 }; //!< The next iteration to run
+      std::atomic<size_t> remaining_{ 0 }; //!< The amount of iterations that haven't finished
+    };
+  }
+}
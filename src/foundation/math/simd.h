@@ -0,0 +1,189 @@
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PS_SIMD_SSE
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PS_SIMD_NEON
+#include <arm_neon.h>
+#else
+#define PS_SIMD_SCALAR
+#include <cmath>
+#include <cstring>
+#include <cinttypes>
+#endif
+
+namespace sulphur
+{
+  namespace foundation
+  {
+    /**
+    * @brief A thin abstraction over 4-wide float vector instructions.
+    * Uses SSE2 on x86, NEON on AArch64 and plain floats everywhere else, including 32-bit ARM.
+    * @remarks Comparisons return masks with all bits set in the lanes where the comparison holds.
+    * Masks can only be used with sulphur::foundation::simd::And, AndNot, Or and Select.
+    */
+    namespace simd
+    {
+#if defined(PS_SIMD_SSE)
+      using Float4 = __m128; //!< Four floats processed at once
+#elif defined(PS_SIMD_NEON)
+      using Float4 = float32x4_t; //!< Four floats processed at once
+#else
+      /**
+      * @struct sulphur::foundation::simd::Float4
+      * @brief Four floats processed at once
+      */
+      struct Float4
+      {
+        float v[4]; //!< The lanes
+      };
+#endif
+
+#if defined(PS_SIMD_SSE)
+      //-------------------------------------------------------------------------
+      inline Float4 Load(const float* p) { return _mm_loadu_ps(p); }
+      inline void Store(float* p, Float4 a) { _mm_storeu_ps(p, a); }
+      inline Float4 Set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+      inline Float4 Set1(float x) { return _mm_set1_ps(x); }
+      inline Float4 Zero() { return _mm_setzero_ps(); }
+
+      inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+      inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+      inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+      inline Float4 Div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+      inline Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a); }
+
+      inline Float4 CmpGt(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+      inline Float4 CmpLt(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+      inline Float4 And(Float4 a, Float4 b) { return _mm_and_ps(a, b); }
+      inline Float4 AndNot(Float4 a, Float4 b) { return _mm_andnot_ps(a, b); }
+      inline Float4 Or(Float4 a, Float4 b) { return _mm_or_ps(a, b); }
+      inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+      template<int lane>
+      inline Float4 Splat(Float4 a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(lane, lane, lane, lane)); }
+
+      inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+#elif defined(PS_SIMD_NEON)
+      //-------------------------------------------------------------------------
+      inline Float4 Load(const float* p) { return vld1q_f32(p); }
+      inline void Store(float* p, Float4 a) { vst1q_f32(p, a); }
+      inline Float4 Set(float x, float y, float z, float w) { const float v[4] = { x, y, z, w }; return vld1q_f32(v); }
+      inline Float4 Set1(float x) { return vdupq_n_f32(x); }
+      inline Float4 Zero() { return vdupq_n_f32(0.0f); }
+
+      inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+      inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+      inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+      inline Float4 Div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+      inline Float4 Sqrt(Float4 a) { return vsqrtq_f32(a); }
+
+      inline Float4 CmpGt(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+      inline Float4 CmpLt(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+      inline Float4 And(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+      inline Float4 AndNot(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(b), vreinterpretq_u32_f32(a))); }
+      inline Float4 Or(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+      inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+
+      template<int lane>
+      inline Float4 Splat(Float4 a) { return vdupq_laneq_f32(a, lane); }
+
+      inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+      {
+        const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+      }
+#else
+      //-------------------------------------------------------------------------
+      /**
+      * @brief Applies a function to every lane of two vectors
+      * @param[in] a (sulphur::foundation::simd::Float4) The first vector
+      * @param[in] b (sulphur::foundation::simd::Float4) The second vector
+      * @param[in] f (Func) The function taking two floats and returning a float
+      * @return (sulphur::foundation::simd::Float4) The results
+      */
+      template<typename Func>
+      inline Float4 PerLane(Float4 a, Float4 b, Func f)
+      {
+        return { { f(a.v[0], b.v[0]), f(a.v[1], b.v[1]), f(a.v[2], b.v[2]), f(a.v[3], b.v[3]) } };
+      }
+
+      /**
+      * @brief Applies a function to the bits of every lane of two vectors
+      * @param[in] a (sulphur::foundation::simd::Float4) The first vector
+      * @param[in] b (sulphur::foundation::simd::Float4) The second vector
+      * @param[in] f (Func) The function taking two uint32_t and returning an uint32_t
+      * @return (sulphur::foundation::simd::Float4) The results
+      */
+      template<typename Func>
+      inline Float4 PerLaneBits(Float4 a, Float4 b, Func f)
+      {
+        uint32_t ba[4], bb[4];
+        memcpy(ba, a.v, sizeof(ba));
+        memcpy(bb, b.v, sizeof(bb));
+        for (int i = 0; i < 4; ++i)
+        {
+          ba[i] = f(ba[i], bb[i]);
+        }
+        Float4 result;
+        memcpy(result.v, ba, sizeof(ba));
+        return result;
+      }
+
+      inline Float4 MaskFromBool(bool x, bool y, bool z, bool w)
+      {
+        const uint32_t bits[4] = { x ? ~0u : 0u, y ? ~0u : 0u, z ? ~0u : 0u, w ? ~0u : 0u };
+        Float4 result;
+        memcpy(result.v, bits, sizeof(bits));
+        return result;
+      }
+
+      inline Float4 Load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+      inline void Store(float* p, Float4 a) { memcpy(p, a.v, sizeof(a.v)); }
+      inline Float4 Set(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+      inline Float4 Set1(float x) { return { { x, x, x, x } }; }
+      inline Float4 Zero() { return Set1(0.0f); }
+
+      inline Float4 Add(Float4 a, Float4 b) { return PerLane(a, b, [](float x, float y) { return x + y; }); }
+      inline Float4 Sub(Float4 a, Float4 b) { return PerLane(a, b, [](float x, float y) { return x - y; }); }
+      inline Float4 Mul(Float4 a, Float4 b) { return PerLane(a, b, [](float x, float y) { return x * y; }); }
+      inline Float4 Div(Float4 a, Float4 b) { return PerLane(a, b, [](float x, float y) { return x / y; }); }
+      inline Float4 Sqrt(Float4 a) { return PerLane(a, a, [](float x, float) { return std::sqrt(x); }); }
+
+      inline Float4 CmpGt(Float4 a, Float4 b) { return MaskFromBool(a.v[0] > b.v[0], a.v[1] > b.v[1], a.v[2] > b.v[2], a.v[3] > b.v[3]); }
+      inline Float4 CmpLt(Float4 a, Float4 b) { return CmpGt(b, a); }
+      inline Float4 And(Float4 a, Float4 b) { return PerLaneBits(a, b, [](uint32_t x, uint32_t y) { return x & y; }); }
+      inline Float4 AndNot(Float4 a, Float4 b) { return PerLaneBits(a, b, [](uint32_t x, uint32_t y) { return ~x & y; }); }
+      inline Float4 Or(Float4 a, Float4 b) { return PerLaneBits(a, b, [](uint32_t x, uint32_t y) { return x | y; }); }
+      inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return Or(And(mask, a), AndNot(mask, b)); }
+
+      template<int lane>
+      inline Float4 Splat(Float4 a) { return Set1(a.v[lane]); }
+
+      inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+      {
+        const Float4 t0 = r0, t1 = r1, t2 = r2, t3 = r3;
+        r0 = { { t0.v[0], t1.v[0], t2.v[0], t3.v[0] } };
+        r1 = { { t0.v[1], t1.v[1], t2.v[1], t3.v[1] } };
+        r2 = { { t0.v[2], t1.v[2], t2.v[2], t3.v[2] } };
+        r3 = { { t0.v[3], t1.v[3], t2.v[3], t3.v[3] } };
+      }
+#endif
+
+      //-------------------------------------------------------------------------
+      /**
+      * @brief Calculates a * b + c
+      * @param[in] a (sulphur::foundation::simd::Float4) The first factor
+      * @param[in] b (sulphur::foundation::simd::Float4) The second factor
+      * @param[in] c (sulphur::foundation::simd::Float4) The value to add
+      * @return (sulphur::foundation::simd::Float4) The result
+      */
+      inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return Add(Mul(a, b), c); }
+    }
+  }
+}
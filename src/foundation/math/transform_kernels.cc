@@ -0,0 +1,595 @@
+#include "foundation/math/transform_kernels.h"
+#include "foundation/math/simd.h"
+#include <cassert>
+
+namespace sulphur
+{
+  namespace foundation
+  {
+    static_assert(sizeof(glm::quat) == 4 * sizeof(float), "The kernels load quaternions as 4 floats");
+    static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "The kernels load matrices as 16 floats");
+
+    namespace
+    {
+      using simd::Float4;
+
+      constexpr size_t kBlockSize = 4; //!< The amount of transforms processed at once
+
+      /**
+      * @brief Loads the same column of four matrices, one component of the four columns per vector
+      * @param[in] m (const glm::mat4*) The four matrices
+      * @param[in] column (int) The column to load
+      * @param[out] x (sulphur::foundation::simd::Float4&) The x components
+      * @param[out] y (sulphur::foundation::simd::Float4&) The y components
+      * @param[out] z (sulphur::foundation::simd::Float4&) The z components
+      * @param[out] w (sulphur::foundation::simd::Float4&) The w components
+      */
+      inline void LoadColumns(const glm::mat4* m, int column,
+        Float4& x, Float4& y, Float4& z, Float4& w)
+      {
+        x = simd::Load(&m[0][column][0]);
+        y = simd::Load(&m[1][column][0]);
+        z = simd::Load(&m[2][column][0]);
+        w = simd::Load(&m[3][column][0]);
+        simd::Transpose(x, y, z, w);
+      }
+
+      /**
+      * @brief Stores the same column of four matrices, the inverse of sulphur::foundation::LoadColumns
+      * @param[out] m (glm::mat4*) The four matrices
+      * @param[in] column (int) The column to store
+      * @param[in] x (sulphur::foundation::simd::Float4) The x components
+      * @param[in] y (sulphur::foundation::simd::Float4) The y components
+      * @param[in] z (sulphur::foundation::simd::Float4) The z components
+      * @param[in] w (sulphur::foundation::simd::Float4) The w components
+      */
+      inline void StoreColumns(glm::mat4* m, int column,
+        Float4 x, Float4 y, Float4 z, Float4 w)
+      {
+        simd::Transpose(x, y, z, w);
+        simd::Store(&m[0][column][0], x);
+        simd::Store(&m[1][column][0], y);
+        simd::Store(&m[2][column][0], z);
+        simd::Store(&m[3][column][0], w);
+      }
+
+      /**
+      * @brief Calculates the dot product of four pairs of 3D vectors
+      */
+      inline Float4 Dot(Float4 ax, Float4 ay, Float4 az, Float4 bx, Float4 by, Float4 bz)
+      {
+        return simd::MulAdd(ax, bx, simd::MulAdd(ay, by, simd::Mul(az, bz)));
+      }
+
+      /**
+      * @brief Calculates the cross product of four pairs of 3D vectors
+      */
+      inline void Cross(Float4 ax, Float4 ay, Float4 az, Float4 bx, Float4 by, Float4 bz,
+        Float4& x, Float4& y, Float4& z)
+      {
+        x = simd::Sub(simd::Mul(ay, bz), simd::Mul(az, by));
+        y = simd::Sub(simd::Mul(az, bx), simd::Mul(ax, bz));
+        z = simd::Sub(simd::Mul(ax, by), simd::Mul(ay, bx));
+      }
+
+      //-------------------------------------------------------------------------
+      void ComposeColumns(
+        Float4 px, Float4 py, Float4 pz,
+        Float4 qx, Float4 qy, Float4 qz, Float4 qw,
+        Float4 sx, Float4 sy, Float4 sz,
+        glm::mat4* out)
+      {
+        const Float4 one = simd::Set1(1.0f);
+        const Float4 two = simd::Set1(2.0f);
+
+        const Float4 xx = simd::Mul(qx, qx);
+        const Float4 yy = simd::Mul(qy, qy);
+        const Float4 zz = simd::Mul(qz, qz);
+        const Float4 xy = simd::Mul(qx, qy);
+        const Float4 xz = simd::Mul(qx, qz);
+        const Float4 yz = simd::Mul(qy, qz);
+        const Float4 wx = simd::Mul(qw, qx);
+        const Float4 wy = simd::Mul(qw, qy);
+        const Float4 wz = simd::Mul(qw, qz);
+
+        // Same layout as glm::mat4_cast, with every column multiplied by its scale
+        StoreColumns(out, 0,
+          simd::Mul(simd::Sub(one, simd::Mul(two, simd::Add(yy, zz))), sx),
+          simd::Mul(simd::Mul(two, simd::Add(xy, wz)), sx),
+          simd::Mul(simd::Mul(two, simd::Sub(xz, wy)), sx),
+          simd::Zero());
+
+        StoreColumns(out, 1,
+          simd::Mul(simd::Mul(two, simd::Sub(xy, wz)), sy),
+          simd::Mul(simd::Sub(one, simd::Mul(two, simd::Add(xx, zz))), sy),
+          simd::Mul(simd::Mul(two, simd::Add(yz, wx)), sy),
+          simd::Zero());
+
+        StoreColumns(out, 2,
+          simd::Mul(simd::Mul(two, simd::Add(xz, wy)), sz),
+          simd::Mul(simd::Mul(two, simd::Sub(yz, wx)), sz),
+          simd::Mul(simd::Sub(one, simd::Mul(two, simd::Add(xx, yy))), sz),
+          simd::Zero());
+
+        StoreColumns(out, 3, px, py, pz, one);
+      }
+
+      //-------------------------------------------------------------------------
+      void ComposeBlock(
+        const glm::vec3* positions,
+        const glm::quat* rotations,
+        const glm::vec3* scales,
+        glm::mat4* out)
+      {
+        Float4 qx = simd::Load(&rotations[0].x);
+        Float4 qy = simd::Load(&rotations[1].x);
+        Float4 qz = simd::Load(&rotations[2].x);
+        Float4 qw = simd::Load(&rotations[3].x);
+        simd::Transpose(qx, qy, qz, qw);
+
+        ComposeColumns(
+          simd::Set(positions[0].x, positions[1].x, positions[2].x, positions[3].x),
+          simd::Set(positions[0].y, positions[1].y, positions[2].y, positions[3].y),
+          simd::Set(positions[0].z, positions[1].z, positions[2].z, positions[3].z),
+          qx, qy, qz, qw,
+          simd::Set(scales[0].x, scales[1].x, scales[2].x, scales[3].x),
+          simd::Set(scales[0].y, scales[1].y, scales[2].y, scales[3].y),
+          simd::Set(scales[0].z, scales[1].z, scales[2].z, scales[3].z),
+          out);
+      }
+
+      //-------------------------------------------------------------------------
+      void InverseBlock(const glm::mat4* in, glm::mat4* out)
+      {
+        Float4 ax, ay, az, bx, by, bz, cx, cy, cz, tx, ty, tz, unused;
+        LoadColumns(in, 0, ax, ay, az, unused);
+        LoadColumns(in, 1, bx, by, bz, unused);
+        LoadColumns(in, 2, cx, cy, cz, unused);
+        LoadColumns(in, 3, tx, ty, tz, unused);
+
+        // The rows of the inverse are the cross products of the columns divided by the determinant
+        Float4 r0x, r0y, r0z, r1x, r1y, r1z, r2x, r2y, r2z;
+        Cross(bx, by, bz, cx, cy, cz, r0x, r0y, r0z);
+        Cross(cx, cy, cz, ax, ay, az, r1x, r1y, r1z);
+        Cross(ax, ay, az, bx, by, bz, r2x, r2y, r2z);
+
+        const Float4 inv_det = simd::Div(simd::Set1(1.0f), Dot(ax, ay, az, r0x, r0y, r0z));
+        r0x = simd::Mul(r0x, inv_det); r0y = simd::Mul(r0y, inv_det); r0z = simd::Mul(r0z, inv_det);
+        r1x = simd::Mul(r1x, inv_det); r1y = simd::Mul(r1y, inv_det); r1z = simd::Mul(r1z, inv_det);
+        r2x = simd::Mul(r2x, inv_det); r2y = simd::Mul(r2y, inv_det); r2z = simd::Mul(r2z, inv_det);
+
+        const Float4 zero = simd::Zero();
+        StoreColumns(out, 0, r0x, r1x, r2x, zero);
+        StoreColumns(out, 1, r0y, r1y, r2y, zero);
+        StoreColumns(out, 2, r0z, r1z, r2z, zero);
+        StoreColumns(out, 3,
+          simd::Sub(zero, Dot(r0x, r0y, r0z, tx, ty, tz)),
+          simd::Sub(zero, Dot(r1x, r1y, r1z, tx, ty, tz)),
+          simd::Sub(zero, Dot(r2x, r2y, r2z, tx, ty, tz)),
+          simd::Set1(1.0f));
+      }
+
+      //-------------------------------------------------------------------------
+      void DecomposeBlock(
+        const glm::mat4* in,
+        glm::vec3* positions,
+        glm::quat* rotations,
+        glm::vec3* scales)
+      {
+        if (positions != nullptr)
+        {
+          for (size_t i = 0; i < kBlockSize; ++i)
+          {
+            positions[i] = glm::vec3(in[i][3]);
+          }
+        }
+
+        if (rotations == nullptr && scales == nullptr)
+        {
+          return;
+        }
+
+        Float4 r0x, r0y, r0z, r1x, r1y, r1z, r2x, r2y, r2z, unused;
+        LoadColumns(in, 0, r0x, r0y, r0z, unused);
+        LoadColumns(in, 1, r1x, r1y, r1z, unused);
+        LoadColumns(in, 2, r2x, r2y, r2z, unused);
+
+        // Gram-Schmidt orthonormalization, removing the shear from the columns
+        Float4 sx = simd::Sqrt(Dot(r0x, r0y, r0z, r0x, r0y, r0z));
+        r0x = simd::Div(r0x, sx); r0y = simd::Div(r0y, sx); r0z = simd::Div(r0z, sx);
+
+        Float4 d = Dot(r0x, r0y, r0z, r1x, r1y, r1z);
+        r1x = simd::Sub(r1x, simd::Mul(r0x, d));
+        r1y = simd::Sub(r1y, simd::Mul(r0y, d));
+        r1z = simd::Sub(r1z, simd::Mul(r0z, d));
+        Float4 sy = simd::Sqrt(Dot(r1x, r1y, r1z, r1x, r1y, r1z));
+        r1x = simd::Div(r1x, sy); r1y = simd::Div(r1y, sy); r1z = simd::Div(r1z, sy);
+
+        d = Dot(r0x, r0y, r0z, r2x, r2y, r2z);
+        r2x = simd::Sub(r2x, simd::Mul(r0x, d));
+        r2y = simd::Sub(r2y, simd::Mul(r0y, d));
+        r2z = simd::Sub(r2z, simd::Mul(r0z, d));
+        d = Dot(r1x, r1y, r1z, r2x, r2y, r2z);
+        r2x = simd::Sub(r2x, simd::Mul(r1x, d));
+        r2y = simd::Sub(r2y, simd::Mul(r1y, d));
+        r2z = simd::Sub(r2z, simd::Mul(r1z, d));
+        Float4 sz = simd::Sqrt(Dot(r2x, r2y, r2z, r2x, r2y, r2z));
+        r2x = simd::Div(r2x, sz); r2y = simd::Div(r2y, sz); r2z = simd::Div(r2z, sz);
+
+        // Negate everything if the matrix mirrors
+        Float4 cx, cy, cz;
+        Cross(r1x, r1y, r1z, r2x, r2y, r2z, cx, cy, cz);
+        const Float4 flip = simd::CmpLt(Dot(r0x, r0y, r0z, cx, cy, cz), simd::Zero());
+        const Float4 sign = simd::Select(flip, simd::Set1(-1.0f), simd::Set1(1.0f));
+
+        if (scales != nullptr)
+        {
+          sx = simd::Mul(sx, sign);
+          sy = simd::Mul(sy, sign);
+          sz = simd::Mul(sz, sign);
+          Float4 w = simd::Zero();
+          simd::Transpose(sx, sy, sz, w);
+
+          float scale[kBlockSize][4];
+          simd::Store(scale[0], sx);
+          simd::Store(scale[1], sy);
+          simd::Store(scale[2], sz);
+          simd::Store(scale[3], w);
+          for (size_t i = 0; i < kBlockSize; ++i)
+          {
+            scales[i] = glm::vec3(scale[i][0], scale[i][1], scale[i][2]);
+          }
+        }
+
+        if (rotations == nullptr)
+        {
+          return;
+        }
+
+        const Float4 m00 = simd::Mul(r0x, sign), m01 = simd::Mul(r0y, sign), m02 = simd::Mul(r0z, sign);
+        const Float4 m10 = simd::Mul(r1x, sign), m11 = simd::Mul(r1y, sign), m12 = simd::Mul(r1z, sign);
+        const Float4 m20 = simd::Mul(r2x, sign), m21 = simd::Mul(r2y, sign), m22 = simd::Mul(r2z, sign);
+
+        // Pick the same case as the scalar decomposition: the trace if positive, otherwise the largest diagonal
+        const Float4 one = simd::Set1(1.0f);
+        const Float4 trace = simd::Add(m00, simd::Add(m11, m22));
+        const Float4 use_w = simd::CmpGt(trace, simd::Zero());
+        const Float4 y_over_x = simd::CmpGt(m11, m00);
+        const Float4 use_z = simd::AndNot(use_w, simd::CmpGt(m22, simd::Select(y_over_x, m11, m00)));
+        const Float4 use_y = simd::AndNot(use_z, simd::AndNot(use_w, y_over_x));
+
+        // Lanes that don't use w, y or z use the x case
+        Float4 arg = simd::Add(simd::Sub(simd::Sub(m00, m11), m22), one);
+        arg = simd::Select(use_y, simd::Add(simd::Sub(simd::Sub(m11, m22), m00), one), arg);
+        arg = simd::Select(use_z, simd::Add(simd::Sub(simd::Sub(m22, m00), m11), one), arg);
+        arg = simd::Select(use_w, simd::Add(trace, one), arg);
+
+        const Float4 root = simd::Sqrt(arg);
+        const Float4 half = simd::Mul(root, simd::Set1(0.5f));
+        const Float4 f = simd::Div(simd::Set1(0.5f), root);
+
+        const Float4 d_x = simd::Mul(f, simd::Sub(m12, m21));
+        const Float4 d_y = simd::Mul(f, simd::Sub(m20, m02));
+        const Float4 d_z = simd::Mul(f, simd::Sub(m01, m10));
+        const Float4 s_xy = simd::Mul(f, simd::Add(m01, m10));
+        const Float4 s_xz = simd::Mul(f, simd::Add(m02, m20));
+        const Float4 s_yz = simd::Mul(f, simd::Add(m12, m21));
+
+        Float4 qx = simd::Select(use_w, d_x, simd::Select(use_y, s_xy, simd::Select(use_z, s_xz, half)));
+        Float4 qy = simd::Select(use_w, d_y, simd::Select(use_y, half, simd::Select(use_z, s_yz, s_xy)));
+        Float4 qz = simd::Select(use_w, d_z, simd::Select(use_y, s_yz, simd::Select(use_z, half, s_xz)));
+        Float4 qw = simd::Select(use_w, half, simd::Select(use_y, d_y, simd::Select(use_z, d_z, d_x)));
+
+        simd::Transpose(qx, qy, qz, qw);
+        simd::Store(&rotations[0].x, qx);
+        simd::Store(&rotations[1].x, qy);
+        simd::Store(&rotations[2].x, qz);
+        simd::Store(&rotations[3].x, qw);
+      }
+
+      //-------------------------------------------------------------------------
+      // Blends four transforms, b holds the weight of each of them
+      void BlendBlock(PoseSoA& pose, const PoseSoA& other, size_t i, Float4 b)
+      {
+        const Float4 a = simd::Sub(simd::Set1(1.0f), b);
+        const Float4 zero = simd::Zero();
+
+        float* const linear[] = { &pose.tx[i], &pose.ty[i], &pose.tz[i], &pose.sx[i], &pose.sy[i], &pose.sz[i] };
+        const float* const other_linear[] = { &other.tx[i], &other.ty[i], &other.tz[i], &other.sx[i], &other.sy[i], &other.sz[i] };
+        for (size_t c = 0; c < 6; ++c)
+        {
+          simd::Store(linear[c], simd::MulAdd(simd::Load(linear[c]), a, simd::Mul(simd::Load(other_linear[c]), b)));
+        }
+
+        const Float4 qx = simd::Load(&pose.rx[i]);
+        const Float4 qy = simd::Load(&pose.ry[i]);
+        const Float4 qz = simd::Load(&pose.rz[i]);
+        const Float4 qw = simd::Load(&pose.rw[i]);
+        const Float4 ox = simd::Load(&other.rx[i]);
+        const Float4 oy = simd::Load(&other.ry[i]);
+        const Float4 oz = simd::Load(&other.rz[i]);
+        const Float4 ow = simd::Load(&other.rw[i]);
+
+        // Blend towards the closest of q and -q, so the rotation takes the short way around
+        const Float4 dot = simd::MulAdd(qx, ox, simd::MulAdd(qy, oy, simd::MulAdd(qz, oz, simd::Mul(qw, ow))));
+        const Float4 ob = simd::Select(simd::CmpLt(dot, zero), simd::Sub(zero, b), b);
+
+        const Float4 nx = simd::MulAdd(qx, a, simd::Mul(ox, ob));
+        const Float4 ny = simd::MulAdd(qy, a, simd::Mul(oy, ob));
+        const Float4 nz = simd::MulAdd(qz, a, simd::Mul(oz, ob));
+        const Float4 nw = simd::MulAdd(qw, a, simd::Mul(ow, ob));
+
+        const Float4 length = simd::Sqrt(
+          simd::MulAdd(nx, nx, simd::MulAdd(ny, ny, simd::MulAdd(nz, nz, simd::Mul(nw, nw)))));
+
+        // Transforms with a weight of 0 keep their rotation as is, instead of being normalized again
+        const Float4 blended = simd::CmpGt(b, zero);
+        simd::Store(&pose.rx[i], simd::Select(blended, simd::Div(nx, length), qx));
+        simd::Store(&pose.ry[i], simd::Select(blended, simd::Div(ny, length), qy));
+        simd::Store(&pose.rz[i], simd::Select(blended, simd::Div(nz, length), qz));
+        simd::Store(&pose.rw[i], simd::Select(blended, simd::Div(nw, length), qw));
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ComposeTransforms(
+      const glm::vec3* positions,
+      const glm::quat* rotations,
+      const glm::vec3* scales,
+      glm::mat4* out,
+      size_t count)
+    {
+      size_t i = 0;
+      for (; i + kBlockSize <= count; i += kBlockSize)
+      {
+        ComposeBlock(positions + i, rotations + i, scales + i, out + i);
+      }
+
+      if (i == count)
+      {
+        return;
+      }
+
+      // Pad the remainder with identity transforms
+      glm::vec3 p[kBlockSize];
+      glm::quat r[kBlockSize];
+      glm::vec3 s[kBlockSize];
+      glm::mat4 result[kBlockSize];
+      for (size_t j = 0; j < kBlockSize; ++j)
+      {
+        const bool valid = i + j < count;
+        p[j] = valid == true ? positions[i + j] : glm::vec3(0.0f);
+        r[j] = valid == true ? rotations[i + j] : glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        s[j] = valid == true ? scales[i + j] : glm::vec3(1.0f);
+      }
+
+      ComposeBlock(p, r, s, result);
+      for (size_t j = 0; i + j < count; ++j)
+      {
+        out[i + j] = result[j];
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void MultiplyAffine(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out)
+    {
+      const Float4 l0 = simd::Load(&lhs[0][0]);
+      const Float4 l1 = simd::Load(&lhs[1][0]);
+      const Float4 l2 = simd::Load(&lhs[2][0]);
+      const Float4 l3 = simd::Load(&lhs[3][0]);
+
+      Float4 result[4];
+      for (int c = 0; c < 4; ++c)
+      {
+        const Float4 r = simd::Load(&rhs[c][0]);
+        result[c] = simd::MulAdd(l0, simd::Splat<0>(r),
+          simd::MulAdd(l1, simd::Splat<1>(r),
+            simd::Mul(l2, simd::Splat<2>(r))));
+      }
+      result[3] = simd::Add(result[3], l3);
+
+      for (int c = 0; c < 4; ++c)
+      {
+        simd::Store(&out[c][0], result[c]);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void MultiplyAffine(const glm::mat4& lhs, const glm::mat4* rhs, glm::mat4* out, size_t count)
+    {
+      const Float4 l0 = simd::Load(&lhs[0][0]);
+      const Float4 l1 = simd::Load(&lhs[1][0]);
+      const Float4 l2 = simd::Load(&lhs[2][0]);
+      const Float4 l3 = simd::Load(&lhs[3][0]);
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        Float4 result[4];
+        for (int c = 0; c < 4; ++c)
+        {
+          const Float4 r = simd::Load(&rhs[i][c][0]);
+          result[c] = simd::MulAdd(l0, simd::Splat<0>(r),
+            simd::MulAdd(l1, simd::Splat<1>(r),
+              simd::Mul(l2, simd::Splat<2>(r))));
+        }
+        result[3] = simd::Add(result[3], l3);
+
+        for (int c = 0; c < 4; ++c)
+        {
+          simd::Store(&out[i][c][0], result[c]);
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void InverseAffine(const glm::mat4* in, glm::mat4* out, size_t count)
+    {
+      size_t i = 0;
+      for (; i + kBlockSize <= count; i += kBlockSize)
+      {
+        InverseBlock(in + i, out + i);
+      }
+
+      if (i == count)
+      {
+        return;
+      }
+
+      glm::mat4 m[kBlockSize] = { glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f) };
+      for (size_t j = 0; i + j < count; ++j)
+      {
+        m[j] = in[i + j];
+      }
+
+      InverseBlock(m, m);
+      for (size_t j = 0; i + j < count; ++j)
+      {
+        out[i + j] = m[j];
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void DecomposeTransforms(
+      const glm::mat4* in,
+      glm::vec3* positions,
+      glm::quat* rotations,
+      glm::vec3* scales,
+      size_t count)
+    {
+      size_t i = 0;
+      for (; i + kBlockSize <= count; i += kBlockSize)
+      {
+        DecomposeBlock(in + i,
+          positions != nullptr ? positions + i : nullptr,
+          rotations != nullptr ? rotations + i : nullptr,
+          scales != nullptr ? scales + i : nullptr);
+      }
+
+      if (i == count)
+      {
+        return;
+      }
+
+      glm::mat4 m[kBlockSize] = { glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f) };
+      glm::vec3 p[kBlockSize];
+      glm::quat r[kBlockSize];
+      glm::vec3 s[kBlockSize];
+      for (size_t j = 0; i + j < count; ++j)
+      {
+        m[j] = in[i + j];
+      }
+
+      DecomposeBlock(m, p, r, s);
+      for (size_t j = 0; i + j < count; ++j)
+      {
+        if (positions != nullptr)
+        {
+          positions[i + j] = p[j];
+        }
+        if (rotations != nullptr)
+        {
+          rotations[i + j] = r[j];
+        }
+        if (scales != nullptr)
+        {
+          scales[i + j] = s[j];
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void PoseSoA::Resize(size_t count)
+    {
+      // Padding lanes hold identity transforms, so whole blocks can always be processed
+      const size_t padded = (count + kBlockSize - 1) / kBlockSize * kBlockSize;
+      size_ = count;
+
+      for (Vector<float>* channel : { &tx, &ty, &tz, &rx, &ry, &rz })
+      {
+        channel->resize(padded, 0.0f);
+      }
+      for (Vector<float>* channel : { &rw, &sx, &sy, &sz })
+      {
+        channel->resize(padded, 1.0f);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void PoseSoA::Set(size_t index, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+    {
+      tx[index] = position.x; ty[index] = position.y; tz[index] = position.z;
+      rx[index] = rotation.x; ry[index] = rotation.y; rz[index] = rotation.z; rw[index] = rotation.w;
+      sx[index] = scale.x; sy[index] = scale.y; sz[index] = scale.z;
+    }
+
+    //-------------------------------------------------------------------------
+    void PoseSoA::Copy(size_t index, const PoseSoA& other, size_t other_index)
+    {
+      tx[index] = other.tx[other_index]; ty[index] = other.ty[other_index]; tz[index] = other.tz[other_index];
+      rx[index] = other.rx[other_index]; ry[index] = other.ry[other_index];
+      rz[index] = other.rz[other_index]; rw[index] = other.rw[other_index];
+      sx[index] = other.sx[other_index]; sy[index] = other.sy[other_index]; sz[index] = other.sz[other_index];
+    }
+
+    //-------------------------------------------------------------------------
+    size_t PoseSoA::size() const
+    {
+      return size_;
+    }
+
+    //-------------------------------------------------------------------------
+    void BlendPoses(PoseSoA& pose, const PoseSoA& other, float weight)
+    {
+      assert(pose.tx.size() == other.tx.size());
+
+      const Float4 b = simd::Set1(weight);
+      for (size_t i = 0; i < pose.tx.size(); i += kBlockSize)
+      {
+        BlendBlock(pose, other, i, b);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void BlendPoses(PoseSoA& pose, const PoseSoA& other, float weight, const float* mask)
+    {
+      assert(pose.tx.size() == other.tx.size());
+
+      const Float4 w = simd::Set1(weight);
+      for (size_t i = 0; i < pose.tx.size(); i += kBlockSize)
+      {
+        BlendBlock(pose, other, i, simd::Mul(simd::Load(&mask[i]), w));
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ComposePose(const PoseSoA& pose, glm::mat4* out)
+    {
+      size_t i = 0;
+      for (; i + kBlockSize <= pose.size(); i += kBlockSize)
+      {
+        ComposeColumns(
+          simd::Load(&pose.tx[i]), simd::Load(&pose.ty[i]), simd::Load(&pose.tz[i]),
+          simd::Load(&pose.rx[i]), simd::Load(&pose.ry[i]), simd::Load(&pose.rz[i]), simd::Load(&pose.rw[i]),
+          simd::Load(&pose.sx[i]), simd::Load(&pose.sy[i]), simd::Load(&pose.sz[i]),
+          out + i);
+      }
+
+      if (i == pose.size())
+      {
+        return;
+      }
+
+      // The padding lanes hold identity transforms, only the valid ones are copied out
+      glm::mat4 result[kBlockSize];
+      ComposeColumns(
+        simd::Load(&pose.tx[i]), simd::Load(&pose.ty[i]), simd::Load(&pose.tz[i]),
+        simd::Load(&pose.rx[i]), simd::Load(&pose.ry[i]), simd::Load(&pose.rz[i]), simd::Load(&pose.rw[i]),
+        simd::Load(&pose.sx[i]), simd::Load(&pose.sy[i]), simd::Load(&pose.sz[i]),
+        result);
+      for (size_t j = 0; i + j < pose.size(); ++j)
+      {
+        out[i + j] = result[j];
+      }
+    }
+  }
+}
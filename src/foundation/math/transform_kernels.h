@@ -0,0 +1,142 @@
+#pragma once
+
+#include "foundation/containers/vector.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace sulphur
+{
+  namespace foundation
+  {
+    /**
+    * @brief Builds translation * rotation * scale matrices, four transforms at a time
+    * @param[in] positions (const glm::vec3*) The translations
+    * @param[in] rotations (const glm::quat*) The rotations, these must be normalized
+    * @param[in] scales (const glm::vec3*) The scales
+    * @param[out] out (glm::mat4*) The resulting matrices
+    * @param[in] count (size_t) The amount of transforms
+    */
+    void ComposeTransforms(
+      const glm::vec3* positions,
+      const glm::quat* rotations,
+      const glm::vec3* scales,
+      glm::mat4* out,
+      size_t count);
+
+    /**
+    * @brief Multiplies two affine matrices
+    * @param[in] lhs (const glm::mat4&) The left hand side, usually the parent's transformation
+    * @param[in] rhs (const glm::mat4&) The right hand side, must be affine
+    * @param[out] out (glm::mat4&) The result, may alias either input
+    * @remarks Skips the bottom row of the right hand side, which is assumed to be (0, 0, 0, 1)
+    */
+    void MultiplyAffine(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out);
+
+    /**
+    * @brief Multiplies affine matrices by the same matrix, used to place matrices that are shared in model space
+    * @param[in] lhs (const glm::mat4&) The left hand side of every multiplication
+    * @param[in] rhs (const glm::mat4*) The right hand sides, must be affine
+    * @param[out] out (glm::mat4*) The results, may alias the right hand sides
+    * @param[in] count (size_t) The amount of matrices
+    */
+    void MultiplyAffine(const glm::mat4& lhs, const glm::mat4* rhs, glm::mat4* out, size_t count);
+
+    /**
+    * @brief Inverts affine matrices, four at a time
+    * @param[in] in (const glm::mat4*) The matrices to invert, the bottom rows must be (0, 0, 0, 1)
+    * @param[out] out (glm::mat4*) The inverted matrices, may alias the input
+    * @param[in] count (size_t) The amount of matrices
+    * @remarks Only inverts the upper 3x3 part, which makes it much cheaper than glm::inverse.
+    * Matrices with a scale of 0 on any axis have no inverse and result in non-finite values.
+    */
+    void InverseAffine(const glm::mat4* in, glm::mat4* out, size_t count);
+
+    /**
+    * @brief Extracts the translation, rotation and scale from affine matrices, four at a time
+    * @param[in] in (const glm::mat4*) The matrices to decompose
+    * @param[out] positions (glm::vec3*) The translations, can be nullptr
+    * @param[out] rotations (glm::quat*) The rotations, can be nullptr
+    * @param[out] scales (glm::vec3*) The scales, can be nullptr
+    * @param[in] count (size_t) The amount of matrices
+    * @remarks Shear is removed by orthonormalizing the columns in order. A mirrored matrix
+    * results in a negative scale on all axes.
+    */
+    void DecomposeTransforms(
+      const glm::mat4* in,
+      glm::vec3* positions,
+      glm::quat* rotations,
+      glm::vec3* scales,
+      size_t count);
+
+    /**
+    * @struct sulphur::foundation::PoseSoA
+    * @brief Local transforms stored as one array per component, so the kernels can process four at a time
+    * @remarks The arrays are padded to a multiple of four with identity transforms.
+    */
+    struct PoseSoA
+    {
+      /**
+      * @brief Sets the amount of transforms, new transforms are identity transforms
+      * @param[in] count (size_t) The amount of transforms
+      */
+      void Resize(size_t count);
+
+      /**
+      * @brief Sets a transform
+      * @param[in] index (size_t) The index of the transform
+      * @param[in] position (const glm::vec3&) The translation
+      * @param[in] rotation (const glm::quat&) The rotation, must be normalized
+      * @param[in] scale (const glm::vec3&) The scale
+      */
+      void Set(size_t index, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+      /**
+      * @brief Copies a transform from another pose
+      * @param[in] index (size_t) The index of the transform
+      * @param[in] other (const sulphur::foundation::PoseSoA&) The pose to copy from
+      * @param[in] other_index (size_t) The index of the transform in the other pose
+      */
+      void Copy(size_t index, const PoseSoA& other, size_t other_index);
+
+      /**
+      * @return (size_t) The amount of transforms, without the padding
+      */
+      size_t size() const;
+
+      Vector<float> tx, ty, tz; //!< The translations
+      Vector<float> rx, ry, rz, rw; //!< The rotations
+      Vector<float> sx, sy, sz; //!< The scales
+
+    private:
+      size_t size_ = 0; //!< The amount of transforms
+    };
+
+    /**
+    * @brief Blends another pose into a pose, four transforms at a time
+    * @param[in,out] pose (sulphur::foundation::PoseSoA&) The pose to blend into
+    * @param[in] other (const sulphur::foundation::PoseSoA&) The pose to blend towards, must have the same size
+    * @param[in] weight (float) How far to blend towards the other pose, 0 keeps the pose and 1 results in the other pose
+    * @remarks Translations and scales are interpolated linearly, rotations with a normalized linear
+    * interpolation along the shortest path.
+    */
+    void BlendPoses(PoseSoA& pose, const PoseSoA& other, float weight);
+
+    /**
+    * @brief Blends another pose into a pose with a weight per transform, four transforms at a time
+    * @param[in,out] pose (sulphur::foundation::PoseSoA&) The pose to blend into
+    * @param[in] other (const sulphur::foundation::PoseSoA&) The pose to blend towards, must have the same size
+    * @param[in] weight (float) How far to blend towards the other pose, 0 keeps the pose and 1 results in the other pose
+    * @param[in] mask (const float*) The weight is multiplied by this per transform, it has to cover the padding too
+    * @remarks Transforms with a mask of 0 are left untouched, so a pose that only animates part of a skeleton
+    * doesn't pull the rest of it towards the other pose.
+    */
+    void BlendPoses(PoseSoA& pose, const PoseSoA& other, float weight, const float* mask);
+
+    /**
+    * @brief Builds translation * rotation * scale matrices from a pose, four transforms at a time
+    * @param[in] pose (const sulphur::foundation::PoseSoA&) The pose, its rotations must be normalized
+    * @param[out] out (glm::mat4*) The resulting matrices, one per transform of the pose
+    */
+    void ComposePose(const PoseSoA& pose, glm::mat4* out);
+  }
+}
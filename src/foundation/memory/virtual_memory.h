@@ -0,0 +1,12 @@
+#pragma once
+
+#ifdef PS_WIN32
+#include "foundation/win32/win32_virtual_memory.h"
+namespace sulphur
+{
+  namespace foundation
+  {
+    using VirtualMemory = Win32VirtualMemory;
+  }
+}
+#endif
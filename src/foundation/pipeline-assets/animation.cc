@@ -1,13 +1,230 @@
 #include "animation.h"
+#include <EASTL/algorithm.h>
 
 namespace sulphur 
 {
   namespace foundation 
   {
+    namespace
+    {
+      const float kSmallestThreeRange = 0.70710678f; //!< Largest magnitude of a non-dropped component.
+      const uint16_t kSmallestThreeMask = 0x7fff;     //!< Mask of the bits storing a component.
+
+      //--------------------------------------------------------------------------------
+      uint16_t PackComponent(float value)
+      {
+        float normalized = glm::clamp(value / kSmallestThreeRange, -1.0f, 1.0f) * 0.5f + 0.5f;
+        return static_cast<uint16_t>(normalized * kSmallestThreeMask + 0.5f);
+      }
+
+      //--------------------------------------------------------------------------------
+      float UnpackComponent(uint16_t value)
+      {
+        float normalized = static_cast<float>(value & kSmallestThreeMask) / kSmallestThreeMask;
+        return (normalized * 2.0f - 1.0f) * kSmallestThreeRange;
+      }
+
+      /**
+      * @brief Finds the key to interpolate from and how far to interpolate to the next key.
+      * @param[in] format (sulphur::foundation::AnimationTrackFormat) The format of the track.
+      * @param[in] start_time (float) The time of the first key of a uniform track.
+      * @param[in] sample_interval (float) The time between keys of a uniform track.
+      * @param[in] times (const sulphur::foundation::Vector<float>&) The key times of a keyframed track.
+      * @param[in] count (size_t) The amount of keys in the track.
+      * @param[in] time (float) The time to sample at.
+      * @param[out] factor (float&) The interpolation factor towards the next key.
+      * @return (size_t) The index of the key to interpolate from.
+      */
+      size_t FindKey(AnimationTrackFormat format, float start_time, float sample_interval,
+        const Vector<float>& times, size_t count, float time, float& factor)
+      {
+        factor = 0.0f;
+        if (format == AnimationTrackFormat::kConstant || count <= 1)
+        {
+          return 0;
+        }
+
+        if (format == AnimationTrackFormat::kUniform)
+        {
+          float position = (time - start_time) / sample_interval;
+          if (position <= 0.0f)
+          {
+            return 0;
+          }
+          if (position >= static_cast<float>(count - 1))
+          {
+            return count - 1;
+          }
+
+          size_t index = static_cast<size_t>(position);
+          factor = position - static_cast<float>(index);
+          return index;
+        }
+
+        const float* next = eastl::upper_bound(times.begin(), times.end(), time);
+        if (next == times.begin())
+        {
+          return 0;
+        }
+        if (next == times.end())
+        {
+          return count - 1;
+        }
+
+        size_t index = static_cast<size_t>(next - times.begin()) - 1;
+        factor = (time - times[index]) / (times[index + 1] - times[index]);
+        return index;
+      }
+    }
+
+    //--------------------------------------------------------------------------------
+    QuantizedQuaternion QuantizedQuaternion::Encode(const glm::quat& quaternion)
+    {
+      glm::quat q = glm::normalize(quaternion);
+      float components[4] = { q.x, q.y, q.z, q.w };
+
+      uint16_t largest = 0;
+      for (uint16_t i = 1; i < 4; ++i)
+      {
+        if (glm::abs(components[i]) > glm::abs(components[largest]))
+        {
+          largest = i;
+        }
+      }
+
+      // q and -q describe the same rotation, make sure the dropped component is positive
+      float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+      uint16_t packed[3];
+      for (uint16_t i = 0, j = 0; i < 4; ++i)
+      {
+        if (i != largest)
+        {
+          packed[j++] = PackComponent(components[i] * sign);
+        }
+      }
+
+      QuantizedQuaternion result;
+      result.data[0] = static_cast<uint16_t>(((largest >> 1) << 15) | packed[0]);
+      result.data[1] = static_cast<uint16_t>(((largest & 1) << 15) | packed[1]);
+      result.data[2] = packed[2];
+      return result;
+    }
+
+    //--------------------------------------------------------------------------------
+    glm::quat QuantizedQuaternion::Decode() const
+    {
+      const uint16_t largest = static_cast<uint16_t>(((data[0] >> 15) << 1) | (data[1] >> 15));
+
+      float components[4];
+      float sum = 0.0f;
+      for (uint16_t i = 0, j = 0; i < 4; ++i)
+      {
+        if (i != largest)
+        {
+          components[i] = UnpackComponent(data[j++]);
+          sum += components[i] * components[i];
+        }
+      }
+      components[largest] = glm::sqrt(glm::max(0.0f, 1.0f - sum));
+
+      return glm::normalize(
+        glm::quat(components[3], components[0], components[1], components[2]));
+    }
+
+    //--------------------------------------------------------------------------------
+    void AnimationVectorTrack::Write(BinaryWriter& binary_writer) const
+    {
+      binary_writer.Write(format);
+      binary_writer.Write(start_time);
+      binary_writer.Write(sample_interval);
+      binary_writer.Write(times);
+      binary_writer.Write(values);
+    }
+
+    //--------------------------------------------------------------------------------
+    void AnimationVectorTrack::Read(BinaryReader& binary_reader)
+    {
+      format = binary_reader.Read<AnimationTrackFormat>();
+      start_time = binary_reader.ReadFloat();
+      sample_interval = binary_reader.ReadFloat();
+      times = binary_reader.ReadVector<float>();
+      values = binary_reader.ReadVector<glm::vec3>();
+    }
+
+    //--------------------------------------------------------------------------------
+    glm::vec3 AnimationVectorTrack::Evaluate(float time, const glm::vec3& fallback) const
+    {
+      if (values.empty() == true)
+      {
+        return fallback;
+      }
+
+      float factor = 0.0f;
+      const size_t index = FindKey(format, start_time, sample_interval, 
+        times, values.size(), time, factor);
+
+      if (factor <= 0.0f)
+      {
+        return values[index];
+      }
+
+      return glm::mix(values[index], values[index + 1], factor);
+    }
+
+    //--------------------------------------------------------------------------------
+    void AnimationRotationTrack::Write(BinaryWriter& binary_writer) const
+    {
+      binary_writer.Write(format);
+      binary_writer.Write(start_time);
+      binary_writer.Write(sample_interval);
+      binary_writer.Write(times);
+      binary_writer.Write(values);
+    }
+
+    //--------------------------------------------------------------------------------
+    void AnimationRotationTrack::Read(BinaryReader& binary_reader)
+    {
+      format = binary_reader.Read<AnimationTrackFormat>();
+      start_time = binary_reader.ReadFloat();
+      sample_interval = binary_reader.ReadFloat();
+      times = binary_reader.ReadVector<float>();
+      values = binary_reader.ReadVector<QuantizedQuaternion>();
+    }
+
+    //--------------------------------------------------------------------------------
+    glm::quat AnimationRotationTrack::Evaluate(float time) const
+    {
+      if (values.empty() == true)
+      {
+        return glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+      }
+
+      float factor = 0.0f;
+      const size_t index = FindKey(format, start_time, sample_interval,
+        times, values.size(), time, factor);
+
+      if (factor <= 0.0f)
+      {
+        return values[index].Decode();
+      }
+
+      return glm::slerp(values[index].Decode(), values[index + 1].Decode(), factor);
+    }
+
     //--------------------------------------------------------------------------------
     void AnimationChannel::Write(BinaryWriter& binary_writer) const
     {
       binary_writer.Write(bone_name);
+      binary_writer.Write(compressed);
+      if (compressed == true)
+      {
+        binary_writer.Write(position_track);
+        binary_writer.Write(rotation_track);
+        binary_writer.Write(scale_track);
+        return;
+      }
+
       binary_writer.Write(position_keys);
       binary_writer.Write(rotation_keys);
       binary_writer.Write(scale_keys);
@@ -17,6 +234,15 @@ namespace sulphur
     void AnimationChannel::Read(BinaryReader& binary_reader)
     {
       bone_name = binary_reader.ReadString();
+      compressed = binary_reader.ReadBoolean();
+      if (compressed == true)
+      {
+        position_track = binary_reader.Read<AnimationVectorTrack>();
+        rotation_track = binary_reader.Read<AnimationRotationTrack>();
+        scale_track = binary_reader.Read<AnimationVectorTrack>();
+        return;
+      }
+
       position_keys = binary_reader.ReadVector<AnimationVectorKey>();
       rotation_keys = binary_reader.ReadVector<AnimationQuaternionKey>();
       scale_keys = binary_reader.ReadVector<AnimationVectorKey>();
@@ -25,6 +251,7 @@ namespace sulphur
     //--------------------------------------------------------------------------------
     void AnimationData::Write(BinaryWriter& binary_writer) const
     {
+      WritePackageHeader(binary_writer, kPackageMagic, kPackageVersion);
       binary_writer.Write(duration);
       binary_writer.Write(ticks_per_second);
       binary_writer.Write(channels);
@@ -33,6 +260,12 @@ namespace sulphur
     //--------------------------------------------------------------------------------
     void AnimationData::Read(BinaryReader& binary_reader)
     {
+      if (ReadPackageHeader(binary_reader, kPackageMagic, kPackageVersion) == false)
+      {
+        channels.clear();
+        return;
+      }
+
       duration = binary_reader.ReadFloat();
       ticks_per_second = binary_reader.ReadFloat();
       channels = binary_reader.ReadVector<AnimationChannel>();
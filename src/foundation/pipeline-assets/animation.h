@@ -31,6 +31,101 @@ namespace sulphur
       glm::quat quaternion; //!< The keyframe value.
     };
 
+    /**
+    * @brief The way the keys of a compressed animation track are stored.
+    */
+    enum struct AnimationTrackFormat : uint8_t
+    {
+      kKeyframes, //!< Every key stores its own timestamp.
+      kConstant,  //!< The track holds a single value for the whole animation.
+      kUniform    //!< Keys are sampled at a fixed interval, timestamps are implicit.
+    };
+
+    /**
+    * @struct sulphur::foundation::QuantizedQuaternion
+    * @brief A unit quaternion packed into 48 bits using the smallest-three encoding.
+    * @remarks The largest component is dropped and reconstructed from the other three.
+    * Its index is stored in the top bit of data[0] and data[1], the remaining
+    * three components use 15 bits each.
+    */
+    struct QuantizedQuaternion
+    {
+      /**
+      * @brief Packs a quaternion. The quaternion is normalized before packing.
+      * @param[in] quaternion (const glm::quat&) The quaternion to pack.
+      * @return (sulphur::foundation::QuantizedQuaternion) The packed quaternion.
+      */
+      static QuantizedQuaternion Encode(const glm::quat& quaternion);
+      /**
+      * @brief Unpacks the quaternion.
+      * @return (glm::quat) The unit quaternion.
+      */
+      glm::quat Decode() const;
+
+      uint16_t data[3]; //!< The packed components.
+    };
+
+    /**
+    * @class sulphur::foundation::AnimationVectorTrack : public sulphur::foundation::IBinarySerializable
+    * @brief Compressed position or scale keys of an animation channel.
+    */
+    class AnimationVectorTrack : public IBinarySerializable
+    {
+    public:
+      /*
+      * @see sulphur::foundation::IBinarySerializable::Write
+      */
+      void Write(BinaryWriter& binary_writer) const override;
+      /*
+      * @see sulphur::foundation::IBinarySerializable::Read
+      */
+      void Read(BinaryReader& binary_reader) override;
+
+      /**
+      * @brief Samples the track, interpolating linearly between keys.
+      * @param[in] time (float) The time in ticks to sample at.
+      * @param[in] fallback (const glm::vec3&) The value to return when the track is empty.
+      * @return (glm::vec3) The sampled value. Clamped to the first and last key.
+      */
+      glm::vec3 Evaluate(float time, const glm::vec3& fallback) const;
+
+      AnimationTrackFormat format = AnimationTrackFormat::kKeyframes; //!< How the keys are stored.
+      float start_time = 0.0f;      //!< Time of the first key when the format is kUniform.
+      float sample_interval = 0.0f; //!< Time between keys when the format is kUniform.
+      Vector<float> times;          //!< Key timestamps when the format is kKeyframes.
+      Vector<glm::vec3> values;     //!< Key values.
+    };
+
+    /**
+    * @class sulphur::foundation::AnimationRotationTrack : public sulphur::foundation::IBinarySerializable
+    * @brief Compressed rotation keys of an animation channel.
+    */
+    class AnimationRotationTrack : public IBinarySerializable
+    {
+    public:
+      /*
+      * @see sulphur::foundation::IBinarySerializable::Write
+      */
+      void Write(BinaryWriter& binary_writer) const override;
+      /*
+      * @see sulphur::foundation::IBinarySerializable::Read
+      */
+      void Read(BinaryReader& binary_reader) override;
+
+      /**
+      * @brief Samples the track, using spherical interpolation between keys.
+      * @param[in] time (float) The time in ticks to sample at.
+      * @return (glm::quat) The sampled rotation. Identity when the track is empty.
+      */
+      glm::quat Evaluate(float time) const;
+
+      AnimationTrackFormat format = AnimationTrackFormat::kKeyframes; //!< How the keys are stored.
+      float start_time = 0.0f;      //!< Time of the first key when the format is kUniform.
+      float sample_interval = 0.0f; //!< Time between keys when the format is kUniform.
+      Vector<float> times;          //!< Key timestamps when the format is kKeyframes.
+      Vector<QuantizedQuaternion> values; //!< Key values.
+    };
+
     /**
     * @class sulphur::foundation::AnimationChannel : public sulphur::foundation::IBinarySerializable
     * @brief Keyframe animation channel.
@@ -52,6 +147,11 @@ namespace sulphur
       Vector<AnimationVectorKey> position_keys; //!< Positions keys
       Vector<AnimationQuaternionKey> rotation_keys; //!< Rotation keys
       Vector<AnimationVectorKey> scale_keys;  //!< Scale keys
+
+      bool compressed = false; //!< Whether the tracks are used instead of the keys.
+      AnimationVectorTrack position_track;   //!< Compressed position keys.
+      AnimationRotationTrack rotation_track; //!< Compressed rotation keys.
+      AnimationVectorTrack scale_track;      //!< Compressed scale keys.
     };
 
 
@@ -72,9 +172,12 @@ namespace sulphur
       */
       void Read(BinaryReader& binary_reader) override;
 
+      static constexpr uint32_t kPackageMagic = MakePackageMagic('P', 'S', 'A', 'N'); //!< Identifies a packaged animation.
+      static constexpr uint32_t kPackageVersion = 2; //!< The layout version of packaged animations. Version 1 had no header and no compressed tracks.
+
       float duration; //!< The duration of the animation.
       float ticks_per_second; //!< The amount of keyframes per channel per second.
-      Vector<AnimationChannel> channels; //!< The animation channels.
+      Vector<AnimationChannel> channels; //!< The animation channels. Empty if the package has another layout version.
     };
 
     /**
@@ -1,17 +1,199 @@
 #include "mesh.h"
 
+#include <glm/gtc/packing.hpp>
+
 namespace sulphur 
 {
   namespace foundation 
   {
+    namespace
+    {
+      //--------------------------------------------------------------------------------
+      glm::vec2 SignNotZero(const glm::vec2& v)
+      {
+        return glm::vec2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+      }
+
+      //--------------------------------------------------------------------------------
+      void EncodeOctahedral(const glm::vec3& v, uint16_t out[2])
+      {
+        const float l1 = glm::abs(v.x) + glm::abs(v.y) + glm::abs(v.z);
+        if (l1 == 0.0f)
+        {
+          out[0] = out[1] = glm::packSnorm1x16(0.0f);
+          return;
+        }
+
+        const glm::vec3 n = v / l1;
+        glm::vec2 p = glm::vec2(n.x, n.y);
+        if (n.z < 0.0f)
+        {
+          p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) * SignNotZero(p);
+        }
+
+        out[0] = glm::packSnorm1x16(p.x);
+        out[1] = glm::packSnorm1x16(p.y);
+      }
+
+      //--------------------------------------------------------------------------------
+      glm::vec3 DecodeOctahedral(const uint16_t in[2])
+      {
+        const glm::vec2 p = glm::vec2(glm::unpackSnorm1x16(in[0]), glm::unpackSnorm1x16(in[1]));
+        glm::vec3 n = glm::vec3(p.x, p.y, 1.0f - glm::abs(p.x) - glm::abs(p.y));
+        if (n.z < 0.0f)
+        {
+          const glm::vec2 xy = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * SignNotZero(p);
+          n.x = xy.x;
+          n.y = xy.y;
+        }
+        return glm::normalize(n);
+      }
+
+      //--------------------------------------------------------------------------------
+      glm::vec3 QuantizationScale(const AABB& box)
+      {
+        const glm::vec3 extent = box.max - box.min;
+        return glm::vec3(
+          extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+          extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+          extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+      }
+
+      //--------------------------------------------------------------------------------
+      void QuantizeWeights(const float in[4], uint8_t out[4])
+      {
+        int sum = 0;
+        int largest = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+          out[i] = glm::packUnorm1x8(in[i]);
+          sum += out[i];
+          if (out[i] > out[largest])
+          {
+            largest = i;
+          }
+        }
+
+        // Keep the weights normalized by moving the rounding error into the largest weight
+        if (sum != 0)
+        {
+          out[largest] = static_cast<uint8_t>(glm::clamp(out[largest] + 255 - sum, 0, 255));
+        }
+      }
+    }
+
+    //--------------------------------------------------------------------------------
+    VertexBase Decode(const VertexBaseQuantized& vertex, const AABB& bounding_box)
+    {
+      const glm::vec3 position = glm::vec3(
+        glm::unpackUnorm1x16(vertex.position[0]),
+        glm::unpackUnorm1x16(vertex.position[1]),
+        glm::unpackUnorm1x16(vertex.position[2]));
+
+      VertexBase result;
+      result.position = bounding_box.min + position * (bounding_box.max - bounding_box.min);
+      result.normal = DecodeOctahedral(vertex.normal);
+      return result;
+    }
+
+    //--------------------------------------------------------------------------------
+    VertexTextured Decode(const VertexTexturedQuantized& vertex)
+    {
+      VertexTextured result;
+      result.uv = glm::vec2(glm::unpackHalf1x16(vertex.uv[0]), glm::unpackHalf1x16(vertex.uv[1]));
+      result.tangent = DecodeOctahedral(vertex.tangent);
+      return result;
+    }
+
+    //--------------------------------------------------------------------------------
+    VertexColor Decode(const VertexColorQuantized& vertex)
+    {
+      VertexColor result;
+      for (int i = 0; i < 4; ++i)
+      {
+        result.color[i] = glm::unpackUnorm1x8(vertex.color[i]);
+      }
+      return result;
+    }
+
+    //--------------------------------------------------------------------------------
+    VertexBones Decode(const VertexBonesQuantized& vertex)
+    {
+      VertexBones result;
+      for (int i = 0; i < 4; ++i)
+      {
+        result.bone_weights[i] = glm::unpackUnorm1x8(vertex.bone_weights[i]);
+        result.bone_indices[i] = vertex.bone_indices[i];
+      }
+      return result;
+    }
+
     //--------------------------------------------------------------------------------
     void SubMesh::Write(BinaryWriter& binary_writer) const
     {
+      const VertexEncoding encoding = 
+        vertex_encoding == VertexEncoding::kQuantized && CanQuantize() == true ?
+        VertexEncoding::kQuantized : VertexEncoding::kFloat;
+
       binary_writer.Write(vertex_config);
-      binary_writer.Write(vertices_base);
-      binary_writer.Write(vertices_color);
-      binary_writer.Write(vertices_textured);
-      binary_writer.Write(vertices_bones);
+      binary_writer.Write(encoding);
+
+      if (encoding == VertexEncoding::kQuantized)
+      {
+        const glm::vec3 scale = QuantizationScale(bounding_box);
+
+        Vector<VertexBaseQuantized> base(vertices_base.size());
+        for (size_t i = 0; i < vertices_base.size(); ++i)
+        {
+          const glm::vec3 position = glm::clamp(
+            (vertices_base[i].position - bounding_box.min) * scale, 0.0f, 1.0f);
+          base[i].position[0] = glm::packUnorm1x16(position.x);
+          base[i].position[1] = glm::packUnorm1x16(position.y);
+          base[i].position[2] = glm::packUnorm1x16(position.z);
+          EncodeOctahedral(vertices_base[i].normal, base[i].normal);
+        }
+
+        Vector<VertexColorQuantized> color(vertices_color.size());
+        for (size_t i = 0; i < vertices_color.size(); ++i)
+        {
+          const glm::vec4& c = vertices_color[i].color;
+          for (int j = 0; j < 4; ++j)
+          {
+            color[i].color[j] = glm::packUnorm1x8(c[j]);
+          }
+        }
+
+        Vector<VertexTexturedQuantized> textured(vertices_textured.size());
+        for (size_t i = 0; i < vertices_textured.size(); ++i)
+        {
+          textured[i].uv[0] = glm::packHalf1x16(vertices_textured[i].uv.x);
+          textured[i].uv[1] = glm::packHalf1x16(vertices_textured[i].uv.y);
+          EncodeOctahedral(vertices_textured[i].tangent, textured[i].tangent);
+        }
+
+        Vector<VertexBonesQuantized> bones(vertices_bones.size());
+        for (size_t i = 0; i < vertices_bones.size(); ++i)
+        {
+          QuantizeWeights(vertices_bones[i].bone_weights, bones[i].bone_weights);
+          for (int j = 0; j < 4; ++j)
+          {
+            bones[i].bone_indices[j] = static_cast<uint8_t>(vertices_bones[i].bone_indices[j]);
+          }
+        }
+
+        binary_writer.Write(base);
+        binary_writer.Write(color);
+        binary_writer.Write(textured);
+        binary_writer.Write(bones);
+      }
+      else
+      {
+        binary_writer.Write(vertices_base);
+        binary_writer.Write(vertices_color);
+        binary_writer.Write(vertices_textured);
+        binary_writer.Write(vertices_bones);
+      }
+
       binary_writer.Write(indices);
       binary_writer.Write(primitive_type);
       binary_writer.Write(bounding_box);
@@ -23,10 +205,23 @@ namespace sulphur
     void SubMesh::Read(BinaryReader& binary_reader)
     {
       vertex_config = binary_reader.Read<VertexConfig>();
-      vertices_base = binary_reader.ReadVector<VertexBase>();
-      vertices_color = binary_reader.ReadVector<VertexColor>();
-      vertices_textured = binary_reader.ReadVector<VertexTextured>();
-      vertices_bones = binary_reader.ReadVector<VertexBones>();
+      vertex_encoding = binary_reader.Read<VertexEncoding>();
+
+      if (vertex_encoding == VertexEncoding::kQuantized)
+      {
+        quantized_base = binary_reader.ReadVector<VertexBaseQuantized>();
+        quantized_color = binary_reader.ReadVector<VertexColorQuantized>();
+        quantized_textured = binary_reader.ReadVector<VertexTexturedQuantized>();
+        quantized_bones = binary_reader.ReadVector<VertexBonesQuantized>();
+      }
+      else
+      {
+        vertices_base = binary_reader.ReadVector<VertexBase>();
+        vertices_color = binary_reader.ReadVector<VertexColor>();
+        vertices_textured = binary_reader.ReadVector<VertexTextured>();
+        vertices_bones = binary_reader.ReadVector<VertexBones>();
+      }
+
       indices = binary_reader.ReadVector<uint32_t>();
       primitive_type = binary_reader.Read<PrimitiveType>();
       bounding_box = binary_reader.Read<AABB>();
@@ -34,9 +229,61 @@ namespace sulphur
       root_transform = binary_reader.Read<glm::mat4>();
     }
 
+    //--------------------------------------------------------------------------------
+    void SubMesh::Decode()
+    {
+      vertices_base.resize(quantized_base.size());
+      for (size_t i = 0; i < quantized_base.size(); ++i)
+      {
+        vertices_base[i] = foundation::Decode(quantized_base[i], bounding_box);
+      }
+
+      vertices_color.resize(quantized_color.size());
+      for (size_t i = 0; i < quantized_color.size(); ++i)
+      {
+        vertices_color[i] = foundation::Decode(quantized_color[i]);
+      }
+
+      vertices_textured.resize(quantized_textured.size());
+      for (size_t i = 0; i < quantized_textured.size(); ++i)
+      {
+        vertices_textured[i] = foundation::Decode(quantized_textured[i]);
+      }
+
+      vertices_bones.resize(quantized_bones.size());
+      for (size_t i = 0; i < quantized_bones.size(); ++i)
+      {
+        vertices_bones[i] = foundation::Decode(quantized_bones[i]);
+      }
+
+      quantized_base.clear();
+      quantized_color.clear();
+      quantized_textured.clear();
+      quantized_bones.clear();
+      vertex_encoding = VertexEncoding::kFloat;
+    }
+
+    //--------------------------------------------------------------------------------
+    bool SubMesh::CanQuantize() const
+    {
+      for (size_t i = 0; i < vertices_bones.size(); ++i)
+      {
+        for (int j = 0; j < 4; ++j)
+        {
+          if (vertices_bones[i].bone_indices[j] > UINT8_MAX)
+          {
+            return false;
+          }
+        }
+      }
+
+      return true;
+    }
+
     //--------------------------------------------------------------------------------
     void MeshData::Write(BinaryWriter& binary_writer) const
     {
+      WritePackageHeader(binary_writer, kPackageMagic, kPackageVersion);
       binary_writer.Write(sub_meshes);
       binary_writer.Write(bounding_box);
       binary_writer.Write(bounding_sphere);
@@ -45,6 +292,12 @@ namespace sulphur
     //--------------------------------------------------------------------------------
     void MeshData::Read(BinaryReader& binary_reader)
     {
+      if (ReadPackageHeader(binary_reader, kPackageMagic, kPackageVersion) == false)
+      {
+        sub_meshes.clear();
+        return;
+      }
+
       sub_meshes = binary_reader.ReadVector<SubMesh>();
       bounding_box = binary_reader.Read<AABB>();
       bounding_sphere = binary_reader.Read<Sphere>();
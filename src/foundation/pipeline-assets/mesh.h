@@ -83,6 +83,87 @@ namespace sulphur
       kAll = 0xFF //!< Base vertex data with color, texture and bone data.
     };
 
+    /**
+     * @brief Enum with the possible encodings of the vertex streams in a packaged sub-mesh.
+     */
+    enum struct VertexEncoding : uint8_t
+    {
+      kFloat,     //!< Full precision 32-bit floating point vertex data.
+      kQuantized  //!< Quantized vertex data. See sulphur::foundation::VertexBaseQuantized.
+    };
+
+    /**
+    * @struct sulphur::foundation::VertexBaseQuantized
+    * @brief Quantized base data for a single vertex.
+    * @remark The position is stored as 16-bit unsigned normalized coordinates 
+    * relative to the bounding box of the sub-mesh. The normal is octahedral encoded 
+    * into two 16-bit signed normalized values.
+    */
+    struct VertexBaseQuantized
+    {
+      uint16_t position[3]; //!< The quantized position of the vertex.
+      uint16_t normal[2];   //!< The octahedral encoded normal vector of the vertex.
+    };
+
+    /**
+    * @struct sulphur::foundation::VertexTexturedQuantized
+    * @brief Quantized texture data for a single vertex.
+    * @remark The texture coordinate is stored as half floats. The tangent is 
+    * octahedral encoded into two 16-bit signed normalized values.
+    */
+    struct VertexTexturedQuantized
+    {
+      uint16_t uv[2];       //!< The half float texture coordinate of the vertex.
+      uint16_t tangent[2];  //!< The octahedral encoded tangent vector of the vertex.
+    };
+
+    /**
+    * @struct sulphur::foundation::VertexColorQuantized
+    * @brief Quantized color data for a single vertex, stored as RGBA8.
+    */
+    struct VertexColorQuantized
+    {
+      uint8_t color[4]; //!< The 8-bit unsigned normalized color of the vertex.
+    };
+
+    /**
+    * @struct sulphur::foundation::VertexBonesQuantized
+    * @brief Quantized bone data for a single vertex.
+    * @remark The weights are stored as 8-bit unsigned normalized values that always
+    * sum up to 255.
+    */
+    struct VertexBonesQuantized
+    {
+      uint8_t bone_weights[4];  //!< The 8-bit unsigned normalized bone weights of the vertex.
+      uint8_t bone_indices[4];  //!< The bone indices of the vertex.
+    };
+
+    /**
+     * @brief Decodes quantized base vertex data.
+     * @param[in] vertex (const sulphur::foundation::VertexBaseQuantized&) The quantized vertex data.
+     * @param[in] bounding_box (const sulphur::foundation::AABB&) The bounding box of the sub-mesh the vertex is in.
+     * @return (sulphur::foundation::VertexBase) The decoded vertex data.
+     */
+    VertexBase Decode(const VertexBaseQuantized& vertex, const AABB& bounding_box);
+    /**
+     * @brief Decodes quantized texture vertex data.
+     * @param[in] vertex (const sulphur::foundation::VertexTexturedQuantized&) The quantized vertex data.
+     * @return (sulphur::foundation::VertexTextured) The decoded vertex data.
+     */
+    VertexTextured Decode(const VertexTexturedQuantized& vertex);
+    /**
+     * @brief Decodes quantized color vertex data.
+     * @param[in] vertex (const sulphur::foundation::VertexColorQuantized&) The quantized vertex data.
+     * @return (sulphur::foundation::VertexColor) The decoded vertex data.
+     */
+    VertexColor Decode(const VertexColorQuantized& vertex);
+    /**
+     * @brief Decodes quantized bone vertex data.
+     * @param[in] vertex (const sulphur::foundation::VertexBonesQuantized&) The quantized vertex data.
+     * @return (sulphur::foundation::VertexBones) The decoded vertex data.
+     */
+    VertexBones Decode(const VertexBonesQuantized& vertex);
+
     /**
      * @brief Or assignement operator for sulphur::foundation::VertexConfig.
      * @param[in|out] c1 (sulphur::foundation::VertexConfig&) Left operand.
@@ -110,11 +191,31 @@ namespace sulphur
       */
       void Read(BinaryReader& binary_reader) override;
 
+      /**
+       * @brief Checks if the vertex data of this sub-mesh can be stored using 
+       * sulphur::foundation::VertexEncoding::kQuantized without losing bone indices.
+       * @return (bool) True if all bone indices fit in 8 bits.
+       */
+      bool CanQuantize() const;
+
+      /**
+       * @brief Decodes the quantized vertex data into the full precision vertex data.
+       * @remark A quantized sub-mesh that is read from a package keeps its quantized 
+       * vertex data, so it can be decoded straight into its final buffers. Call this 
+       * when the full precision vertex data of the sub-mesh itself is needed.
+       */
+      void Decode();
+
       VertexConfig vertex_config;               //!< The vertex data configuration.
+      VertexEncoding vertex_encoding = VertexEncoding::kFloat; //!< The encoding to use for the vertex data when writing the sub-mesh to a package. After reading, the encoding of the vertex data that was read.
       Vector<VertexBase> vertices_base;         //!< The base vertex data.
       Vector<VertexColor> vertices_color;       //!< The color vertex data.
       Vector<VertexTextured> vertices_textured; //!< The texture vertex data.
       Vector<VertexBones> vertices_bones;       //!< The bone vertex data.
+      Vector<VertexBaseQuantized> quantized_base;         //!< The quantized base vertex data of a sub-mesh that was read from a package.
+      Vector<VertexColorQuantized> quantized_color;       //!< The quantized color vertex data of a sub-mesh that was read from a package.
+      Vector<VertexTexturedQuantized> quantized_textured; //!< The quantized texture vertex data of a sub-mesh that was read from a package.
+      Vector<VertexBonesQuantized> quantized_bones;       //!< The quantized bone vertex data of a sub-mesh that was read from a package.
       Vector<uint32_t> indices;                 //!< The index data.
       PrimitiveType primitive_type;             //!< The primitive type stored in the vertex data.
       AABB bounding_box;                        //!< The bounding box of the sub-mesh.
@@ -139,7 +240,10 @@ namespace sulphur
       */
       void Read(BinaryReader& binary_reader) override;
 
-      Vector<SubMesh> sub_meshes; //!< List of sub-meshes.   
+      static constexpr uint32_t kPackageMagic = MakePackageMagic('P', 'S', 'M', 'S'); //!< Identifies a packaged mesh.
+      static constexpr uint32_t kPackageVersion = 2; //!< The layout version of packaged meshes. Version 1 had no header and no vertex encoding.
+
+      Vector<SubMesh> sub_meshes; //!< List of sub-meshes. Empty if the package has another layout version.   
       AABB bounding_box; //!< The bounding box of the mesh.
       Sphere bounding_sphere; //!< The bounding sphere of the mesh.
     };
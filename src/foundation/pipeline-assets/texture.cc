@@ -7,7 +7,9 @@ namespace sulphur
     //--------------------------------------------------------------------------------
     void TextureData::Write(BinaryWriter& binary_writer) const
     {
+      WritePackageHeader(binary_writer, kPackageMagic, kPackageVersion);
       binary_writer.Write(pixel_data);
+      binary_writer.Write(mip_offsets);
       binary_writer.Write(width);
       binary_writer.Write(height);
       binary_writer.Write(depth);
@@ -15,12 +17,21 @@ namespace sulphur
       binary_writer.Write(type);
       binary_writer.Write(format);
       binary_writer.Write(compression);
+      binary_writer.Write(srgb);
     }
 
     //--------------------------------------------------------------------------------
     void TextureData::Read(BinaryReader& binary_reader)
     {
+      if (ReadPackageHeader(binary_reader, kPackageMagic, kPackageVersion) == false)
+      {
+        pixel_data.clear();
+        mip_offsets.clear();
+        return;
+      }
+
       pixel_data = binary_reader.ReadVector<byte>();
+      mip_offsets = binary_reader.ReadVector<uint32_t>();
       width = binary_reader.ReadInt32();
       height = binary_reader.ReadInt32();
       depth = binary_reader.ReadInt32();
@@ -28,6 +39,7 @@ namespace sulphur
       type = binary_reader.Read<TextureType>();
       format = binary_reader.Read<TexelFormat>();
       compression = binary_reader.Read<TextureCompressionType>();
+      srgb = binary_reader.ReadBoolean();
     }
   }
 }
@@ -38,7 +38,7 @@ namespace sulphur
       kBC2 = 3,       //nvtt::Format_BC2,
       kBC3 = 4,       //nvtt::Format_BC3,
       kBC4 = 6,       //nvtt::Format_BC4,
-      kBC5 = 6,       //nvtt::Format_BC4,
+      kBC5 = 7,       //nvtt::Format_BC5,
       kBC6 = 10,      //nvtt::Format_BC6,
       kBC7 = 11,      //nvtt::Format_BC7,
       kBC3_RGBM = 12, //nvtt::Format_BC3_RGBM
@@ -69,6 +69,32 @@ namespace sulphur
       }
     }
 
+    /**
+     * @brief Returns the number of bytes needed to store a single 4x4 block of a 
+     * block compressed texture.
+     * @param[in] compression (sulphur::foundation::TextureCompressionType) The compression type.
+     * @return (size_t) The number of bytes needed to store a single block. 
+     * Zero if the texture is not block compressed.
+     */
+    inline size_t GetBytesPerBlock(TextureCompressionType compression)
+    {
+      switch (compression)
+      {
+      case TextureCompressionType::kBC1:
+      case TextureCompressionType::kBC4:
+        return 8;
+      case TextureCompressionType::kBC2:
+      case TextureCompressionType::kBC3:
+      case TextureCompressionType::kBC5:
+      case TextureCompressionType::kBC6:
+      case TextureCompressionType::kBC7:
+      case TextureCompressionType::kBC3_RGBM:
+        return 16;
+      default:
+        return 0;
+      }
+    }
+
     /**
      * @class sulphur::foundation::TextureData : sulphur::foundation::IBinarySerializable
      * @brief Describes the pixel data of a texture asset.
@@ -86,7 +112,11 @@ namespace sulphur
       */
       void Read(BinaryReader& binary_reader) override;
 
-      Vector<byte> pixel_data;  //!< The pixel data
+      static constexpr uint32_t kPackageMagic = MakePackageMagic('P', 'S', 'T', 'X'); //!< Identifies a packaged texture.
+      static constexpr uint32_t kPackageVersion = 2; //!< The layout version of packaged textures. Version 1 had no header, mip offsets or sRGB flag.
+
+      Vector<byte> pixel_data;  //!< The pixel data. Stores the full mip chain of every face or slice one after another. Empty if the package has another layout version.
+      Vector<uint32_t> mip_offsets; //!< The offset in bytes into pixel_data of every mip of every face or slice
       int width;  //!< The width of the texture
       int height; //!< The height of the texture
       int depth; //!< The depth of the image or the number of slices (array image)
@@ -94,6 +124,7 @@ namespace sulphur
       TextureType type; //!< The texture type
       TexelFormat format; //!< The texel format
       TextureCompressionType compression; //!< The compression type
+      bool srgb; //!< Is the pixel data stored in sRGB color space
     };
 
     /**
@@ -4,6 +4,7 @@
 #include "foundation/io/binary_reader.h"
 #include "foundation/io/binary_writer.h"
 #include "foundation/io/filesystem.h"
+#include "foundation/logging/logger.h"
 
 namespace sulphur
 {
@@ -41,6 +42,72 @@ namespace sulphur
       }
     };
 
+    /**
+     * @brief Creates the magic number that identifies a type of packaged asset.
+     * @param[in] a (char) The first character of the four-character code.
+     * @param[in] b (char) The second character of the four-character code.
+     * @param[in] c (char) The third character of the four-character code.
+     * @param[in] d (char) The fourth character of the four-character code.
+     * @return (uint32_t) The magic number.
+     */
+    constexpr uint32_t MakePackageMagic(char a, char b, char c, char d)
+    {
+      return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+        (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+        (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) |
+        (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+    }
+
+    /**
+     * @brief Writes the header in front of a packaged asset that identifies its layout.
+     * @param[in] binary_writer (sulphur::foundation::BinaryWriter&) The writer to write the header to.
+     * @param[in] magic (uint32_t) The magic number of the type of asset.
+     * @param[in] version (uint32_t) The version of the layout of the asset.
+     */
+    inline void WritePackageHeader(BinaryWriter& binary_writer, uint32_t magic, uint32_t version)
+    {
+      binary_writer.Write(magic);
+      binary_writer.Write(version);
+    }
+
+    /**
+     * @brief Reads the header in front of a packaged asset and checks if the layout is the expected one.
+     * @param[in] binary_reader (sulphur::foundation::BinaryReader&) The reader to read the header from.
+     * @param[in] magic (uint32_t) The magic number of the type of asset.
+     * @param[in] version (uint32_t) The version of the layout the asset is read with.
+     * @return (bool) True if the asset can be read, false if it was packaged 
+     * with another layout and needs to be rebuilt.
+     * @remark Packages from before the header was added start with a count instead 
+     * of the magic number, so they are rejected too.
+     */
+    inline bool ReadPackageHeader(BinaryReader& binary_reader, uint32_t magic, uint32_t version)
+    {
+      if (binary_reader.GetSize() - binary_reader.read_pos() < sizeof(uint32_t) * 2)
+      {
+        PS_LOG_WITH(foundation::LineAndFileLogger, Error,
+          "The package is too small to be read, rebuild it.");
+        return false;
+      }
+
+      if (binary_reader.ReadUnsigned32() != magic)
+      {
+        PS_LOG_WITH(foundation::LineAndFileLogger, Error,
+          "The package has no header, it was built by an older builder. Rebuild it.");
+        return false;
+      }
+
+      const uint32_t read_version = binary_reader.ReadUnsigned32();
+      if (read_version != version)
+      {
+        PS_LOG_WITH(foundation::LineAndFileLogger, Error,
+          "The package was built with layout version %u, expected version %u. Rebuild it.",
+          read_version, version);
+        return false;
+      }
+
+      return true;
+    }
+
     /**
      * @brief Generates an asset id from a name.
      * @param[in] name (const sulphur::foundation::AssetName&) The name of the asset.
@@ -0,0 +1,100 @@
+#include "foundation/win32/win32_mapped_file.h"
+#include <Windows.h>
+
+namespace sulphur 
+{
+  namespace foundation 
+  {
+    //-------------------------------------------------------------------------
+    Win32MappedFile::Win32MappedFile() :
+      file_(INVALID_HANDLE_VALUE),
+      mapping_(nullptr),
+      data_(nullptr),
+      size_(0)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    Win32MappedFile::~Win32MappedFile()
+    {
+      Close();
+    }
+
+    //-------------------------------------------------------------------------
+    bool Win32MappedFile::Open(const char* path)
+    {
+      Close();
+
+      // Share writing, so a recording can be opened while it is being written
+      file_ = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+      if (file_ == INVALID_HANDLE_VALUE)
+      {
+        return false;
+      }
+
+      LARGE_INTEGER size;
+      if (GetFileSizeEx(file_, &size) == FALSE || size.QuadPart == 0)
+      {
+        Close();
+        return false;
+      }
+
+      mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mapping_ == nullptr)
+      {
+        Close();
+        return false;
+      }
+
+      data_ = static_cast<const byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+      if (data_ == nullptr)
+      {
+        Close();
+        return false;
+      }
+
+      size_ = static_cast<size_t>(size.QuadPart);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void Win32MappedFile::Close()
+    {
+      if (data_ != nullptr)
+      {
+        UnmapViewOfFile(data_);
+        data_ = nullptr;
+      }
+      if (mapping_ != nullptr)
+      {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+      }
+      if (file_ != INVALID_HANDLE_VALUE)
+      {
+        CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+      }
+      size_ = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    bool Win32MappedFile::is_open() const
+    {
+      return data_ != nullptr;
+    }
+
+    //-------------------------------------------------------------------------
+    const byte* Win32MappedFile::data() const
+    {
+      return data_;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t Win32MappedFile::size() const
+    {
+      return size_;
+    }
+  }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "foundation/utils/type_definitions.h"
+
+namespace sulphur 
+{
+  namespace foundation 
+  {
+    /**
+    * @class sulphur::foundation::Win32MappedFile
+    * @brief Maps a file into memory for reading, so only the pages that are accessed are loaded from disk
+    * @remarks The file can still be written to by other handles, the mapping only covers the size the file had
+    *   when it was opened.
+    */
+    class Win32MappedFile
+    {
+    public:
+      /**
+      * @brief Default constructor, no file is mapped
+      */
+      Win32MappedFile();
+      /**
+      * @brief Unmaps the file
+      */
+      ~Win32MappedFile();
+
+      Win32MappedFile(const Win32MappedFile&) = delete;
+      Win32MappedFile& operator=(const Win32MappedFile&) = delete;
+
+      /**
+      * @brief Maps a file, unmapping the previously mapped file
+      * @param[in] path (const char*) The file to map
+      * @return (bool) False if the file doesn't exist, is empty or couldn't be mapped
+      */
+      bool Open(const char* path);
+      /**
+      * @brief Unmaps the file
+      */
+      void Close();
+
+      /**
+      * @return (bool) Is a file mapped?
+      */
+      bool is_open() const;
+      /**
+      * @return (const byte*) The contents of the file, nullptr if no file is mapped
+      */
+      const byte* data() const;
+      /**
+      * @return (size_t) The size of the file in bytes
+      */
+      size_t size() const;
+
+    private:
+      void* file_; //!< The handle of the file
+      void* mapping_; //!< The handle of the file mapping
+      const byte* data_; //!< The view of the mapping
+      size_t size_; //!< The size of the view in bytes
+    };
+  }
+}
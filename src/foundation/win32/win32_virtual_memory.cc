@@ -0,0 +1,50 @@
+#include "foundation/win32/win32_virtual_memory.h"
+#include <Windows.h>
+
+namespace sulphur
+{
+  namespace foundation
+  {
+    //-------------------------------------------------------------------------
+    void* Win32VirtualMemory::Reserve(size_t size)
+    {
+      return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+    }
+
+    //-------------------------------------------------------------------------
+    bool Win32VirtualMemory::Commit(void* address, size_t size)
+    {
+      return size == 0 || VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+    }
+
+    //-------------------------------------------------------------------------
+    void Win32VirtualMemory::Decommit(void* address, size_t size)
+    {
+      if (size != 0)
+      {
+        VirtualFree(address, size, MEM_DECOMMIT);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void Win32VirtualMemory::Release(void* address)
+    {
+      if (address != nullptr)
+      {
+        VirtualFree(address, 0, MEM_RELEASE);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    size_t Win32VirtualMemory::page_size()
+    {
+      static const size_t size = []()
+      {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+      }();
+      return size;
+    }
+  }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "foundation/utils/type_definitions.h"
+
+namespace sulphur
+{
+  namespace foundation
+  {
+    /**
+    * @class sulphur::foundation::Win32VirtualMemory
+    * @brief Reserves address space and commits memory to it page by page, so buffers can grow without moving
+    */
+    class Win32VirtualMemory
+    {
+    public:
+      /**
+      * @brief Reserves address space without committing any memory to it
+      * @param[in] size (size_t) The size of the range in bytes
+      * @return (void*) The start of the range, nullptr if it couldn't be reserved
+      */
+      static void* Reserve(size_t size);
+      /**
+      * @brief Commits the pages that overlap a part of a reserved range, the memory is zero-initialized
+      * @param[in] address (void*) The start of the part, within a range returned by Reserve
+      * @param[in] size (size_t) The size of the part in bytes
+      * @remarks Pages that are already committed keep their contents
+      * @return (bool) Could the memory be committed?
+      */
+      static bool Commit(void* address, size_t size);
+      /**
+      * @brief Releases the memory of the pages in a part of a reserved range, keeping the addresses reserved
+      * @param[in] address (void*) The start of the part, has to be aligned to the page size
+      * @param[in] size (size_t) The size of the part in bytes, has to be a multiple of the page size
+      */
+      static void Decommit(void* address, size_t size);
+      /**
+      * @brief Releases a reserved range and all memory that was committed to it
+      * @param[in] address (void*) The start of the range, as returned by Reserve
+      */
+      static void Release(void* address);
+      /**
+      * @return (size_t) The granularity of Commit and Decommit in bytes
+      */
+      static size_t page_size();
+    };
+  }
+}
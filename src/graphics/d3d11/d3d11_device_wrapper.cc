@@ -165,6 +165,39 @@ namespace sulphur
       case engine::TextureFormat::kR24G8_TYPELESS:
         dxgi_format = DXGI_FORMAT_R24G8_TYPELESS;
         break;
+      case engine::TextureFormat::kBC1_UNORM:
+        dxgi_format = DXGI_FORMAT_BC1_UNORM;
+        break;
+      case engine::TextureFormat::kBC1_UNORM_SRGB:
+        dxgi_format = DXGI_FORMAT_BC1_UNORM_SRGB;
+        break;
+      case engine::TextureFormat::kBC2_UNORM:
+        dxgi_format = DXGI_FORMAT_BC2_UNORM;
+        break;
+      case engine::TextureFormat::kBC2_UNORM_SRGB:
+        dxgi_format = DXGI_FORMAT_BC2_UNORM_SRGB;
+        break;
+      case engine::TextureFormat::kBC3_UNORM:
+        dxgi_format = DXGI_FORMAT_BC3_UNORM;
+        break;
+      case engine::TextureFormat::kBC3_UNORM_SRGB:
+        dxgi_format = DXGI_FORMAT_BC3_UNORM_SRGB;
+        break;
+      case engine::TextureFormat::kBC4_UNORM:
+        dxgi_format = DXGI_FORMAT_BC4_UNORM;
+        break;
+      case engine::TextureFormat::kBC5_UNORM:
+        dxgi_format = DXGI_FORMAT_BC5_UNORM;
+        break;
+      case engine::TextureFormat::kBC6H_UF16:
+        dxgi_format = DXGI_FORMAT_BC6H_UF16;
+        break;
+      case engine::TextureFormat::kBC7_UNORM:
+        dxgi_format = DXGI_FORMAT_BC7_UNORM;
+        break;
+      case engine::TextureFormat::kBC7_UNORM_SRGB:
+        dxgi_format = DXGI_FORMAT_BC7_UNORM_SRGB;
+        break;
       }
 
       // See if format is supported for auto-gen mipmaps (varies by feature level)
@@ -206,8 +239,12 @@ namespace sulphur
 
       D3D11_SUBRESOURCE_DATA initData;
       initData.pSysMem = data;
-      initData.SysMemPitch = desc.Width * GetSizeFromFormat(desc.Format);
-      initData.SysMemSlicePitch = initData.SysMemPitch * desc.Height;
+      // Block compressed formats are stored as rows of 4x4 blocks
+      const uint block_size = engine::GetBytesPerBlock(format);
+      initData.SysMemPitch = block_size != 0u ?
+        ((desc.Width + 3u) / 4u) * block_size : desc.Width * GetSizeFromFormat(desc.Format);
+      initData.SysMemSlicePitch = initData.SysMemPitch * 
+        (block_size != 0u ? (desc.Height + 3u) / 4u : desc.Height);
 
       hr = device_->CreateTexture2D(&desc, (autogen) ? nullptr : &initData, out_tex.GetAddressOf());
       if (SUCCEEDED(hr) && out_tex != 0)
@@ -232,6 +269,39 @@ namespace sulphur
         case engine::TextureFormat::kR24G8_TYPELESS:
           SRVDesc.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
           break;
+        case engine::TextureFormat::kBC1_UNORM:
+          SRVDesc.Format = DXGI_FORMAT_BC1_UNORM;
+          break;
+        case engine::TextureFormat::kBC1_UNORM_SRGB:
+          SRVDesc.Format = DXGI_FORMAT_BC1_UNORM_SRGB;
+          break;
+        case engine::TextureFormat::kBC2_UNORM:
+          SRVDesc.Format = DXGI_FORMAT_BC2_UNORM;
+          break;
+        case engine::TextureFormat::kBC2_UNORM_SRGB:
+          SRVDesc.Format = DXGI_FORMAT_BC2_UNORM_SRGB;
+          break;
+        case engine::TextureFormat::kBC3_UNORM:
+          SRVDesc.Format = DXGI_FORMAT_BC3_UNORM;
+          break;
+        case engine::TextureFormat::kBC3_UNORM_SRGB:
+          SRVDesc.Format = DXGI_FORMAT_BC3_UNORM_SRGB;
+          break;
+        case engine::TextureFormat::kBC4_UNORM:
+          SRVDesc.Format = DXGI_FORMAT_BC4_UNORM;
+          break;
+        case engine::TextureFormat::kBC5_UNORM:
+          SRVDesc.Format = DXGI_FORMAT_BC5_UNORM;
+          break;
+        case engine::TextureFormat::kBC6H_UF16:
+          SRVDesc.Format = DXGI_FORMAT_BC6H_UF16;
+          break;
+        case engine::TextureFormat::kBC7_UNORM:
+          SRVDesc.Format = DXGI_FORMAT_BC7_UNORM;
+          break;
+        case engine::TextureFormat::kBC7_UNORM_SRGB:
+          SRVDesc.Format = DXGI_FORMAT_BC7_UNORM_SRGB;
+          break;
         }
 
         SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
@@ -148,6 +148,11 @@ namespace sulphur
     {
     }
 
+    //--------------------------------------------------------------------------
+    void D3D11Renderer::SetBoneMatrices(const foundation::Vector<glm::mat4>&, const glm::mat4&)
+    {
+    }
+
     //--------------------------------------------------------------------------
     void D3D11Renderer::SetPipelineState(const PipelineState& pipeline_state)
     {
@@ -34,6 +34,7 @@ namespace sulphur
       // Processing draws
       void SetMesh(const engine::MeshHandle& mesh) override;
       void SetBoneMatrices(const foundation::Vector<glm::mat4>& bone_matrices)override;
+      void SetBoneMatrices(const foundation::Vector<glm::mat4>& bone_matrices, const glm::mat4& bone_space) override;
       void SetPipelineState(const PipelineState& pipeline_state) override;
       void SetMaterial(const engine::MaterialPass& pass) override;
       void SetComputePass(const engine::ComputePass& pass) override;
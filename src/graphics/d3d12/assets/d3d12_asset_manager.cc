@@ -167,6 +167,39 @@ namespace sulphur
       case sulphur::engine::TextureFormat::kR24G8_TYPELESS:
         desc.Format = DXGI_FORMAT_R24G8_TYPELESS;
         break;
+      case sulphur::engine::TextureFormat::kBC1_UNORM:
+        desc.Format = DXGI_FORMAT_BC1_UNORM;
+        break;
+      case sulphur::engine::TextureFormat::kBC1_UNORM_SRGB:
+        desc.Format = DXGI_FORMAT_BC1_UNORM_SRGB;
+        break;
+      case sulphur::engine::TextureFormat::kBC2_UNORM:
+        desc.Format = DXGI_FORMAT_BC2_UNORM;
+        break;
+      case sulphur::engine::TextureFormat::kBC2_UNORM_SRGB:
+        desc.Format = DXGI_FORMAT_BC2_UNORM_SRGB;
+        break;
+      case sulphur::engine::TextureFormat::kBC3_UNORM:
+        desc.Format = DXGI_FORMAT_BC3_UNORM;
+        break;
+      case sulphur::engine::TextureFormat::kBC3_UNORM_SRGB:
+        desc.Format = DXGI_FORMAT_BC3_UNORM_SRGB;
+        break;
+      case sulphur::engine::TextureFormat::kBC4_UNORM:
+        desc.Format = DXGI_FORMAT_BC4_UNORM;
+        break;
+      case sulphur::engine::TextureFormat::kBC5_UNORM:
+        desc.Format = DXGI_FORMAT_BC5_UNORM;
+        break;
+      case sulphur::engine::TextureFormat::kBC6H_UF16:
+        desc.Format = DXGI_FORMAT_BC6H_UF16;
+        break;
+      case sulphur::engine::TextureFormat::kBC7_UNORM:
+        desc.Format = DXGI_FORMAT_BC7_UNORM;
+        break;
+      case sulphur::engine::TextureFormat::kBC7_UNORM_SRGB:
+        desc.Format = DXGI_FORMAT_BC7_UNORM_SRGB;
+        break;
       default:
         desc.Format = DXGI_FORMAT_UNKNOWN;
         break;
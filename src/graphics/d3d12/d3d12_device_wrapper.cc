@@ -763,8 +763,12 @@ namespace sulphur
       {
         D3D12_SUBRESOURCE_DATA subres_data = {};
         subres_data.pData = bytes;
-        subres_data.RowPitch = desc.Width * GetSizeFromFormat(desc.Format);
-        subres_data.SlicePitch = subres_data.RowPitch * desc.Height;
+        // Block compressed formats are stored as rows of 4x4 blocks
+        const size_t block_size = GetBytesPerBlock(desc.Format);
+        subres_data.RowPitch = block_size != 0 ?
+          ((desc.Width + 3) / 4) * block_size : desc.Width * GetSizeFromFormat(desc.Format);
+        subres_data.SlicePitch = subres_data.RowPitch * 
+          (block_size != 0 ? (desc.Height + 3) / 4 : desc.Height);
 
         UpdateSubresources(
           command_list_,
@@ -915,6 +919,30 @@ namespace sulphur
       }
     }
 
+    //------------------------------------------------------------------------------------------------------
+    size_t D3D12Device::GetBytesPerBlock(DXGI_FORMAT format) const
+    {
+      switch (format)
+      {
+      case DXGI_FORMAT_BC1_UNORM:
+      case DXGI_FORMAT_BC1_UNORM_SRGB:
+      case DXGI_FORMAT_BC4_UNORM:
+        return 8;
+
+      case DXGI_FORMAT_BC2_UNORM:
+      case DXGI_FORMAT_BC2_UNORM_SRGB:
+      case DXGI_FORMAT_BC3_UNORM:
+      case DXGI_FORMAT_BC3_UNORM_SRGB:
+      case DXGI_FORMAT_BC5_UNORM:
+      case DXGI_FORMAT_BC6H_UF16:
+      case DXGI_FORMAT_BC7_UNORM:
+      case DXGI_FORMAT_BC7_UNORM_SRGB:
+        return 16;
+
+      default: return 0;
+      }
+    }
+
     //------------------------------------------------------------------------------------------------------
     D3D12Device::D3D12Device() :
       persistent_descriptor_heap_(*this),
@@ -376,6 +376,13 @@ namespace sulphur
       */
       size_t GetSizeFromFormat(DXGI_FORMAT format) const;
 
+      /**
+      * @brief Retrieves the size of a 4x4 block based on a block compressed texture format
+      * @param[in] format (DXGI_FORMAT) The format to retrieve a size from
+      * @return (size_t) The size in bytes, 0 if the format isn't block compressed
+      */
+      size_t GetBytesPerBlock(DXGI_FORMAT format) const;
+
       D3D12PersistentDescriptorHeap persistent_descriptor_heap_; //!< Persistent descriptor heap. Stores all descriptors currently loaded in GPU memory. Not sorted.
 
       D3D12MeshAssetManager mesh_asset_manager_; //!< The mesh asset manager. Can find a mesh object by its GPU handle.
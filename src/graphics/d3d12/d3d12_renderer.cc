@@ -24,6 +24,7 @@
 #include <foundation/utils/timer.h>
 #include <foundation/containers/vector.h>
 #include <foundation/logging/logger.h>
+#include <foundation/math/transform_kernels.h>
 
 #include <experimental/filesystem>
 #include <d3dcompiler.h>
@@ -994,6 +995,20 @@ namespace sulphur
       );
     }
 
+    //------------------------------------------------------------------------------------------------------
+    void D3D12Renderer::SetBoneMatrices(const foundation::Vector<glm::mat4>& bone_matrices, const glm::mat4& bone_space)
+    {
+      // The shared matrices are placed while they are copied into the scene buffer anyway
+      foundation::MultiplyAffine(bone_space, bone_matrices.data(), g_scene_buffer.bone_matrices, bone_matrices.size());
+
+      size_t offset;
+      constant_buffer_heap_.Write(&g_scene_buffer, sizeof(g_scene_buffer), offset);
+      direct_command_list_->SetGraphicsRootConstantBufferView(
+        0,
+        constant_buffer_heap_.GetGPUVirtualAddress() + offset
+      );
+    }
+
     //------------------------------------------------------------------------------------------------------
     void D3D12Renderer::SetPipelineState(const PipelineState& pipeline_state)
     {
@@ -95,6 +95,11 @@ namespace sulphur
       */
       void SetBoneMatrices(const foundation::Vector<glm::mat4>& bone_matrices) override;
 
+      /**
+      * @see sulphur::engine::IRenderer::SetBoneMatrices
+      */
+      void SetBoneMatrices(const foundation::Vector<glm::mat4>& bone_matrices, const glm::mat4& bone_space) override;
+
       /**
       * @see sulphur::engine::IRenderer::SetPipelineState
       */
@@ -0,0 +1,78 @@
+#include "test/test.h"
+
+#include <engine/systems/components/skinned_mesh_render_system.h>
+#include <engine/core/entity_system.h>
+#include <foundation/containers/vector.h>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kEntityCount = 64; //!< The components that are updated at their LOD update interval
+  const unsigned int kInterval = 4; //!< The LOD update interval of every component
+  const unsigned int kFrameCount = 100; //!< The frames that are simulated
+
+  //--------------------------------------------------------------------------
+  engine::Entity CreateEntity(size_t index, size_t generation)
+  {
+    engine::Entity entity;
+    entity.handle = index | generation << engine::Entity::kIndexBits;
+    return entity;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(LodUpdatesAreSpreadOverTheInterval)
+{
+  for (unsigned int frame = 0; frame < kFrameCount; ++frame)
+  {
+    size_t updated = 0;
+    for (size_t i = 0; i < kEntityCount; ++i)
+    {
+      updated += engine::SkinnedMeshRenderSystem::IsLodUpdateFrame(frame, CreateEntity(i, i % 3), kInterval) ? 1 : 0;
+    }
+    PS_CHECK(updated == kEntityCount / kInterval);
+  }
+
+  // An interval of 1 updates every frame
+  for (unsigned int frame = 0; frame < kFrameCount; ++frame)
+  {
+    PS_CHECK(engine::SkinnedMeshRenderSystem::IsLodUpdateFrame(frame, CreateEntity(frame, 0), 1) == true);
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(LodUpdatesFollowTheEntity)
+{
+  // The components in the order of the system data, removing one moves the others down
+  foundation::Vector<engine::Entity> components;
+  foundation::Vector<unsigned int> last_update(kEntityCount, 0);
+  foundation::Vector<bool> updated_before(kEntityCount, false);
+  for (size_t i = 0; i < kEntityCount; ++i)
+  {
+    components.push_back(CreateEntity(i, 1));
+  }
+
+  for (unsigned int frame = 0; frame < kFrameCount; ++frame)
+  {
+    if (frame % 5 == 0 && components.size() > 1)
+    {
+      components.erase(components.begin() + frame % components.size());
+    }
+
+    for (const engine::Entity& entity : components)
+    {
+      if (engine::SkinnedMeshRenderSystem::IsLodUpdateFrame(frame, entity, kInterval) == false)
+      {
+        continue;
+      }
+
+      // Every component keeps updating exactly once per interval
+      const size_t index = entity.GetIndex();
+      PS_CHECK(updated_before[index] == false || frame - last_update[index] == kInterval);
+      PS_CHECK(updated_before[index] == true || frame < kInterval);
+      updated_before[index] = true;
+      last_update[index] = frame;
+    }
+  }
+}
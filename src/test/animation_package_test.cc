@@ -0,0 +1,194 @@
+#include "test/test.h"
+
+#include <foundation/pipeline-assets/animation.h>
+#include <foundation/io/binary_reader.h>
+#include <foundation/io/binary_writer.h>
+#include <foundation/containers/vector.h>
+
+#include <cstdlib>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kKeyCount = 32; //!< The keys per track
+  const float kRotationError = 0.0005f; //!< The largest angle in radians between a quaternion and its quantized version, a tenth of the default pipeline tolerance
+
+  //--------------------------------------------------------------------------
+  float Random(float min, float max)
+  {
+    return min + (max - min) * static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+  }
+
+  //--------------------------------------------------------------------------
+  glm::quat RandomRotation()
+  {
+    return glm::normalize(glm::quat(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f)));
+  }
+
+  //--------------------------------------------------------------------------
+  float Angle(const glm::quat& a, const glm::quat& b)
+  {
+    // From the distance between the quaternions, as the arc cosine of a dot product close to one is too coarse
+    const float sign = glm::dot(a, b) < 0.0f ? -1.0f : 1.0f;
+    const glm::vec4 difference = glm::vec4(a.x, a.y, a.z, a.w) - glm::vec4(b.x, b.y, b.z, b.w) * sign;
+    return 4.0f * glm::asin(glm::min(1.0f, glm::length(difference) * 0.5f));
+  }
+
+  //--------------------------------------------------------------------------
+  foundation::AnimationData CreateAnimation()
+  {
+    srand(1);
+
+    foundation::AnimationData animation;
+    animation.duration = static_cast<float>(kKeyCount - 1);
+    animation.ticks_per_second = 30.0f;
+
+    // A compressed channel with a keyframed, a uniform and a constant track
+    foundation::AnimationChannel compressed;
+    compressed.bone_name = "compressed";
+    compressed.compressed = true;
+    compressed.position_track.format = foundation::AnimationTrackFormat::kKeyframes;
+    compressed.rotation_track.format = foundation::AnimationTrackFormat::kUniform;
+    compressed.rotation_track.start_time = 0.0f;
+    compressed.rotation_track.sample_interval = 1.0f;
+    compressed.scale_track.format = foundation::AnimationTrackFormat::kConstant;
+    compressed.scale_track.values.push_back(glm::vec3(2.0f));
+
+    float time = 0.0f;
+    for (size_t i = 0; i < kKeyCount; ++i)
+    {
+      compressed.position_track.times.push_back(time);
+      compressed.position_track.values.push_back(glm::vec3(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f)));
+      compressed.rotation_track.values.push_back(foundation::QuantizedQuaternion::Encode(RandomRotation()));
+      time += Random(0.5f, 1.5f);
+    }
+    animation.channels.push_back(compressed);
+
+    foundation::AnimationChannel raw;
+    raw.bone_name = "raw";
+    for (size_t i = 0; i < kKeyCount; ++i)
+    {
+      const float key_time = static_cast<float>(i);
+      raw.position_keys.push_back({ key_time, glm::vec3(key_time, 0.0f, 1.0f) });
+      raw.rotation_keys.push_back({ key_time, RandomRotation() });
+      raw.scale_keys.push_back({ key_time, glm::vec3(1.0f) });
+    }
+    animation.channels.push_back(raw);
+
+    return animation;
+  }
+
+  //--------------------------------------------------------------------------
+  foundation::AnimationData ReadBack(const foundation::BinaryWriter& writer)
+  {
+    foundation::Vector<unsigned char> data = writer.get_data();
+    foundation::BinaryReader reader(data.data(), static_cast<int>(data.size()));
+    return reader.Read<foundation::AnimationData>();
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(QuantizedQuaternionErrorBound)
+{
+  srand(2);
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    const glm::quat rotation = RandomRotation();
+    PS_CHECK(Angle(foundation::QuantizedQuaternion::Encode(rotation).Decode(), rotation) < kRotationError);
+  }
+
+  // The largest component is dropped, so every axis has to survive being the dropped one
+  const glm::quat axes[] = {
+    glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::quat(0.0f, 1.0f, 0.0f, 0.0f),
+    glm::quat(0.0f, 0.0f, 1.0f, 0.0f), glm::quat(0.0f, 0.0f, 0.0f, -1.0f) };
+  for (const glm::quat& rotation : axes)
+  {
+    PS_CHECK(Angle(foundation::QuantizedQuaternion::Encode(rotation).Decode(), rotation) < kRotationError);
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(AnimationTrackEvaluation)
+{
+  const foundation::AnimationData animation = CreateAnimation();
+  const foundation::AnimationChannel& channel = animation.channels[0];
+  const foundation::AnimationVectorTrack& positions = channel.position_track;
+  const foundation::AnimationRotationTrack& rotations = channel.rotation_track;
+
+  // Keys are hit exactly and the ends are clamped
+  for (size_t i = 0; i < kKeyCount; ++i)
+  {
+    PS_CHECK(positions.Evaluate(positions.times[i], glm::vec3(0.0f)) == positions.values[i]);
+    PS_CHECK(Angle(rotations.Evaluate(static_cast<float>(i)), rotations.values[i].Decode()) < 1e-5f);
+  }
+  PS_CHECK(positions.Evaluate(-1.0f, glm::vec3(0.0f)) == positions.values.front());
+  PS_CHECK(positions.Evaluate(1000.0f, glm::vec3(0.0f)) == positions.values.back());
+  PS_CHECK(channel.scale_track.Evaluate(5.0f, glm::vec3(0.0f)) == glm::vec3(2.0f));
+  PS_CHECK(foundation::AnimationVectorTrack().Evaluate(5.0f, glm::vec3(3.0f)) == glm::vec3(3.0f));
+
+  // Halfway between keys is halfway between the values
+  const float time = (positions.times[3] + positions.times[4]) * 0.5f;
+  const glm::vec3 expected = (positions.values[3] + positions.values[4]) * 0.5f;
+  PS_CHECK(glm::all(glm::lessThan(glm::abs(positions.Evaluate(time, glm::vec3(0.0f)) - expected), glm::vec3(1e-5f))));
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(AnimationPackageRoundTrip)
+{
+  const foundation::AnimationData animation = CreateAnimation();
+
+  foundation::BinaryWriter writer;
+  writer.Write(animation);
+  const foundation::AnimationData read = ReadBack(writer);
+
+  PS_CHECK(read.duration == animation.duration);
+  PS_CHECK(read.ticks_per_second == animation.ticks_per_second);
+  PS_CHECK(read.channels.size() == 2);
+
+  const foundation::AnimationChannel& compressed = read.channels[0];
+  PS_CHECK(compressed.bone_name == "compressed");
+  PS_CHECK(compressed.compressed == true);
+  PS_CHECK(compressed.position_keys.empty() == true);
+  PS_CHECK(compressed.rotation_track.format == foundation::AnimationTrackFormat::kUniform);
+  PS_CHECK(compressed.scale_track.format == foundation::AnimationTrackFormat::kConstant);
+
+  // The compressed tracks sample to the same values after the round trip
+  for (float time = -1.0f; time < animation.duration + 1.0f; time += 0.25f)
+  {
+    const foundation::AnimationChannel& original = animation.channels[0];
+    PS_CHECK(compressed.position_track.Evaluate(time, glm::vec3(0.0f)) == original.position_track.Evaluate(time, glm::vec3(0.0f)));
+    PS_CHECK(compressed.rotation_track.Evaluate(time) == original.rotation_track.Evaluate(time));
+    PS_CHECK(compressed.scale_track.Evaluate(time, glm::vec3(0.0f)) == original.scale_track.Evaluate(time, glm::vec3(0.0f)));
+  }
+
+  const foundation::AnimationChannel& raw = read.channels[1];
+  PS_CHECK(raw.bone_name == "raw");
+  PS_CHECK(raw.compressed == false);
+  PS_CHECK(raw.rotation_keys.size() == kKeyCount);
+  for (size_t i = 0; i < kKeyCount; ++i)
+  {
+    PS_CHECK(raw.position_keys[i].vector == animation.channels[1].position_keys[i].vector);
+    PS_CHECK(raw.rotation_keys[i].quaternion == animation.channels[1].rotation_keys[i].quaternion);
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(StaleAnimationPackageIsRejected)
+{
+  const foundation::AnimationData animation = CreateAnimation();
+
+  // Version 1 packages start with the duration
+  foundation::BinaryWriter unversioned;
+  unversioned.Write(animation.duration);
+  unversioned.Write(animation.ticks_per_second);
+  unversioned.Write(animation.channels);
+  PS_CHECK(ReadBack(unversioned).channels.empty() == true);
+
+  foundation::BinaryWriter old_version;
+  foundation::WritePackageHeader(old_version, foundation::AnimationData::kPackageMagic, 1);
+  old_version.Write(animation.duration);
+  old_version.Write(animation.ticks_per_second);
+  old_version.Write(animation.channels);
+  PS_CHECK(ReadBack(old_version).channels.empty() == true);
+}
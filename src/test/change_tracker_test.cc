@@ -0,0 +1,131 @@
+#include "test/test.h"
+
+#include <engine/systems/change_tracker.h>
+#include <engine/systems/components/transform_system.h>
+#include <engine/core/entity_system.h>
+#include <foundation/containers/vector.h>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kComponentCount = 200; //!< Spans several words of the bitsets
+  const size_t kTransformCount = 3; //!< A parent, its child and a transform that doesn't move
+
+  //--------------------------------------------------------------------------
+  foundation::Vector<size_t> Read(engine::ChangeTracker& tracker, size_t consumer)
+  {
+    foundation::Vector<size_t> changed;
+    tracker.ForEachChanged(consumer, [&changed](size_t index)
+    {
+      changed.push_back(index);
+    });
+    return changed;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(ChangesAreSeenOncePerConsumer)
+{
+  engine::ChangeTracker tracker;
+  const size_t first = tracker.AddConsumer();
+
+  tracker.MarkChanged(3);
+  const size_t second = tracker.AddConsumer();
+  tracker.MarkChanged(130);
+  tracker.MarkChanged(3);
+
+  // Changes made before a consumer registered aren't reported to it, the indices come in order
+  PS_CHECK(tracker.IsChanged(first, 3) == true);
+  PS_CHECK(tracker.IsChanged(second, 130) == true);
+  const foundation::Vector<size_t> first_changes = Read(tracker, first);
+  PS_CHECK(first_changes.size() == 2 && first_changes[0] == 3 && first_changes[1] == 130);
+  PS_CHECK(Read(tracker, first).empty() == true);
+
+  // Reading by one consumer doesn't consume the changes of the other
+  const foundation::Vector<size_t> second_changes = Read(tracker, second);
+  PS_CHECK(second_changes.size() == 2 && second_changes[0] == 3 && second_changes[1] == 130);
+  PS_CHECK(tracker.IsChanged(second, 3) == false);
+
+  // A reused identifier starts without changes
+  tracker.MarkChanged(7);
+  tracker.RemoveConsumer(second);
+  PS_CHECK(tracker.AddConsumer() == second);
+  PS_CHECK(Read(tracker, second).empty() == true);
+  PS_CHECK(Read(tracker, first).size() == 1);
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(ChangesCanBeCleared)
+{
+  engine::ChangeTracker tracker;
+  const size_t consumer = tracker.AddConsumer();
+  const size_t other = tracker.AddConsumer();
+
+  tracker.MarkAll(kComponentCount);
+  PS_CHECK(tracker.IsChanged(consumer, kComponentCount - 1) == true);
+  PS_CHECK(tracker.IsChanged(consumer, kComponentCount) == false);
+
+  // Clearing a single change, like a consumer does with the changes it made itself, keeps the others
+  tracker.ClearChanged(consumer, 5);
+  const foundation::Vector<size_t> changes = Read(tracker, consumer);
+  PS_CHECK(changes.size() == kComponentCount - 1);
+  PS_CHECK(changes[4] == 4 && changes[5] == 6);
+  PS_CHECK(tracker.IsChanged(other, 5) == true);
+
+  tracker.Clear(other);
+  PS_CHECK(Read(tracker, other).empty() == true);
+
+  // Changes made while reading are reported on the next read
+  tracker.MarkChanged(1);
+  size_t visited = 0;
+  tracker.ForEachChanged(consumer, [&tracker, &visited](size_t index)
+  {
+    tracker.MarkChanged(index + 1);
+    ++visited;
+  });
+  PS_CHECK(visited == 1);
+  const foundation::Vector<size_t> next = Read(tracker, consumer);
+  PS_CHECK(next.size() == 1 && next[0] == 2);
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(MovedTransformsAreTracked)
+{
+  engine::EntitySystem entity_system;
+  engine::TransformSystem transform_system;
+
+  foundation::Vector<engine::Entity> entities;
+  for (size_t i = 0; i < kTransformCount; ++i)
+  {
+    entities.push_back(entity_system.Create());
+  }
+
+  engine::HierarchyNode node;
+  node.parent = engine::HierarchyNode::kNoParent;
+  node.child_count = 0;
+  node.local_position = glm::vec3(0.0f);
+  node.local_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+  node.local_scale = glm::vec3(1.0f);
+
+  foundation::Vector<engine::TransformComponent> transforms(entities.size());
+  transform_system.CreateHierarchies(&node, 1, entities.data(), entities.size(), nullptr, transforms.data());
+  transform_system.SetParent(transforms[1], transforms[0]);
+
+  const size_t consumer = transform_system.changes().AddConsumer();
+
+  // Moving a parent reports its children too, the transforms that didn't move aren't visited
+  transform_system.SetLocalPosition(transforms[0], glm::vec3(1.0f, 2.0f, 3.0f));
+
+  foundation::Vector<engine::TransformComponent> changed;
+  transform_system.ForEachChanged(consumer, [&changed](engine::TransformComponent transform)
+  {
+    changed.push_back(transform);
+  });
+  PS_CHECK(changed.size() == 2);
+  PS_CHECK(changed[0].Handle() == transforms[0].Handle());
+  PS_CHECK(changed[1].Handle() == transforms[1].Handle());
+
+  transform_system.changes().RemoveConsumer(consumer);
+  entity_system.OnTerminate();
+}
@@ -0,0 +1,113 @@
+#include "test/test.h"
+
+#include <engine/core/entity_component.h>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kEntity = 3; //!< The entity the colliders are linked to
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(SecondColliderIsLinkedNextToTheFirst)
+{
+  const engine::ComponentHandleBase box(10);
+  const engine::ComponentHandleBase sphere(11);
+
+  engine::ComponentLinks colliders;
+  colliders.Resize(8);
+  colliders.Add(kEntity, box);
+  colliders.Add(kEntity, sphere);
+
+  PS_CHECK(colliders.Count(kEntity) == 2);
+  PS_CHECK(colliders.First(kEntity) == box);
+  PS_CHECK(colliders.Count(kEntity - 1) == 0);
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(RemovingTheFirstColliderKeepsTheSecond)
+{
+  const engine::ComponentHandleBase box(10);
+  const engine::ComponentHandleBase sphere(11);
+
+  engine::ComponentLinks colliders;
+  colliders.Add(kEntity, box);
+  colliders.Add(kEntity, sphere);
+
+  PS_CHECK(colliders.Remove(kEntity, box) == true);
+  PS_CHECK(colliders.Count(kEntity) == 1);
+  PS_CHECK(colliders.First(kEntity) == sphere);
+
+  PS_CHECK(colliders.Remove(kEntity, box) == false);
+  PS_CHECK(colliders.Remove(kEntity, sphere) == true);
+  PS_CHECK(colliders.Count(kEntity) == 0);
+  PS_CHECK(colliders.First(kEntity).IsValid() == false);
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(ClearingAnEntityReturnsEveryCollider)
+{
+  const engine::ComponentHandleBase box(10);
+  const engine::ComponentHandleBase sphere(11);
+  const engine::ComponentHandleBase capsule(12);
+
+  engine::ComponentLinks colliders;
+  colliders.Add(kEntity, box);
+  colliders.Add(kEntity, sphere);
+  colliders.Add(kEntity, capsule);
+  PS_CHECK(colliders.Remove(kEntity, sphere) == true);
+
+  foundation::Vector<engine::ComponentHandleBase> destroyed;
+  colliders.Clear(kEntity, destroyed);
+
+  PS_CHECK(destroyed.size() == 2);
+  PS_CHECK(destroyed.size() == 2 && destroyed[0] == box && destroyed[1] == capsule);
+  PS_CHECK(colliders.Count(kEntity) == 0);
+
+  // A reused entity slot starts without links
+  colliders.Add(kEntity, sphere);
+  PS_CHECK(colliders.Count(kEntity) == 1);
+  PS_CHECK(colliders.First(kEntity) == sphere);
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(StoredCollidersIncludeTheOverflow)
+{
+  const engine::ComponentHandleBase box(10);
+  const engine::ComponentHandleBase sphere(11);
+  const engine::ComponentHandleBase capsule(12);
+  const engine::ComponentHandleBase mesh(13);
+
+  // Linked to the later entity first, the links are still stored in entity order
+  engine::ComponentLinks colliders;
+  colliders.Add(kEntity + 2, mesh);
+  colliders.Add(kEntity + 2, box);
+  colliders.Add(kEntity, box);
+  colliders.Add(kEntity, sphere);
+  colliders.Add(kEntity, capsule);
+
+  PS_CHECK(colliders.overflow_count() == 3);
+  foundation::Vector<engine::ComponentLink> links(colliders.overflow_count());
+  colliders.StoreOverflow(links.data());
+
+  PS_CHECK(links[0].entity == kEntity && links[0].handle == sphere);
+  PS_CHECK(links[1].entity == kEntity && links[1].handle == capsule);
+  PS_CHECK(links[2].entity == kEntity + 2 && links[2].handle == box);
+
+  // Restoring the stored links next to the first components gives back every collider
+  engine::ComponentLinks restored;
+  restored.Add(kEntity, box);
+  restored.Add(kEntity + 2, mesh);
+  restored.Add(kEntity + 2, capsule);
+  restored.RestoreOverflow(links.data(), links.size());
+
+  foundation::Vector<engine::ComponentHandleBase> destroyed;
+  restored.Clear(kEntity, destroyed);
+  PS_CHECK(destroyed.size() == 3);
+  PS_CHECK(destroyed.size() == 3 && destroyed[0] == box && destroyed[1] == sphere && destroyed[2] == capsule);
+
+  destroyed.clear();
+  restored.Clear(kEntity + 2, destroyed);
+  PS_CHECK(destroyed.size() == 2 && destroyed[0] == mesh && destroyed[1] == box);
+}
@@ -0,0 +1,163 @@
+#include "test/test.h"
+
+#include <engine/core/entity_command_buffer.h>
+#include <engine/core/entity_system.h>
+#include <foundation/containers/vector.h>
+
+#include <thread>
+
+using namespace sulphur;
+
+namespace
+{
+  const uint32_t kKeyCount = 4; //!< The systems that record commands
+  const uint32_t kEntityCount = 8; //!< The entities every system creates
+
+  /**
+  * @struct <anonymous>::Modification
+  * @brief A deferred modification as it was applied during the playback
+  */
+  struct Modification
+  {
+    uint32_t key; //!< The key of the buffer that recorded the modification
+    uint32_t sort_key; //!< The sort key it was recorded with
+    size_t entity; //!< The handle of the entity it was applied to
+  };
+
+  //--------------------------------------------------------------------------
+  void Record(engine::EntitySystem& system, uint32_t key, foundation::Vector<Modification>& applied)
+  {
+    engine::EntityCommandBuffer& commands = system.Commands(key);
+    for (uint32_t i = 0; i < kEntityCount; ++i)
+    {
+      // Alternate the sort keys, so the commands of all systems are interleaved
+      const uint32_t sort_key = i % 2;
+      commands.set_sort_key(sort_key);
+      const engine::DeferredEntity entity = commands.Create();
+      commands.Modify(entity, [&applied, key, sort_key](engine::Entity& created)
+      {
+        applied.push_back({ key, sort_key, created.handle });
+      });
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  foundation::Vector<Modification> Playback(bool reverse)
+  {
+    engine::EntitySystem system;
+    foundation::Vector<Modification> applied;
+
+    // Every system records from its own thread, in a different order for every run
+    for (uint32_t i = 0; i < kKeyCount; ++i)
+    {
+      const uint32_t key = reverse == true ? kKeyCount - 1 - i : i;
+      std::thread thread([&system, &applied, key]()
+      {
+        Record(system, key, applied);
+      });
+      thread.join();
+    }
+
+    PS_CHECK(applied.empty() == true);
+    system.PlaybackCommands();
+    system.OnTerminate();
+    return applied;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(EntityCommandsPlayBackInKeyOrder)
+{
+  const foundation::Vector<Modification> forward = Playback(false);
+  const foundation::Vector<Modification> reverse = Playback(true);
+
+  // The same entities are created and modified in the same order, whichever thread asked for its buffer first
+  PS_CHECK(forward.size() == kKeyCount * kEntityCount);
+  PS_CHECK(reverse.size() == forward.size());
+  for (size_t i = 0; i < forward.size(); ++i)
+  {
+    PS_CHECK(forward[i].key == reverse[i].key);
+    PS_CHECK(forward[i].sort_key == reverse[i].sort_key);
+    PS_CHECK(forward[i].entity == reverse[i].entity);
+  }
+
+  // Ordered by sort key first and by the key of the buffer second
+  for (size_t i = 1; i < forward.size(); ++i)
+  {
+    const Modification& previous = forward[i - 1];
+    const Modification& current = forward[i];
+    PS_CHECK(previous.sort_key < current.sort_key ||
+      (previous.sort_key == current.sort_key && previous.key <= current.key));
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(EntityCommandsDestroyAfterCreate)
+{
+  engine::EntitySystem system;
+  engine::EntityCommandBuffer& commands = system.Commands(0);
+
+  // The placeholder is used with a lower sort key than its creation
+  engine::Entity created;
+  commands.set_sort_key(1);
+  const engine::DeferredEntity entity = commands.Create();
+  commands.set_sort_key(0);
+  commands.Modify(entity, [&created](engine::Entity& target)
+  {
+    created = target;
+  });
+  commands.Destroy(entity);
+  PS_CHECK(commands.size() == 3);
+
+  system.PlaybackCommands();
+  PS_CHECK(commands.size() == 0);
+  PS_CHECK(system.Alive(created) == true);
+
+  system.DestroyMarkedForDestruction();
+  PS_CHECK(system.Alive(created) == false);
+
+  // Commands that target an entity that was destroyed in the meantime are skipped
+  bool applied = false;
+  system.Commands(0).Modify(created, [&applied](engine::Entity&)
+  {
+    applied = true;
+  });
+  system.Commands(0).Destroy(created);
+  system.PlaybackCommands();
+  system.DestroyMarkedForDestruction();
+  PS_CHECK(applied == false);
+
+  system.OnTerminate();
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(EntityCommandsAreDeferredUntilPlayback)
+{
+  engine::EntitySystem system;
+  const engine::Entity existing = system.Create();
+
+  size_t applied = 0;
+  engine::EntityCommandBuffer& commands = system.Commands(7);
+  commands.Modify(existing, [&system, &applied](engine::Entity& entity)
+  {
+    ++applied;
+
+    // Commands recorded during the playback are kept for the next one
+    system.Commands(7).Modify(entity, [&applied](engine::Entity&)
+    {
+      applied += 10;
+    });
+  });
+  PS_CHECK(applied == 0);
+
+  system.PlaybackCommands();
+  PS_CHECK(applied == 1);
+  PS_CHECK(system.Commands(7).size() == 1);
+
+  system.PlaybackCommands();
+  PS_CHECK(applied == 11);
+  PS_CHECK(&system.Commands(7) == &commands);
+  PS_CHECK(&system.Commands(8) != &commands);
+
+  system.OnTerminate();
+}
@@ -0,0 +1,156 @@
+#include "test/test.h"
+
+#include <engine/rewinder/history_buffer.h>
+#include <engine/rewinder/snapshot_pool.h>
+
+#include <foundation/containers/vector.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace sulphur;
+
+namespace
+{
+  /**
+  * @struct <anonymous>::SystemState
+  * @brief The blocks of a system that change a little every frame, like the columns of a component system
+  */
+  struct SystemState
+  {
+    foundation::Vector<foundation::Vector<char>> blocks; //!< The data of every block
+  };
+
+  //--------------------------------------------------------------------------
+  SystemState CreateState(size_t block_count, size_t block_size)
+  {
+    SystemState state;
+    state.blocks.resize(block_count);
+    for (foundation::Vector<char>& block : state.blocks)
+    {
+      block.resize(block_size);
+      for (char& value : block)
+      {
+        value = static_cast<char>(rand());
+      }
+    }
+    return state;
+  }
+
+  //--------------------------------------------------------------------------
+  void Change(SystemState& state, size_t changes)
+  {
+    for (size_t i = 0; i < changes; ++i)
+    {
+      foundation::Vector<char>& block = state.blocks[rand() % state.blocks.size()];
+      block[rand() % block.size()] = static_cast<char>(rand());
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  void Store(const SystemState& state, engine::HistoryBuffer& history)
+  {
+    engine::FrameStorage& frame = history.Capture();
+    for (const foundation::Vector<char>& block : state.blocks)
+    {
+      void* data = engine::SnapshotPool::Instance().Allocate(block.size());
+      memcpy(data, block.data(), block.size());
+      frame.data.push_back({ data, block.size() });
+    }
+    history.Commit();
+  }
+
+  //--------------------------------------------------------------------------
+  bool Equal(const engine::FrameStorage& frame, const SystemState& state)
+  {
+    if (frame.data.size() != state.blocks.size())
+    {
+      return false;
+    }
+
+    for (size_t i = 0; i < state.blocks.size(); ++i)
+    {
+      const foundation::Vector<char>& block = state.blocks[i];
+      if (engine::SnapshotPool::SizeOf(frame.data[i].data) != block.size() ||
+        memcmp(frame.data[i].data, block.data(), block.size()) != 0)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(HistoryBufferDecodesEveryStoredFrame)
+{
+  srand(1);
+
+  engine::HistoryBuffer history;
+  history.set_capacity(37);
+  history.set_keyframe_interval(5);
+
+  SystemState state = CreateState(3, 3000);
+  foundation::Vector<SystemState> stored;
+  for (size_t frame = 0; frame < 200; ++frame)
+  {
+    Change(state, 20);
+    Store(state, history);
+    stored.push_back(state);
+
+    // Shrinking drops the oldest frames, the frames that are left have to stay decodable
+    if (frame == 120)
+    {
+      history.set_capacity(20);
+    }
+  }
+
+  const size_t first = stored.size() - history.size();
+  for (size_t i = 0; i < history.size(); ++i)
+  {
+    PS_CHECK(Equal(history.Decode(i), stored[first + i]));
+  }
+
+  // Out of order decoding starts at the keyframe of a frame
+  for (size_t i = 0; i < history.size(); ++i)
+  {
+    const size_t index = (i * 7) % history.size();
+    PS_CHECK(Equal(history.Decode(index), stored[first + index]));
+  }
+
+  history.Clear();
+}
+
+//--------------------------------------------------------------------------
+PS_BENCHMARK(HistoryBufferDeltaCapture)
+{
+  const size_t kBlockCount = 16;
+  const size_t kBlockSize = 16 * 1024;
+  const size_t kChangesPerFrame = 1024; // About 0.4% of the bytes
+  const size_t kFrames = 300;
+
+  const size_t intervals[] = { 1, engine::HistoryBuffer::kDefaultKeyframeInterval };
+  for (size_t interval : intervals)
+  {
+    srand(1);
+    SystemState state = CreateState(kBlockCount, kBlockSize);
+
+    engine::HistoryBuffer history;
+    history.set_capacity(kFrames);
+    history.set_keyframe_interval(interval);
+
+    char name[64];
+    snprintf(name, sizeof(name), "capture 256KB, keyframe every %zu frames", interval);
+    test::Measure(name, kFrames - 1, [&]()
+    {
+      Change(state, kChangesPerFrame);
+      Store(state, history);
+    });
+
+    printf("  %-48s %12.1f KB\n", "  compressed per frame",
+      static_cast<double>(history.compressed_bytes()) / static_cast<double>(history.size()) / 1024.0);
+
+    history.Clear();
+  }
+}
@@ -0,0 +1,190 @@
+#include "test/test.h"
+
+#include <engine/systems/components/skinned_mesh_render_system.h>
+#include <engine/core/entity_system.h>
+#include <engine/assets/animation.h>
+#include <foundation/containers/vector.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <cmath>
+#include <cstdlib>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kCharacterCount = 100; //!< The characters of the benchmark
+  const size_t kBoneCount = 60; //!< The animated bones per character
+  const size_t kKeyCount = 120; //!< The keys per track
+  const float kDuration = 120.0f; //!< The duration of the animation in ticks
+  const float kTicksPerFrame = 0.5f; //!< The ticks a character advances per frame, about two frames per key
+
+  /**
+  * @struct <anonymous>::Channel
+  * @brief The keyframed tracks of a bone
+  */
+  struct Channel
+  {
+    foundation::Vector<engine::Vector3Keyframe> positions; //!< The position keys
+    foundation::Vector<engine::QuaternionKeyframe> rotations; //!< The rotation keys
+    foundation::Vector<engine::Vector3Keyframe> scales; //!< The scale keys
+  };
+
+  //--------------------------------------------------------------------------
+  float Random(float min, float max)
+  {
+    return min + (max - min) * static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+  }
+
+  //--------------------------------------------------------------------------
+  foundation::Vector<Channel> CreateChannels(size_t count)
+  {
+    srand(1);
+
+    foundation::Vector<Channel> channels(count);
+    for (Channel& channel : channels)
+    {
+      // Keys are a tick apart on average, but not evenly spaced
+      float time = 0.0f;
+      for (size_t i = 0; i < kKeyCount; ++i)
+      {
+        channel.positions.push_back({ time, glm::vec3(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f)) });
+        channel.rotations.push_back({ time, glm::normalize(
+          glm::quat(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f))) });
+        channel.scales.push_back({ time, glm::vec3(Random(0.5f, 2.0f)) });
+        time += Random(0.5f, 1.5f) * (kDuration / kKeyCount);
+      }
+    }
+
+    return channels;
+  }
+
+  /**
+  * @brief Finds the key the way pose evaluation did before the cursors, scanning back from the last key
+  * @param[in] playback_time (float) The playback time in ticks
+  * @param[in] keyframes (const sulphur::foundation::Vector<sulphur::engine::Keyframe<T>>&) The keys
+  * @returns (unsigned int) The index of the key, UINT_MAX if no key comes before the playback time
+  */
+  template<typename T>
+  unsigned int ScanKeys(float playback_time, const foundation::Vector<engine::Keyframe<T>>& keyframes)
+  {
+    for (int i = static_cast<int>(keyframes.size()) - 1; i >= 0; i--)
+    {
+      if (keyframes[i].time < playback_time)
+      {
+        return static_cast<unsigned int>(i);
+      }
+    }
+    return UINT_MAX;
+  }
+
+  //--------------------------------------------------------------------------
+  glm::vec3 ScanKeyframes(float playback_time, const foundation::Vector<engine::Vector3Keyframe>& keyframes)
+  {
+    const unsigned int current = ScanKeys(playback_time, keyframes);
+    if (current == UINT_MAX)
+    {
+      return keyframes[0].value;
+    }
+
+    const unsigned int next = (current + 1) % static_cast<unsigned int>(keyframes.size());
+    const float factor = (playback_time - keyframes[current].time) / (keyframes[next].time - keyframes[current].time);
+    return keyframes[current].value + (keyframes[next].value - keyframes[current].value) * factor;
+  }
+
+  //--------------------------------------------------------------------------
+  glm::quat ScanKeyframes(float playback_time, const foundation::Vector<engine::QuaternionKeyframe>& keyframes)
+  {
+    const unsigned int current = ScanKeys(playback_time, keyframes);
+    if (current == UINT_MAX)
+    {
+      return keyframes[0].value;
+    }
+
+    const unsigned int next = (current + 1) % static_cast<unsigned int>(keyframes.size());
+    const float factor = (playback_time - keyframes[current].time) / (keyframes[next].time - keyframes[current].time);
+    return glm::slerp(keyframes[current].value, keyframes[next].value, factor);
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(KeyframeCursorsMatchLinearScan)
+{
+  const foundation::Vector<Channel> channels = CreateChannels(1);
+  const Channel& channel = channels[0];
+  engine::SkinnedMeshRenderSystem system;
+
+  // Play forward over a few loops, then seek back and forth
+  foundation::Vector<float> times;
+  for (float time = 0.0f; time < kDuration * 3.0f; time += kTicksPerFrame * 0.75f)
+  {
+    times.push_back(std::fmod(time, kDuration));
+  }
+  for (size_t i = 0; i < 200; ++i)
+  {
+    times.push_back(Random(-1.0f, kDuration + 1.0f));
+  }
+
+  engine::KeyframeCursor cursor;
+  for (float time : times)
+  {
+    PS_CHECK(system.ProcessKeyframes(time, channel.positions, cursor.position) == ScanKeyframes(time, channel.positions));
+    PS_CHECK(system.ProcessKeyframes(time, channel.rotations, cursor.rotation) == ScanKeyframes(time, channel.rotations));
+    PS_CHECK(system.ProcessKeyframes(time, channel.scales, cursor.scale) == ScanKeyframes(time, channel.scales));
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_BENCHMARK(KeyframeCursorEvaluation)
+{
+  const foundation::Vector<Channel> channels = CreateChannels(kBoneCount);
+  engine::SkinnedMeshRenderSystem system;
+  foundation::Vector<engine::KeyframeCursor> cursors(kCharacterCount * kBoneCount);
+  foundation::Vector<glm::vec3> positions(kBoneCount);
+  foundation::Vector<glm::quat> rotations(kBoneCount);
+  foundation::Vector<glm::vec3> scales(kBoneCount);
+  const size_t iterations = 60;
+
+  // Every character is at a different time of the animation, and every iteration is a frame
+  float time = 0.0f;
+  const auto character_time = [&time](size_t character)
+  {
+    return std::fmod(time + static_cast<float>(character) * 1.7f, kDuration);
+  };
+
+  test::Measure("100 characters x 60 bones, linear scan", iterations, [&]()
+  {
+    for (size_t character = 0; character < kCharacterCount; ++character)
+    {
+      const float playback_time = character_time(character);
+      for (size_t bone = 0; bone < kBoneCount; ++bone)
+      {
+        positions[bone] = ScanKeyframes(playback_time, channels[bone].positions);
+        rotations[bone] = ScanKeyframes(playback_time, channels[bone].rotations);
+        scales[bone] = ScanKeyframes(playback_time, channels[bone].scales);
+      }
+      test::DoNotOptimize(positions);
+    }
+    time += kTicksPerFrame;
+  });
+
+  time = 0.0f;
+  test::Measure("100 characters x 60 bones, cursors", iterations, [&]()
+  {
+    for (size_t character = 0; character < kCharacterCount; ++character)
+    {
+      const float playback_time = character_time(character);
+      engine::KeyframeCursor* character_cursors = cursors.data() + character * kBoneCount;
+      for (size_t bone = 0; bone < kBoneCount; ++bone)
+      {
+        engine::KeyframeCursor& cursor = character_cursors[bone];
+        positions[bone] = system.ProcessKeyframes(playback_time, channels[bone].positions, cursor.position);
+        rotations[bone] = system.ProcessKeyframes(playback_time, channels[bone].rotations, cursor.rotation);
+        scales[bone] = system.ProcessKeyframes(playback_time, channels[bone].scales, cursor.scale);
+      }
+      test::DoNotOptimize(positions);
+    }
+    time += kTicksPerFrame;
+  });
+}
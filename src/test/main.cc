@@ -0,0 +1,113 @@
+#include "test/test.h"
+
+#include <foundation/memory/memory.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace sulphur
+{
+  namespace test
+  {
+    namespace
+    {
+      /**
+      * @struct sulphur::test::<anonymous>::Entry
+      * @brief A registered test or benchmark
+      */
+      struct Entry
+      {
+        const char* name; //!< The name of the test
+        TestFunction function; //!< The function to run
+        bool benchmark; //!< Is it a benchmark?
+      };
+
+      const size_t kMaxEntries = 256; //!< The maximum amount of tests and benchmarks
+
+      // Registration happens during static initialization, so this can't use containers that allocate
+      Entry entries_[kMaxEntries]; //!< The registered tests and benchmarks
+      size_t entry_count_ = 0; //!< The amount of registered tests and benchmarks
+      size_t failures_ = 0; //!< The amount of failed checks of the running test
+    }
+
+    const void* volatile sink = nullptr;
+
+    //--------------------------------------------------------------------------
+    Registration::Registration(const char* name, TestFunction function, bool benchmark)
+    {
+      if (entry_count_ < kMaxEntries)
+      {
+        entries_[entry_count_++] = { name, function, benchmark };
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    void Fail(const char* file, int line, const char* expression)
+    {
+      printf("  %s(%i): check failed: %s\n", file, line, expression);
+      ++failures_;
+    }
+
+    //--------------------------------------------------------------------------
+    void Report(const char* name, size_t iterations, double seconds)
+    {
+      printf("  %-48s %12.3f us\n", name, seconds * 1000000.0 / static_cast<double>(iterations));
+    }
+  }
+}
+
+using namespace sulphur::test;
+
+//-----------------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  // Usage: sulphur-test [--bench] [name]
+  bool benchmarks = false;
+  const char* filter = nullptr;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (strcmp(argv[i], "--bench") == 0)
+    {
+      benchmarks = true;
+    }
+    else
+    {
+      filter = argv[i];
+    }
+  }
+
+  sulphur::foundation::Memory::Initialize(512ul * 1024ul * 1024ul);
+
+  size_t failed = 0;
+  size_t ran = 0;
+  for (size_t i = 0; i < entry_count_; ++i)
+  {
+    const Entry& entry = entries_[i];
+    if (entry.benchmark != benchmarks || (filter != nullptr && strstr(entry.name, filter) == nullptr))
+    {
+      continue;
+    }
+
+    printf("%s\n", entry.name);
+    failures_ = 0;
+    entry.function();
+    ++ran;
+
+    if (failures_ > 0)
+    {
+      ++failed;
+    }
+  }
+
+  if (benchmarks == true)
+  {
+    printf("%zu benchmarks ran\n", ran);
+  }
+  else
+  {
+    printf("%zu of %zu tests passed\n", ran - failed, ran);
+  }
+
+  sulphur::foundation::Memory::Shutdown();
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+#include "test/test.h"
+
+#include <foundation/pipeline-assets/mesh.h>
+#include <foundation/io/binary_reader.h>
+#include <foundation/io/binary_writer.h>
+#include <foundation/containers/vector.h>
+
+#include <glm/glm.hpp>
+
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kVertexCount = 1000; //!< The vertices of the test sub-mesh
+
+  //--------------------------------------------------------------------------
+  float Random(float min, float max)
+  {
+    return min + (max - min) * static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+  }
+
+  //--------------------------------------------------------------------------
+  glm::vec3 RandomDirection()
+  {
+    return glm::normalize(glm::vec3(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f)) +
+      glm::vec3(0.0f, 0.0f, 0.001f));
+  }
+
+  //--------------------------------------------------------------------------
+  foundation::SubMesh CreateSubMesh(foundation::VertexEncoding encoding, uint16_t max_bone_index)
+  {
+    srand(1);
+
+    foundation::SubMesh sub_mesh;
+    sub_mesh.vertex_config = foundation::VertexConfig::kAll;
+    sub_mesh.vertex_encoding = encoding;
+    sub_mesh.primitive_type = foundation::PrimitiveType::kTriangle;
+    sub_mesh.bounding_box.min = glm::vec3(FLT_MAX);
+    sub_mesh.bounding_box.max = glm::vec3(-FLT_MAX);
+    sub_mesh.root_transform = glm::mat4(1.0f);
+
+    for (size_t i = 0; i < kVertexCount; ++i)
+    {
+      foundation::VertexBase base;
+      base.position = glm::vec3(Random(-3.0f, 5.0f), Random(0.0f, 20.0f), Random(-0.5f, 0.5f));
+      base.normal = RandomDirection();
+      sub_mesh.vertices_base.push_back(base);
+      sub_mesh.bounding_box.min = glm::min(sub_mesh.bounding_box.min, base.position);
+      sub_mesh.bounding_box.max = glm::max(sub_mesh.bounding_box.max, base.position);
+
+      foundation::VertexColor color;
+      color.color = glm::vec4(Random(0.0f, 1.0f), Random(0.0f, 1.0f), Random(0.0f, 1.0f), Random(0.0f, 1.0f));
+      sub_mesh.vertices_color.push_back(color);
+
+      foundation::VertexTextured textured;
+      textured.uv = glm::vec2(Random(0.0f, 1.0f), Random(0.0f, 1.0f));
+      textured.tangent = RandomDirection();
+      sub_mesh.vertices_textured.push_back(textured);
+
+      foundation::VertexBones bones;
+      float total = 0.0f;
+      for (int j = 0; j < 4; ++j)
+      {
+        bones.bone_weights[j] = Random(0.0f, 1.0f);
+        bones.bone_indices[j] = static_cast<uint16_t>(rand() % (max_bone_index + 1));
+        total += bones.bone_weights[j];
+      }
+      for (int j = 0; j < 4; ++j)
+      {
+        bones.bone_weights[j] /= total;
+      }
+      sub_mesh.vertices_bones.push_back(bones);
+
+      sub_mesh.indices.push_back(static_cast<uint32_t>(kVertexCount - 1 - i));
+    }
+
+    return sub_mesh;
+  }
+
+  //--------------------------------------------------------------------------
+  foundation::MeshData ReadBack(const foundation::BinaryWriter& writer)
+  {
+    foundation::Vector<unsigned char> data = writer.get_data();
+    foundation::BinaryReader reader(data.data(), static_cast<int>(data.size()));
+    return reader.Read<foundation::MeshData>();
+  }
+
+  //--------------------------------------------------------------------------
+  template<typename T>
+  bool Equal(const foundation::Vector<T>& a, const foundation::Vector<T>& b)
+  {
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(QuantizedMeshPackageRoundTrip)
+{
+  foundation::MeshData mesh;
+  mesh.sub_meshes.push_back(CreateSubMesh(foundation::VertexEncoding::kQuantized, 255));
+  const foundation::SubMesh& original = mesh.sub_meshes[0];
+
+  foundation::BinaryWriter writer;
+  writer.Write(mesh);
+  foundation::MeshData read = ReadBack(writer);
+
+  PS_CHECK(read.sub_meshes.size() == 1);
+  foundation::SubMesh& sub_mesh = read.sub_meshes[0];
+
+  // The quantized data is kept until it is decoded
+  PS_CHECK(sub_mesh.vertex_encoding == foundation::VertexEncoding::kQuantized);
+  PS_CHECK(sub_mesh.quantized_base.size() == kVertexCount);
+  PS_CHECK(sub_mesh.vertices_base.empty() == true);
+  PS_CHECK(Equal(sub_mesh.indices, original.indices));
+
+  sub_mesh.Decode();
+  PS_CHECK(sub_mesh.vertex_encoding == foundation::VertexEncoding::kFloat);
+  PS_CHECK(sub_mesh.quantized_base.empty() == true);
+  PS_CHECK(sub_mesh.vertices_base.size() == kVertexCount);
+  PS_CHECK(sub_mesh.vertices_color.size() == kVertexCount);
+  PS_CHECK(sub_mesh.vertices_textured.size() == kVertexCount);
+  PS_CHECK(sub_mesh.vertices_bones.size() == kVertexCount);
+
+  // Positions are off by half a step of 16 bits over the bounding box at most
+  const glm::vec3 position_error =
+    (original.bounding_box.max - original.bounding_box.min) * (0.5f / 65535.0f) + 1e-5f;
+  const float weight_error = 2.0f / 255.0f + 1e-5f;
+
+  for (size_t i = 0; i < kVertexCount; ++i)
+  {
+    const glm::vec3 position_delta =
+      glm::abs(sub_mesh.vertices_base[i].position - original.vertices_base[i].position);
+    PS_CHECK(glm::all(glm::lessThanEqual(position_delta, position_error)));
+
+    PS_CHECK(glm::dot(sub_mesh.vertices_base[i].normal, original.vertices_base[i].normal) > 0.9999f);
+    PS_CHECK(glm::dot(sub_mesh.vertices_textured[i].tangent, original.vertices_textured[i].tangent) > 0.9999f);
+
+    const glm::vec2 uv_delta = glm::abs(sub_mesh.vertices_textured[i].uv - original.vertices_textured[i].uv);
+    PS_CHECK(glm::all(glm::lessThanEqual(uv_delta, glm::vec2(1.0f / 2048.0f))));
+
+    const glm::vec4 color_delta = glm::abs(sub_mesh.vertices_color[i].color - original.vertices_color[i].color);
+    PS_CHECK(glm::all(glm::lessThanEqual(color_delta, glm::vec4(0.5f / 255.0f + 1e-5f))));
+
+    float total = 0.0f;
+    for (int j = 0; j < 4; ++j)
+    {
+      const float weight = sub_mesh.vertices_bones[i].bone_weights[j];
+      PS_CHECK(glm::abs(weight - original.vertices_bones[i].bone_weights[j]) <= weight_error);
+      PS_CHECK(sub_mesh.vertices_bones[i].bone_indices[j] == original.vertices_bones[i].bone_indices[j]);
+      total += weight;
+    }
+    PS_CHECK(glm::abs(total - 1.0f) < 1e-5f);
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(MeshPackageFallsBackToFloat)
+{
+  // Bone indices that don't fit in 8 bits keep the sub-mesh at full precision
+  foundation::MeshData mesh;
+  mesh.sub_meshes.push_back(CreateSubMesh(foundation::VertexEncoding::kQuantized, 300));
+  mesh.sub_meshes.push_back(CreateSubMesh(foundation::VertexEncoding::kFloat, 255));
+  PS_CHECK(mesh.sub_meshes[0].CanQuantize() == false);
+
+  foundation::BinaryWriter writer;
+  writer.Write(mesh);
+  const foundation::MeshData read = ReadBack(writer);
+
+  PS_CHECK(read.sub_meshes.size() == 2);
+  for (size_t i = 0; i < read.sub_meshes.size(); ++i)
+  {
+    const foundation::SubMesh& original = mesh.sub_meshes[i];
+    const foundation::SubMesh& sub_mesh = read.sub_meshes[i];
+    PS_CHECK(sub_mesh.vertex_encoding == foundation::VertexEncoding::kFloat);
+    PS_CHECK(sub_mesh.quantized_base.empty() == true);
+    PS_CHECK(Equal(sub_mesh.vertices_base, original.vertices_base));
+    PS_CHECK(Equal(sub_mesh.vertices_color, original.vertices_color));
+    PS_CHECK(Equal(sub_mesh.vertices_textured, original.vertices_textured));
+    PS_CHECK(Equal(sub_mesh.vertices_bones, original.vertices_bones));
+    PS_CHECK(Equal(sub_mesh.indices, original.indices));
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(StaleMeshPackageIsRejected)
+{
+  foundation::MeshData mesh;
+  mesh.sub_meshes.push_back(CreateSubMesh(foundation::VertexEncoding::kFloat, 255));
+
+  // Version 1 packages start with the sub-meshes
+  foundation::BinaryWriter unversioned;
+  unversioned.Write(mesh.sub_meshes);
+  unversioned.Write(mesh.bounding_box);
+  unversioned.Write(mesh.bounding_sphere);
+  PS_CHECK(ReadBack(unversioned).sub_meshes.empty() == true);
+
+  foundation::BinaryWriter old_version;
+  foundation::WritePackageHeader(old_version, foundation::MeshData::kPackageMagic, 1);
+  old_version.Write(mesh.sub_meshes);
+  old_version.Write(mesh.bounding_box);
+  old_version.Write(mesh.bounding_sphere);
+  PS_CHECK(ReadBack(old_version).sub_meshes.empty() == true);
+
+  foundation::BinaryWriter empty;
+  PS_CHECK(ReadBack(empty).sub_meshes.empty() == true);
+}
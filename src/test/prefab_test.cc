@@ -0,0 +1,134 @@
+#include "test/test.h"
+
+#include <engine/core/prefab.h>
+#include <engine/core/entity_system.h>
+#include <engine/systems/components/transform_system.h>
+#include <foundation/containers/vector.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kInstanceCount = 5; //!< The instances that are created at once
+  const float kTolerance = 1e-4f; //!< The maximum difference of the world transformations
+
+  //--------------------------------------------------------------------------
+  glm::mat4 Compose(const engine::HierarchyNode& node)
+  {
+    return glm::translate(glm::mat4(1.0f), node.local_position) *
+      glm::mat4_cast(node.local_rotation) *
+      glm::scale(glm::mat4(1.0f), node.local_scale);
+  }
+
+  //--------------------------------------------------------------------------
+  bool Equal(const glm::mat4& a, const glm::mat4& b)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      if (glm::any(glm::greaterThan(glm::abs(a[i] - b[i]), glm::vec4(kTolerance))))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //--------------------------------------------------------------------------
+  engine::Prefab CreatePrefab()
+  {
+    // root -> arm -> hand, root -> leg
+    engine::Prefab prefab;
+    const size_t root = prefab.AddNode(engine::HierarchyNode::kNoParent, glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f), "root");
+    const size_t arm = prefab.AddNode(root, glm::vec3(1.0f, 2.0f, 0.0f),
+      glm::angleAxis(0.5f, glm::vec3(0.0f, 0.0f, 1.0f)), glm::vec3(2.0f), "arm");
+    prefab.AddNode(arm, glm::vec3(0.0f, 1.0f, 0.0f), glm::angleAxis(-1.0f, glm::vec3(1.0f, 0.0f, 0.0f)));
+    prefab.AddNode(root, glm::vec3(0.0f, -1.0f, 0.5f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(0.5f), "leg");
+    return prefab;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(PrefabNodesAreDepthFirst)
+{
+  engine::Prefab prefab = CreatePrefab();
+  const foundation::Vector<engine::HierarchyNode>& nodes = prefab.nodes();
+
+  PS_CHECK(prefab.node_count() == 4);
+  PS_CHECK(nodes[0].parent == engine::HierarchyNode::kNoParent);
+  PS_CHECK(nodes[0].child_count == 2);
+  PS_CHECK(nodes[1].parent == 0);
+  PS_CHECK(nodes[1].child_count == 1);
+  PS_CHECK(nodes[2].parent == 1);
+  PS_CHECK(nodes[3].parent == 0);
+  PS_CHECK(nodes[3].child_count == 0);
+
+  // The hand isn't the last node or one of its ancestors anymore, and there is only one root
+  PS_CHECK(prefab.AddNode(2) == engine::Prefab::kInvalidNode);
+  PS_CHECK(prefab.AddNode(engine::HierarchyNode::kNoParent) == engine::Prefab::kInvalidNode);
+  PS_CHECK(prefab.AddNode(42) == engine::Prefab::kInvalidNode);
+  PS_CHECK(prefab.node_count() == 4);
+  PS_CHECK(nodes[2].child_count == 0);
+
+  PS_CHECK(prefab.AddNode(3) == 4);
+  PS_CHECK(nodes[3].child_count == 1);
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(PrefabHierarchiesAreInstantiated)
+{
+  const engine::Prefab prefab = CreatePrefab();
+  const foundation::Vector<engine::HierarchyNode>& nodes = prefab.nodes();
+  const size_t node_count = prefab.node_count();
+
+  engine::EntitySystem entity_system;
+  engine::TransformSystem transform_system;
+
+  // Every instance is moved and turned differently
+  foundation::Vector<engine::Entity> entities;
+  foundation::Vector<glm::mat4> roots;
+  for (size_t i = 0; i < kInstanceCount; ++i)
+  {
+    roots.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i) * 10.0f, 0.0f, -3.0f)) *
+      glm::mat4_cast(glm::angleAxis(static_cast<float>(i) * 0.3f, glm::vec3(0.0f, 1.0f, 0.0f))));
+    for (size_t j = 0; j < node_count; ++j)
+    {
+      entities.push_back(entity_system.Create());
+    }
+  }
+
+  // The same call sulphur::engine::EntitySystem::Instantiate makes for the transforms of all instances
+  foundation::Vector<engine::TransformComponent> transforms(entities.size());
+  transform_system.CreateHierarchies(
+    nodes.data(), node_count, entities.data(), kInstanceCount, roots.data(), transforms.data());
+
+  for (size_t instance = 0; instance < kInstanceCount; ++instance)
+  {
+    engine::TransformComponent* instance_transforms = transforms.data() + instance * node_count;
+    foundation::Vector<glm::mat4> expected(node_count);
+
+    for (size_t i = 0; i < node_count; ++i)
+    {
+      const engine::TransformComponent transform = instance_transforms[i];
+      const engine::HierarchyNode& node = nodes[i];
+      PS_CHECK(transform_system.GetEntity(transform) == entities[instance * node_count + i]);
+
+      // Every instance is its own hierarchy under the root node
+      if (node.parent == engine::HierarchyNode::kNoParent)
+      {
+        PS_CHECK(transform_system.HasParent(transform) == false);
+        expected[i] = roots[instance];
+      }
+      else
+      {
+        PS_CHECK(transform_system.GetParent(transform).Handle() == instance_transforms[node.parent].Handle());
+        expected[i] = expected[node.parent] * Compose(node);
+      }
+
+      PS_CHECK(Equal(transform_system.GetLocalToWorld(transform), expected[i]));
+    }
+  }
+
+  entity_system.OnTerminate();
+}
@@ -0,0 +1,285 @@
+#include "test/test.h"
+
+#include <engine/rewinder/rewind_system.h>
+#include <engine/rewinder/rewindable_storage_base.h>
+#include <engine/rewinder/system_stored_data.h>
+#include <engine/rewinder/snapshot_pool.h>
+#include <engine/rewinder/frame_storage.h>
+#include <foundation/containers/vector.h>
+
+#include <cstring>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kSystemCount = 4; //!< Systems that are copied in parallel with async capture
+  const size_t kFrameCount = 50; //!< More frames than the limit, so the oldest frames are replaced too
+  const size_t kFrameLimit = 40; //!< The frames kept in memory
+  const size_t kKeyframeInterval = 7; //!< Doesn't divide the limit, so the first stored frame isn't always a keyframe
+
+  /**
+  * @struct <anonymous>::Particle
+  * @brief The element that the test systems store
+  */
+  struct Particle
+  {
+    float position[3]; //!< Changes every frame
+    int age; //!< Only changes for some of the particles
+  };
+}
+
+namespace sulphur
+{
+  namespace engine
+  {
+    //-------------------------------------------------------------------------
+    template<>
+    inline void* Store(Particle* buffer, size_t size)
+    {
+      void* raw_array = SnapshotPool::Instance().Allocate(size * sizeof(Particle));
+      memcpy(raw_array, buffer, size * sizeof(Particle));
+      return raw_array;
+    }
+    //-------------------------------------------------------------------------
+    template<>
+    inline void Restore(Particle* buffer, void* old, size_t size)
+    {
+      memcpy(buffer, old, size * sizeof(Particle));
+    }
+  }
+}
+
+namespace
+{
+  /**
+  * @class <anonymous>::ParticleStorage : sulphur::engine::RewindStorageBase
+  * @brief A system with one column of particles that grows over time
+  */
+  class ParticleStorage : public engine::RewindStorageBase
+  {
+  public:
+    /**
+    * @brief Constructor
+    */
+    ParticleStorage() :
+      RewindStorageBase(element_list_, element_sizes_, 1),
+      storage_(this, engine::StoreFunc<Particle>())
+    {}
+
+    /**
+    * @see sulphur::engine::RewindStorageBase::PrepareStore
+    */
+    void PrepareStore() override
+    {
+      ++stores_;
+      element_list_[0] = particles_.data();
+      element_sizes_[0] = particles_.size();
+    }
+
+    /**
+    * @see sulphur::engine::RewindStorageBase::PrepareRestore
+    */
+    void PrepareRestore(const engine::FrameStorage& storage) override
+    {
+      particles_.resize(storage.data[0].size);
+      element_list_[0] = particles_.data();
+      element_sizes_[0] = particles_.size();
+    }
+
+    /**
+    * @brief Changes the particles the same way for the same system and frame
+    * @param[in] system (size_t) The index of the system
+    * @param[in] frame (size_t) The frame that is simulated
+    */
+    void Simulate(size_t system, size_t frame)
+    {
+      particles_.resize(64 + frame * (system + 1));
+      for (size_t i = 0; i < particles_.size(); ++i)
+      {
+        Particle& particle = particles_[i];
+        particle.position[0] = static_cast<float>(i) + static_cast<float>(frame) * 0.5f;
+        particle.position[1] = static_cast<float>(system);
+        particle.position[2] = static_cast<float>((i * 31 + frame * 17) % 101);
+        particle.age = (i + frame) % 5 == 0 ? static_cast<int>(frame + system) : static_cast<int>(i % 7);
+      }
+    }
+
+    void* element_list_[1]; //!< The particle column
+    size_t stores_ = 0; //!< The amount of times the particles were copied
+    uint64_t element_sizes_[1]; //!< The amount of particles
+    engine::RewindStorage storage_; //!< The storage that is registered with the rewind system
+    foundation::Vector<Particle> particles_; //!< The data of the system
+  };
+
+  /**
+  * @struct <anonymous>::Rewinder
+  * @brief A rewind system with the test systems registered to it
+  */
+  struct Rewinder
+  {
+    engine::RewindSystem system; //!< The rewind system
+    ParticleStorage storages[kSystemCount]; //!< The registered systems
+  };
+
+  //--------------------------------------------------------------------------
+  void Setup(Rewinder& rewinder, bool async_capture)
+  {
+    rewinder.system.set_async_capture(async_capture);
+    rewinder.system.set_frame_limit(kFrameLimit);
+    rewinder.system.set_keyframe_interval(kKeyframeInterval);
+    for (ParticleStorage& storage : rewinder.storages)
+    {
+      rewinder.system.Register(storage.storage_);
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  void Simulate(Rewinder& rewinder, size_t frame)
+  {
+    for (size_t i = 0; i < kSystemCount; ++i)
+    {
+      rewinder.storages[i].Simulate(i, frame);
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  bool Equal(const foundation::Vector<Particle>& a, const foundation::Vector<Particle>& b)
+  {
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(Particle)) == 0;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(RewindAsyncCaptureMatchesSyncCapture)
+{
+  Rewinder sync;
+  Rewinder async;
+  Setup(sync, false);
+  Setup(async, true);
+
+  foundation::Vector<foundation::Vector<Particle>> expected;
+  for (size_t frame = 0; frame < kFrameCount; ++frame)
+  {
+    Simulate(sync, frame);
+    Simulate(async, frame);
+    sync.system.StoreFrame();
+    async.system.StoreFrame();
+
+    // The systems change their data right after the frame is stored, while async capture still compresses it
+    expected.push_back(async.storages[kSystemCount - 1].particles_);
+    for (ParticleStorage& storage : async.storages)
+    {
+      memset(storage.particles_.data(), 0xff, storage.particles_.size() * sizeof(Particle));
+    }
+  }
+
+  PS_CHECK(sync.system.stored_frames() == kFrameLimit);
+  PS_CHECK(async.system.stored_frames() == kFrameLimit);
+
+  for (size_t frame = 0; frame < kFrameLimit; ++frame)
+  {
+    sync.system.set_frame_to_restore(static_cast<int>(frame));
+    async.system.set_frame_to_restore(static_cast<int>(frame));
+    sync.system.RestoreFrame();
+    async.system.RestoreFrame();
+
+    for (size_t i = 0; i < kSystemCount; ++i)
+    {
+      PS_CHECK(Equal(sync.storages[i].particles_, async.storages[i].particles_));
+    }
+    PS_CHECK(Equal(async.storages[kSystemCount - 1].particles_, expected[kFrameCount - kFrameLimit + frame]));
+  }
+
+  sync.system.set_frame_to_restore(-1);
+  async.system.set_frame_to_restore(-1);
+  sync.system.OnTerminate();
+  async.system.OnTerminate();
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(RewindSkipsUnchangedStorage)
+{
+  Rewinder rewinder;
+  Setup(rewinder, true);
+  for (ParticleStorage& storage : rewinder.storages)
+  {
+    storage.track_changes_ = true;
+  }
+
+  // Only the first system changes after the first frame, the others are copied once
+  foundation::Vector<foundation::Vector<Particle>> expected;
+  for (size_t frame = 0; frame < kFrameCount; ++frame)
+  {
+    rewinder.storages[0].Simulate(0, frame);
+    rewinder.storages[0].MarkChanged();
+    if (frame == 0)
+    {
+      Simulate(rewinder, frame);
+    }
+    rewinder.system.StoreFrame();
+    expected.push_back(rewinder.storages[0].particles_);
+  }
+
+  PS_CHECK(rewinder.storages[0].stores_ == kFrameCount);
+  for (size_t i = 1; i < kSystemCount; ++i)
+  {
+    PS_CHECK(rewinder.storages[i].stores_ == 1);
+  }
+
+  const foundation::Vector<Particle> unchanged = rewinder.storages[kSystemCount - 1].particles_;
+  for (size_t frame = 0; frame < kFrameLimit; ++frame)
+  {
+    rewinder.system.set_frame_to_restore(static_cast<int>(frame));
+    rewinder.system.RestoreFrame();
+    PS_CHECK(Equal(rewinder.storages[0].particles_, expected[kFrameCount - kFrameLimit + frame]));
+    PS_CHECK(Equal(rewinder.storages[kSystemCount - 1].particles_, unchanged));
+  }
+
+  // Restoring changes the data, so the next stored frame copies it again
+  rewinder.system.set_frame_to_restore(-1);
+  rewinder.system.StoreFrame();
+  PS_CHECK(rewinder.storages[kSystemCount - 1].stores_ == 2);
+
+  rewinder.system.OnTerminate();
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(RewindReservesSnapshotPool)
+{
+  engine::SnapshotPool& pool = engine::SnapshotPool::Instance();
+  Rewinder rewinder;
+  Setup(rewinder, true);
+
+  // Only the first frame is a keyframe, the others don't change and don't store compressed blocks
+  rewinder.system.set_keyframe_interval(kFrameLimit);
+  Simulate(rewinder, 0);
+  const foundation::Vector<Particle> expected = rewinder.storages[kSystemCount - 1].particles_;
+
+  // The first frame allocates its copies, the second reserves the blocks for the frames after it
+  const size_t initial = pool.heap_allocations();
+  rewinder.system.StoreFrame();
+  PS_CHECK(pool.heap_allocations() > initial);
+  rewinder.system.StoreFrame();
+  const size_t reserved = pool.heap_allocations();
+  PS_CHECK(pool.free_bytes() > 0);
+
+  for (size_t frame = 2; frame < kFrameLimit; ++frame)
+  {
+    rewinder.system.StoreFrame();
+  }
+  PS_CHECK(rewinder.system.stored_frames() == kFrameLimit);
+
+  for (size_t frame = 0; frame < kFrameLimit; ++frame)
+  {
+    rewinder.system.set_frame_to_restore(static_cast<int>(frame));
+    rewinder.system.RestoreFrame();
+    PS_CHECK(Equal(rewinder.storages[kSystemCount - 1].particles_, expected));
+  }
+
+  // Capturing and decoding the frames only used the reserved blocks
+  PS_CHECK(pool.heap_allocations() == reserved);
+
+  rewinder.system.set_frame_to_restore(-1);
+  rewinder.system.OnTerminate();
+}
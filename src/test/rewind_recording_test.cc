@@ -0,0 +1,89 @@
+#include "test/test.h"
+
+#include <engine/rewinder/rewind_recorder.h>
+#include <engine/rewinder/rewind_recording.h>
+#include <engine/rewinder/snapshot_pool.h>
+
+#include <foundation/containers/vector.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace sulphur;
+
+namespace
+{
+  const char* kPath = "rewind_recording_test.psrw"; //!< The recording that is written and read back
+  const size_t kFrameCount = 200; //!< Spans several chunks of the recorder
+  const size_t kBlockSize = 64 * 1024; //!< Random blocks of this size don't compress
+
+  //--------------------------------------------------------------------------
+  foundation::Vector<char> CreateBlock(size_t frame)
+  {
+    // Odd frames hold noise, which the recorder has to store uncompressed
+    foundation::Vector<char> block(kBlockSize);
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+      block[i] = frame % 2 == 0 ? static_cast<char>(frame + i / 256) : static_cast<char>(rand());
+    }
+    return block;
+  }
+
+  //--------------------------------------------------------------------------
+  bool Equal(const engine::FrameStorage& frame, const foundation::Vector<char>& block, size_t size)
+  {
+    return frame.data.size() == 1 &&
+      frame.data[0].size == size &&
+      memcmp(frame.data[0].data, block.data(), block.size()) == 0;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(RecordedFramesReplay)
+{
+  srand(1);
+
+  foundation::Vector<foundation::Vector<char>> blocks;
+  {
+    engine::RewindRecorder recorder;
+    PS_CHECK(recorder.Open(kPath, 2) == true);
+
+    for (size_t frame = 0; frame < kFrameCount; ++frame)
+    {
+      blocks.push_back(CreateBlock(frame));
+
+      engine::FrameStorage storage;
+      void* data = engine::SnapshotPool::Instance().Allocate(kBlockSize);
+      memcpy(data, blocks.back().data(), kBlockSize);
+      storage.data.push_back({ data, frame });
+
+      recorder.Begin();
+      recorder.Add(storage);
+      recorder.Add(engine::FrameStorage());
+      recorder.Submit();
+      engine::SnapshotPool::Instance().Release(data);
+    }
+
+    PS_CHECK(recorder.frame_count() == kFrameCount);
+    recorder.Close();
+  }
+
+  // Every frame is in the recording, whether it compressed or not
+  {
+    engine::RewindRecording recording;
+    PS_CHECK(recording.Open(kPath) == true);
+    PS_CHECK(recording.frame_count() == kFrameCount);
+    PS_CHECK(recording.system_count() == 2);
+
+    for (size_t i = 0; i < kFrameCount; ++i)
+    {
+      const size_t frame = (i * 37) % kFrameCount;
+      PS_CHECK(recording.Read(frame) == true);
+      PS_CHECK(Equal(recording.system_frame(0), blocks[frame], frame));
+      PS_CHECK(recording.system_frame(1).data.empty() == true);
+    }
+  }
+
+  remove(kPath);
+}
@@ -0,0 +1,108 @@
+#include "test/test.h"
+
+#include <engine/systems/components/skinned_mesh_render_system.h>
+#include <engine/core/entity_system.h>
+#include <engine/assets/skeleton.h>
+#include <foundation/math/transform_kernels.h>
+#include <foundation/containers/vector.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdlib>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kNodeCount = 40; //!< The nodes of the flattened skeleton
+  const size_t kInstanceCount = 8; //!< The components that share the pose
+  const float kTolerance = 1e-3f; //!< The maximum difference of the bone matrices
+
+  //--------------------------------------------------------------------------
+  float Random(float min, float max)
+  {
+    return min + (max - min) * static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+  }
+
+  //--------------------------------------------------------------------------
+  glm::mat4 RandomTransform(float scale)
+  {
+    const glm::quat rotation = glm::normalize(
+      glm::quat(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f)));
+    return glm::translate(glm::mat4(1.0f), glm::vec3(Random(-scale, scale), Random(-scale, scale), Random(-scale, scale))) *
+      glm::mat4_cast(rotation) *
+      glm::scale(glm::mat4(1.0f), glm::vec3(Random(0.5f, 2.0f)));
+  }
+
+  //--------------------------------------------------------------------------
+  bool Equal(const foundation::Vector<glm::mat4>& a, const foundation::Vector<glm::mat4>& b)
+  {
+    if (a.size() != b.size())
+    {
+      return false;
+    }
+
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+      for (int c = 0; c < 4; ++c)
+      {
+        if (glm::any(glm::greaterThan(glm::abs(a[i][c] - b[i][c]), glm::vec4(kTolerance))))
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(SharedPosesMatchOwnPoses)
+{
+  srand(1);
+
+  // Every node has a parent before it, every other node drives a bone
+  engine::SkeletonAnimationRemap remap;
+  foundation::Vector<engine::Bone> bones;
+  foundation::Vector<glm::mat4> local_transforms;
+  for (size_t i = 0; i < kNodeCount; ++i)
+  {
+    engine::SkeletonAnimationRemap::Node node;
+    node.node = static_cast<unsigned int>(i);
+    node.parent = i == 0 ? engine::SkeletonAnimationRemap::kNone : static_cast<unsigned int>(rand() % i);
+    node.bone = engine::SkeletonAnimationRemap::kNone;
+    node.channel = engine::SkeletonAnimationRemap::kNone;
+    node.leaf = false;
+    if (i % 2 == 0)
+    {
+      node.bone = static_cast<unsigned int>(bones.size());
+      bones.push_back(engine::Bone(RandomTransform(1.0f)));
+    }
+    remap.nodes.push_back(node);
+    local_transforms.push_back(RandomTransform(1.0f));
+  }
+  remap.inverse_root = glm::inverse(RandomTransform(1.0f));
+
+  foundation::Vector<glm::mat4> node_transforms(kNodeCount);
+
+  // The first component evaluates the pose in model space for all of them
+  foundation::Vector<glm::mat4> shared_pose(bones.size());
+  engine::SkinnedMeshRenderSystem::ComposeBoneMatrices(remap, local_transforms.data(), bones,
+    glm::mat4(1.0f), glm::mat4(1.0f), node_transforms.data(), shared_pose.data());
+
+  for (size_t instance = 0; instance < kInstanceCount; ++instance)
+  {
+    const glm::mat4 local_to_world = RandomTransform(100.0f);
+
+    foundation::Vector<glm::mat4> own_pose(bones.size());
+    engine::SkinnedMeshRenderSystem::ComposeBoneMatrices(remap, local_transforms.data(), bones,
+      local_to_world, remap.inverse_root, node_transforms.data(), own_pose.data());
+
+    // Placed the way the renderer binds a shared pose
+    foundation::Vector<glm::mat4> placed_pose(bones.size());
+    foundation::MultiplyAffine(remap.inverse_root * local_to_world, shared_pose.data(), placed_pose.data(), shared_pose.size());
+
+    PS_CHECK(Equal(placed_pose, own_pose));
+  }
+}
@@ -0,0 +1,98 @@
+#include "test/test.h"
+
+#include <engine/systems/system_data.h>
+#include <foundation/containers/string.h>
+#include <foundation/containers/vector.h>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kComponentCount = 10000; //!< Spans several chunks, and isn't a multiple of the chunk size
+
+  /**
+  * @struct <anonymous>::ParticleData
+  * @brief System data with a trivially copyable column and one that isn't, laid out like the component systems do
+  */
+  struct ParticleData
+  {
+    using ComponentSystemData = engine::SystemData<float, foundation::String>; //!< The columns of the components
+
+    /**
+    * @brief Constructor that passes the pointers to the system data
+    */
+    ParticleData() :
+      data((void**)&age)
+    {
+    }
+
+    float* age; //!< Direct access to the ages
+    foundation::String* name; //!< Direct access to the names
+    ComponentSystemData data; //!< The system data of the components
+  };
+
+  //--------------------------------------------------------------------------
+  foundation::String Name(size_t i)
+  {
+    return "particle " + foundation::to_string(i);
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(SystemDataGrowsInPlace)
+{
+  ParticleData particles;
+  foundation::Vector<engine::ComponentHandleBase> handles;
+
+  handles.push_back(engine::ComponentHandleBase(particles.data.Add(0.0f, Name(0))));
+  float* const ages = particles.age;
+  foundation::String* const names = particles.name;
+
+  // Committing more chunks doesn't move the elements
+  for (size_t i = 1; i < kComponentCount; ++i)
+  {
+    handles.push_back(engine::ComponentHandleBase(particles.data.Add(static_cast<float>(i), Name(i))));
+    PS_CHECK(particles.age == ages);
+    PS_CHECK(particles.name == names);
+  }
+  PS_CHECK(particles.data.size() == kComponentCount);
+  PS_CHECK(particles.data.capacity() >= kComponentCount);
+  PS_CHECK(particles.data.capacity() < kComponentCount + ParticleData::ComponentSystemData::kChunkSize);
+
+  for (size_t i = 0; i < kComponentCount; ++i)
+  {
+    PS_CHECK(particles.data.Get<0>(handles[i]) == static_cast<float>(i));
+    PS_CHECK(particles.data.Get<1>(handles[i]) == Name(i));
+  }
+
+  // Removing and compacting keeps the addresses of the remaining elements too
+  for (size_t i = 0; i < kComponentCount; i += 2)
+  {
+    particles.data.Remove(handles[i]);
+  }
+  particles.data.Compact();
+  PS_CHECK(particles.data.size() == kComponentCount / 2);
+  PS_CHECK(particles.data.capacity() == kComponentCount / 2);
+  PS_CHECK(particles.age == ages);
+
+  for (size_t i = 1; i < kComponentCount; i += 2)
+  {
+    PS_CHECK(particles.data.IsValid(handles[i]) == true);
+    PS_CHECK(particles.data.Get<0>(handles[i]) == static_cast<float>(i));
+    PS_CHECK(particles.data.Get<1>(handles[i]) == Name(i));
+  }
+
+  // Growing again after compacting
+  particles.data.Reserve(kComponentCount * 2);
+  PS_CHECK(particles.data.capacity() == kComponentCount * 2);
+  for (size_t i = 0; i < kComponentCount; ++i)
+  {
+    const engine::ComponentHandleBase handle(particles.data.Add(-1.0f, Name(i)));
+    PS_CHECK(particles.data.Get<0>(handle) == -1.0f);
+  }
+  PS_CHECK(particles.age == ages);
+  PS_CHECK(particles.data.Get<1>(handles[kComponentCount - 1]) == Name(kComponentCount - 1));
+
+  particles.data.Clear();
+  PS_CHECK(particles.data.size() == 0);
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+
+namespace sulphur
+{
+  namespace test
+  {
+    using TestFunction = void(*)(); //!< A test or a benchmark
+
+    /**
+    * @struct sulphur::test::Registration
+    * @brief Adds a test or a benchmark to the runner when it is constructed, used by PS_TEST and PS_BENCHMARK
+    */
+    struct Registration
+    {
+      /**
+      * @brief Registers a test or a benchmark
+      * @param[in] name (const char*) The name that is printed and can be used to select it
+      * @param[in] function (sulphur::test::TestFunction) The function to run
+      * @param[in] benchmark (bool) Is it a benchmark? Benchmarks only run with --bench
+      */
+      Registration(const char* name, TestFunction function, bool benchmark);
+    };
+
+    /**
+    * @brief Marks the running test as failed
+    * @param[in] file (const char*) The file of the failed check
+    * @param[in] line (int) The line of the failed check
+    * @param[in] expression (const char*) The expression that didn't hold
+    */
+    void Fail(const char* file, int line, const char* expression);
+
+    /**
+    * @brief Prints the time per iteration of a measurement
+    * @param[in] name (const char*) What was measured
+    * @param[in] iterations (size_t) The amount of iterations that were timed
+    * @param[in] seconds (double) The total time of all iterations
+    */
+    void Report(const char* name, size_t iterations, double seconds);
+
+    /**
+    * @brief Times a function and prints the time per iteration
+    * @param[in] name (const char*) What is measured
+    * @param[in] iterations (size_t) The amount of times the function is called
+    * @param[in] function (const T&) The function to time
+    */
+    template<typename T>
+    void Measure(const char* name, size_t iterations, const T& function)
+    {
+      // The first call warms up the caches and is left out
+      function();
+
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < iterations; ++i)
+      {
+        function();
+      }
+      const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+      Report(name, iterations, duration.count());
+    }
+
+    extern const void* volatile sink; //!< Written by DoNotOptimize, defined by the runner so the writes can't be removed
+
+    /**
+    * @brief Keeps the compiler from optimizing away a result that is otherwise unused
+    * @param[in] value (const T&) The result
+    */
+    template<typename T>
+    void DoNotOptimize(const T& value)
+    {
+      sink = &value;
+    }
+  }
+}
+
+/**
+* @brief Defines a test, which fails when any of its PS_CHECKs fail
+*/
+#define PS_TEST(name) \
+  static void name(); \
+  static sulphur::test::Registration name##_registration(#name, &name, false); \
+  static void name()
+
+/**
+* @brief Defines a benchmark, which only runs when the runner is started with --bench
+*/
+#define PS_BENCHMARK(name) \
+  static void name(); \
+  static sulphur::test::Registration name##_registration(#name, &name, true); \
+  static void name()
+
+/**
+* @brief Fails the running test if the expression doesn't hold, the test continues afterwards
+*/
+#define PS_CHECK(expression) \
+  ((expression) ? static_cast<void>(0) : sulphur::test::Fail(__FILE__, __LINE__, #expression))
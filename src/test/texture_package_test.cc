@@ -0,0 +1,125 @@
+#include "test/test.h"
+
+#include <engine/assets/texture.h>
+#include <foundation/pipeline-assets/texture.h>
+#include <foundation/io/binary_reader.h>
+#include <foundation/io/binary_writer.h>
+#include <foundation/containers/vector.h>
+
+using namespace sulphur;
+
+namespace
+{
+  const int kWidth = 64; //!< The width of the test texture
+  const int kHeight = 30; //!< The height of the test texture, not a multiple of the block size
+
+  //--------------------------------------------------------------------------
+  foundation::TextureData CreateTexture()
+  {
+    foundation::TextureData texture;
+    texture.width = kWidth;
+    texture.height = kHeight;
+    texture.depth = 1;
+    texture.type = foundation::TextureType::k2D;
+    texture.format = foundation::TexelFormat::kRGBA;
+    texture.compression = foundation::TextureCompressionType::kBC1;
+    texture.srgb = true;
+
+    // A full mip chain of BC1 blocks, every mip filled with its index
+    const size_t block_size = foundation::GetBytesPerBlock(texture.compression);
+    int width = kWidth;
+    int height = kHeight;
+    texture.mips = 0;
+    while (true)
+    {
+      const size_t size = ((width + 3) / 4) * ((height + 3) / 4) * block_size;
+      texture.mip_offsets.push_back(static_cast<uint32_t>(texture.pixel_data.size()));
+      texture.pixel_data.resize(texture.pixel_data.size() + size, static_cast<byte>(texture.mips));
+      ++texture.mips;
+
+      if (width == 1 && height == 1)
+      {
+        break;
+      }
+      width = width > 1 ? width / 2 : 1;
+      height = height > 1 ? height / 2 : 1;
+    }
+
+    return texture;
+  }
+
+  //--------------------------------------------------------------------------
+  foundation::TextureData ReadBack(const foundation::BinaryWriter& writer)
+  {
+    foundation::Vector<unsigned char> data = writer.get_data();
+    foundation::BinaryReader reader(data.data(), static_cast<int>(data.size()));
+    return reader.Read<foundation::TextureData>();
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(TexturePackageRoundTrip)
+{
+  const foundation::TextureData texture = CreateTexture();
+  PS_CHECK(texture.mips == 7);
+
+  foundation::BinaryWriter writer;
+  writer.Write(texture);
+  const foundation::TextureData read = ReadBack(writer);
+
+  PS_CHECK(read.pixel_data == texture.pixel_data);
+  PS_CHECK(read.mip_offsets == texture.mip_offsets);
+  PS_CHECK(read.width == kWidth);
+  PS_CHECK(read.height == kHeight);
+  PS_CHECK(read.depth == 1);
+  PS_CHECK(read.mips == texture.mips);
+  PS_CHECK(read.type == foundation::TextureType::k2D);
+  PS_CHECK(read.format == foundation::TexelFormat::kRGBA);
+  PS_CHECK(read.compression == foundation::TextureCompressionType::kBC1);
+  PS_CHECK(read.srgb == true);
+
+  // Every mip starts at its offset, and the top mip is what the engine uploads
+  for (size_t i = 0; i < read.mip_offsets.size(); ++i)
+  {
+    PS_CHECK(read.pixel_data[read.mip_offsets[i]] == static_cast<byte>(i));
+  }
+
+  const engine::Texture engine_texture(glm::u32vec2(kWidth, kHeight), engine::TextureFormat::kBC1_UNORM_SRGB);
+  PS_CHECK(engine_texture.raw_data().size() == read.mip_offsets[1]);
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(StaleTexturePackageIsRejected)
+{
+  const foundation::TextureData texture = CreateTexture();
+
+  // Version 1 packages start with the pixel data and have no mip offsets or sRGB flag
+  foundation::BinaryWriter unversioned;
+  unversioned.Write(texture.pixel_data);
+  unversioned.Write(texture.width);
+  unversioned.Write(texture.height);
+  unversioned.Write(texture.depth);
+  unversioned.Write(texture.mips);
+  unversioned.Write(texture.type);
+  unversioned.Write(texture.format);
+  unversioned.Write(texture.compression);
+  PS_CHECK(ReadBack(unversioned).pixel_data.empty() == true);
+
+  foundation::BinaryWriter old_version;
+  foundation::WritePackageHeader(old_version, foundation::TextureData::kPackageMagic, 1);
+  old_version.Write(texture.pixel_data);
+  PS_CHECK(ReadBack(old_version).pixel_data.empty() == true);
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(BlockCompressedTextureSize)
+{
+  PS_CHECK(engine::GetBytesPerBlock(engine::TextureFormat::kR8G8B8A8_UNORM) == 0u);
+  PS_CHECK(engine::GetBytesPerBlock(engine::TextureFormat::kBC4_UNORM) == 8u);
+  PS_CHECK(engine::GetBytesPerBlock(engine::TextureFormat::kBC7_UNORM_SRGB) == 16u);
+
+  // Partial blocks at the edges take up a full block
+  PS_CHECK(engine::Texture(glm::u32vec2(5, 5), engine::TextureFormat::kBC1_UNORM).raw_data().size() == 4 * 8);
+  PS_CHECK(engine::Texture(glm::u32vec2(1, 1), engine::TextureFormat::kBC5_UNORM).raw_data().size() == 16);
+  PS_CHECK(engine::Texture(glm::u32vec2(8, 4), engine::TextureFormat::kR8G8B8A8_UNORM).raw_data().size() == 8 * 4 * 4);
+}
@@ -0,0 +1,341 @@
+#include "test/test.h"
+
+#include <foundation/math/transform_kernels.h>
+#include <foundation/containers/vector.h>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/matrix_decompose.hpp>
+
+#include <cstdlib>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kTransformCount = 1027; //!< Not a multiple of four, so the tail of the kernels is covered too
+  const float kTolerance = 1e-4f; //!< The maximum difference with the glm results
+
+  /**
+  * @struct <anonymous>::Transforms
+  * @brief Random transforms with the matrices glm builds for them
+  */
+  struct Transforms
+  {
+    foundation::Vector<glm::vec3> positions; //!< The translations
+    foundation::Vector<glm::quat> rotations; //!< The normalized rotations
+    foundation::Vector<glm::vec3> scales; //!< The positive scales
+    foundation::Vector<glm::mat4> matrices; //!< translation * rotation * scale, built by glm
+  };
+
+  //--------------------------------------------------------------------------
+  float Random(float min, float max)
+  {
+    return min + (max - min) * static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+  }
+
+  //--------------------------------------------------------------------------
+  Transforms CreateTransforms(size_t count)
+  {
+    srand(1);
+
+    Transforms transforms;
+    for (size_t i = 0; i < count; ++i)
+    {
+      const glm::vec3 position(Random(-100.0f, 100.0f), Random(-100.0f, 100.0f), Random(-100.0f, 100.0f));
+      const glm::quat rotation = glm::normalize(
+        glm::quat(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f)));
+      const glm::vec3 scale(Random(0.1f, 4.0f), Random(0.1f, 4.0f), Random(0.1f, 4.0f));
+
+      transforms.positions.push_back(position);
+      transforms.rotations.push_back(rotation);
+      transforms.scales.push_back(scale);
+      transforms.matrices.push_back(
+        glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale));
+    }
+
+    return transforms;
+  }
+
+  //--------------------------------------------------------------------------
+  foundation::PoseSoA CreatePose(size_t count)
+  {
+    foundation::PoseSoA pose;
+    pose.Resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      pose.Set(i,
+        glm::vec3(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f)),
+        glm::normalize(glm::quat(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f))),
+        glm::vec3(Random(0.5f, 2.0f), Random(0.5f, 2.0f), Random(0.5f, 2.0f)));
+    }
+    return pose;
+  }
+
+  //--------------------------------------------------------------------------
+  bool Equal(const foundation::PoseSoA& a, size_t a_index, const foundation::PoseSoA& b, size_t b_index)
+  {
+    return a.tx[a_index] == b.tx[b_index] && a.ty[a_index] == b.ty[b_index] && a.tz[a_index] == b.tz[b_index] &&
+      a.rx[a_index] == b.rx[b_index] && a.ry[a_index] == b.ry[b_index] &&
+      a.rz[a_index] == b.rz[b_index] && a.rw[a_index] == b.rw[b_index] &&
+      a.sx[a_index] == b.sx[b_index] && a.sy[a_index] == b.sy[b_index] && a.sz[a_index] == b.sz[b_index];
+  }
+
+  //--------------------------------------------------------------------------
+  bool Equal(const glm::mat4& a, const glm::mat4& b, float tolerance)
+  {
+    for (int column = 0; column < 4; ++column)
+    {
+      for (int row = 0; row < 4; ++row)
+      {
+        // Relative to the magnitude, translations are in the hundreds
+        const float magnitude = glm::max(1.0f, glm::abs(b[column][row]));
+        if (glm::abs(a[column][row] - b[column][row]) > tolerance * magnitude)
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(ComposeTransformsMatchesGlm)
+{
+  const Transforms transforms = CreateTransforms(kTransformCount);
+
+  foundation::Vector<glm::mat4> result(kTransformCount);
+  foundation::ComposeTransforms(transforms.positions.data(), transforms.rotations.data(),
+    transforms.scales.data(), result.data(), kTransformCount);
+
+  for (size_t i = 0; i < kTransformCount; ++i)
+  {
+    PS_CHECK(Equal(result[i], transforms.matrices[i], kTolerance));
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(InverseAffineMatchesGlm)
+{
+  const Transforms transforms = CreateTransforms(kTransformCount);
+
+  foundation::Vector<glm::mat4> result(kTransformCount);
+  foundation::InverseAffine(transforms.matrices.data(), result.data(), kTransformCount);
+
+  for (size_t i = 0; i < kTransformCount; ++i)
+  {
+    PS_CHECK(Equal(result[i], glm::inverse(transforms.matrices[i]), kTolerance));
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(DecomposeTransformsRoundTrips)
+{
+  const Transforms transforms = CreateTransforms(kTransformCount);
+
+  foundation::Vector<glm::vec3> positions(kTransformCount);
+  foundation::Vector<glm::quat> rotations(kTransformCount);
+  foundation::Vector<glm::vec3> scales(kTransformCount);
+  foundation::DecomposeTransforms(transforms.matrices.data(),
+    positions.data(), rotations.data(), scales.data(), kTransformCount);
+
+  for (size_t i = 0; i < kTransformCount; ++i)
+  {
+    PS_CHECK(glm::all(glm::epsilonEqual(positions[i], transforms.positions[i], kTolerance * 100.0f)));
+    PS_CHECK(glm::all(glm::epsilonEqual(scales[i], transforms.scales[i], kTolerance)));
+
+    // q and -q are the same rotation
+    PS_CHECK(glm::abs(glm::dot(rotations[i], transforms.rotations[i])) > 1.0f - kTolerance);
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(MultiplyAffineMatchesGlm)
+{
+  const Transforms transforms = CreateTransforms(kTransformCount);
+
+  for (size_t i = 0; i + 1 < kTransformCount; ++i)
+  {
+    glm::mat4 result;
+    foundation::MultiplyAffine(transforms.matrices[i], transforms.matrices[i + 1], result);
+    PS_CHECK(Equal(result, transforms.matrices[i] * transforms.matrices[i + 1], kTolerance));
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_BENCHMARK(TransformKernels)
+{
+  const Transforms transforms = CreateTransforms(kTransformCount);
+  foundation::Vector<glm::mat4> matrices(kTransformCount);
+  foundation::Vector<glm::vec3> positions(kTransformCount);
+  foundation::Vector<glm::quat> rotations(kTransformCount);
+  foundation::Vector<glm::vec3> scales(kTransformCount);
+  const size_t iterations = 1000;
+
+  test::Measure("compose 1027, glm", iterations, [&]()
+  {
+    for (size_t i = 0; i < kTransformCount; ++i)
+    {
+      matrices[i] = glm::translate(glm::mat4(1.0f), transforms.positions[i]) *
+        glm::mat4_cast(transforms.rotations[i]) *
+        glm::scale(glm::mat4(1.0f), transforms.scales[i]);
+    }
+    test::DoNotOptimize(matrices);
+  });
+
+  test::Measure("compose 1027, simd", iterations, [&]()
+  {
+    foundation::ComposeTransforms(transforms.positions.data(), transforms.rotations.data(),
+      transforms.scales.data(), matrices.data(), kTransformCount);
+    test::DoNotOptimize(matrices);
+  });
+
+  test::Measure("inverse 1027, glm", iterations, [&]()
+  {
+    for (size_t i = 0; i < kTransformCount; ++i)
+    {
+      matrices[i] = glm::inverse(transforms.matrices[i]);
+    }
+    test::DoNotOptimize(matrices);
+  });
+
+  test::Measure("inverse 1027, simd", iterations, [&]()
+  {
+    foundation::InverseAffine(transforms.matrices.data(), matrices.data(), kTransformCount);
+    test::DoNotOptimize(matrices);
+  });
+
+  test::Measure("decompose 1027, glm", iterations, [&]()
+  {
+    glm::vec3 skew;
+    glm::vec4 perspective;
+    for (size_t i = 0; i < kTransformCount; ++i)
+    {
+      glm::decompose(transforms.matrices[i], scales[i], rotations[i], positions[i], skew, perspective);
+    }
+    test::DoNotOptimize(positions);
+  });
+
+  test::Measure("decompose 1027, simd", iterations, [&]()
+  {
+    foundation::DecomposeTransforms(transforms.matrices.data(),
+      positions.data(), rotations.data(), scales.data(), kTransformCount);
+    test::DoNotOptimize(positions);
+  });
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(BlendPosesKeepsMaskedTransforms)
+{
+  srand(1);
+  const size_t count = 61;
+  const foundation::PoseSoA pose = CreatePose(count);
+  const foundation::PoseSoA other = CreatePose(count);
+
+  foundation::Vector<float> mask(pose.tx.size(), 0.0f);
+  for (size_t i = 0; i < count; i += 3)
+  {
+    mask[i] = 1.0f;
+  }
+
+  foundation::PoseSoA masked = pose;
+  foundation::BlendPoses(masked, other, 0.5f, mask.data());
+  foundation::PoseSoA blended = pose;
+  foundation::BlendPoses(blended, other, 0.5f);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    PS_CHECK(Equal(masked, i, mask[i] > 0.0f ? blended : pose, i));
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_BENCHMARK(PoseBlending)
+{
+  const size_t instance_count = 200;
+  const size_t layer_count = 4;
+  const size_t node_count = 60;
+  const size_t iterations = 100;
+  srand(1);
+
+  // Every layer animates a different part of the skeleton, the first one all of it
+  foundation::Vector<foundation::PoseSoA> poses;
+  foundation::Vector<foundation::Vector<float>> masks;
+  for (size_t i = 0; i < instance_count * (layer_count + 1); ++i)
+  {
+    poses.push_back(CreatePose(node_count));
+  }
+  for (size_t layer = 0; layer < layer_count; ++layer)
+  {
+    masks.push_back(foundation::Vector<float>(poses[0].tx.size(), 0.0f));
+    for (size_t i = 0; i < node_count; ++i)
+    {
+      masks.back()[i] = layer == 0 || i % layer_count == layer ? 1.0f : 0.0f;
+    }
+  }
+
+  const float weights[] = { 1.0f, 0.75f, 0.5f, 0.25f };
+  foundation::Vector<glm::vec3> positions(node_count);
+  foundation::Vector<glm::quat> rotations(node_count);
+  foundation::Vector<glm::vec3> scales(node_count);
+  foundation::Vector<glm::mat4> matrices(poses[0].tx.size());
+  foundation::PoseSoA pose;
+
+  test::Measure("4 layers x 200 instances, glm", iterations, [&]()
+  {
+    for (size_t instance = 0; instance < instance_count; ++instance)
+    {
+      const foundation::PoseSoA* layers = &poses[instance * (layer_count + 1)];
+      for (size_t i = 0; i < node_count; ++i)
+      {
+        positions[i] = glm::vec3(layers[0].tx[i], layers[0].ty[i], layers[0].tz[i]);
+        rotations[i] = glm::quat(layers[0].rw[i], layers[0].rx[i], layers[0].ry[i], layers[0].rz[i]);
+        scales[i] = glm::vec3(layers[0].sx[i], layers[0].sy[i], layers[0].sz[i]);
+      }
+
+      for (size_t layer = 0; layer < layer_count; ++layer)
+      {
+        const foundation::PoseSoA& other = layers[layer + 1];
+        for (size_t i = 0; i < node_count; ++i)
+        {
+          if (masks[layer][i] == 0.0f)
+          {
+            continue;
+          }
+
+          const float weight = weights[layer];
+          glm::quat rotation(other.rw[i], other.rx[i], other.ry[i], other.rz[i]);
+          rotation = glm::dot(rotations[i], rotation) < 0.0f ? -rotation : rotation;
+          positions[i] = glm::mix(positions[i], glm::vec3(other.tx[i], other.ty[i], other.tz[i]), weight);
+          rotations[i] = glm::normalize(rotations[i] * (1.0f - weight) + rotation * weight);
+          scales[i] = glm::mix(scales[i], glm::vec3(other.sx[i], other.sy[i], other.sz[i]), weight);
+        }
+      }
+
+      for (size_t i = 0; i < node_count; ++i)
+      {
+        matrices[i] = glm::translate(glm::mat4(1.0f), positions[i]) *
+          glm::mat4_cast(rotations[i]) *
+          glm::scale(glm::mat4(1.0f), scales[i]);
+      }
+      test::DoNotOptimize(matrices);
+    }
+  });
+
+  test::Measure("4 layers x 200 instances, simd", iterations, [&]()
+  {
+    for (size_t instance = 0; instance < instance_count; ++instance)
+    {
+      const foundation::PoseSoA* layers = &poses[instance * (layer_count + 1)];
+      pose = layers[0];
+      for (size_t layer = 0; layer < layer_count; ++layer)
+      {
+        foundation::BlendPoses(pose, layers[layer + 1], weights[layer], masks[layer].data());
+      }
+
+      foundation::ComposePose(pose, matrices.data());
+      test::DoNotOptimize(matrices);
+    }
+  });
+}
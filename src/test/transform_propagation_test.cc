@@ -0,0 +1,134 @@
+#include "test/test.h"
+
+#include <engine/systems/components/transform_system.h>
+#include <engine/core/entity_system.h>
+#include <foundation/containers/vector.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdlib>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kTransformCount = 600; //!< Wide enough for levels of several batches
+  const size_t kRootCount = 64; //!< The transforms that are never parented
+  const size_t kChangeCount = 20; //!< The transforms that move between propagations
+  const size_t kNoParent = PS_SIZE_MAX; //!< The parent of a transform without a parent
+  const float kTolerance = 1e-3f; //!< The maximum difference of the matrices
+
+  //--------------------------------------------------------------------------
+  float Random(float min, float max)
+  {
+    return min + (max - min) * static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+  }
+
+  //--------------------------------------------------------------------------
+  void Move(engine::TransformSystem& transform_system, engine::TransformComponent transform)
+  {
+    transform_system.SetLocalPosition(transform, glm::vec3(Random(-2.0f, 2.0f), Random(-2.0f, 2.0f), Random(-2.0f, 2.0f)));
+    transform_system.SetLocalRotation(transform, glm::normalize(
+      glm::quat(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f))));
+    transform_system.SetLocalScale(transform, glm::vec3(Random(0.8f, 1.2f)));
+  }
+
+  //--------------------------------------------------------------------------
+  bool Equal(const glm::mat4& a, const glm::mat4& b)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      if (glm::any(glm::greaterThan(glm::abs(a[i] - b[i]), glm::vec4(kTolerance))))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //--------------------------------------------------------------------------
+  bool MatchesHierarchy(engine::TransformSystem& transform_system,
+    const foundation::Vector<engine::TransformComponent>& transforms, const foundation::Vector<size_t>& parents)
+  {
+    // Parents are created before their children, so their expected matrix is known by the time a child is reached
+    foundation::Vector<glm::mat4> expected(transforms.size());
+    for (size_t i = 0; i < transforms.size(); ++i)
+    {
+      const glm::mat4 local = transform_system.GetLocal(transforms[i]);
+      expected[i] = parents[i] == kNoParent ? local : expected[parents[i]] * local;
+
+      // Views read the propagated matrix without cleaning it
+      const size_t index = transform_system.ViewIndex(transforms[i]);
+      if (Equal(transform_system.ViewAt(index).local_to_world, expected[i]) == false)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(PropagationMatchesTheHierarchy)
+{
+  srand(1);
+
+  engine::EntitySystem entity_system;
+  engine::TransformSystem transform_system;
+
+  foundation::Vector<engine::Entity> entities;
+  for (size_t i = 0; i < kTransformCount; ++i)
+  {
+    entities.push_back(entity_system.Create());
+  }
+
+  engine::HierarchyNode node;
+  node.parent = engine::HierarchyNode::kNoParent;
+  node.child_count = 0;
+  node.local_position = glm::vec3(0.0f);
+  node.local_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+  node.local_scale = glm::vec3(1.0f);
+
+  foundation::Vector<engine::TransformComponent> transforms(kTransformCount);
+  transform_system.CreateHierarchies(&node, 1, entities.data(), kTransformCount, nullptr, transforms.data());
+
+  // Every transform is parented to one that was created before it, which still has no parent of its own yet
+  foundation::Vector<size_t> parents(kTransformCount, kNoParent);
+  for (size_t i = kRootCount; i < kTransformCount; ++i)
+  {
+    parents[i] = static_cast<size_t>(rand()) % i;
+    transform_system.SetParent(transforms[i], transforms[parents[i]]);
+  }
+
+  for (size_t i = 0; i < kTransformCount; ++i)
+  {
+    Move(transform_system, transforms[i]);
+  }
+
+  transform_system.PropagateTransforms();
+  PS_CHECK(MatchesHierarchy(transform_system, transforms, parents) == true);
+
+  // Moving a transform invalidates its whole subtree
+  for (size_t i = 0; i < kChangeCount; ++i)
+  {
+    Move(transform_system, transforms[static_cast<size_t>(rand()) % kTransformCount]);
+  }
+  Move(transform_system, transforms[0]);
+
+  transform_system.PropagateTransforms();
+  PS_CHECK(MatchesHierarchy(transform_system, transforms, parents) == true);
+
+  // So does moving it to another parent
+  const size_t moved = kTransformCount / 2;
+  transform_system.UnsetParent(transforms[moved]);
+  parents[moved] = kNoParent;
+
+  transform_system.PropagateTransforms();
+  PS_CHECK(MatchesHierarchy(transform_system, transforms, parents) == true);
+
+  // Propagating without changes leaves the matrices as they are
+  transform_system.PropagateTransforms();
+  PS_CHECK(MatchesHierarchy(transform_system, transforms, parents) == true);
+
+  entity_system.OnTerminate();
+}
@@ -0,0 +1,119 @@
+#include "test/test.h"
+
+#include <engine/systems/components/transform_system.h>
+#include <engine/core/entity_system.h>
+#include <foundation/containers/vector.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace sulphur;
+
+namespace
+{
+  const size_t kTransformCount = 3; //!< The transforms that are re-ordered
+  const float kTolerance = 1e-4f; //!< The maximum difference of the matrices
+
+  //--------------------------------------------------------------------------
+  bool Equal(const glm::mat4& a, const glm::mat4& b)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      if (glm::any(glm::greaterThan(glm::abs(a[i] - b[i]), glm::vec4(kTolerance))))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  //--------------------------------------------------------------------------
+  foundation::Vector<engine::TransformComponent> CreateTransforms(
+    engine::TransformSystem& transform_system, const foundation::Vector<engine::Entity>& entities)
+  {
+    // Every transform is a hierarchy of its own, created the way entities are instantiated
+    engine::HierarchyNode node;
+    node.parent = engine::HierarchyNode::kNoParent;
+    node.child_count = 0;
+    node.local_position = glm::vec3(0.0f);
+    node.local_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    node.local_scale = glm::vec3(1.0f);
+
+    foundation::Vector<engine::TransformComponent> transforms(entities.size());
+    transform_system.CreateHierarchies(&node, 1, entities.data(), entities.size(), nullptr, transforms.data());
+    return transforms;
+  }
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(TransformLocalValuesAreKept)
+{
+  engine::EntitySystem entity_system;
+  engine::TransformSystem transform_system;
+
+  const foundation::Vector<engine::Entity> entities(1, entity_system.Create());
+  const engine::TransformComponent transform = CreateTransforms(transform_system, entities)[0];
+
+  // The local values are stored as they are set, instead of being decomposed from a matrix
+  const glm::vec3 position(1.0f, -2.0f, 3.5f);
+  const glm::quat rotation = glm::angleAxis(0.7f, glm::normalize(glm::vec3(1.0f, 2.0f, -1.0f)));
+  const glm::vec3 scale(2.0f, 0.5f, 3.0f);
+  transform_system.SetLocalPosition(transform, position);
+  transform_system.SetLocalRotation(transform, rotation);
+  transform_system.SetLocalScale(transform, scale);
+
+  PS_CHECK(transform_system.GetLocalPosition(transform) == position);
+  PS_CHECK(transform_system.GetLocalRotation(transform) == rotation);
+  PS_CHECK(transform_system.GetLocalScale(transform) == scale);
+
+  const glm::mat4 local = glm::translate(glm::mat4(1.0f), position) *
+    glm::mat4_cast(rotation) *
+    glm::scale(glm::mat4(1.0f), scale);
+  PS_CHECK(Equal(transform_system.GetLocal(transform), local));
+  PS_CHECK(Equal(transform_system.GetLocalToWorld(transform), local));
+  PS_CHECK(transform_system.GetWorldPosition(transform) == position);
+
+  entity_system.OnTerminate();
+}
+
+//--------------------------------------------------------------------------
+PS_TEST(TransformColdDataFollowsTheHandle)
+{
+  engine::EntitySystem entity_system;
+  engine::TransformSystem transform_system;
+
+  foundation::Vector<engine::Entity> entities;
+  for (size_t i = 0; i < kTransformCount; ++i)
+  {
+    entities.push_back(entity_system.Create());
+  }
+
+  const foundation::Vector<engine::TransformComponent> transforms = CreateTransforms(transform_system, entities);
+  for (size_t i = 0; i < kTransformCount; ++i)
+  {
+    transform_system.SetLocalPosition(transforms[i], glm::vec3(static_cast<float>(i), 0.0f, 0.0f));
+  }
+
+  // Parenting the last transform to the first moves it in front of the second in the hierarchy
+  transform_system.SetParent(transforms[2], transforms[0]);
+  PS_CHECK(transform_system.GetHierarchyIndex(transforms[0]) == 0);
+  PS_CHECK(transform_system.GetHierarchyIndex(transforms[2]) == 1);
+  PS_CHECK(transform_system.GetHierarchyIndex(transforms[1]) == 2);
+
+  for (size_t i = 0; i < kTransformCount; ++i)
+  {
+    PS_CHECK(transform_system.GetEntity(transforms[i]) == entities[i]);
+  }
+
+  // The cached inverse is rebuilt after the parent moves
+  PS_CHECK(Equal(transform_system.GetWorldToLocal(transforms[2]),
+    glm::inverse(transform_system.GetLocalToWorld(transforms[2]))));
+
+  transform_system.SetLocalRotation(transforms[0], glm::angleAxis(1.2f, glm::vec3(0.0f, 1.0f, 0.0f)));
+  transform_system.SetLocalPosition(transforms[0], glm::vec3(4.0f, 5.0f, 6.0f));
+  PS_CHECK(Equal(transform_system.GetWorldToLocal(transforms[2]),
+    glm::inverse(transform_system.GetLocalToWorld(transforms[2]))));
+  PS_CHECK(Equal(transform_system.GetLocalToWorld(transforms[2]),
+    transform_system.GetLocalToWorld(transforms[0]) * transform_system.GetLocal(transforms[2])));
+
+  entity_system.OnTerminate();
+}
@@ -161,6 +161,10 @@ namespace sulphur
                 << Application::package_dir().GetAbsolutePath().GetString().c_str()
                 << "\n";
 
+      std::cout << "--report <file>\n"
+                << "can be combined with any command when running from the command line. \n"
+                << "writes the time, cpu time, bytes in and out and peak memory per asset and per build stage to <file> as json \n";
+
       std::cout << std::endl;
 
       for (ICommand* command : registered_commands_)
@@ -3,6 +3,7 @@
 #include "tools/builder/shared/application.h"
 #include "tools/builder/pipelines/shader_pipeline_options.h"
 #include "tools/builder/shared/file_system.h"
+#include "tools/builder/shared/build_report.h"
 #include "tools/builder/pipelines/model_pipeline.h"
 #include "tools/builder/pipelines/shader_pipeline.h"
 #include "tools/builder/pipelines/mesh_pipeline.h"
@@ -38,6 +39,8 @@ namespace sulphur
         VertexShaderFlag,
         PixelShaderFlag,
         SingleFlag,
+        QuantizeFlag,
+        CompressAnimationFlag,
         OutputLocationFlag>();
       HasParameter<DirFlag>(true);
       HasParameter<FileFlag>(true);
@@ -49,6 +52,8 @@ namespace sulphur
       IsOptional<DirFlag>(true);
       IsOptional<RecursiveFlag>(true);
       IsOptional<SingleFlag>(true);
+      IsOptional<QuantizeFlag>(true);
+      IsOptional<CompressAnimationFlag>(true);
       IsOptional<OutputLocationFlag>(true);
       IsOptional<FileFlag>(true);
     }
@@ -64,6 +69,10 @@ namespace sulphur
 
       model_pipeline_->PackageDefaultAssets();
       mesh_pipeline_->PackageDefaultAssets();
+
+      mesh_pipeline_->set_vertex_encoding(input.HasFlag<QuantizeFlag>() == true ?
+        foundation::VertexEncoding::kQuantized : foundation::VertexEncoding::kFloat);
+      SetAnimationCompression(input.HasFlag<CompressAnimationFlag>());
       skeleton_pipeline_->PackageDefaultAssets();
       material_pipeline_->PackageDefaultAssets();
       texture_pipeline_->PackageDefaultAssets();
@@ -172,6 +181,9 @@ namespace sulphur
       {
         ResetOutputLocation();
       }
+
+      mesh_pipeline_->set_vertex_encoding(foundation::VertexEncoding::kFloat);
+      SetAnimationCompression(false);
     }
 
     //--------------------------------------------------------------------------
@@ -186,6 +198,8 @@ namespace sulphur
         "   [opt]-single                 forces the model to be interpreted as a single mesh \n"
         "                                if not specified -file must be specified. cannot be combined with -file flag \n"
         "   [opt]-r                      search the directory specified with -dir flag recursivly i.e. also go through subfolders \n"
+        "   [opt]-quantize               quantize the vertex data of the packaged meshes. halves the size of the mesh packages \n"
+        "   [opt]-compress_anim          compress the keyframes of the packaged animations within the default error tolerances \n"
         "   [opt]-output <path>          path where to put the generated cache file and the folder containing the processed assets \n"
         "                                if not specified working directory will be used \n"
         "                                if specified it is assumed that the vertex and pixel shader specified with the -vertex and -pixel flag are compiled to caches allready located at the given output path \n";
@@ -368,6 +382,37 @@ namespace sulphur
 
       texture_pipeline_->PackageDefaultAssets();
 
+      TextureCompressionSettings settings = {};
+      settings.generate_mips = input.HasFlag<MipMapFlag>();
+      if (input.HasFlag<CompressionTypeFlag>() == true)
+      {
+        settings.compress = true;
+
+        const foundation::String usage = input.GetFlagArg<CompressionTypeFlag>();
+        if (usage == "albedo")
+        {
+          settings.usage = TextureUsage::kAlbedo;
+        }
+        else if (usage == "normal")
+        {
+          settings.usage = TextureUsage::kNormal;
+        }
+        else if (usage == "mask")
+        {
+          settings.usage = TextureUsage::kMask;
+        }
+        else if (usage == "hdr")
+        {
+          settings.usage = TextureUsage::kHDR;
+        }
+        else if (usage.empty() == false && usage != "auto")
+        {
+          PS_LOG_BUILDER(Warning, "Unknown texture usage %s. Deducing the usage per texture.", 
+            usage.c_str());
+        }
+      }
+      texture_pipeline_->set_compression_settings(settings);
+
       foundation::TextureAsset out;
       eastl::function<bool(const foundation::String&)> func =
         [this, &out](const foundation::Path& file)
@@ -378,7 +423,8 @@ namespace sulphur
           extension != "tga" &&
           extension != "bmp" &&
           extension != "dds" &&
-          extension != "jpg")
+          extension != "jpg" &&
+          extension != "hdr")
         {
           return false;
         }
@@ -413,19 +459,22 @@ namespace sulphur
       {
         ResetOutputLocation();
       }
+
+      texture_pipeline_->set_compression_settings(TextureCompressionSettings());
     }
 
     //--------------------------------------------------------------------------
     const char* ConvertTextures::GetDescription() const
     {
-      return "convert textures from *.png, *.jpeg, *.tga, *.bmp \n"
+      return "convert textures from *.png, *.jpeg, *.tga, *.bmp, *.dds, *.hdr \n"
         "to an engine readable format \n"
         "   [opt]-dir<path>              convert all textures located in working directory \n"
         "   [opt]-r                      search the working directory recursivly i.e. also go through subfolders \n"
         "                                can only be used in combination with -dir flag \n"
         "   [opt]-file<name>,<name>...   convert single files located in the directory specified with -dir every file must be delimitied with a ',' \n"
-        "   [opt]-mipmap                 enable mipmaps \n"
-        "   [opt]-compression<type>      set compression type. types: Block, NormalMap \n"
+        "   [opt]-mipmap                 generate a gamma correct, kaiser filtered mip chain \n"
+        "   [opt]-compr<usage>           block compress the textures. usages: auto, albedo (BC1/BC3), normal (BC5), mask (BC4/BC7), hdr (BC6) \n"
+        "                                auto deduces the usage per texture from its name and pixel data \n"
         "   [opt]-output <path>          path where to put the generated cache file and the folder containing the processed assets \n"
         "                                if not specified working directory will be used";
     }
@@ -437,6 +486,7 @@ namespace sulphur
       SetValidFlags<DirFlag,
         FileFlag,
         RecursiveFlag,
+        CompressAnimationFlag,
         OutputLocationFlag>();
       AllowMultipleOccurances<DirFlag>(true);
 
@@ -447,6 +497,7 @@ namespace sulphur
       IsOptional<DirFlag>(true);
       IsOptional<FileFlag>(true);
       IsOptional<RecursiveFlag>(true);
+      IsOptional<CompressAnimationFlag>(true);
       IsOptional<OutputLocationFlag>(true);
     }
 
@@ -459,6 +510,7 @@ namespace sulphur
         "   [opt]-r                      search the working directory recursivly i.e. also go through subfolders \n"
         "                                can only be used in combination with -dir flag \n"
         "   [opt]-file<name>,<name>...   convert single files located in the directory specified with -dir every file must be delimitied with a ',' \n"
+        "   [opt]-compress_anim          compress the keyframes within the default error tolerances \n"
         "   [opt]-output <path>          path where to put the generated cache file and the folder containing the processed assets \n"
         "                                if not specified working directory will be used";
     }
@@ -564,6 +616,7 @@ namespace sulphur
       }
 
       animation_pipeline_->PackageDefaultAssets();
+      SetAnimationCompression(input.HasFlag<CompressAnimationFlag>());
 
       foundation::Vector<foundation::AnimationAsset> out;
       eastl::function<bool(const foundation::String&)> func =
@@ -608,6 +661,8 @@ namespace sulphur
       {
         ResetOutputLocation();
       }
+
+      SetAnimationCompression(false);
     }
 
 
@@ -863,6 +918,7 @@ namespace sulphur
       options.additional_include_dirs = { "./include/" };
       for (size_t i = 0; i < shaders.size(); ++i)
       {
+        BuildReport::AssetScope asset(shaders[i]);
         foundation::ShaderAsset shader = {};
         if (shader_pipeline_->Create(shaders[i], options, shader) == false)
         {
@@ -882,6 +938,7 @@ namespace sulphur
       // handle all other assets
       for (int i = 0; i < rest.size(); ++i)
       {
+        BuildReport::AssetScope asset(rest[i]);
         foundation::String extension = files[i].GetFileExtension();
 
         if (extension == "obj" ||
@@ -967,7 +1024,8 @@ namespace sulphur
           extension == "tga" ||
           extension == "bmp" ||
           extension == "dds" ||
-          extension == "jpg")
+          extension == "jpg" ||
+          extension == "hdr")
         {
           foundation::TextureAsset texture = {};
           if (texture_pipeline_->Create(rest[i], texture) == false)
@@ -1054,6 +1112,7 @@ namespace sulphur
 
         for (const foundation::Path& file : files)
         {
+          BuildReport::AssetScope asset(file.GetString());
           func(file.GetString());
         }
       }
@@ -1124,6 +1183,7 @@ namespace sulphur
 
       for (const foundation::String& file : files)
       {
+        BuildReport::AssetScope asset(file);
         func(file);
       }
     }
@@ -1171,6 +1231,14 @@ namespace sulphur
       audio_pipeline_->SetOutputLocation("");
     }
 
+    //--------------------------------------------------------------------------
+    void Convert::SetAnimationCompression(bool compress)
+    {
+      AnimationCompressionSettings settings = {};
+      settings.compress = compress;
+      animation_pipeline_->set_compression_settings(settings);
+    }
+
     //--------------------------------------------------------------------------
     const char* Convert::GetDescription() const
     {
@@ -64,6 +64,12 @@ namespace sulphur
       *@remark this also changes the package output location
       */
       void ResetOutputLocation();
+
+      /**
+      *@brief enable or disable keyframe compression of the packaged animations
+      *@param[in] compress (bool) whether to compress the keyframes using the default error tolerances
+      */
+      void SetAnimationCompression(bool compress);
     };
 
     /**
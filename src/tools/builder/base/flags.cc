@@ -81,6 +81,20 @@ namespace sulphur
     {
       return "geom";
     }
+
+    //-----------------------------------------------------------------------------------------------
+    const char* QuantizeFlag::GetKey() const
+    {
+      return "quantize";
+    }
+
+    //-----------------------------------------------------------------------------------------------
+    const char* CompressAnimationFlag::GetKey() const
+    {
+      return "compress_anim";
+    }
+
+    //-----------------------------------------------------------------------------------------------
     const char* OutputLocationFlag::GetKey() const
     {
       return "output";
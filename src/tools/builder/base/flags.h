@@ -174,6 +174,30 @@ namespace sulphur
       const char* GetKey() const override;
     };
 
+    /**
+    *@struct sulphur::builder::QuantizeFlag : sulphur::builder::Flag
+    *@brief flag specifying that vertex data should be quantized when packaging meshes
+    */
+    struct QuantizeFlag : public Flag
+    {
+      /**
+      *@see sulphur::builder::Flag::GetKey
+      */
+      const char* GetKey() const override;
+    };
+
+    /**
+    *@struct sulphur::builder::CompressAnimationFlag : sulphur::builder::Flag
+    *@brief flag specifying that keyframes should be compressed when packaging animations
+    */
+    struct CompressAnimationFlag : public Flag
+    {
+      /**
+      *@see sulphur::builder::Flag::GetKey
+      */
+      const char* GetKey() const override;
+    };
+
     /**
     *@struct sulphur::builder::OutputLocationFlag : sulphur::builder::Flag
     *@brief flag specifying the output directory
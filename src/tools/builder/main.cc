@@ -2,6 +2,7 @@
 #include "tools/builder/shared/Application.h"
 #include "tools/builder/base/common_commands.h"
 #include "tools/builder/base/convert_commands.h"
+#include "tools/builder/shared/build_report.h"
 
 #include "tools/builder/pipelines/model_pipeline.h"
 #include "tools/builder/pipelines/mesh_pipeline.h"
@@ -14,6 +15,8 @@
 #include "tools/builder/pipelines/audio_pipeline.h"
 
 #include <foundation/memory/memory.h>
+
+#include <cstring>
 using namespace sulphur::builder;
 
 //-----------------------------------------------------------------------------------------------
@@ -76,14 +79,25 @@ int main(int argc, char** argv)
       sulphur::foundation::String command_line = "";
       for (int i = 1; i < argc; ++i)
       {
+        // --report <file> can be combined with any command
+        if (strcmp(argv[i], "--report") == 0 && i + 1 < argc)
+        {
+          BuildReport::Enable(argv[++i]);
+          continue;
+        }
 
-        command_line += argv[i];
-        if (i != argc - 1)
+        if (command_line.empty() == false)
         {
           command_line += " ";
         }
+        command_line += argv[i];
       }
       system.ExecuteCommandLine(command_line.c_str());
+
+      if (BuildReport::enabled() == true)
+      {
+        BuildReport::Save();
+      }
     }
     else
     {
@@ -1,17 +1,354 @@
 #include "tools/builder/pipelines/animation_pipeline.h"
+#include "tools/builder/shared/build_report.h"
 #include "tools/builder/pipelines/scene_loader.h"
 #include <foundation/pipeline-assets/animation.h>
 #include <assimp/scene.h>
+#include <EASTL/algorithm.h>
+#include <cfloat>
 
 namespace sulphur 
 {
   namespace builder 
   {
+    namespace
+    {
+      /**
+       * @struct sulphur::builder::<anonymous>::KeySet
+       * @brief Keys of a single track, split in timestamps and values.
+       * @tparam T The type of the key values.
+       */
+      template<typename T>
+      struct KeySet
+      {
+        foundation::AnimationTrackFormat format = 
+          foundation::AnimationTrackFormat::kKeyframes; //!< How the keys should be stored.
+        float start_time = 0.0f;        //!< Time of the first key when the format is kUniform.
+        float sample_interval = 0.0f;   //!< Time between keys when the format is kUniform.
+        foundation::Vector<float> times; //!< Key timestamps.
+        foundation::Vector<T> values;    //!< Key values.
+      };
+
+      //--------------------------------------------------------------------------------
+      glm::vec3 Interpolate(const glm::vec3& a, const glm::vec3& b, float t)
+      {
+        return glm::mix(a, b, t);
+      }
+
+      //--------------------------------------------------------------------------------
+      glm::quat Interpolate(const glm::quat& a, const glm::quat& b, float t)
+      {
+        return glm::slerp(a, b, t);
+      }
+
+      //--------------------------------------------------------------------------------
+      float Difference(const glm::vec3& a, const glm::vec3& b)
+      {
+        const glm::vec3 delta = glm::abs(a - b);
+        return glm::max(delta.x, glm::max(delta.y, delta.z));
+      }
+
+      //--------------------------------------------------------------------------------
+      float Difference(const glm::quat& a, const glm::quat& b)
+      {
+        const float dot = glm::min(glm::abs(glm::dot(a, b)), 1.0f);
+        return 2.0f * glm::acos(dot);
+      }
+
+      //--------------------------------------------------------------------------------
+      glm::vec3 Quantize(const glm::vec3& value)
+      {
+        return value;
+      }
+
+      //--------------------------------------------------------------------------------
+      glm::quat Quantize(const glm::quat& value)
+      {
+        return foundation::QuantizedQuaternion::Encode(value).Decode();
+      }
+
+      /**
+       * @brief Samples a set of keys the way the runtime samples a track.
+       * @param[in] keys (const KeySet<T>&) The keys to sample.
+       * @param[in] time (float) The time to sample at.
+       * @return (T) The sampled value, clamped to the first and last key.
+       */
+      template<typename T>
+      T Sample(const KeySet<T>& keys, float time)
+      {
+        if (keys.values.size() == 1 || 
+          keys.format == foundation::AnimationTrackFormat::kConstant)
+        {
+          return keys.values[0];
+        }
+
+        if (keys.format == foundation::AnimationTrackFormat::kUniform)
+        {
+          const float position = (time - keys.start_time) / keys.sample_interval;
+          if (position <= 0.0f)
+          {
+            return keys.values.front();
+          }
+          if (position >= static_cast<float>(keys.values.size() - 1))
+          {
+            return keys.values.back();
+          }
+
+          const size_t index = static_cast<size_t>(position);
+          return Interpolate(keys.values[index], keys.values[index + 1], 
+            position - static_cast<float>(index));
+        }
+
+        const float* next = eastl::upper_bound(keys.times.begin(), keys.times.end(), time);
+        if (next == keys.times.begin())
+        {
+          return keys.values.front();
+        }
+        if (next == keys.times.end())
+        {
+          return keys.values.back();
+        }
+
+        const size_t index = static_cast<size_t>(next - keys.times.begin()) - 1;
+        const float factor = (time - keys.times[index]) /
+          (keys.times[index + 1] - keys.times[index]);
+        return Interpolate(keys.values[index], keys.values[index + 1], factor);
+      }
+
+      /**
+       * @brief Removes keys that can be reconstructed from their neighbours within tolerance.
+       * @param[in] source (const KeySet<T>&) The original keys.
+       * @param[in] tolerance (float) The maximum error allowed.
+       * @return (KeySet<T>) The keys that have to be stored.
+       * @remark The first and last key are always kept.
+       */
+      template<typename T>
+      KeySet<T> ReduceKeys(const KeySet<T>& source, float tolerance)
+      {
+        KeySet<T> result;
+        const size_t count = source.values.size();
+
+        size_t anchor = 0;
+        result.times.push_back(source.times[anchor]);
+        result.values.push_back(source.values[anchor]);
+
+        while (anchor < count - 1)
+        {
+          // Extend the segment as far as the keys in between can be interpolated
+          size_t end = anchor + 1;
+          while (end + 1 < count)
+          {
+            const size_t candidate = end + 1;
+            const T start_value = Quantize(source.values[anchor]);
+            const T end_value = Quantize(source.values[candidate]);
+            const float duration = source.times[candidate] - source.times[anchor];
+
+            bool fits = true;
+            for (size_t i = anchor + 1; i < candidate && fits == true; ++i)
+            {
+              const float factor = (source.times[i] - source.times[anchor]) / duration;
+              fits = Difference(Interpolate(start_value, end_value, factor),
+                source.values[i]) <= tolerance;
+            }
+
+            if (fits == false)
+            {
+              break;
+            }
+
+            end = candidate;
+          }
+
+          result.times.push_back(source.times[end]);
+          result.values.push_back(source.values[end]);
+          anchor = end;
+        }
+
+        return result;
+      }
+
+      /**
+       * @brief Resamples the keys at a fixed interval so their timestamps can be dropped.
+       * @param[in] source (const KeySet<T>&) The original keys.
+       * @param[in] tolerance (float) The maximum error allowed.
+       * @param[out] result (KeySet<T>&) The resampled keys.
+       * @return (bool) False when the resampled keys exceed the tolerance.
+       */
+      template<typename T>
+      bool Resample(const KeySet<T>& source, float tolerance, KeySet<T>& result)
+      {
+        float interval = FLT_MAX;
+        for (size_t i = 1; i < source.times.size(); ++i)
+        {
+          const float delta = source.times[i] - source.times[i - 1];
+          if (delta > 0.0f)
+          {
+            interval = glm::min(interval, delta);
+          }
+        }
+
+        const float duration = source.times.back() - source.times.front();
+        if (interval == FLT_MAX || duration <= 0.0f)
+        {
+          return false;
+        }
+
+        const size_t count = static_cast<size_t>(glm::round(duration / interval)) + 1;
+        result.format = foundation::AnimationTrackFormat::kUniform;
+        result.start_time = source.times.front();
+        result.sample_interval = duration / static_cast<float>(count - 1);
+        result.times.clear();
+        result.values.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+          result.values[i] = Sample(source, 
+            result.start_time + static_cast<float>(i) * result.sample_interval);
+        }
+
+        // Both tracks are piecewise interpolated, so the error peaks at the keys of either
+        KeySet<T> stored = result;
+        for (T& value : stored.values)
+        {
+          value = Quantize(value);
+        }
+
+        for (size_t i = 0; i < source.values.size(); ++i)
+        {
+          if (Difference(Sample(stored, source.times[i]), source.values[i]) > tolerance)
+          {
+            return false;
+          }
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+          if (Difference(stored.values[i], result.values[i]) > tolerance)
+          {
+            return false;
+          }
+        }
+
+        return true;
+      }
+
+      /**
+       * @brief Picks the smallest representation of a track that stays within tolerance.
+       * @param[in] source (const KeySet<T>&) The original keys.
+       * @param[in] tolerance (float) The maximum error allowed.
+       * @param[in] value_size (size_t) The size of a single stored value in bytes.
+       * @return (KeySet<T>) The keys to store, not yet quantized.
+       */
+      template<typename T>
+      KeySet<T> CompressKeys(const KeySet<T>& source, float tolerance, size_t value_size)
+      {
+        if (source.values.empty() == true)
+        {
+          return source;
+        }
+
+        const T constant = Quantize(source.values[0]);
+        bool is_constant = true;
+        for (size_t i = 0; i < source.values.size() && is_constant == true; ++i)
+        {
+          is_constant = Difference(constant, source.values[i]) <= tolerance;
+        }
+
+        if (is_constant == true)
+        {
+          KeySet<T> result;
+          result.format = foundation::AnimationTrackFormat::kConstant;
+          result.values.push_back(source.values[0]);
+          return result;
+        }
+
+        KeySet<T> reduced = ReduceKeys(source, tolerance);
+        KeySet<T> uniform;
+        if (Resample(source, tolerance, uniform) == true &&
+          uniform.values.size() * value_size <
+          reduced.values.size() * (value_size + sizeof(float)))
+        {
+          return uniform;
+        }
+
+        return reduced;
+      }
+
+      //--------------------------------------------------------------------------------
+      KeySet<glm::vec3> ToKeySet(const foundation::Vector<foundation::AnimationVectorKey>& keys)
+      {
+        KeySet<glm::vec3> result;
+        result.times.reserve(keys.size());
+        result.values.reserve(keys.size());
+        for (const foundation::AnimationVectorKey& key : keys)
+        {
+          result.times.push_back(key.time);
+          result.values.push_back(key.vector);
+        }
+        return result;
+      }
+
+      //--------------------------------------------------------------------------------
+      KeySet<glm::quat> ToKeySet(const foundation::Vector<foundation::AnimationQuaternionKey>& keys)
+      {
+        KeySet<glm::quat> result;
+        result.times.reserve(keys.size());
+        result.values.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+          glm::quat value = glm::normalize(keys[i].quaternion);
+          // Keep neighbouring keys in the same hemisphere so they interpolate the short way
+          if (i > 0 && glm::dot(value, result.values.back()) < 0.0f)
+          {
+            value = -value;
+          }
+          result.times.push_back(keys[i].time);
+          result.values.push_back(value);
+        }
+        return result;
+      }
+
+      //--------------------------------------------------------------------------------
+      foundation::AnimationVectorTrack CompressTrack(
+        const foundation::Vector<foundation::AnimationVectorKey>& keys, float tolerance)
+      {
+        KeySet<glm::vec3> compressed = 
+          CompressKeys(ToKeySet(keys), tolerance, sizeof(glm::vec3));
+
+        foundation::AnimationVectorTrack track;
+        track.format = compressed.format;
+        track.start_time = compressed.start_time;
+        track.sample_interval = compressed.sample_interval;
+        track.times = eastl::move(compressed.times);
+        track.values = eastl::move(compressed.values);
+        return track;
+      }
+
+      //--------------------------------------------------------------------------------
+      foundation::AnimationRotationTrack CompressTrack(
+        const foundation::Vector<foundation::AnimationQuaternionKey>& keys, float tolerance)
+      {
+        KeySet<glm::quat> compressed = CompressKeys(ToKeySet(keys), tolerance, 
+          sizeof(foundation::QuantizedQuaternion));
+
+        foundation::AnimationRotationTrack track;
+        track.format = compressed.format;
+        track.start_time = compressed.start_time;
+        track.sample_interval = compressed.sample_interval;
+        track.times = eastl::move(compressed.times);
+        track.values.reserve(compressed.values.size());
+        for (const glm::quat& value : compressed.values)
+        {
+          track.values.push_back(foundation::QuantizedQuaternion::Encode(value));
+        }
+        return track;
+      }
+    }
+
     //--------------------------------------------------------------------------------
     bool AnimationPipeline::Create(const foundation::Path& file,
       SceneLoader& scene_loader,
       foundation::Vector<foundation::AnimationAsset>& animations)
     {
+      BuildReport::StageScope stage(BuildStage::kCreate, "animation");
       if (ValidatePath(file) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -23,7 +360,9 @@ namespace sulphur
       foundation::Path file_path = file.is_relative_path() ? project_dir() + file : file;
 
 
-      const aiScene* scene = scene_loader.LoadScene(file_path);
+      SceneHandle scene_handle = 
+        scene_loader.LoadScene(file_path, SceneLoader::kAnimationPostProcess);
+      const aiScene* scene = scene_handle.get();
       if (scene == nullptr)
       {
         PS_LOG_BUILDER(Error,
@@ -115,6 +454,7 @@ namespace sulphur
     bool AnimationPipeline::PackageAnimation(const foundation::Path& asset_origin,
       foundation::AnimationAsset& animation)
     {
+      BuildReport::StageScope stage(BuildStage::kPackage, "animation");
       if (ValidatePath(asset_origin) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -148,11 +488,16 @@ namespace sulphur
         return false;
       }
 
+      if (compression_settings_.compress == true)
+      {
+        Compress(animation.data);
+      }
+
       foundation::BinaryWriter writer(output_file);
 
       writer.Write(animation.data);
 
-      if (writer.SaveCompressed(foundation::CompressionType::kHighCompression) == false)
+      if (SaveCompressed(writer, output_file) == false)
       {
         PS_LOG_BUILDER(Error,
           "Failed to package animation.");
@@ -162,6 +507,53 @@ namespace sulphur
       return true;
     }
 
+    //--------------------------------------------------------------------------------
+    void AnimationPipeline::set_compression_settings(const AnimationCompressionSettings& settings)
+    {
+      compression_settings_ = settings;
+    }
+
+    //--------------------------------------------------------------------------------
+    const AnimationCompressionSettings& AnimationPipeline::compression_settings() const
+    {
+      return compression_settings_;
+    }
+
+    //--------------------------------------------------------------------------------
+    void AnimationPipeline::Compress(foundation::AnimationData& animation) const
+    {
+      size_t original_keys = 0;
+      size_t stored_keys = 0;
+
+      for (foundation::AnimationChannel& channel : animation.channels)
+      {
+        if (channel.compressed == true)
+        {
+          continue;
+        }
+
+        channel.position_track = CompressTrack(channel.position_keys,
+          compression_settings_.position_tolerance);
+        channel.rotation_track = CompressTrack(channel.rotation_keys,
+          compression_settings_.rotation_tolerance);
+        channel.scale_track = CompressTrack(channel.scale_keys,
+          compression_settings_.scale_tolerance);
+
+        original_keys += channel.position_keys.size() + 
+          channel.rotation_keys.size() + channel.scale_keys.size();
+        stored_keys += channel.position_track.values.size() +
+          channel.rotation_track.values.size() + channel.scale_track.values.size();
+
+        channel.compressed = true;
+        channel.position_keys.clear();
+        channel.rotation_keys.clear();
+        channel.scale_keys.clear();
+      }
+
+      PS_LOG_BUILDER(Info, "Compressed animation keys from %u to %u.", 
+        static_cast<unsigned int>(original_keys), static_cast<unsigned int>(stored_keys));
+    }
+
     //--------------------------------------------------------------------------------
     foundation::String AnimationPipeline::GetPackageExtension() const
     {
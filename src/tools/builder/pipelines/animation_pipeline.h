@@ -18,6 +18,20 @@ namespace sulphur
   {
     class SceneLoader;
 
+    /**
+     * @struct sulphur::builder::AnimationCompressionSettings
+     * @brief Settings used to compress the keyframes of packaged animations.
+     * @remark Rotations are always quantized to 48 bits when compression is enabled.
+     * The quantization error is included when checking the rotation tolerance.
+     */
+    struct AnimationCompressionSettings
+    {
+      bool compress = false;            //!< Compress the keyframes when packaging animations.
+      float position_tolerance = 0.001f; //!< Maximum position error in model units.
+      float rotation_tolerance = 0.005f; //!< Maximum rotation error in radians.
+      float scale_tolerance = 0.001f;    //!< Maximum scale error per axis.
+    };
+
     /**
      * @class sulphur::builder::AnimationPipeline : sulphur::builder::PipelineBase
      * @brief Pipeline that handles the creation, packaging and management of animations.
@@ -52,6 +66,18 @@ namespace sulphur
       bool PackageAnimation(const foundation::Path& asset_origin,
         foundation::AnimationAsset& animation);
 
+      /**
+       * @brief Sets the settings used to compress the keyframes of packaged animations.
+       * @param[in] settings (const sulphur::builder::AnimationCompressionSettings&) 
+       * The compression settings.
+       */
+      void set_compression_settings(const AnimationCompressionSettings& settings);
+      /**
+       * @return (const sulphur::builder::AnimationCompressionSettings&) 
+       * The settings used to compress the keyframes of packaged animations.
+       */
+      const AnimationCompressionSettings& compression_settings() const;
+
       /**
        * @see sulphur::builder::PipelineBase::GetPackageExtension
        */
@@ -61,6 +87,15 @@ namespace sulphur
        * @see sulphur::builder::PipelineBase::GetCacheName
        */
       foundation::String GetCacheName() const override; 
+
+    private:
+      /**
+       * @brief Replaces the keys of every channel with compressed tracks.
+       * @param[in] animation (sulphur::foundation::AnimationData&) The animation to compress.
+       */
+      void Compress(foundation::AnimationData& animation) const;
+
+      AnimationCompressionSettings compression_settings_; //!< The settings used to compress packaged animations.
     };
   }
 }
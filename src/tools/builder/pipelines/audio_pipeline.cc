@@ -1,4 +1,5 @@
 #include "tools/builder/pipelines/audio_pipeline.h"
+#include "tools/builder/shared/build_report.h"
 #include <foundation/pipeline-assets/audio.h>
 
 namespace sulphur 
@@ -8,6 +9,7 @@ namespace sulphur
     //--------------------------------------------------------------------------------
     bool AudioPipeline::Create(const foundation::Path& file, foundation::AudioBankAsset& bank) const
     {
+      BuildReport::StageScope stage(BuildStage::kCreate, "audio");
       if (ValidatePath(file) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -54,6 +56,7 @@ namespace sulphur
     bool AudioPipeline::PackageAudioBank(const foundation::Path& asset_origin,
       foundation::AudioBankAsset& bank)
     {
+      BuildReport::StageScope stage(BuildStage::kPackage, "audio");
       if (ValidatePath(asset_origin) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -91,7 +94,7 @@ namespace sulphur
 
       writer.Write(bank.data);
 
-      if (writer.SaveCompressed(foundation::CompressionType::kHighCompression) == false)
+      if (SaveCompressed(writer, output_file) == false)
       {
         PS_LOG_BUILDER(Error,
           "Failed to package audio bank %s.", bank.name.GetCString());
@@ -1,4 +1,5 @@
 #include "tools/builder/pipelines/material_pipeline.h"
+#include "tools/builder/shared/build_report.h"
 #include "tools/builder/pipelines/texture_pipeline.h"
 #include "tools/builder/pipelines/shader_pipeline.h"
 #include "tools/builder/shared/util.h"
@@ -25,6 +26,7 @@ namespace sulphur
       const foundation::AssetName& pixel_shader,
       foundation::Vector<foundation::MaterialAsset>& materials) const
     {
+      BuildReport::StageScope stage(BuildStage::kCreate, "material");
       if (scene == nullptr)
       {
         PS_LOG_BUILDER(Error, 
@@ -343,7 +345,8 @@ namespace sulphur
         foundation::ModelTextureCache& texture_cache, 
         TexturePipeline& texture_pipeline, 
         const aiMaterial* ai_mat, 
-        aiTextureType texture_type)
+        aiTextureType texture_type,
+        TextureUsage usage)
       {
         if (ai_mat->GetTextureCount(texture_type) > 0)
         {
@@ -356,7 +359,7 @@ namespace sulphur
             texture_cache.texture_lookup.end())
           {
             foundation::TextureAsset texture = {};
-            if (texture_pipeline.Create(texture_filepath, texture) == true)
+            if (texture_pipeline.Create(texture_filepath, texture, usage) == true)
             {
               texture_cache.textures.push_back(eastl::move(texture));
               texture_cache.texture_lookup[texture_filepath] = 
@@ -372,19 +375,19 @@ namespace sulphur
 
         // Get albedo texture
         create_texture_func(scene_directory, texture_cache, texture_pipeline, ai_mat, 
-          aiTextureType_DIFFUSE);
+          aiTextureType_DIFFUSE, TextureUsage::kAlbedo);
 
         // Get normal texture
         create_texture_func(scene_directory, texture_cache, texture_pipeline, ai_mat,
-          aiTextureType_NORMALS);
+          aiTextureType_NORMALS, TextureUsage::kNormal);
 
         // Get metallic texture
         create_texture_func(scene_directory, texture_cache, texture_pipeline, ai_mat,
-          aiTextureType_SPECULAR);
+          aiTextureType_SPECULAR, TextureUsage::kMask);
 
         // Get roughness texture
         create_texture_func(scene_directory, texture_cache, texture_pipeline, ai_mat,
-          aiTextureType_SHININESS);
+          aiTextureType_SHININESS, TextureUsage::kMask);
       }
 
       return true;
@@ -394,6 +397,7 @@ namespace sulphur
     bool MaterialPipeline::PackageMaterial(const foundation::Path& asset_origin, 
       foundation::MaterialAsset& material)
     {
+      BuildReport::StageScope stage(BuildStage::kPackage, "material");
       if (material.name.get_length() == 0)
       {
         PS_LOG_BUILDER(Error, 
@@ -428,6 +432,7 @@ namespace sulphur
       TexturePipeline& texture_pipeline,
       foundation::Vector<foundation::MaterialAsset>& materials) const
     {
+      BuildReport::StageScope stage(BuildStage::kPackage, "texture_cache");
       for(const eastl::pair<foundation::Path, int> it : texture_cache.texture_lookup)
       {
         for(foundation::MaterialAsset& material: materials)
@@ -1,4 +1,5 @@
 #include "tools/builder/pipelines/mesh_pipeline.h"
+#include "tools/builder/shared/build_report.h"
 #include "tools/builder/shared/util.h"
 #include "tools/builder/pipelines/skeleton_pipeline.h"
 #include <foundation/io/binary_writer.h>
@@ -17,6 +18,7 @@ namespace sulphur
       foundation::Vector<foundation::MeshAsset>& meshes,
       foundation::Vector<foundation::SkeletonAsset>& skeletons) const
     {
+      BuildReport::StageScope stage(BuildStage::kCreate, "mesh");
       if (scene == nullptr)
       {
         PS_LOG_BUILDER(Error,
@@ -78,6 +80,7 @@ namespace sulphur
     //--------------------------------------------------------------------------------
     bool MeshPipeline::PackageMesh(const foundation::Path& asset_origin, foundation::MeshAsset& mesh)
     {
+      BuildReport::StageScope stage(BuildStage::kPackage, "mesh");
       if (ValidatePath(asset_origin) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -111,11 +114,16 @@ namespace sulphur
         return false;
       }
 
+      for (foundation::SubMesh& sub_mesh : mesh.data.sub_meshes)
+      {
+        sub_mesh.vertex_encoding = vertex_encoding_;
+      }
+
       foundation::BinaryWriter writer(output_file);
 
       writer.Write(mesh.data);
 
-      if (writer.SaveCompressed(foundation::CompressionType::kHighCompression) == false)
+      if (SaveCompressed(writer, output_file) == false)
       {
         PS_LOG_BUILDER(Error, 
           "Failed to package mesh.");
@@ -137,6 +145,18 @@ namespace sulphur
       return "mesh_package";
     }
 
+    //--------------------------------------------------------------------------------
+    void MeshPipeline::set_vertex_encoding(foundation::VertexEncoding vertex_encoding)
+    {
+      vertex_encoding_ = vertex_encoding;
+    }
+
+    //--------------------------------------------------------------------------------
+    foundation::VertexEncoding MeshPipeline::vertex_encoding() const
+    {
+      return vertex_encoding_;
+    }
+
     //--------------------------------------------------------------------------------
     bool MeshPipeline::LoadSubMeshes(const aiScene* scene, const aiNode* node,
       const glm::mat4& parent_transform, foundation::MeshData& mesh,
@@ -64,6 +64,20 @@ namespace sulphur
        */
       foundation::String GetCacheName() const override;
 
+      /**
+       * @brief Sets the encoding used for the vertex data of packaged meshes.
+       * @param[in] vertex_encoding (sulphur::foundation::VertexEncoding) The vertex encoding.
+       * @remark Sub-meshes that can't be quantized are always packaged with 
+       * sulphur::foundation::VertexEncoding::kFloat.
+       */
+      void set_vertex_encoding(foundation::VertexEncoding vertex_encoding);
+
+      /**
+       * @return (sulphur::foundation::VertexEncoding) The encoding used for the vertex 
+       * data of packaged meshes.
+       */
+      foundation::VertexEncoding vertex_encoding() const;
+
     private:
       /**
        * @brief Recursivly loads all sub-meshes and adds them to the mesh.
@@ -94,7 +108,9 @@ namespace sulphur
       *  the bounding shapes for. Bounding shapes are stored in the mesh.
       */
       static void CalculateBoundingShapes(foundation::MeshData& mesh);
-    
+
+      foundation::VertexEncoding vertex_encoding_ = 
+        foundation::VertexEncoding::kFloat; //!< The encoding used for the vertex data of packaged meshes.
     };
   }
 }
@@ -1,4 +1,5 @@
 #include "tools/builder/pipelines/model_pipeline.h"
+#include "tools/builder/shared/build_report.h"
 #include "tools/builder/pipelines/mesh_pipeline.h"
 #include "tools/builder/pipelines/skeleton_pipeline.h"
 #include "tools/builder/pipelines/material_pipeline.h"
@@ -30,7 +31,9 @@ namespace sulphur
 
       foundation::Path file_path = file.is_relative_path() ? project_dir() + file : file;
 
-      const aiScene* scene = scene_loader.LoadScene(file_path);
+      SceneHandle scene_handle = 
+        scene_loader.LoadScene(file_path, SceneLoader::kModelPostProcess);
+      const aiScene* scene = scene_handle.get();
       if (scene == nullptr)
       {
         PS_LOG_BUILDER(Error, 
@@ -83,6 +86,7 @@ namespace sulphur
       const foundation::AssetName& pixel_shader,
       foundation::Vector<foundation::ModelAsset>& models)
     {
+      BuildReport::StageScope stage(BuildStage::kCreate, "model");
       if (ValidatePath(file) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -100,7 +104,9 @@ namespace sulphur
         return false;
       }
 
-      const aiScene* scene = scene_loader.LoadScene(file_path);
+      SceneHandle scene_handle = 
+        scene_loader.LoadScene(file_path, SceneLoader::kModelPostProcess);
+      const aiScene* scene = scene_handle.get();
       if (scene == nullptr)
       {
         PS_LOG_BUILDER(Error,
@@ -152,7 +158,7 @@ namespace sulphur
       }
 
       foundation::Vector<foundation::MaterialAsset> materials;
-      if (material_pipeline.Create(scene, directory, scene_loader.GetModelFileType(), 
+      if (material_pipeline.Create(scene, directory, scene_handle.file_type(), 
         shader_pipeline, texture_cache, vertex_shader, pixel_shader, materials) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -224,6 +230,7 @@ namespace sulphur
       SkeletonPipeline& skeleton_pipeline, MaterialPipeline& material_pipeline, 
       TexturePipeline& texture_pipeline)
     {
+      BuildReport::StageScope stage(BuildStage::kPackage, "model");
       if (ValidatePath(asset_origin) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -1,6 +1,7 @@
 #include "tools/builder/pipelines/pipeline_base.h"
 #include "tools/builder/shared/util.h"
 #include "tools/builder/shared/file_system.h"
+#include "tools/builder/shared/build_report.h"
 
 #include <foundation/io/binary_reader.h>
 #include <foundation/io/binary_writer.h>
@@ -127,9 +128,31 @@ namespace sulphur
       return abs_path.GetString().substr(project_dir_.GetString().length());
     }
 
+    //--------------------------------------------------------------------------------
+    bool PipelineBase::SaveCompressed(foundation::BinaryWriter& writer,
+      const foundation::Path& output_file) const
+    {
+      BuildReport::StageScope stage(BuildStage::kCompression, "lz4");
+
+      if (writer.SaveCompressed(foundation::CompressionType::kHighCompression) == false)
+      {
+        return false;
+      }
+
+      if (BuildReport::enabled() == true)
+      {
+        BuildReport::AddBytes(writer.GetSize(), 
+          BuildReport::GetFileSize(output_file.GetString()));
+      }
+
+      return true;
+    }
+
     //--------------------------------------------------------------------------------
     void PipelineBase::ExportCache() const
     {
+      BuildReport::StageScope stage(BuildStage::kCacheExport, GetCacheName().c_str());
+
       foundation::Path cache_file = output_path().GetString() + GetCacheName() + ".cache";
       foundation::BinaryWriter writer(cache_file);
 
@@ -139,7 +162,10 @@ namespace sulphur
       {
         PS_LOG_BUILDER(Warning, 
           "Failed to write %s cache.", GetCacheName().c_str());
+        return;
       }
+
+      BuildReport::AddBytes(0, writer.GetSize());
     }
 
     //--------------------------------------------------------------------------------
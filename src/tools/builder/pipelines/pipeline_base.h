@@ -69,6 +69,16 @@ namespace sulphur
       * @see sulphur::builder::PipelineBase::ValidatePath
       */
       foundation::Path CreateProjectRelativePath(const foundation::Path& abs_path) const;
+
+      /**
+      * @brief Compresses the data written to a package and saves it to disk.
+      * @param[in] writer (sulphur::foundation::BinaryWriter&) The writer holding the package data.
+      * @param[in] output_file (const sulphur::foundation::Path&) The file the writer saves to.
+      * @return (bool) True if the package was saved succesfully.
+      * @remark The time spent and the bytes in and out are recorded in the build report.
+      */
+      bool SaveCompressed(foundation::BinaryWriter& writer, 
+        const foundation::Path& output_file) const;
     public:
       /**
        * @brief Initializes the pipeline. Loads the package.
@@ -1,75 +1,310 @@
 #include "tools/builder/pipelines/scene_loader.h"
 #include "tools/builder/base/logger.h"
+#include "tools/builder/shared/build_report.h"
+#include <foundation/memory/memory.h>
+#include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 
-namespace sulphur 
+#include <EASTL/algorithm.h>
+
+#include <thread>
+
+namespace sulphur
 {
-  namespace builder 
+  namespace builder
   {
+    /**
+     * @struct sulphur::builder::SceneEntry
+     * @brief A scene imported by the sulphur::builder::SceneLoader.
+     */
+    struct SceneEntry
+    {
+      foundation::Path file;          //!< The file the scene was imported from.
+      unsigned int post_process = 0;  //!< The post-process steps applied to the scene.
+      ModelFileType file_type = ModelFileType::kUnknown; //!< The type of the file.
+      Assimp::Importer* importer = nullptr; //!< The importer holding the scene.
+      const aiScene* scene = nullptr; //!< The scene or nullptr if the import failed.
+      unsigned int references = 0;    //!< The amount of handles referencing the scene.
+      uint64_t last_release = 0;      //!< When the last reference was released.
+      std::mutex mutex;               //!< Locked while the scene is being imported or processed.
+    };
+
+    //--------------------------------------------------------------------------------
+    const unsigned int SceneLoader::kModelPostProcess =
+      aiProcess_GenNormals |
+      aiProcess_CalcTangentSpace |
+      aiProcess_JoinIdenticalVertices |
+      aiProcess_LimitBoneWeights |
+      aiProcess_RemoveRedundantMaterials |
+      aiProcess_Triangulate |
+      aiProcess_SortByPType |
+      aiProcess_ImproveCacheLocality;
+
+    //--------------------------------------------------------------------------------
+    // Meshes have to be split the same way as for models, so the bones are found in the same order
+    const unsigned int SceneLoader::kSkeletonPostProcess =
+      aiProcess_LimitBoneWeights |
+      aiProcess_Triangulate |
+      aiProcess_SortByPType;
+
+    //--------------------------------------------------------------------------------
+    const unsigned int SceneLoader::kAnimationPostProcess = 0;
+
+    //--------------------------------------------------------------------------------
+    SceneHandle::SceneHandle() :
+      loader_(nullptr),
+      entry_(nullptr)
+    {
+    }
+
+    //--------------------------------------------------------------------------------
+    SceneHandle::SceneHandle(SceneLoader* loader, SceneEntry* entry) :
+      loader_(loader),
+      entry_(entry)
+    {
+    }
+
     //--------------------------------------------------------------------------------
-    const aiScene* SceneLoader::LoadScene(const foundation::Path& file)
+    SceneHandle::~SceneHandle()
     {
-      if (file == last_file_loaded_)
+      Release();
+    }
+
+    //--------------------------------------------------------------------------------
+    SceneHandle::SceneHandle(SceneHandle&& other) :
+      loader_(other.loader_),
+      entry_(other.entry_)
+    {
+      other.loader_ = nullptr;
+      other.entry_ = nullptr;
+    }
+
+    //--------------------------------------------------------------------------------
+    SceneHandle& SceneHandle::operator=(SceneHandle&& other)
+    {
+      if (this != &other)
+      {
+        Release();
+        loader_ = other.loader_;
+        entry_ = other.entry_;
+        other.loader_ = nullptr;
+        other.entry_ = nullptr;
+      }
+      return *this;
+    }
+
+    //--------------------------------------------------------------------------------
+    void SceneHandle::Release()
+    {
+      if (entry_ != nullptr)
       {
-        return GetScene();
+        loader_->Release(entry_);
+        loader_ = nullptr;
+        entry_ = nullptr;
       }
+    }
 
-      const aiScene* ai_scene = importer_.ReadFile(file.GetString().c_str(),
-        aiProcess_GenNormals |
-        aiProcess_CalcTangentSpace |
-        aiProcess_JoinIdenticalVertices |
-        aiProcess_LimitBoneWeights |
-        aiProcess_RemoveRedundantMaterials |
-        aiProcess_Triangulate |
-        aiProcess_SortByPType |
-        aiProcess_ImproveCacheLocality);
-
-      if (ai_scene == nullptr)
+    //--------------------------------------------------------------------------------
+    const aiScene* SceneHandle::get() const
+    {
+      return entry_ != nullptr ? entry_->scene : nullptr;
+    }
+
+    //--------------------------------------------------------------------------------
+    const aiScene* SceneHandle::operator->() const
+    {
+      return get();
+    }
+
+    //--------------------------------------------------------------------------------
+    ModelFileType SceneHandle::file_type() const
+    {
+      return entry_ != nullptr ? entry_->file_type : ModelFileType::kUnknown;
+    }
+
+    //--------------------------------------------------------------------------------
+    SceneLoader::SceneLoader(unsigned int max_importers) :
+      max_importers_(max_importers),
+      num_importers_(0),
+      release_counter_(0)
+    {
+      if (max_importers_ == 0)
+      {
+        max_importers_ = eastl::max(1u, std::thread::hardware_concurrency());
+      }
+    }
+
+    //--------------------------------------------------------------------------------
+    SceneLoader::~SceneLoader()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      while (entries_.empty() == false)
+      {
+        RemoveEntry(entries_.size() - 1);
+      }
+
+      for (Assimp::Importer* importer : free_importers_)
+      {
+        foundation::Memory::Destruct(importer);
+      }
+      free_importers_.clear();
+    }
+
+    //--------------------------------------------------------------------------------
+    SceneHandle SceneLoader::LoadScene(const foundation::Path& file, unsigned int post_process)
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      // Reuse a scene that was imported with all requested steps
+      for (SceneEntry* entry : entries_)
+      {
+        if (entry->file == file && (post_process & ~entry->post_process) == 0)
+        {
+          ++entry->references;
+          lock.unlock();
+
+          // Wait until the scene is imported
+          std::lock_guard<std::mutex> entry_lock(entry->mutex);
+          return SceneHandle(this, entry);
+        }
+      }
+
+      // Apply the missing steps to a scene that isn't used by anyone else
+      for (SceneEntry* entry : entries_)
+      {
+        if (entry->file == file && entry->references == 0 && entry->scene != nullptr)
+        {
+          ++entry->references;
+          std::lock_guard<std::mutex> entry_lock(entry->mutex);
+          const unsigned int missing_steps = post_process & ~entry->post_process;
+          entry->post_process |= missing_steps;
+          lock.unlock();
+
+          BuildReport::StageScope stage(BuildStage::kImport, "assimp");
+          entry->scene = entry->importer->ApplyPostProcessing(missing_steps);
+          if (entry->scene == nullptr)
+          {
+            PS_LOG_BUILDER(Error,
+              "Assimp: %s", entry->importer->GetErrorString());
+          }
+
+          return SceneHandle(this, entry);
+        }
+      }
+
+      SceneEntry* entry = foundation::Memory::Construct<SceneEntry>();
+      entry->file = file;
+      entry->post_process = post_process;
+      entry->file_type = GetModelFileType(file);
+      entry->importer = AcquireImporter();
+      entry->references = 1;
+      entries_.push_back(entry);
+
+      std::lock_guard<std::mutex> entry_lock(entry->mutex);
+      lock.unlock();
+
+      BuildReport::StageScope stage(BuildStage::kImport, "assimp");
+      BuildReport::AddBytes(BuildReport::GetFileSize(file.GetString()), 0);
+
+      entry->scene = entry->importer->ReadFile(file.GetString().c_str(), post_process);
+      if (entry->scene == nullptr)
       {
         PS_LOG_BUILDER(Error,
-          "Assimp: %s", importer_.GetErrorString());
-        return nullptr;
+          "Assimp: %s", entry->importer->GetErrorString());
       }
 
-      last_file_loaded_ = file;
+      return SceneHandle(this, entry);
+    }
 
+    //--------------------------------------------------------------------------------
+    ModelFileType SceneLoader::GetModelFileType(const foundation::Path& file)
+    {
       foundation::String extension = file.GetFileExtension();
       if (extension == "fbx")
       {
-        model_file_type_ = ModelFileType::kFBX;
+        return ModelFileType::kFBX;
       }
       else if (extension == "obj")
       {
-        model_file_type_ = ModelFileType::kOBJ;
+        return ModelFileType::kOBJ;
       }
       else if (extension == "gltf")
       {
-        model_file_type_ = ModelFileType::kglTF;
-      }
-      else
-      {
-        model_file_type_ = ModelFileType::kUnknown;
+        return ModelFileType::kglTF;
       }
 
-      return GetScene();
+      return ModelFileType::kUnknown;
     }
 
     //--------------------------------------------------------------------------------
-    const aiScene* SceneLoader::GetScene() const
+    Assimp::Importer* SceneLoader::AcquireImporter()
     {
-      return importer_.GetScene();
+      if (free_importers_.empty() == false)
+      {
+        Assimp::Importer* importer = free_importers_.back();
+        free_importers_.pop_back();
+        return importer;
+      }
+
+      if (num_importers_ >= max_importers_)
+      {
+        // Evict the least recently used scene nobody references
+        size_t evict = entries_.size();
+        for (size_t i = 0; i < entries_.size(); ++i)
+        {
+          if (entries_[i]->references == 0 && (evict == entries_.size() ||
+            entries_[i]->last_release < entries_[evict]->last_release))
+          {
+            evict = i;
+          }
+        }
+
+        if (evict != entries_.size())
+        {
+          RemoveEntry(evict);
+          Assimp::Importer* importer = free_importers_.back();
+          free_importers_.pop_back();
+          return importer;
+        }
+      }
+
+      // Every importer is in use, grow the pool
+      ++num_importers_;
+      return foundation::Memory::Construct<Assimp::Importer>();
     }
 
     //--------------------------------------------------------------------------------
-    const foundation::Path& SceneLoader::GetLastFileLoaded() const
+    void SceneLoader::RemoveEntry(size_t index)
     {
-      return last_file_loaded_;
+      SceneEntry* entry = entries_[index];
+      entries_.erase(entries_.begin() + index);
+
+      entry->importer->FreeScene();
+      free_importers_.push_back(entry->importer);
+      foundation::Memory::Destruct(entry);
     }
 
     //--------------------------------------------------------------------------------
-    ModelFileType SceneLoader::GetModelFileType() const
+    void SceneLoader::Release(SceneEntry* entry)
     {
-      return model_file_type_;
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      --entry->references;
+      entry->last_release = ++release_counter_;
+
+      if (entry->references == 0 && entry->scene == nullptr)
+      {
+        // Don't keep failed imports around, so the next request retries
+        for (size_t i = 0; i < entries_.size(); ++i)
+        {
+          if (entries_[i] == entry)
+          {
+            RemoveEntry(i);
+            break;
+          }
+        }
+      }
     }
   }
 }
@@ -1,15 +1,25 @@
 #pragma once
 #include <foundation/containers/string.h>
 #include <foundation/containers/vector.h>
-#include <assimp/Importer.hpp>
 #include <foundation/io/filesystem.h>
 
+#include <mutex>
+
 struct aiNode;
+struct aiScene;
+
+namespace Assimp
+{
+  class Importer;
+}
 
-namespace sulphur 
+namespace sulphur
 {
-  namespace builder 
+  namespace builder
   {
+    struct SceneEntry;
+    class SceneLoader;
+
     /**
      * @brief The types of supported model file formats
      */
@@ -21,39 +31,143 @@ namespace sulphur
       kglTF,
     };
 
+    /**
+     * @class sulphur::builder::SceneHandle
+     * @brief Reference to a scene imported by the sulphur::builder::SceneLoader.
+     * The scene stays loaded for as long as a handle to it exists.
+     */
+    class SceneHandle
+    {
+    public:
+      SceneHandle();
+      /**
+       * @brief Releases the reference to the scene.
+       */
+      ~SceneHandle();
+
+      SceneHandle(const SceneHandle&) = delete;
+      SceneHandle& operator=(const SceneHandle&) = delete;
+
+      /**
+       * @brief Takes over the reference of another handle.
+       * @param[in] other (sulphur::builder::SceneHandle&&) The handle to take the reference from.
+       */
+      SceneHandle(SceneHandle&& other);
+      /**
+       * @brief Releases the current reference and takes over the reference of another handle.
+       * @param[in] other (sulphur::builder::SceneHandle&&) The handle to take the reference from.
+       * @return (sulphur::builder::SceneHandle&) This handle.
+       */
+      SceneHandle& operator=(SceneHandle&& other);
+
+      /**
+       * @brief Releases the reference to the scene. The handle is invalid afterwards.
+       */
+      void Release();
+
+      /**
+       * @return (const aiScene*) The imported scene or nullptr if the import failed.
+       */
+      const aiScene* get() const;
+      /**
+       * @return (const aiScene*) The imported scene.
+       */
+      const aiScene* operator->() const;
+      /**
+       * @return (sulphur::builder::ModelFileType) The type of the file the scene was imported from.
+       */
+      ModelFileType file_type() const;
+
+    private:
+      friend class SceneLoader;
+
+      /**
+       * @brief Constructs a handle from a referenced entry.
+       * @param[in] loader (sulphur::builder::SceneLoader*) The loader owning the entry.
+       * @param[in] entry (sulphur::builder::SceneEntry*) The referenced entry.
+       */
+      SceneHandle(SceneLoader* loader, SceneEntry* entry);
+
+      SceneLoader* loader_; //!< The loader owning the entry.
+      SceneEntry* entry_;   //!< The referenced scene.
+    };
+
     /**
      * @class sulphur::builder::SceneLoader
-     * @brief Utility class for loading scenes from model files.
+     * @brief Imports scenes from model files and shares them between pipelines.
+     * @remark Every source file is imported once and reused by every caller that needs it,
+     * as long as the post-process steps it was imported with include the ones requested.
+     * Imported scenes remain cached after their last handle is released, until their
+     * importer is needed for another file.
+     * @remark Each concurrently used scene has its own Assimp::Importer taken from a pool,
+     * so different files can be imported at the same time from multiple threads.
      * @author Timo van Hees
      */
     class SceneLoader
     {
     public:
-      /**
-      * @brief Loads the scene from a file.
-      * @param[in] file (const sulphur::foundation::Path&) The file containing the scene.
-      * @return (const aiScene*) Returns the loaded scene or nullptr.
-      */
-      const aiScene* LoadScene(const foundation::Path& file);
+      static const unsigned int kModelPostProcess;     //!< Post-process steps needed to create models and meshes.
+      static const unsigned int kSkeletonPostProcess;  //!< Post-process steps needed to create skeletons.
+      static const unsigned int kAnimationPostProcess; //!< Post-process steps needed to create animations.
 
       /**
-       * @return (const aiScene*) The last loaded scene or nullptr. 
+       * @brief Constructor.
+       * @param[in] max_importers (unsigned int) The amount of importers to pool before
+       * unreferenced scenes are evicted. 0 uses the amount of hardware threads.
        */
-      const aiScene* GetScene() const;
+      SceneLoader(unsigned int max_importers = 0);
       /**
-      * @return (const sulphur::foundation::Path&) The last loaded file.
-      */
-      const foundation::Path& GetLastFileLoaded() const;
+       * @brief Destructor. Frees all scenes and importers.
+       * @remark All handles must have been released.
+       */
+      ~SceneLoader();
+
       /**
-      * @return (sulphur::builder::ModelFileType) The type of the last loaded file.
+      * @brief Loads the scene from a file or references it if it was already imported.
+      * @param[in] file (const sulphur::foundation::Path&) The file containing the scene.
+      * @param[in] post_process (unsigned int) The aiPostProcessSteps the caller needs.
+      * @return (sulphur::builder::SceneHandle) Handle to the scene.
+      * sulphur::builder::SceneHandle::get returns nullptr if the import failed.
       */
-      ModelFileType GetModelFileType() const;
+      SceneHandle LoadScene(const foundation::Path& file,
+        unsigned int post_process = kModelPostProcess);
 
+      /**
+      * @param[in] file (const sulphur::foundation::Path&) A model file.
+      * @return (sulphur::builder::ModelFileType) The type of the model file.
+      */
+      static ModelFileType GetModelFileType(const foundation::Path& file);
 
     private:
-      Assimp::Importer importer_; //!< Importer used to load all scenes. 
-      foundation::Path last_file_loaded_; //!< The file name of the last loaded scene.
-      ModelFileType model_file_type_; //!< The type of model file loaded.
+      friend class SceneHandle;
+
+      /**
+       * @brief Takes an importer from the pool, evicting an unreferenced scene if needed.
+       * @return (Assimp::Importer*) An importer without a scene.
+       * @remark mutex_ must be locked.
+       */
+      Assimp::Importer* AcquireImporter();
+
+      /**
+       * @brief Frees the scene of an entry, returns its importer to the pool and
+       * deletes the entry.
+       * @param[in] index (size_t) The index of the entry in entries_.
+       * @remark mutex_ must be locked.
+       */
+      void RemoveEntry(size_t index);
+
+      /**
+       * @brief Releases a reference to an entry.
+       * @param[in] entry (sulphur::builder::SceneEntry*) The entry to release.
+       */
+      void Release(SceneEntry* entry);
+
+      std::mutex mutex_; //!< Guards the entries and the importer pool.
+      foundation::Vector<SceneEntry*> entries_;             //!< Imported and importing scenes.
+      foundation::Vector<Assimp::Importer*> free_importers_; //!< Importers not holding a scene.
+      unsigned int max_importers_;  //!< The amount of importers to create before evicting scenes.
+      unsigned int num_importers_;  //!< The amount of importers created.
+      uint64_t release_counter_;    //!< Increments every release, used to find the least recently used scene.
     };
   }
 }
@@ -1,4 +1,5 @@
 #include "tools/builder/pipelines/script_pipeline.h"
+#include "tools/builder/shared/build_report.h"
 #include <foundation/pipeline-assets/script.h>
 
 //#define SCRIPT_COMPILE_DEBUG
@@ -11,6 +12,7 @@ namespace sulphur
     bool ScriptPipeline::Create(const foundation::Path& file,
       foundation::ScriptAsset& script) const
     {
+      BuildReport::StageScope stage(BuildStage::kCreate, "script");
       if (ValidatePath(file) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -57,6 +59,7 @@ namespace sulphur
     bool ScriptPipeline::PackageScript(const foundation::Path& asset_origin,
       foundation::ScriptAsset& script)
     {
+      BuildReport::StageScope stage(BuildStage::kPackage, "script");
       if (ValidatePath(asset_origin) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -1,4 +1,5 @@
 #include "tools/builder/pipelines/shader_pipeline.h"
+#include "tools/builder/shared/build_report.h"
 #include "tools/builder/pipelines/shader_pipeline_options.h"
 #include "tools/builder/shared/spv_shader_compiler.h"
 #include "tools/builder/platform-specific/win32/win32_hlsl_compiler.h"
@@ -27,6 +28,7 @@ namespace sulphur
     bool ShaderPipeline::Create(const foundation::Path& shader_file, 
       const ShaderPipelineOptions& options, foundation::ShaderAsset& shader)
     {
+      BuildReport::StageScope stage(BuildStage::kCreate, "shader");
       if (ValidatePath(shader_file) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -83,6 +85,7 @@ namespace sulphur
     bool ShaderPipeline::PackageShader(const foundation::Path& asset_origin,
       foundation::ShaderAsset& shader)
     {
+      BuildReport::StageScope stage(BuildStage::kPackage, "shader");
       if (ValidatePath(asset_origin) == false)
       {
         PS_LOG_BUILDER(Error,
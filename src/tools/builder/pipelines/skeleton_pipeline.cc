@@ -1,4 +1,5 @@
 #include "tools/builder/pipelines/skeleton_pipeline.h"
+#include "tools/builder/shared/build_report.h"
 #include "tools/builder/shared/util.h"
 #include "tools/builder/pipelines/scene_loader.h"
 #include <foundation/pipeline-assets/skeleton.h>
@@ -13,6 +14,7 @@ namespace sulphur
     bool SkeletonPipeline::Create(const foundation::Path& file, SceneLoader& scene_loader,
       foundation::Vector<foundation::SkeletonAsset>& skeletons) const
     {
+      BuildReport::StageScope stage(BuildStage::kCreate, "skeleton");
       if (ValidatePath(file) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -24,7 +26,9 @@ namespace sulphur
       foundation::Path file_path = file.is_relative_path() ? project_dir() + file : file;
 
 
-      const aiScene* scene = scene_loader.LoadScene(file_path);
+      SceneHandle scene_handle = 
+        scene_loader.LoadScene(file_path, SceneLoader::kSkeletonPostProcess);
+      const aiScene* scene = scene_handle.get();
       if (scene == nullptr)
       {
         PS_LOG_BUILDER(Error,
@@ -103,6 +107,7 @@ namespace sulphur
     bool SkeletonPipeline::PackageSkeleton(const foundation::Path& asset_origin,
       foundation::SkeletonAsset& skeleton)
     {
+      BuildReport::StageScope stage(BuildStage::kPackage, "skeleton");
       if (ValidatePath(asset_origin) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -140,7 +145,7 @@ namespace sulphur
 
       writer.Write(skeleton.data);
 
-      if (writer.SaveCompressed(foundation::CompressionType::kHighCompression) == false)
+      if (SaveCompressed(writer, output_file) == false)
       {
         PS_LOG_BUILDER(Error,
           "Failed to package skeleton.");
@@ -1,10 +1,13 @@
 #include "tools/builder/pipelines/texture_pipeline.h"
+#include "tools/builder/shared/build_report.h"
 #include "tools/builder/pipelines/texture_processor.h"
 #include "tools/builder/shared/util.h"
 #include <foundation/containers/vector.h>
 #include <foundation/io/binary_reader.h>
 #include <foundation/logging/logger.h>
 
+#include <EASTL/algorithm.h>
+
 #define STB_NO_STDIO
 #include <stb_image.h>
 #include <nvtt/nvtt.h>
@@ -20,8 +23,9 @@ namespace sulphur
   {
     // ------------------------------------------------------------------------
     bool TexturePipeline::Create(const foundation::Path& image_file,
-      foundation::TextureAsset& texture) const
+      foundation::TextureAsset& texture, TextureUsage usage) const
     {
+      BuildReport::StageScope stage(BuildStage::kCreate, "texture");
       if (ValidatePath(image_file) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -46,6 +50,22 @@ namespace sulphur
         return false;
       }
 
+      if (compression_settings_.compress == true || 
+        compression_settings_.generate_mips == true)
+      {
+        if (compression_settings_.usage != TextureUsage::kAuto)
+        {
+          usage = compression_settings_.usage;
+        }
+
+        if (ProcessTexture(usage, texture) == false)
+        {
+          PS_LOG_BUILDER(Error,
+            "Failed to process the texture. Texture should be discarded.");
+          return false;
+        }
+      }
+
       return true;
     }
 
@@ -53,6 +73,7 @@ namespace sulphur
     bool TexturePipeline::PackageTexture(const foundation::Path& asset_origin, 
       foundation::TextureAsset& texture)
     {
+      BuildReport::StageScope stage(BuildStage::kPackage, "texture");
       if (ValidatePath(asset_origin) == false)
       {
         PS_LOG_BUILDER(Error,
@@ -90,7 +111,7 @@ namespace sulphur
 
       writer.Write(texture.data);
 
-      if (writer.SaveCompressed(foundation::CompressionType::kHighCompression) == false)
+      if (SaveCompressed(writer, output_file) == false)
       {
         PS_LOG_BUILDER(Warning,
           "Failed to package texture.");
@@ -120,6 +141,7 @@ namespace sulphur
         foundation::TextureAsset asset = {};
         asset.name = "ps_default_texture";
         asset.data.pixel_data = { 255, 0, 255, 255 };
+        asset.data.mip_offsets = { 0 };
         asset.data.width = 1;
         asset.data.height = 1;
         asset.data.depth = 0;
@@ -127,6 +149,7 @@ namespace sulphur
         asset.data.type = foundation::TextureType::k2D;
         asset.data.format = foundation::TexelFormat::kRGBA;
         asset.data.compression = foundation::TextureCompressionType::kNone;
+        asset.data.srgb = false;
 
         if (PackageTexture(ASSET_ORIGIN_USER, asset) == false)
         {
@@ -139,6 +162,219 @@ namespace sulphur
       return true;
     }
 
+    // ------------------------------------------------------------------------
+    void TexturePipeline::set_compression_settings(const TextureCompressionSettings& settings)
+    {
+      compression_settings_ = settings;
+    }
+
+    // ------------------------------------------------------------------------
+    const TextureCompressionSettings& TexturePipeline::compression_settings() const
+    {
+      return compression_settings_;
+    }
+
+    // ------------------------------------------------------------------------
+    bool TexturePipeline::ProcessTexture(TextureUsage usage, 
+      foundation::TextureAsset& texture) const
+    {
+      foundation::TextureData& data = texture.data;
+      if (data.type != foundation::TextureType::k2D ||
+        data.compression != foundation::TextureCompressionType::kNone)
+      {
+        PS_LOG_BUILDER(Warning,
+          "Only uncompressed 2D textures can be processed. Texture %s is packaged as is.",
+          texture.name.GetCString());
+        return true;
+      }
+
+      const bool hdr = data.format == foundation::TexelFormat::kHDR;
+      const size_t texel_count = static_cast<size_t>(data.width) * data.height;
+      const size_t num_channels = hdr == true ? 4 : data.pixel_data.size() / texel_count;
+
+      // Convert the pixel data to the BGRA layout expected by NVTT
+      foundation::Vector<byte> input_data;
+      bool has_alpha = false;
+      if (hdr == true)
+      {
+        input_data = data.pixel_data;
+      }
+      else
+      {
+        input_data.resize(texel_count * 4);
+        for (size_t i = 0; i < texel_count; ++i)
+        {
+          const byte* texel = &data.pixel_data[i * num_channels];
+          byte* out = &input_data[i * 4];
+          switch (num_channels)
+          {
+          case 1:
+            out[0] = out[1] = out[2] = texel[0];
+            out[3] = 255;
+            break;
+          case 2:
+            out[0] = out[1] = out[2] = texel[0];
+            out[3] = texel[1];
+            break;
+          default:
+            out[0] = texel[2];
+            out[1] = texel[1];
+            out[2] = texel[0];
+            out[3] = texel[3];
+            break;
+          }
+
+          has_alpha |= out[3] != 255;
+        }
+      }
+
+      if (usage == TextureUsage::kAuto)
+      {
+        usage = hdr == true ? TextureUsage::kHDR : DeduceUsage(texture, num_channels);
+      }
+
+      if ((usage == TextureUsage::kHDR) != hdr)
+      {
+        PS_LOG_BUILDER(Warning,
+          "Texture %s is %s HDR image. Deducing the usage instead.",
+          texture.name.GetCString(), hdr == true ? "a" : "not a");
+        usage = hdr == true ? TextureUsage::kHDR : DeduceUsage(texture, num_channels);
+      }
+
+      nvtt::InputOptions input_options;
+      input_options.setTextureLayout(nvtt::TextureType_2D, data.width, data.height);
+      input_options.setFormat(hdr == true ? 
+        nvtt::InputFormat_RGBA_32F : nvtt::InputFormat_BGRA_8UB);
+      input_options.setMipmapData(input_data.data(), data.width, data.height);
+      input_options.setMipmapGeneration(compression_settings_.generate_mips);
+      input_options.setMipmapFilter(nvtt::MipmapFilter_Kaiser);
+      input_options.setWrapMode(nvtt::WrapMode_Repeat);
+      input_options.setAlphaMode(has_alpha == true ? 
+        nvtt::AlphaMode_Transparency : nvtt::AlphaMode_None);
+
+      // Albedo is filtered in linear space and converted back to sRGB afterwards
+      const bool srgb = usage == TextureUsage::kAlbedo;
+      input_options.setGamma(srgb == true ? 2.2f : 1.0f, srgb == true ? 2.2f : 1.0f);
+
+      if (usage == TextureUsage::kNormal)
+      {
+        input_options.setNormalMap(true);
+        input_options.setNormalizeMipmaps(true);
+      }
+
+      nvtt::Format format = nvtt::Format_RGBA;
+      foundation::TextureCompressionType compression = foundation::TextureCompressionType::kNone;
+      if (compression_settings_.compress == true)
+      {
+        switch (usage)
+        {
+        case TextureUsage::kAlbedo:
+          compression = has_alpha == true ? 
+            foundation::TextureCompressionType::kBC3 : foundation::TextureCompressionType::kBC1;
+          break;
+        case TextureUsage::kNormal:
+          compression = foundation::TextureCompressionType::kBC5;
+          break;
+        case TextureUsage::kMask:
+          compression = num_channels == 1 ?
+            foundation::TextureCompressionType::kBC4 : foundation::TextureCompressionType::kBC7;
+          break;
+        case TextureUsage::kHDR:
+          compression = foundation::TextureCompressionType::kBC6;
+          break;
+        default:
+          break;
+        }
+
+        // The compression types map directly onto the NVTT formats
+        format = static_cast<nvtt::Format>(compression);
+      }
+
+      nvtt::CompressionOptions compression_options;
+      compression_options.setFormat(format);
+      compression_options.setQuality(nvtt::Quality_Production);
+      if (compression == foundation::TextureCompressionType::kNone)
+      {
+        if (hdr == true)
+        {
+          compression_options.setPixelType(nvtt::PixelType_Float);
+          compression_options.setPixelFormat(32, 32, 32, 32);
+        }
+        else
+        {
+          // Output RGBA byte order
+          compression_options.setPixelFormat(32, 
+            0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+        }
+      }
+      else if (usage == TextureUsage::kNormal)
+      {
+        compression_options.setColorWeights(1.0f, 1.0f, 0.0f);
+      }
+
+      // NVTT encodes the blocks on all cores using its concurrent task dispatcher
+      nvtt::Compressor compressor;
+      compressor.enableCudaAcceleration(false);
+
+      foundation::TextureData processed = {};
+      TextureProcessor processor(&processed, 
+        compressor.estimateSize(input_options, compression_options));
+
+      nvtt::OutputOptions output_options;
+      output_options.setOutputHeader(false);
+      output_options.setOutputHandler(&processor);
+      output_options.setErrorHandler(&processor);
+
+      if (compressor.process(input_options, compression_options, output_options) == false ||
+        processor.failed() == true)
+      {
+        PS_LOG_BUILDER(Error,
+          "NVTT failed to process texture %s.", texture.name.GetCString());
+        return false;
+      }
+
+      data.pixel_data = eastl::move(processed.pixel_data);
+      data.mip_offsets = eastl::move(processed.mip_offsets);
+      data.width = processed.width;
+      data.height = processed.height;
+      data.depth = processed.depth;
+      data.mips = static_cast<int>(data.mip_offsets.size());
+      data.compression = compression;
+      data.srgb = srgb;
+
+      return true;
+    }
+
+    // ------------------------------------------------------------------------
+    TextureUsage TexturePipeline::DeduceUsage(const foundation::TextureAsset& texture,
+      size_t num_channels)
+    {
+      foundation::String name = texture.name.GetString();
+      eastl::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+      const auto ends_with = [&name](const char* suffix)
+      {
+        const size_t length = strlen(suffix);
+        return name.size() >= length && 
+          name.compare(name.size() - length, length, suffix) == 0;
+      };
+
+      if (ends_with("_n") || ends_with("_nrm") || 
+        ends_with("normal") || ends_with("normals"))
+      {
+        return TextureUsage::kNormal;
+      }
+
+      if (num_channels == 1 || ends_with("_mask") || ends_with("_rough") ||
+        ends_with("_roughness") || ends_with("_metal") || ends_with("_metallic") ||
+        ends_with("_ao") || ends_with("_orm") || ends_with("_spec"))
+      {
+        return TextureUsage::kMask;
+      }
+
+      return TextureUsage::kAlbedo;
+    }
+
     // ------------------------------------------------------------------------
     bool TexturePipeline::LoadImage(const foundation::Path& image_file,
       foundation::TextureAsset& texture) const
@@ -169,7 +405,8 @@ namespace sulphur
         file_extension == "jpg" ||
         file_extension == "jpeg" ||
         file_extension == "bmp" ||
-        file_extension == "tga")
+        file_extension == "tga" ||
+        file_extension == "hdr")
       {
         if (LoadImageSTBI(image_file, texture, image_data, size) == false)
         {
@@ -203,6 +440,45 @@ namespace sulphur
       int height = 0;
       int num_channels = 0;
 
+      if (stbi_is_hdr_from_memory(image_data, size) != 0)
+      {
+        int real_num_channels = 0;
+        float* texture_data = stbi_loadf_from_memory(image_data, size, &width, &height,
+          &real_num_channels, 4);
+        if (texture_data == nullptr)
+        {
+          PS_LOG_BUILDER(Error,
+            "Failed to load texture data from image. file: %s", image_file.GetString().c_str());
+          return false;
+        }
+
+        const size_t row_size = width * foundation::GetBytesPerTexel(foundation::TexelFormat::kHDR);
+        const byte* source = reinterpret_cast<const byte*>(texture_data);
+        foundation::Vector<byte>& pd = texture.data.pixel_data;
+        pd.resize(row_size * height);
+
+        // Copy the rows flipped
+        for (int y = 0; y < height; ++y)
+        {
+          eastl::copy(source + (height - y - 1) * row_size, 
+            source + (height - y) * row_size, pd.begin() + y * row_size);
+        }
+
+        stbi_image_free(texture_data);
+
+        texture.data.mip_offsets = { 0 };
+        texture.data.width = width;
+        texture.data.height = height;
+        texture.data.depth = 1;
+        texture.data.mips = 1;
+        texture.data.type = foundation::TextureType::k2D;
+        texture.data.format = foundation::TexelFormat::kHDR;
+        texture.data.compression = foundation::TextureCompressionType::kNone;
+        texture.data.srgb = false;
+
+        return true;
+      }
+
       stbi_info_from_memory(image_data, size, &width, &height, &num_channels);
       if (num_channels == 3)
       {
@@ -241,6 +517,7 @@ namespace sulphur
         }
       }
 
+      texture.data.mip_offsets = { 0 };
       texture.data.width = width;
       texture.data.height = height;
       texture.data.depth = 1;
@@ -248,6 +525,7 @@ namespace sulphur
       texture.data.type = foundation::TextureType::k2D;
       texture.data.format = foundation::TexelFormat::kRGBA;
       texture.data.compression = foundation::TextureCompressionType::kNone;
+      texture.data.srgb = false;
 
       return true;
     }
@@ -269,9 +547,11 @@ namespace sulphur
       uint32_t width = dds.width();
       uint32_t height = dds.height();
       uint32_t depth = dds.depth();
-      int mips = dds.mipmapCount();
       int array_size = dds.arraySize();
 
+      texture.data.pixel_data.clear();
+      texture.data.mip_offsets = { 0 };
+
       foundation::TextureType type = {};
       if(dds.isTexture1D())
       {
@@ -304,6 +584,12 @@ namespace sulphur
             return false;
           }
 
+          if (i > 0)
+          {
+            texture.data.mip_offsets.push_back(
+              static_cast<uint32_t>(texture.data.pixel_data.size()));
+          }
+
           texture.data.pixel_data.insert(texture.data.pixel_data.end(), pixel_data.begin(), pixel_data.end());
         }
       }
@@ -321,6 +607,12 @@ namespace sulphur
             return false;
           }
 
+          if (i > 0)
+          {
+            texture.data.mip_offsets.push_back(
+              static_cast<uint32_t>(texture.data.pixel_data.size()));
+          }
+
           texture.data.pixel_data.insert(texture.data.pixel_data.end(), pixel_data.begin(), pixel_data.end());
         }
       }
@@ -338,16 +630,25 @@ namespace sulphur
             return false;
           }
 
+          if (i > 0)
+          {
+            texture.data.mip_offsets.push_back(
+              static_cast<uint32_t>(texture.data.pixel_data.size()));
+          }
+
           texture.data.pixel_data.insert(texture.data.pixel_data.end(), pixel_data.begin(), pixel_data.end());
         }
       }
 
+      // Only the top level mip of every surface is loaded
       texture.data.width = width;
       texture.data.height = height;
       texture.data.depth = depth;
-      texture.data.mips = mips;
+      texture.data.mips = 1;
+      texture.data.type = type;
       texture.data.format = foundation::TexelFormat::kRGBA;
       texture.data.compression = foundation::TextureCompressionType::kNone;
+      texture.data.srgb = false;
 
       return true;
     }
@@ -11,6 +11,30 @@ namespace sulphur
 {
   namespace builder 
   {
+    /**
+     * @brief Describes how the pixel data of a texture is used. 
+     * Determines the block compression format and the way mips are filtered.
+     */
+    enum struct TextureUsage
+    {
+      kAuto,    //!< Deduce the usage from the file name and the pixel data.
+      kAlbedo,  //!< Color data in sRGB space. BC1, or BC3 when the texture has alpha.
+      kNormal,  //!< Tangent space normal map. BC5.
+      kMask,    //!< Linear data like roughness or metalness. BC4, or BC7 when multiple channels are used.
+      kHDR      //!< High dynamic range color data. BC6.
+    };
+
+    /**
+     * @struct sulphur::builder::TextureCompressionSettings
+     * @brief Settings used by the texture pipeline to process textures before they are packaged.
+     */
+    struct TextureCompressionSettings
+    {
+      bool compress = false;      //!< Should the texture be block compressed.
+      bool generate_mips = false; //!< Should a full mip chain be generated.
+      TextureUsage usage = TextureUsage::kAuto; //!< Forces the usage of all textures when not kAuto.
+    };
+
     /**
      * @class sulphur::builder::TexturePipeline : sulphur::builder::PipelineBase
      * @brief Pipeline that handles the creation, packaging, processing and management 
@@ -26,10 +50,13 @@ namespace sulphur
        * containing the pixel data. 
        * @param[out] texture (sulphur::builder::TextureAsset&) The texture created 
        * from the image.
+       * @param[in] usage (sulphur::builder::TextureUsage) Hint of how the texture is used.
+       * Ignored when the compression settings force a usage.
        * @return (bool) False when there was an error that couldn't be recovered from. 
        * @remark If the function returned false, the texture should be discarded.
        */
-      bool Create(const foundation::Path& image_file, foundation::TextureAsset& texture) const;
+      bool Create(const foundation::Path& image_file, foundation::TextureAsset& texture,
+        TextureUsage usage = TextureUsage::kAuto) const;
       /**
        * @brief Adds a texture to the package.
        * @param[in] asset_origin (const sulphur::foundation::Path&) The file the asset was 
@@ -52,7 +79,38 @@ namespace sulphur
       */
       bool PackageDefaultAssets() override;
 
+      /**
+       * @brief Sets the settings used to compress textures and generate their mips.
+       * @param[in] settings (const sulphur::builder::TextureCompressionSettings&) The settings.
+       */
+      void set_compression_settings(const TextureCompressionSettings& settings);
+
+      /**
+       * @return (const sulphur::builder::TextureCompressionSettings&) The settings used 
+       * to compress textures and generate their mips.
+       */
+      const TextureCompressionSettings& compression_settings() const;
+
     private:
+      /**
+       * @brief Generates the mip chain of a texture and block compresses it 
+       * using Nvidia Texture Tools, according to the compression settings.
+       * @param[in] usage (sulphur::builder::TextureUsage) How the texture is used.
+       * @param[in|out] texture (sulphur::builder::TextureAsset&) The texture to process.
+       * @return (bool) False when there was an error that couldn't be recovered from.
+       * @remark If the function returned false, the texture should be discarded.
+       */
+      bool ProcessTexture(TextureUsage usage, foundation::TextureAsset& texture) const;
+
+      /**
+       * @brief Deduces the usage of a texture from its name and pixel data.
+       * @param[in] texture (const sulphur::builder::TextureAsset&) The texture.
+       * @param[in] num_channels (size_t) The number of channels in the pixel data.
+       * @return (sulphur::builder::TextureUsage) The deduced usage.
+       */
+      static TextureUsage DeduceUsage(const foundation::TextureAsset& texture, 
+        size_t num_channels);
+
       /**
        * @brief Loads an image and creates a texture with the pixel data.
        * @param[in] image_file (const sulphur::foundation::Path&) The image file 
@@ -103,6 +161,8 @@ namespace sulphur
        */
       bool LoadSurface(nv::DirectDrawSurface& dds, int face, int mip, 
         foundation::Vector<byte>& pixel_data) const;
+
+      TextureCompressionSettings compression_settings_; //!< The settings used to compress textures and generate their mips.
     };
   }
 }
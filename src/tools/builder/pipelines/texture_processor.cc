@@ -13,22 +13,24 @@ namespace sulphur
       int width,
       int height,
       int depth,
-      int /*mip_level*/,
+      int face,
       int mip_level)
     {
-      if (mip_level == 0)
+      if (face == 0 && mip_level == 0)
       {
         target_->width = width;
         target_->height = height;
         target_->depth = depth;
       }
+
+      target_->mip_offsets.push_back(static_cast<uint32_t>(curr_texel_));
     }
 
     // ------------------------------------------------------------------------
     bool TextureProcessor::writeData(const void* data, int size)
     {
       const byte* source = static_cast<const byte*>(data);
-      eastl::copy(source, source + size, curr_texel_);
+      target_->pixel_data.insert(target_->pixel_data.end(), source, source + size);
       
       curr_texel_ += size;
 
@@ -43,6 +45,7 @@ namespace sulphur
     // ------------------------------------------------------------------------
     void TextureProcessor::error(nvtt::Error error)
     {
+      failed_ = true;
       PS_LOG_BUILDER(Error,
         nvtt::errorString(error));
     }
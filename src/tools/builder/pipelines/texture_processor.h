@@ -7,25 +7,57 @@ namespace sulphur
 {
   namespace builder 
   {
+    /**
+     * @struct sulphur::builder::TextureProcessor : nvtt::OutputHandler, nvtt::ErrorHandler
+     * @brief Receives the processed images from Nvidia Texture Tools and stores them
+     * in texture data. Every image is appended to the pixel data and its offset is 
+     * recorded in the mip offsets.
+     */
     struct TextureProcessor : public nvtt::OutputHandler, public nvtt::ErrorHandler
     {
     public:
+      /**
+       * @brief Constructor.
+       * @param[in] target (sulphur::foundation::TextureData*) The texture data to write to.
+       * @param[in] total_size (size_t) The estimated size of all images.
+       */
       TextureProcessor(foundation::TextureData* target, size_t total_size)
-        : target_(target)
+        : target_(target), 
+        curr_texel_(0),
+        failed_(false)
       {
-        target->pixel_data.resize(total_size);
-        curr_texel_ = target->pixel_data.begin();
+        target->pixel_data.clear();
+        target->pixel_data.reserve(total_size);
+        target->mip_offsets.clear();
       }
 
+      /**
+       * @see nvtt::OutputHandler::beginImage
+       */
       void beginImage(int size, int width, int height, int depth, int face,
         int mip_level) override;
+      /**
+       * @see nvtt::OutputHandler::writeData
+       */
       bool writeData(const void * data, int size) override;
+      /**
+       * @see nvtt::OutputHandler::endImage
+       */
       void endImage() override;
-      void error(nvtt::Error error);
+      /**
+       * @see nvtt::ErrorHandler::error
+       */
+      void error(nvtt::Error error) override;
+
+      /**
+       * @return (bool) True if Nvidia Texture Tools reported an error.
+       */
+      bool failed() const { return failed_; }
 
     private:
-      foundation::TextureData* target_;
-      foundation::Vector<byte>::iterator curr_texel_;
+      foundation::TextureData* target_; //!< The texture data to write to.
+      size_t curr_texel_;               //!< Write offset into the pixel data.
+      bool failed_;                     //!< Did Nvidia Texture Tools report an error.
     };
   }
 }
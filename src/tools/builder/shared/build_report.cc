@@ -0,0 +1,501 @@
+#include "tools/builder/shared/build_report.h"
+#include "tools/builder/base/logger.h"
+#include <foundation/memory/memory.h>
+
+#include <EASTL/sort.h>
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+
+#ifdef PS_WIN32
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+namespace sulphur
+{
+  namespace builder
+  {
+    namespace
+    {
+      using Clock = std::chrono::steady_clock;
+
+      /**
+      * @struct sulphur::builder::<anonymous>::StageFrame
+      * @brief A stage that is currently being measured.
+      */
+      struct StageFrame
+      {
+        foundation::String name;       //!< The name of the stage in the report.
+        Clock::time_point wall_start;  //!< Wall clock time when the stage started.
+        double cpu_start;              //!< Thread CPU time when the stage started.
+        uint64_t peak_memory_start;    //!< Peak memory of the process when the stage started.
+        double child_wall_ms;          //!< Wall time spent in nested stages.
+        double child_cpu_ms;           //!< CPU time spent in nested stages.
+        uint64_t child_peak_memory_growth; //!< Peak memory growth in nested stages.
+        uint64_t bytes_in;             //!< Bytes read or passed into the stage.
+        uint64_t bytes_out;            //!< Bytes produced by the stage.
+      };
+
+      /**
+      * @struct sulphur::builder::<anonymous>::AssetRecord
+      * @brief Measurements of a single source asset.
+      */
+      struct AssetRecord
+      {
+        BuildStats totals; //!< Measurements of the asset as a whole.
+        foundation::Map<foundation::String, BuildStats> stages; //!< Measurements per stage.
+      };
+
+      /**
+      * @struct sulphur::builder::<anonymous>::ThreadState
+      * @brief What a single thread is measuring.
+      */
+      struct ThreadState
+      {
+        foundation::Vector<StageFrame> frames;  //!< Stack of active stages.
+        foundation::String current_asset;       //!< The asset stages are attributed to.
+        Clock::time_point asset_wall_start;     //!< Wall clock time when the asset started.
+        double asset_cpu_start;                 //!< Thread CPU time when the asset started.
+        uint64_t asset_peak_memory_start;       //!< Peak memory of the process when the asset started.
+      };
+
+      /**
+      * @struct sulphur::builder::<anonymous>::ReportState
+      * @brief Everything recorded while the report is enabled.
+      */
+      struct ReportState
+      {
+        foundation::Path file;                  //!< The file to write the report to.
+        Clock::time_point build_wall_start;     //!< Wall clock time when recording started.
+        double build_cpu_start;                 //!< Process CPU time when recording started.
+        uint64_t build_peak_memory_start;       //!< Peak memory of the process when recording started.
+        std::mutex mutex;                       //!< Guards the measurements per asset and per stage.
+        foundation::Map<foundation::String, AssetRecord> assets; //!< Measurements per asset.
+        foundation::Map<foundation::String, BuildStats> stages;  //!< Measurements per stage over all assets.
+      };
+
+      const char* kNoAsset = "(builder)"; //!< Asset name of work done outside of an asset scope.
+      ReportState* state_ = nullptr;      //!< The report being recorded, nullptr when disabled.
+      thread_local ThreadState thread_state_; //!< The stages and asset measured by the calling thread.
+
+#ifdef PS_WIN32
+      //--------------------------------------------------------------------------------
+      double ToMilliseconds(const FILETIME& kernel_time, const FILETIME& user_time)
+      {
+        ULARGE_INTEGER kernel, user;
+        kernel.LowPart = kernel_time.dwLowDateTime;
+        kernel.HighPart = kernel_time.dwHighDateTime;
+        user.LowPart = user_time.dwLowDateTime;
+        user.HighPart = user_time.dwHighDateTime;
+
+        // FILETIME is in 100 nanosecond intervals
+        return static_cast<double>(kernel.QuadPart + user.QuadPart) / 10000.0;
+      }
+#endif
+
+      //--------------------------------------------------------------------------------
+      double GetThreadCpuMilliseconds()
+      {
+#ifdef PS_WIN32
+        FILETIME creation_time, exit_time, kernel_time, user_time;
+        if (GetThreadTimes(GetCurrentThread(),
+          &creation_time, &exit_time, &kernel_time, &user_time) == FALSE)
+        {
+          return 0.0;
+        }
+        return ToMilliseconds(kernel_time, user_time);
+#else
+        timespec time = {};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return static_cast<double>(time.tv_sec) * 1000.0 + static_cast<double>(time.tv_nsec) / 1000000.0;
+#endif
+      }
+
+      //--------------------------------------------------------------------------------
+      double GetProcessCpuMilliseconds()
+      {
+#ifdef PS_WIN32
+        FILETIME creation_time, exit_time, kernel_time, user_time;
+        if (GetProcessTimes(GetCurrentProcess(),
+          &creation_time, &exit_time, &kernel_time, &user_time) == FALSE)
+        {
+          return 0.0;
+        }
+        return ToMilliseconds(kernel_time, user_time);
+#else
+        return static_cast<double>(std::clock()) * 1000.0 / CLOCKS_PER_SEC;
+#endif
+      }
+
+      //--------------------------------------------------------------------------------
+      uint64_t GetPeakMemory()
+      {
+#ifdef PS_WIN32
+        PROCESS_MEMORY_COUNTERS counters = {};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == FALSE)
+        {
+          return 0;
+        }
+        return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+#else
+        rusage usage = {};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+      }
+
+      //--------------------------------------------------------------------------------
+      double GetMilliseconds(Clock::time_point start, Clock::time_point end)
+      {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+      }
+
+      //--------------------------------------------------------------------------------
+      foundation::String EscapeJson(const foundation::String& value)
+      {
+        foundation::String result;
+        result.reserve(value.size());
+        for (char c : value)
+        {
+          if (c == '\\' || c == '"')
+          {
+            result.push_back('\\');
+          }
+          result.push_back(c);
+        }
+        return result;
+      }
+
+      //--------------------------------------------------------------------------------
+      void WriteStats(std::ofstream& out, const BuildStats& stats)
+      {
+        out << "\"wall_ms\": " << stats.wall_ms
+          << ", \"cpu_ms\": " << stats.cpu_ms
+          << ", \"bytes_in\": " << stats.bytes_in
+          << ", \"bytes_out\": " << stats.bytes_out
+          << ", \"peak_memory_growth\": " << stats.peak_memory_growth
+          << ", \"calls\": " << stats.calls;
+      }
+
+      //--------------------------------------------------------------------------------
+      void WriteStages(std::ofstream& out,
+        const foundation::Map<foundation::String, BuildStats>& stages, const char* indent)
+      {
+        out << "[";
+        bool first = true;
+        for (const eastl::pair<const foundation::String, BuildStats>& stage : stages)
+        {
+          out << (first == true ? "\n" : ",\n") << indent
+            << "{ \"name\": \"" << EscapeJson(stage.first).c_str() << "\", ";
+          WriteStats(out, stage.second);
+          out << " }";
+          first = false;
+        }
+        out << "]";
+      }
+
+      /**
+      * @brief Sorts named stats by wall time, slowest first.
+      */
+      template<typename T>
+      foundation::Vector<const eastl::pair<const foundation::String, T>*> SortByWallTime(
+        const foundation::Map<foundation::String, T>& map,
+        const BuildStats& (*get_stats)(const T&))
+      {
+        foundation::Vector<const eastl::pair<const foundation::String, T>*> result;
+        result.reserve(map.size());
+        for (const eastl::pair<const foundation::String, T>& entry : map)
+        {
+          result.push_back(&entry);
+        }
+
+        eastl::sort(result.begin(), result.end(),
+          [get_stats](const eastl::pair<const foundation::String, T>* a,
+            const eastl::pair<const foundation::String, T>* b)
+        {
+          return get_stats(a->second).wall_ms > get_stats(b->second).wall_ms;
+        });
+        return result;
+      }
+
+      //--------------------------------------------------------------------------------
+      const BuildStats& GetStageStats(const BuildStats& stats)
+      {
+        return stats;
+      }
+
+      //--------------------------------------------------------------------------------
+      const BuildStats& GetAssetStats(const AssetRecord& record)
+      {
+        return record.totals;
+      }
+    }
+
+    //--------------------------------------------------------------------------------
+    void BuildStats::Accumulate(const BuildStats& other)
+    {
+      wall_ms += other.wall_ms;
+      cpu_ms += other.cpu_ms;
+      bytes_in += other.bytes_in;
+      bytes_out += other.bytes_out;
+      peak_memory_growth += other.peak_memory_growth;
+      calls += other.calls;
+    }
+
+    //--------------------------------------------------------------------------------
+    BuildReport::StageScope::StageScope(BuildStage stage, const char* pipeline) :
+      active_(state_ != nullptr)
+    {
+      if (active_ == false)
+      {
+        return;
+      }
+
+      StageFrame frame = {};
+      frame.name = GetStageName(stage);
+      frame.name += ":";
+      frame.name += pipeline;
+      frame.wall_start = Clock::now();
+      frame.cpu_start = GetThreadCpuMilliseconds();
+      frame.peak_memory_start = GetPeakMemory();
+      thread_state_.frames.push_back(frame);
+    }
+
+    //--------------------------------------------------------------------------------
+    BuildReport::StageScope::~StageScope()
+    {
+      ThreadState& thread_state = thread_state_;
+      if (active_ == false || state_ == nullptr || thread_state.frames.empty() == true)
+      {
+        return;
+      }
+
+      const StageFrame frame = thread_state.frames.back();
+      thread_state.frames.pop_back();
+
+      const double wall_ms = GetMilliseconds(frame.wall_start, Clock::now());
+      const double cpu_ms = GetThreadCpuMilliseconds() - frame.cpu_start;
+      const uint64_t peak_memory_growth = GetPeakMemory() - frame.peak_memory_start;
+
+      if (thread_state.frames.empty() == false)
+      {
+        thread_state.frames.back().child_wall_ms += wall_ms;
+        thread_state.frames.back().child_cpu_ms += cpu_ms;
+        thread_state.frames.back().child_peak_memory_growth += peak_memory_growth;
+      }
+
+      BuildStats stats;
+      stats.wall_ms = eastl::max(0.0, wall_ms - frame.child_wall_ms);
+      stats.cpu_ms = eastl::max(0.0, cpu_ms - frame.child_cpu_ms);
+      stats.bytes_in = frame.bytes_in;
+      stats.bytes_out = frame.bytes_out;
+      stats.peak_memory_growth = peak_memory_growth - eastl::min(peak_memory_growth, frame.child_peak_memory_growth);
+      stats.calls = 1;
+
+      const foundation::String asset = thread_state.current_asset.empty() == true ?
+        foundation::String(kNoAsset) : thread_state.current_asset;
+
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      state_->assets[asset].stages[frame.name].Accumulate(stats);
+      state_->stages[frame.name].Accumulate(stats);
+    }
+
+    //--------------------------------------------------------------------------------
+    BuildReport::AssetScope::AssetScope(const foundation::String& asset) :
+      active_(state_ != nullptr && thread_state_.current_asset.empty() == true)
+    {
+      if (active_ == false)
+      {
+        return;
+      }
+
+      thread_state_.current_asset = asset;
+      thread_state_.asset_wall_start = Clock::now();
+      thread_state_.asset_cpu_start = GetThreadCpuMilliseconds();
+      thread_state_.asset_peak_memory_start = GetPeakMemory();
+    }
+
+    //--------------------------------------------------------------------------------
+    BuildReport::AssetScope::~AssetScope()
+    {
+      if (active_ == false || state_ == nullptr)
+      {
+        return;
+      }
+
+      ThreadState& thread_state = thread_state_;
+
+      BuildStats stats;
+      stats.wall_ms = GetMilliseconds(thread_state.asset_wall_start, Clock::now());
+      stats.cpu_ms = GetThreadCpuMilliseconds() - thread_state.asset_cpu_start;
+      stats.peak_memory_growth = GetPeakMemory() - thread_state.asset_peak_memory_start;
+      stats.calls = 1;
+
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      AssetRecord& record = state_->assets[thread_state.current_asset];
+      for (const eastl::pair<const foundation::String, BuildStats>& stage : record.stages)
+      {
+        stats.bytes_in += stage.second.bytes_in;
+        stats.bytes_out += stage.second.bytes_out;
+      }
+
+      // Bytes are summed from the stages, so only keep the latest sum
+      record.totals.bytes_in = 0;
+      record.totals.bytes_out = 0;
+      record.totals.Accumulate(stats);
+
+      thread_state.current_asset.clear();
+    }
+
+    //--------------------------------------------------------------------------------
+    void BuildReport::Enable(const foundation::Path& file)
+    {
+      if (state_ == nullptr)
+      {
+        state_ = foundation::Memory::Construct<ReportState>();
+      }
+
+      state_->file = file;
+      state_->build_wall_start = Clock::now();
+      state_->build_cpu_start = GetProcessCpuMilliseconds();
+      state_->build_peak_memory_start = GetPeakMemory();
+    }
+
+    //--------------------------------------------------------------------------------
+    bool BuildReport::enabled()
+    {
+      return state_ != nullptr;
+    }
+
+    //--------------------------------------------------------------------------------
+    void BuildReport::AddBytes(uint64_t bytes_in, uint64_t bytes_out)
+    {
+      if (state_ == nullptr || thread_state_.frames.empty() == true)
+      {
+        return;
+      }
+
+      thread_state_.frames.back().bytes_in += bytes_in;
+      thread_state_.frames.back().bytes_out += bytes_out;
+    }
+
+    //--------------------------------------------------------------------------------
+    uint64_t BuildReport::GetFileSize(const foundation::String& file)
+    {
+      std::ifstream in_file(file.c_str(), std::ios::binary | std::ios::ate);
+      if (in_file.is_open() == false)
+      {
+        return 0;
+      }
+
+      return static_cast<uint64_t>(in_file.tellg());
+    }
+
+    //--------------------------------------------------------------------------------
+    bool BuildReport::Save()
+    {
+      if (state_ == nullptr)
+      {
+        return false;
+      }
+
+      BuildStats build;
+      build.wall_ms = GetMilliseconds(state_->build_wall_start, Clock::now());
+      const uint64_t peak_memory = GetPeakMemory();
+      build.cpu_ms = GetProcessCpuMilliseconds() - state_->build_cpu_start;
+      build.peak_memory_growth = peak_memory - state_->build_peak_memory_start;
+      build.calls = 1;
+      for (const eastl::pair<const foundation::String, BuildStats>& stage : state_->stages)
+      {
+        build.bytes_in += stage.second.bytes_in;
+        build.bytes_out += stage.second.bytes_out;
+      }
+
+      bool result = true;
+      std::ofstream out(state_->file.GetString().c_str(), std::ios::trunc);
+      if (out.is_open() == false)
+      {
+        PS_LOG_BUILDER(Error, "Unable to write build report to %s.",
+          state_->file.GetString().c_str());
+        result = false;
+      }
+      else
+      {
+        out << "{\n  \"build\": { ";
+        WriteStats(out, build);
+        out << " },\n  \"stages\": ";
+        WriteStages(out, state_->stages, "    ");
+        out << ",\n  \"assets\": [";
+
+        bool first = true;
+        for (const eastl::pair<const foundation::String, AssetRecord>& asset : state_->assets)
+        {
+          out << (first == true ? "\n" : ",\n")
+            << "    { \"name\": \"" << EscapeJson(asset.first).c_str() << "\", ";
+          WriteStats(out, asset.second.totals);
+          out << ", \"stages\": ";
+          WriteStages(out, asset.second.stages, "        ");
+          out << " }";
+          first = false;
+        }
+        out << "]\n}\n";
+        out.close();
+      }
+
+      PS_LOG_BUILDER(Info, "Build report: %.1f ms wall, %.1f ms cpu, %llu bytes in, "
+        "%llu bytes out, %llu bytes peak memory.", build.wall_ms, build.cpu_ms,
+        static_cast<unsigned long long>(build.bytes_in),
+        static_cast<unsigned long long>(build.bytes_out),
+        static_cast<unsigned long long>(peak_memory));
+
+      PS_LOG_BUILDER(Info, "Stages by wall time:");
+      for (const eastl::pair<const foundation::String, BuildStats>* stage :
+        SortByWallTime(state_->stages, &GetStageStats))
+      {
+        PS_LOG_BUILDER(Info, "  %10.1f ms %10.1f ms cpu %6u calls  %s",
+          stage->second.wall_ms, stage->second.cpu_ms, stage->second.calls,
+          stage->first.c_str());
+      }
+
+      PS_LOG_BUILDER(Info, "Assets by wall time:");
+      for (const eastl::pair<const foundation::String, AssetRecord>* asset :
+        SortByWallTime(state_->assets, &GetAssetStats))
+      {
+        PS_LOG_BUILDER(Info, "  %10.1f ms %10.1f ms cpu %12llu bytes out  %s",
+          asset->second.totals.wall_ms, asset->second.totals.cpu_ms,
+          static_cast<unsigned long long>(asset->second.totals.bytes_out),
+          asset->first.c_str());
+      }
+
+      foundation::Memory::Destruct(state_);
+      state_ = nullptr;
+      return result;
+    }
+
+    //--------------------------------------------------------------------------------
+    const char* BuildReport::GetStageName(BuildStage stage)
+    {
+      switch (stage)
+      {
+      case BuildStage::kImport:
+        return "import";
+      case BuildStage::kCreate:
+        return "create";
+      case BuildStage::kPackage:
+        return "package";
+      case BuildStage::kCompression:
+        return "compression";
+      case BuildStage::kCacheExport:
+        return "cache_export";
+      default:
+        return "unknown";
+      }
+    }
+  }
+}
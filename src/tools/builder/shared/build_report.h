@@ -0,0 +1,143 @@
+#pragma once
+#include <foundation/containers/string.h>
+#include <foundation/containers/vector.h>
+#include <foundation/containers/map.h>
+#include <foundation/io/filesystem.h>
+
+namespace sulphur
+{
+  namespace builder
+  {
+    /**
+    * @brief The stages of the content build that are measured by the build report.
+    */
+    enum struct BuildStage : uint8_t
+    {
+      kImport,      //!< Importing a source file with assimp.
+      kCreate,      //!< A pipeline creating assets from a source file.
+      kPackage,     //!< A pipeline packaging an asset.
+      kCompression, //!< Compressing and writing a package to disk.
+      kCacheExport, //!< Writing a pipeline cache to disk.
+      kNumStages
+    };
+
+    /**
+    * @struct sulphur::builder::BuildStats
+    * @brief Measurements of a stage or an asset.
+    */
+    struct BuildStats
+    {
+      double wall_ms = 0.0;       //!< Wall clock time in milliseconds.
+      double cpu_ms = 0.0;        //!< CPU time (user + kernel) of the thread doing the work in milliseconds, of all threads for the whole build.
+      uint64_t bytes_in = 0;      //!< Bytes read or passed in.
+      uint64_t bytes_out = 0;     //!< Bytes produced.
+      uint64_t peak_memory_growth = 0; //!< Bytes the peak memory of the process grew by while the work ran.
+      uint32_t calls = 0;         //!< The amount of times the stage was entered.
+
+      /**
+      * @brief Adds the measurements of another set of stats to these.
+      * @param[in] other (const sulphur::builder::BuildStats&) The stats to add.
+      */
+      void Accumulate(const BuildStats& other);
+    };
+
+    /**
+    * @class sulphur::builder::BuildReport
+    * @brief Records timing, throughput and memory of the content build per asset and
+    * per stage, and writes them to a JSON file with a human-readable summary.
+    * @remark Stage times and memory growth are exclusive. Time spent in a nested stage, e.g. compression
+    * inside a package stage, is only attributed to the nested stage.
+    * @remark CPU time is measured per thread, so work done by other threads at the same time isn't
+    * attributed to a stage. The peak memory is only known for the whole process, so its growth is
+    * attributed to whichever scope was running when it grew.
+    * @remark Recording does nothing until sulphur::builder::BuildReport::Enable is called.
+    * @remark Stages and assets may be measured from multiple threads at the same time. Every thread has
+    * its own stack of stages and its own current asset, the results are merged under a lock. Enable and
+    * Save may not be called while other threads are recording.
+    */
+    class BuildReport
+    {
+    public:
+      /**
+      * @class sulphur::builder::BuildReport::StageScope
+      * @brief Measures a stage for as long as the scope is alive.
+      */
+      class StageScope
+      {
+      public:
+        /**
+        * @brief Starts measuring a stage.
+        * @param[in] stage (sulphur::builder::BuildStage) The stage to measure.
+        * @param[in] pipeline (const char*) The pipeline or library doing the work.
+        */
+        StageScope(BuildStage stage, const char* pipeline);
+        /**
+        * @brief Stops measuring the stage and records the results.
+        */
+        ~StageScope();
+
+      private:
+        bool active_; //!< Whether the report was enabled when the scope was created.
+      };
+
+      /**
+      * @class sulphur::builder::BuildReport::AssetScope
+      * @brief Attributes all stages measured while the scope is alive to a source asset.
+      */
+      class AssetScope
+      {
+      public:
+        /**
+        * @brief Starts measuring an asset.
+        * @param[in] asset (const sulphur::foundation::String&) The source file of the asset.
+        */
+        AssetScope(const foundation::String& asset);
+        /**
+        * @brief Stops measuring the asset and records the results.
+        */
+        ~AssetScope();
+
+      private:
+        bool active_; //!< Whether the report was enabled when the scope was created.
+      };
+
+      /**
+      * @brief Starts recording the build report.
+      * @param[in] file (const sulphur::foundation::Path&) The file to write the JSON report to.
+      */
+      static void Enable(const foundation::Path& file);
+
+      /**
+      * @return (bool) Whether the build report is being recorded.
+      */
+      static bool enabled();
+
+      /**
+      * @brief Adds to the bytes processed by the innermost active stage.
+      * @param[in] bytes_in (uint64_t) Bytes read or passed into the stage.
+      * @param[in] bytes_out (uint64_t) Bytes produced by the stage.
+      */
+      static void AddBytes(uint64_t bytes_in, uint64_t bytes_out);
+
+      /**
+      * @brief Gets the size of a file, used to report the bytes read by a stage.
+      * @param[in] file (const sulphur::foundation::String&) The file.
+      * @return (uint64_t) The size of the file in bytes or 0 if it couldn't be opened.
+      */
+      static uint64_t GetFileSize(const foundation::String& file);
+
+      /**
+      * @brief Writes the JSON report and prints a summary sorted by wall time.
+      * @return (bool) False if the report file couldn't be written.
+      * @remark Recording stops after the report has been written.
+      */
+      static bool Save();
+
+      /**
+      * @param[in] stage (sulphur::builder::BuildStage) The stage.
+      * @return (const char*) The name of the stage as used in the report.
+      */
+      static const char* GetStageName(BuildStage stage);
+    };
+  }
+}